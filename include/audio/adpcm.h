@@ -0,0 +1,125 @@
+#ifndef MIOSIX_DRUM_ADPCM_H
+#define MIOSIX_DRUM_ADPCM_H
+
+#include <cstdint>
+
+/**
+ * 4 bit IMA-ADPCM codec, bit exact with the STMicroelectronics reference
+ * used by miosix/_examples/sad_trombone (adpcm.c), but with the state kept
+ * in an object instead of static variables, so that multiple streams can
+ * be decoded at the same time. Two codes are packed in each byte,
+ * the first one in the low nibble.
+ */
+namespace ImaAdpcm {
+    /**
+     * Quantizer step size lookup table.
+     */
+    static const uint16_t STEP_SIZE_TABLE[89] = {
+            7, 8, 9, 10, 11, 12, 13, 14, 16, 17,
+            19, 21, 23, 25, 28, 31, 34, 37, 41, 45,
+            50, 55, 60, 66, 73, 80, 88, 97, 107, 118,
+            130, 143, 157, 173, 190, 209, 230, 253, 279, 307,
+            337, 371, 408, 449, 494, 544, 598, 658, 724, 796,
+            876, 963, 1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066,
+            2272, 2499, 2749, 3024, 3327, 3660, 4026, 4428, 4871, 5358,
+            5894, 6484, 7132, 7845, 8630, 9493, 10442, 11487, 12635, 13899,
+            15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767
+    };
+
+    /**
+     * Table of the step index changes.
+     */
+    static const int8_t INDEX_TABLE[16] = {-1, -1, -1, -1, 2, 4, 6, 8, -1, -1, -1, -1, 2, 4, 6, 8};
+
+    /**
+     * Predictor state shared by the encoder and the decoder.
+     */
+    class State {
+    public:
+        /**
+         * Constructor.
+         */
+        State() { reset(); };
+
+        /**
+         * Restores the initial state, the one of the beginning of a stream.
+         */
+        inline void reset() {
+            predictor = 0;
+            index = 0;
+        };
+
+        /**
+         * Decodes a 4 bit code.
+         *
+         * @param code code in the low nibble
+         * @return decoded sample
+         */
+        inline int16_t decode(uint8_t code) {
+            update(code & 0x0f);
+            return static_cast<int16_t>(predictor);
+        };
+
+        /**
+         * Encodes a sample, updating the state as the decoder will do.
+         *
+         * @param sample 16 bit sample
+         * @return 4 bit code
+         */
+        inline uint8_t encode(int32_t sample) {
+            int32_t step = STEP_SIZE_TABLE[index];
+            int32_t diff = sample - predictor;
+            uint8_t code = 0;
+            if (diff < 0) {
+                code = 8;
+                diff = -diff;
+            }
+            if (diff >= step) {
+                code |= 4;
+                diff -= step;
+            }
+            step >>= 1;
+            if (diff >= step) {
+                code |= 2;
+                diff -= step;
+            }
+            step >>= 1;
+            if (diff >= step) code |= 1;
+
+            update(code);
+            return code;
+        };
+
+    private:
+        /**
+         * Inverse quantization of a code, and predictor and step updates.
+         */
+        inline void update(uint8_t code) {
+            int32_t step = STEP_SIZE_TABLE[index];
+            int32_t diff = step >> 3;
+            if (code & 4) diff += step;
+            if (code & 2) diff += step >> 1;
+            if (code & 1) diff += step >> 2;
+
+            predictor += (code & 8) ? -diff : diff;
+            if (predictor > 32767) predictor = 32767;
+            else if (predictor < -32768) predictor = -32768;
+
+            index += INDEX_TABLE[code];
+            if (index < 0) index = 0;
+            else if (index > 88) index = 88;
+        };
+
+        /**
+         * Last decoded sample.
+         */
+        int32_t predictor;
+
+        /**
+         * Index in STEP_SIZE_TABLE.
+         */
+        int32_t index;
+    };
+}
+
+#endif //MIOSIX_DRUM_ADPCM_H
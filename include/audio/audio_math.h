@@ -49,6 +49,19 @@ namespace AudioMath {
         return x;
     }
 
+    /**
+     * Waveshaping function used by faust_synth.dsp:
+     * f(a, x) = x * (|x| + a) / (x^2 + (a - 1) * |x| + 1)
+     *
+     * @param x input
+     * @param a amount of distortion, greater or equal to 1
+     * @return distorted input
+     */
+    inline float waveshaper(float x, float a) {
+        float absX = (x < 0) ? -x : x;
+        return x * (absX + a) / (x * x + (a - 1.0f) * absX + 1.0f);
+    }
+
     /**
      * Enumeration describing the behaviour of
      * the LUT tables outside the max and argMin extremes.
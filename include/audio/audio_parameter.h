@@ -1,7 +1,7 @@
 
 
-#ifndef MIOSIX-DRUM_AUDIO_PARAMETER_H
-#define MIOSIX-DRUM_AUDIO_PARAMETER_H
+#ifndef MIOSIX_DRUM_AUDIO_PARAMETER_H
+#define MIOSIX_DRUM_AUDIO_PARAMETER_H
 
 #include "audio_math.h"
 
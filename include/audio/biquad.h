@@ -0,0 +1,367 @@
+#ifndef MIOSIX_DRUM_BIQUAD_H
+#define MIOSIX_DRUM_BIQUAD_H
+
+#include <cmath>
+#include <array>
+#include "audio_buffer.h"
+#include "audio_math.h"
+#include "audio_parameter.h"
+
+/**
+ * Responses available for a biquad section.
+ */
+enum class BiquadType {
+    LOWPASS,
+    HIGHPASS,
+    BANDPASS,
+    NOTCH,
+    PEAK,
+    LOWSHELF,
+    HIGHSHELF
+};
+
+/**
+ * Normalized coefficients of a biquad section (a0 = 1).
+ */
+struct BiquadCoefficients {
+    float b0;
+    float b1;
+    float b2;
+    float a1;
+    float a2;
+
+    /**
+     * Computes the coefficients of a section, using the formulas
+     * from the Audio EQ Cookbook by Robert Bristow-Johnson.
+     *
+     * @param type response of the section
+     * @param frequency cutoff or center frequency in Hz
+     * @param q quality factor
+     * @param gain gain in dB, used only by PEAK, LOWSHELF and HIGHSHELF
+     * @param sampleRate sample rate in Hz
+     * @return normalized coefficients
+     */
+    static BiquadCoefficients compute(BiquadType type, float frequency, float q, float gain, float sampleRate) {
+        float w0 = 2.0f * static_cast<float>(M_PI) * frequency / sampleRate;
+        float cosW0 = std::cos(w0);
+        float alpha = std::sin(w0) / (2.0f * q);
+        float a = std::pow(10.0f, gain / 40.0f);
+        float twoSqrtAAlpha = 2.0f * std::sqrt(a) * alpha;
+
+        float b0 = 1, b1 = 0, b2 = 0, a0 = 1, a1 = 0, a2 = 0;
+        switch (type) {
+            case BiquadType::LOWPASS:
+                b0 = (1.0f - cosW0) / 2.0f;
+                b1 = 1.0f - cosW0;
+                b2 = b0;
+                a0 = 1.0f + alpha;
+                a1 = -2.0f * cosW0;
+                a2 = 1.0f - alpha;
+                break;
+            case BiquadType::HIGHPASS:
+                b0 = (1.0f + cosW0) / 2.0f;
+                b1 = -(1.0f + cosW0);
+                b2 = b0;
+                a0 = 1.0f + alpha;
+                a1 = -2.0f * cosW0;
+                a2 = 1.0f - alpha;
+                break;
+            case BiquadType::BANDPASS:
+                b0 = alpha;
+                b1 = 0;
+                b2 = -alpha;
+                a0 = 1.0f + alpha;
+                a1 = -2.0f * cosW0;
+                a2 = 1.0f - alpha;
+                break;
+            case BiquadType::NOTCH:
+                b0 = 1.0f;
+                b1 = -2.0f * cosW0;
+                b2 = 1.0f;
+                a0 = 1.0f + alpha;
+                a1 = -2.0f * cosW0;
+                a2 = 1.0f - alpha;
+                break;
+            case BiquadType::PEAK:
+                b0 = 1.0f + alpha * a;
+                b1 = -2.0f * cosW0;
+                b2 = 1.0f - alpha * a;
+                a0 = 1.0f + alpha / a;
+                a1 = -2.0f * cosW0;
+                a2 = 1.0f - alpha / a;
+                break;
+            case BiquadType::LOWSHELF:
+                b0 = a * ((a + 1.0f) - (a - 1.0f) * cosW0 + twoSqrtAAlpha);
+                b1 = 2.0f * a * ((a - 1.0f) - (a + 1.0f) * cosW0);
+                b2 = a * ((a + 1.0f) - (a - 1.0f) * cosW0 - twoSqrtAAlpha);
+                a0 = (a + 1.0f) + (a - 1.0f) * cosW0 + twoSqrtAAlpha;
+                a1 = -2.0f * ((a - 1.0f) + (a + 1.0f) * cosW0);
+                a2 = (a + 1.0f) + (a - 1.0f) * cosW0 - twoSqrtAAlpha;
+                break;
+            case BiquadType::HIGHSHELF:
+                b0 = a * ((a + 1.0f) + (a - 1.0f) * cosW0 + twoSqrtAAlpha);
+                b1 = -2.0f * a * ((a - 1.0f) + (a + 1.0f) * cosW0);
+                b2 = a * ((a + 1.0f) + (a - 1.0f) * cosW0 - twoSqrtAAlpha);
+                a0 = (a + 1.0f) - (a - 1.0f) * cosW0 + twoSqrtAAlpha;
+                a1 = 2.0f * ((a - 1.0f) - (a + 1.0f) * cosW0);
+                a2 = (a + 1.0f) - (a - 1.0f) * cosW0 - twoSqrtAAlpha;
+                break;
+        }
+
+        return {b0 / a0, b1 / a0, b2 / a0, a1 / a0, a2 / a0};
+    };
+};
+
+/**
+ * State of a single biquad section in transposed direct form II.
+ */
+class Biquad {
+public:
+    /**
+     * Constructor.
+     */
+    Biquad() : z1(0), z2(0) {};
+
+    /**
+     * Filters a block of samples in place with constant coefficients.
+     *
+     * @param data samples to filter
+     * @param length number of samples
+     * @param c coefficients of the section
+     */
+    inline void process(float *data, size_t length, const BiquadCoefficients &c) {
+        float s1 = z1;
+        float s2 = z2;
+        for (size_t i = 0; i < length; i++) {
+            float x = data[i];
+            float y = c.b0 * x + s1;
+            s1 = c.b1 * x - c.a1 * y + s2;
+            s2 = c.b2 * x - c.a2 * y;
+            data[i] = y;
+        }
+        z1 = s1;
+        z2 = s2;
+    };
+
+    /**
+     * Filters a block of samples in place, linearly interpolating
+     * the coefficients along the block to avoid zipper noise.
+     *
+     * @param data samples to filter
+     * @param length number of samples
+     * @param from coefficients at the beginning of the block
+     * @param to coefficients at the end of the block
+     */
+    inline void processInterpolated(float *data, size_t length,
+                                    const BiquadCoefficients &from, const BiquadCoefficients &to) {
+        float step = 1.0f / static_cast<float>(length);
+        BiquadCoefficients c = from;
+        BiquadCoefficients delta = {(to.b0 - from.b0) * step, (to.b1 - from.b1) * step, (to.b2 - from.b2) * step,
+                                    (to.a1 - from.a1) * step, (to.a2 - from.a2) * step};
+        float s1 = z1;
+        float s2 = z2;
+        for (size_t i = 0; i < length; i++) {
+            c.b0 += delta.b0;
+            c.b1 += delta.b1;
+            c.b2 += delta.b2;
+            c.a1 += delta.a1;
+            c.a2 += delta.a2;
+
+            float x = data[i];
+            float y = c.b0 * x + s1;
+            s1 = c.b1 * x - c.a1 * y + s2;
+            s2 = c.b2 * x - c.a2 * y;
+            data[i] = y;
+        }
+        z1 = s1;
+        z2 = s2;
+    };
+
+    /**
+     * Clears the state of the section.
+     */
+    inline void reset() { z1 = z2 = 0; };
+
+private:
+    /**
+     * State variables of the transposed direct form II.
+     */
+    float z1;
+    float z2;
+};
+
+/**
+ * Cascade of biquad sections applied to every channel of an AudioBuffer.
+ * The parameters of each section are smoothed by AudioParameter objects,
+ * and the coefficients are recomputed only while a parameter is in
+ * transition, once per block, interpolating them inside the block.
+ *
+ * @tparam CHANNEL_NUM number of channels
+ * @tparam STAGES number of biquad sections
+ */
+template<size_t CHANNEL_NUM, size_t STAGES>
+class BiquadCascade {
+public:
+    /**
+     * Constructor, every section is initialized as a flat PEAK filter.
+     *
+     * @param sampleRate sample rate in Hz
+     */
+    BiquadCascade(float sampleRate) : sampleRate(sampleRate), coefficientUpdates(0) {
+        for (auto &stage : stages) {
+            stage.coefficients = computeCoefficients(stage);
+        }
+    };
+
+    /**
+     * Filters a buffer in place.
+     *
+     * @tparam BUFFER_LEN length of the buffer
+     * @param buffer AudioBuffer to be filtered
+     */
+    template<size_t BUFFER_LEN>
+    void processBlock(AudioBuffer<float, CHANNEL_NUM, BUFFER_LEN> &buffer) {
+        for (size_t i = 0; i < STAGES; i++) {
+            Stage &stage = stages[i];
+            if (stage.dirty) {
+                // moving the parameters to the end of the block
+                stage.frequency.updateSampleCount(BUFFER_LEN);
+                stage.q.updateSampleCount(BUFFER_LEN);
+                stage.gain.updateSampleCount(BUFFER_LEN);
+                BiquadCoefficients target = computeCoefficients(stage);
+
+                for (size_t channel = 0; channel < CHANNEL_NUM; channel++) {
+                    sections[channel][i].processInterpolated(buffer.getWritePointer(channel), BUFFER_LEN,
+                                                             stage.coefficients, target);
+                }
+
+                stage.coefficients = target;
+                stage.dirty = !(stage.frequency.transitionIsComplete() &&
+                                stage.q.transitionIsComplete() &&
+                                stage.gain.transitionIsComplete());
+            } else {
+                for (size_t channel = 0; channel < CHANNEL_NUM; channel++) {
+                    sections[channel][i].process(buffer.getWritePointer(channel), BUFFER_LEN, stage.coefficients);
+                }
+            }
+        }
+    };
+
+    /**
+     * Sets the response of a section, the change is not smoothed.
+     *
+     * @param stage index of the section
+     * @param type new response
+     */
+    void setType(size_t stage, BiquadType type) {
+        stages[stage].type = type;
+        stages[stage].coefficients = computeCoefficients(stages[stage]);
+    };
+
+    /**
+     * Sets the cutoff or center frequency of a section.
+     *
+     * @param stage index of the section
+     * @param frequency frequency in Hz, clipped below Nyquist
+     */
+    void setFrequency(size_t stage, float frequency) {
+        stages[stage].frequency.setValue(AudioMath::clip(frequency, 10.0f, 0.49f * sampleRate));
+        stages[stage].dirty = true;
+    };
+
+    /**
+     * Sets the quality factor of a section.
+     *
+     * @param stage index of the section
+     * @param q quality factor, clipped between 0.1 and 40
+     */
+    void setQ(size_t stage, float q) {
+        stages[stage].q.setValue(AudioMath::clip(q, 0.1f, 40.0f));
+        stages[stage].dirty = true;
+    };
+
+    /**
+     * Sets the gain of a PEAK, LOWSHELF or HIGHSHELF section.
+     *
+     * @param stage index of the section
+     * @param gain gain in dB
+     */
+    void setGain(size_t stage, float gain) {
+        stages[stage].gain.setValue(gain);
+        stages[stage].dirty = true;
+    };
+
+    /**
+     * Clears the state of every section.
+     */
+    void reset() {
+        for (auto &channel : sections) {
+            for (auto &section : channel) section.reset();
+        }
+    };
+
+    /**
+     * Returns how many times the coefficients have been computed.
+     *
+     * @return number of coefficient computations
+     */
+    inline unsigned int getCoefficientUpdates() const { return coefficientUpdates; };
+
+private:
+    /**
+     * Parameters and coefficients of a section, shared by all the channels.
+     */
+    struct Stage {
+        Stage() : type(BiquadType::PEAK), frequency(1000.0f), q(0.707f), gain(0.0f), dirty(false) {};
+
+        BiquadType type;
+        AudioParameter<float> frequency;
+        AudioParameter<float> q;
+        AudioParameter<float> gain;
+
+        /**
+         * Coefficients in use at the end of the last block.
+         */
+        BiquadCoefficients coefficients;
+
+        /**
+         * Indicates that some parameter is in transition.
+         */
+        bool dirty;
+    };
+
+    /**
+     * Computes the coefficients of a section from the
+     * current interpolated values of its parameters.
+     */
+    BiquadCoefficients computeCoefficients(const Stage &stage) {
+        coefficientUpdates++;
+        return BiquadCoefficients::compute(stage.type,
+                                           stage.frequency.getInterpolatedValue(),
+                                           stage.q.getInterpolatedValue(),
+                                           stage.gain.getInterpolatedValue(),
+                                           sampleRate);
+    };
+
+    /**
+     * Sample rate in Hz.
+     */
+    float sampleRate;
+
+    /**
+     * Parameters of each section.
+     */
+    std::array<Stage, STAGES> stages;
+
+    /**
+     * Filter state of each section, for each channel.
+     */
+    std::array<std::array<Biquad, STAGES>, CHANNEL_NUM> sections;
+
+    /**
+     * Number of coefficient computations, for diagnostics.
+     */
+    unsigned int coefficientUpdates;
+};
+
+#endif //MIOSIX_DRUM_BIQUAD_H
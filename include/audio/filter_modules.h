@@ -0,0 +1,69 @@
+#ifndef MIOSIX_DRUM_FILTER_MODULES_H
+#define MIOSIX_DRUM_FILTER_MODULES_H
+
+#include "audio_module.h"
+#include "../config/audio_config.h"
+#include "biquad.h"
+#include "state_variable_filter.h"
+
+/**
+ * AudioModule filtering the buffer through a cascade of biquad sections,
+ * each one with its own response, frequency, Q and gain, e.g. to build
+ * a parametric equalizer after the Faust processor.
+ *
+ * @tparam CHANNEL_NUM number of channels of the processed buffer
+ * @tparam STAGES number of biquad sections
+ */
+template<size_t CHANNEL_NUM, size_t STAGES>
+class BiquadFilterBank : public AudioModule<CHANNEL_NUM>, public BiquadCascade<CHANNEL_NUM, STAGES> {
+public:
+    /**
+     * Constructor. The coefficients are computed for AUDIO_DRIVER_SAMPLE_RATE,
+     * since the AudioDriver may not be initialized yet.
+     *
+     * @param audioProcessor AudioProcessor using this module
+     */
+    BiquadFilterBank(AudioProcessor &audioProcessor) :
+            AudioModule<CHANNEL_NUM>(audioProcessor),
+            BiquadCascade<CHANNEL_NUM, STAGES>(AUDIO_DRIVER_SAMPLE_RATE) {};
+
+    /**
+     * Processes the buffer in place.
+     *
+     * @param buffer AudioBuffer to be processed
+     */
+    void process(AudioBuffer<float, CHANNEL_NUM, AUDIO_DRIVER_BUFFER_SIZE> &buffer) override {
+        this->processBlock(buffer);
+    };
+};
+
+/**
+ * AudioModule filtering the buffer through a state variable filter,
+ * suited for cutoff sweeps driven by the user interface.
+ *
+ * @tparam CHANNEL_NUM number of channels of the processed buffer
+ */
+template<size_t CHANNEL_NUM>
+class SvfFilter : public AudioModule<CHANNEL_NUM>, public StateVariableFilter<CHANNEL_NUM> {
+public:
+    /**
+     * Constructor. The coefficients are computed for AUDIO_DRIVER_SAMPLE_RATE,
+     * since the AudioDriver may not be initialized yet.
+     *
+     * @param audioProcessor AudioProcessor using this module
+     */
+    SvfFilter(AudioProcessor &audioProcessor) :
+            AudioModule<CHANNEL_NUM>(audioProcessor),
+            StateVariableFilter<CHANNEL_NUM>(AUDIO_DRIVER_SAMPLE_RATE) {};
+
+    /**
+     * Processes the buffer in place.
+     *
+     * @param buffer AudioBuffer to be processed
+     */
+    void process(AudioBuffer<float, CHANNEL_NUM, AUDIO_DRIVER_BUFFER_SIZE> &buffer) override {
+        this->processBlock(buffer);
+    };
+};
+
+#endif //MIOSIX_DRUM_FILTER_MODULES_H
@@ -0,0 +1,76 @@
+#ifndef MIOSIX_DRUM_OVERSAMPLED_WAVESHAPER_H
+#define MIOSIX_DRUM_OVERSAMPLED_WAVESHAPER_H
+
+#include <cmath>
+#include <array>
+#include "audio_module.h"
+#include "audio_math.h"
+#include "oversampler.h"
+
+/**
+ * AudioModule applying the waveshaping distortion of faust_synth.dsp
+ * at 2x or 4x the sample rate, to reduce the aliasing produced
+ * at high distortion settings. It can be applied to the output
+ * of the Faust processor.
+ *
+ * @tparam CHANNEL_NUM number of channels of the processed buffer
+ * @tparam FACTOR oversampling factor, 2 or 4
+ */
+template<size_t CHANNEL_NUM, size_t FACTOR>
+class OversampledWaveshaper : public AudioModule<CHANNEL_NUM> {
+public:
+    /**
+     * Constructor.
+     *
+     * @param audioProcessor AudioProcessor using this module
+     */
+    OversampledWaveshaper(AudioProcessor &audioProcessor) : AudioModule<CHANNEL_NUM>(audioProcessor) {
+        setDistortion(0);
+    };
+
+    /**
+     * Processes the buffer in place.
+     *
+     * @param buffer AudioBuffer to be processed
+     */
+    void process(AudioBuffer<float, CHANNEL_NUM, AUDIO_DRIVER_BUFFER_SIZE> &buffer) override {
+        for (size_t channel = 0; channel < CHANNEL_NUM; channel++) {
+            oversamplers[channel].process(buffer.getWritePointer(channel), AUDIO_DRIVER_BUFFER_SIZE, shaper);
+        }
+    };
+
+    /**
+     * Sets the distortion amount, with the same scale of the
+     * "distortion" parameter of faust_synth.dsp.
+     *
+     * @param distortion distortion amount between 0 and 100
+     */
+    void setDistortion(float distortion) {
+        distortion = AudioMath::clip(distortion, 0.0f, 100.0f);
+        shaper.amount = std::pow(10.0f, distortion / 20.0f);
+        shaper.gain = 1.0f / std::sqrt(distortion + 1.0f);
+    };
+
+private:
+    /**
+     * Waveshaping function with gain compensation.
+     */
+    struct Shaper {
+        float amount;
+        float gain;
+
+        inline float operator()(float x) const { return gain * AudioMath::waveshaper(x, amount); };
+    };
+
+    /**
+     * Nonlinearity applied at the oversampled rate.
+     */
+    Shaper shaper;
+
+    /**
+     * One oversampler for each channel.
+     */
+    std::array<Oversampler<FACTOR, AUDIO_DRIVER_BUFFER_SIZE>, CHANNEL_NUM> oversamplers;
+};
+
+#endif //MIOSIX_DRUM_OVERSAMPLED_WAVESHAPER_H
@@ -0,0 +1,272 @@
+#ifndef MIOSIX_DRUM_OVERSAMPLER_H
+#define MIOSIX_DRUM_OVERSAMPLER_H
+
+#include <array>
+#include <cstddef>
+
+/**
+ * Precomputed half-band FIR filters used for 2x resampling.
+ *
+ * A half-band filter of length 4 * HALF_LENGTH - 1 has all the odd taps
+ * equal to zero apart from the center one, which is 0.5. In polyphase form
+ * one phase is a pure delay and the other one is a symmetric FIR of
+ * 2 * HALF_LENGTH taps, of which only the first half is stored here.
+ * The coefficients include the gain of 2 needed by the interpolation
+ * and they sum up to 1.
+ */
+namespace HalfBand {
+    /**
+     * 47 taps Kaiser windowed half-band (beta = 7).
+     * At 48kHz -> 96kHz: passband up to 19kHz (0.003dB ripple),
+     * stopband from 29kHz (70dB attenuation).
+     */
+    struct Steep {
+        static constexpr size_t HALF_LENGTH = 12;
+
+        static const float *coefficients() {
+            static const float c[HALF_LENGTH] = {
+                    -1.641752085e-04f, 7.810194337e-04f, -2.141697153e-03f, 4.694795677e-03f,
+                    -9.026420111e-03f, 1.590547625e-02f, -2.640952487e-02f, 4.227439799e-02f,
+                    -6.692341344e-02f, 1.090651766e-01f, -2.007831374e-01f, 6.327275023e-01f
+            };
+            return c;
+        }
+    };
+
+    /**
+     * 15 taps Kaiser windowed half-band (beta = 6), used for the second
+     * stage of the 4x oversampling where the transition band is wider.
+     * At 96kHz -> 192kHz: passband up to 19kHz, stopband from 77kHz (62dB attenuation).
+     */
+    struct Short {
+        static constexpr size_t HALF_LENGTH = 4;
+
+        static const float *coefficients() {
+            static const float c[HALF_LENGTH] = {
+                    -1.351361745e-03f, 2.541250549e-02f, -1.253593729e-01f, 6.012982292e-01f
+            };
+            return c;
+        }
+    };
+}
+
+/**
+ * Polyphase half-band 2x upsampler.
+ *
+ * @tparam FILTER half-band filter definition (see HalfBand)
+ */
+template<typename FILTER>
+class HalfBandUpsampler {
+public:
+    /**
+     * Constructor.
+     */
+    HalfBandUpsampler() { reset(); };
+
+    /**
+     * Upsamples a block of samples.
+     *
+     * @param input input samples
+     * @param output output samples, must hold 2 * length samples
+     * @param length number of input samples
+     */
+    void process(const float *input, float *output, size_t length) {
+        const float *c = FILTER::coefficients();
+        for (size_t i = 0; i < length; i++) {
+            // the history is stored twice to read it without wrapping
+            index = (index == 0) ? TAPS - 1 : index - 1;
+            history[index] = history[index + TAPS] = input[i];
+            const float *x = &history[index]; // x[j] = input[i - j]
+
+            // symmetric FIR phase
+            float even = 0;
+            for (size_t j = 0; j < FILTER::HALF_LENGTH; j++) {
+                even += c[j] * (x[j] + x[TAPS - 1 - j]);
+            }
+            output[2 * i] = even;
+
+            // pure delay phase
+            output[2 * i + 1] = x[FILTER::HALF_LENGTH - 1];
+        }
+    };
+
+    /**
+     * Clears the internal state.
+     */
+    void reset() {
+        history.fill(0);
+        index = 0;
+    };
+
+private:
+    /**
+     * Length of the FIR phase.
+     */
+    static constexpr size_t TAPS = 2 * FILTER::HALF_LENGTH;
+
+    /**
+     * Input history, stored twice.
+     */
+    std::array<float, 2 * TAPS> history;
+
+    /**
+     * Position of the newest sample in history.
+     */
+    size_t index;
+};
+
+/**
+ * Polyphase half-band 2x downsampler.
+ *
+ * @tparam FILTER half-band filter definition (see HalfBand)
+ */
+template<typename FILTER>
+class HalfBandDownsampler {
+public:
+    /**
+     * Constructor.
+     */
+    HalfBandDownsampler() { reset(); };
+
+    /**
+     * Downsamples a block of samples.
+     *
+     * @param input input samples, must hold 2 * length samples
+     * @param output output samples
+     * @param length number of output samples
+     */
+    void process(const float *input, float *output, size_t length) {
+        const float *c = FILTER::coefficients();
+        for (size_t i = 0; i < length; i++) {
+            // the histories are stored twice to read them without wrapping
+            index = (index == 0) ? TAPS - 1 : index - 1;
+            evenHistory[index] = evenHistory[index + TAPS] = input[2 * i];
+            oddHistory[index] = oddHistory[index + TAPS] = input[2 * i + 1];
+            const float *even = &evenHistory[index];
+            const float *odd = &oddHistory[index];
+
+            // symmetric FIR phase
+            float sum = 0;
+            for (size_t j = 0; j < FILTER::HALF_LENGTH; j++) {
+                sum += c[j] * (even[j] + even[TAPS - 1 - j]);
+            }
+
+            // pure delay phase
+            output[i] = 0.5f * (sum + odd[FILTER::HALF_LENGTH]);
+        }
+    };
+
+    /**
+     * Clears the internal state.
+     */
+    void reset() {
+        evenHistory.fill(0);
+        oddHistory.fill(0);
+        index = 0;
+    };
+
+private:
+    /**
+     * Length of the FIR phase.
+     */
+    static constexpr size_t TAPS = 2 * FILTER::HALF_LENGTH;
+
+    /**
+     * History of the even input samples, stored twice.
+     */
+    std::array<float, 2 * TAPS> evenHistory;
+
+    /**
+     * History of the odd input samples, stored twice.
+     */
+    std::array<float, 2 * TAPS> oddHistory;
+
+    /**
+     * Position of the newest sample in the histories.
+     */
+    size_t index;
+};
+
+/**
+ * Runs a function at 2x or 4x the sample rate on a block of samples,
+ * using cascaded half-band filters to upsample and downsample.
+ * This allows to apply nonlinearities limiting the aliasing
+ * they produce, without raising the sample rate of the whole system.
+ *
+ * @tparam FACTOR oversampling factor, 2 or 4
+ * @tparam MAX_BLOCK maximum number of samples processed in a single call
+ */
+template<size_t FACTOR, size_t MAX_BLOCK>
+class Oversampler {
+public:
+    /**
+     * Constructor.
+     */
+    Oversampler() {
+        static_assert(FACTOR == 2 || FACTOR == 4, "The Oversampler FACTOR must be 2 or 4");
+    };
+
+    /**
+     * Processes a block of samples in place.
+     *
+     * @tparam F callable type, float(float)
+     * @param buffer samples to process
+     * @param length number of samples, at most MAX_BLOCK
+     * @param function function applied to each oversampled sample
+     */
+    template<typename F>
+    void process(float *buffer, size_t length, F &function) {
+        if (FACTOR == 2) {
+            firstUpsampler.process(buffer, oversampled.data(), length);
+        } else {
+            firstUpsampler.process(buffer, intermediate.data(), length);
+            secondUpsampler.process(intermediate.data(), oversampled.data(), 2 * length);
+        }
+
+        for (size_t i = 0; i < FACTOR * length; i++) {
+            oversampled[i] = function(oversampled[i]);
+        }
+
+        if (FACTOR == 2) {
+            firstDownsampler.process(oversampled.data(), buffer, length);
+        } else {
+            secondDownsampler.process(oversampled.data(), intermediate.data(), 2 * length);
+            firstDownsampler.process(intermediate.data(), buffer, length);
+        }
+    };
+
+    /**
+     * Clears the internal state.
+     */
+    void reset() {
+        firstUpsampler.reset();
+        firstDownsampler.reset();
+        secondUpsampler.reset();
+        secondDownsampler.reset();
+    };
+
+private:
+    /**
+     * Resamplers between the base rate and 2x.
+     */
+    HalfBandUpsampler<HalfBand::Steep> firstUpsampler;
+    HalfBandDownsampler<HalfBand::Steep> firstDownsampler;
+
+    /**
+     * Resamplers between 2x and 4x, used only when FACTOR is 4.
+     */
+    HalfBandUpsampler<HalfBand::Short> secondUpsampler;
+    HalfBandDownsampler<HalfBand::Short> secondDownsampler;
+
+    /**
+     * Scratch buffer at the oversampled rate.
+     */
+    std::array<float, FACTOR * MAX_BLOCK> oversampled;
+
+    /**
+     * Scratch buffer at 2x, used only when FACTOR is 4.
+     */
+    std::array<float, (FACTOR == 4) ? 2 * MAX_BLOCK : 0> intermediate;
+};
+
+#endif //MIOSIX_DRUM_OVERSAMPLER_H
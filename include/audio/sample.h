@@ -0,0 +1,54 @@
+#ifndef MIOSIX_DRUM_SAMPLE_H
+#define MIOSIX_DRUM_SAMPLE_H
+
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * Encodings of the sample data.
+ */
+enum class SampleFormat {
+    /**
+     * 16 bit signed PCM, one int16_t per sample.
+     */
+    PCM16,
+
+    /**
+     * 4 bit IMA-ADPCM (see ImaAdpcm), two samples per byte.
+     */
+    IMA_ADPCM
+};
+
+/**
+ * Descriptor of a mono sample stored in flash. The data is read in place
+ * by SampleVoice and never copied into RAM. Sample banks are generated
+ * from WAV files by tools/wav2bank.
+ */
+struct Sample {
+    /**
+     * Name of the sample, for the user interface.
+     */
+    const char *name;
+
+    /**
+     * Encoding of data.
+     */
+    SampleFormat format;
+
+    /**
+     * Encoded samples, int16_t for PCM16, uint8_t for IMA_ADPCM.
+     */
+    const void *data;
+
+    /**
+     * Number of samples.
+     */
+    uint32_t length;
+
+    /**
+     * Sample rate of the recording in Hz.
+     */
+    float sampleRate;
+};
+
+#endif //MIOSIX_DRUM_SAMPLE_H
@@ -0,0 +1,217 @@
+#ifndef MIOSIX_DRUM_SAMPLE_VOICE_H
+#define MIOSIX_DRUM_SAMPLE_VOICE_H
+
+#include <cstdint>
+#include <cstddef>
+#include "../config/audio_config.h"
+#include "adpcm.h"
+#include "sample.h"
+
+/**
+ * Interpolation used to read a sample at a different pitch.
+ */
+enum class SampleInterpolation {
+    /**
+     * 2 points linear interpolation.
+     */
+    LINEAR,
+
+    /**
+     * 4 points cubic Hermite (Catmull-Rom) interpolation.
+     */
+    CUBIC
+};
+
+/**
+ * One-shot playback of a Sample, with pitch shifting by resampling.
+ *
+ * The sample is decoded while it is played, reading the data directly
+ * from flash: since a one-shot voice only moves forward, the voice keeps
+ * the 4 samples around the read position and decodes a new one each time
+ * the position crosses an integer index.
+ */
+class SampleVoice {
+public:
+    /**
+     * Lowest playback speed, four octaves down. Lower pitches, including
+     * zero and negative ones, would never reach the end of the sample.
+     */
+    static constexpr float MIN_PITCH = 1.0f / 16;
+
+    /**
+     * Constructor.
+     *
+     * @param sampleRate output sample rate in Hz
+     */
+    SampleVoice(float sampleRate = AUDIO_DRIVER_SAMPLE_RATE) : outputSampleRate(sampleRate),
+                                                               interpolation(SampleInterpolation::CUBIC),
+                                                               sample(nullptr),
+                                                               active(false) {};
+
+    /**
+     * Starts the playback of a sample from its beginning,
+     * interrupting the current one.
+     *
+     * @param newSample sample to play, it must outlive the playback
+     * @param pitch playback speed, 1 plays the sample at its original pitch,
+     *              raised to MIN_PITCH if lower
+     * @param newGain linear gain
+     */
+    void trigger(const Sample &newSample, float pitch = 1.0f, float newGain = 1.0f) {
+        // also catches a NaN pitch
+        if (!(pitch >= MIN_PITCH)) pitch = MIN_PITCH;
+        sample = &newSample;
+        increment = pitch * sample->sampleRate / outputSampleRate;
+        gain = newGain / 32768.0f;
+        decoder.reset();
+        readIndex = 0;
+        position = 0;
+        fraction = 0;
+
+        // history of s[-1], s[0], s[1], s[2]
+        history[0] = 0;
+        history[1] = fetch();
+        history[2] = fetch();
+        history[3] = fetch();
+        active = sample->length > 0;
+    };
+
+    /**
+     * Stops the playback.
+     */
+    inline void stop() { active = false; };
+
+    /**
+     * Indicates if the voice is playing.
+     *
+     * @return boolean flag
+     */
+    inline bool isActive() const { return active; };
+
+    /**
+     * Selects the interpolation used for the next blocks.
+     *
+     * @param newInterpolation interpolation
+     */
+    inline void setInterpolation(SampleInterpolation newInterpolation) { interpolation = newInterpolation; };
+
+    /**
+     * Renders the voice, adding it to the content of the output.
+     *
+     * @param output samples to add the voice to
+     * @param length number of samples
+     * @return number of rendered samples, less than length when the sample ends
+     */
+    size_t process(float *output, size_t length) {
+        if (!active) return 0;
+        if (interpolation == SampleInterpolation::LINEAR) {
+            return render<SampleInterpolation::LINEAR>(output, length);
+        } else {
+            return render<SampleInterpolation::CUBIC>(output, length);
+        }
+    };
+
+private:
+    /**
+     * Renders the voice with the selected interpolation.
+     */
+    template<SampleInterpolation INTERPOLATION>
+    size_t render(float *output, size_t length) {
+        const uint32_t end = sample->length;
+        for (size_t i = 0; i < length; i++) {
+            float y;
+            if (INTERPOLATION == SampleInterpolation::LINEAR) {
+                y = history[1] + fraction * (history[2] - history[1]);
+            } else {
+                float c1 = 0.5f * (history[2] - history[0]);
+                float c2 = history[0] - 2.5f * history[1] + 2.0f * history[2] - 0.5f * history[3];
+                float c3 = 0.5f * (history[3] - history[0]) + 1.5f * (history[1] - history[2]);
+                y = ((c3 * fraction + c2) * fraction + c1) * fraction + history[1];
+            }
+            output[i] += gain * y;
+
+            // moving the read position, decoding the crossed samples
+            fraction += increment;
+            while (fraction >= 1.0f) {
+                fraction -= 1.0f;
+                position++;
+                history[0] = history[1];
+                history[1] = history[2];
+                history[2] = history[3];
+                history[3] = fetch();
+            }
+            if (position >= end) {
+                active = false;
+                return i + 1;
+            }
+        }
+        return length;
+    };
+
+    /**
+     * Decodes the next sample of the stream, zero after its end.
+     */
+    inline float fetch() {
+        if (readIndex >= sample->length) return 0;
+        uint32_t i = readIndex++;
+        if (sample->format == SampleFormat::PCM16) {
+            return static_cast<const int16_t *>(sample->data)[i];
+        } else {
+            uint8_t byte = static_cast<const uint8_t *>(sample->data)[i >> 1];
+            return decoder.decode((i & 1) ? (byte >> 4) : byte);
+        }
+    };
+
+    /**
+     * Output sample rate in Hz.
+     */
+    float outputSampleRate;
+
+    /**
+     * Interpolation in use.
+     */
+    SampleInterpolation interpolation;
+
+    /**
+     * Sample being played.
+     */
+    const Sample *sample;
+
+    /**
+     * Indicates if the voice is playing.
+     */
+    bool active;
+
+    /**
+     * Read position increment for each output sample.
+     */
+    float increment;
+
+    /**
+     * Output gain, including the int16 normalization.
+     */
+    float gain;
+
+    /**
+     * Integer and fractional part of the read position.
+     */
+    uint32_t position;
+    float fraction;
+
+    /**
+     * Index of the next sample to decode.
+     */
+    uint32_t readIndex;
+
+    /**
+     * Samples from position - 1 to position + 2.
+     */
+    float history[4];
+
+    /**
+     * ADPCM decoder state.
+     */
+    ImaAdpcm::State decoder;
+};
+
+#endif //MIOSIX_DRUM_SAMPLE_VOICE_H
@@ -0,0 +1,90 @@
+#ifndef MIOSIX_DRUM_SAMPLER_H
+#define MIOSIX_DRUM_SAMPLER_H
+
+#include <array>
+#include "audio_module.h"
+#include "../config/audio_config.h"
+#include "sample_voice.h"
+
+/**
+ * AudioModule playing one-shot samples on a set of SampleVoices.
+ * The voices are mixed in mono and added to every channel of the
+ * buffer, so the module can be applied after the Faust processor.
+ *
+ * @tparam CHANNEL_NUM number of channels of the processed buffer
+ * @tparam VOICES number of samples that can play at the same time
+ */
+template<size_t CHANNEL_NUM, size_t VOICES>
+class Sampler : public AudioModule<CHANNEL_NUM> {
+public:
+    /**
+     * Constructor. The voices play at AUDIO_DRIVER_SAMPLE_RATE,
+     * since the AudioDriver may not be initialized yet.
+     *
+     * @param audioProcessor AudioProcessor using this module
+     */
+    Sampler(AudioProcessor &audioProcessor) : AudioModule<CHANNEL_NUM>(audioProcessor), nextVoice(0) {};
+
+    /**
+     * Processes the buffer in place.
+     *
+     * @param buffer AudioBuffer to be processed
+     */
+    void process(AudioBuffer<float, CHANNEL_NUM, AUDIO_DRIVER_BUFFER_SIZE> &buffer) override {
+        mix.fill(0);
+        for (auto &voice : voices) {
+            voice.process(mix.data(), AUDIO_DRIVER_BUFFER_SIZE);
+        }
+        for (size_t channel = 0; channel < CHANNEL_NUM; channel++) {
+            float *data = buffer.getWritePointer(channel);
+            for (size_t i = 0; i < AUDIO_DRIVER_BUFFER_SIZE; i++) data[i] += mix[i];
+        }
+    };
+
+    /**
+     * Plays a sample on a free voice, or on the oldest one if all are playing.
+     *
+     * @param sample sample to play
+     * @param pitch playback speed, 1 plays the sample at its original pitch
+     * @param gain linear gain
+     */
+    void trigger(const Sample &sample, float pitch = 1.0f, float gain = 1.0f) {
+        size_t voice = nextVoice;
+        for (size_t i = 0; i < VOICES; i++) {
+            size_t candidate = (nextVoice + i) % VOICES;
+            if (!voices[candidate].isActive()) {
+                voice = candidate;
+                break;
+            }
+        }
+        voices[voice].trigger(sample, pitch, gain);
+        nextVoice = (voice + 1) % VOICES;
+    };
+
+    /**
+     * Selects the interpolation of every voice.
+     *
+     * @param interpolation interpolation
+     */
+    void setInterpolation(SampleInterpolation interpolation) {
+        for (auto &voice : voices) voice.setInterpolation(interpolation);
+    };
+
+private:
+    /**
+     * Voices of the sampler.
+     */
+    std::array<SampleVoice, VOICES> voices;
+
+    /**
+     * Voice used by the next trigger when all the voices are playing.
+     */
+    size_t nextVoice;
+
+    /**
+     * Mono mix of the voices.
+     */
+    std::array<float, AUDIO_DRIVER_BUFFER_SIZE> mix;
+};
+
+#endif //MIOSIX_DRUM_SAMPLER_H
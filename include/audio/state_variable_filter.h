@@ -0,0 +1,241 @@
+#ifndef MIOSIX_DRUM_STATE_VARIABLE_FILTER_H
+#define MIOSIX_DRUM_STATE_VARIABLE_FILTER_H
+
+#include <cmath>
+#include <array>
+#include "audio_buffer.h"
+#include "audio_math.h"
+#include "audio_parameter.h"
+
+/**
+ * Outputs available from the state variable filter.
+ */
+enum class SvfMode {
+    LOWPASS,
+    BANDPASS,
+    HIGHPASS,
+    NOTCH
+};
+
+/**
+ * Coefficients of the trapezoidal state variable filter.
+ */
+struct SvfCoefficients {
+    float k;
+    float a1;
+    float a2;
+    float a3;
+
+    /**
+     * Computes the coefficients of the filter, following
+     * "Linear Trapezoidal Integrated SVF" by Andrew Simper.
+     *
+     * @param frequency cutoff frequency in Hz
+     * @param q quality factor
+     * @param sampleRate sample rate in Hz
+     * @return coefficients of the filter
+     */
+    static SvfCoefficients compute(float frequency, float q, float sampleRate) {
+        float g = std::tan(static_cast<float>(M_PI) * frequency / sampleRate);
+        float k = 1.0f / q;
+        float a1 = 1.0f / (1.0f + g * (g + k));
+        float a2 = g * a1;
+        return {k, a1, a2, g * a2};
+    };
+};
+
+/**
+ * Trapezoidal state variable filter applied to every channel of an
+ * AudioBuffer. Unlike the biquad, its coefficients can be swept at audio
+ * rate without instability, so it is the better choice for modulated
+ * cutoffs. As in BiquadCascade, the coefficients are computed once per
+ * block while the parameters are in transition and interpolated inside it.
+ *
+ * @tparam CHANNEL_NUM number of channels
+ */
+template<size_t CHANNEL_NUM>
+class StateVariableFilter {
+public:
+    /**
+     * Constructor.
+     *
+     * @param sampleRate sample rate in Hz
+     */
+    StateVariableFilter(float sampleRate) : sampleRate(sampleRate),
+                                            mode(SvfMode::LOWPASS),
+                                            frequency(1000.0f),
+                                            q(0.707f),
+                                            dirty(false),
+                                            coefficientUpdates(0) {
+        coefficients = computeCoefficients();
+        reset();
+    };
+
+    /**
+     * Filters a buffer in place.
+     *
+     * @tparam BUFFER_LEN length of the buffer
+     * @param buffer AudioBuffer to be filtered
+     */
+    template<size_t BUFFER_LEN>
+    void processBlock(AudioBuffer<float, CHANNEL_NUM, BUFFER_LEN> &buffer) {
+        SvfCoefficients target = coefficients;
+        if (dirty) {
+            // moving the parameters to the end of the block
+            frequency.updateSampleCount(BUFFER_LEN);
+            q.updateSampleCount(BUFFER_LEN);
+            target = computeCoefficients();
+            dirty = !(frequency.transitionIsComplete() && q.transitionIsComplete());
+        }
+
+        for (size_t channel = 0; channel < CHANNEL_NUM; channel++) {
+            float *data = buffer.getWritePointer(channel);
+            // the output selection is kept out of the sample loop
+            switch (mode) {
+                case SvfMode::LOWPASS:
+                    processChannel<SvfMode::LOWPASS>(data, BUFFER_LEN, states[channel], target);
+                    break;
+                case SvfMode::BANDPASS:
+                    processChannel<SvfMode::BANDPASS>(data, BUFFER_LEN, states[channel], target);
+                    break;
+                case SvfMode::HIGHPASS:
+                    processChannel<SvfMode::HIGHPASS>(data, BUFFER_LEN, states[channel], target);
+                    break;
+                case SvfMode::NOTCH:
+                    processChannel<SvfMode::NOTCH>(data, BUFFER_LEN, states[channel], target);
+                    break;
+            }
+        }
+        coefficients = target;
+    };
+
+    /**
+     * Selects the output of the filter.
+     *
+     * @param newMode output of the filter
+     */
+    void setMode(SvfMode newMode) { mode = newMode; };
+
+    /**
+     * Sets the cutoff frequency.
+     *
+     * @param newFrequency frequency in Hz, clipped below Nyquist
+     */
+    void setFrequency(float newFrequency) {
+        frequency.setValue(AudioMath::clip(newFrequency, 10.0f, 0.49f * sampleRate));
+        dirty = true;
+    };
+
+    /**
+     * Sets the quality factor.
+     *
+     * @param newQ quality factor, clipped between 0.1 and 40
+     */
+    void setQ(float newQ) {
+        q.setValue(AudioMath::clip(newQ, 0.1f, 40.0f));
+        dirty = true;
+    };
+
+    /**
+     * Clears the state of the filter.
+     */
+    void reset() {
+        for (auto &state : states) state = {0, 0};
+    };
+
+    /**
+     * Returns how many times the coefficients have been computed.
+     *
+     * @return number of coefficient computations
+     */
+    inline unsigned int getCoefficientUpdates() const { return coefficientUpdates; };
+
+private:
+    /**
+     * Integrator states of a channel.
+     */
+    struct State {
+        float ic1eq;
+        float ic2eq;
+    };
+
+    /**
+     * Filters a channel, interpolating from the current coefficients to target.
+     */
+    template<SvfMode MODE>
+    void processChannel(float *data, size_t length, State &state, const SvfCoefficients &target) {
+        float step = 1.0f / static_cast<float>(length);
+        SvfCoefficients c = coefficients;
+        SvfCoefficients delta = {(target.k - c.k) * step, (target.a1 - c.a1) * step,
+                                 (target.a2 - c.a2) * step, (target.a3 - c.a3) * step};
+        float ic1eq = state.ic1eq;
+        float ic2eq = state.ic2eq;
+        for (size_t i = 0; i < length; i++) {
+            c.k += delta.k;
+            c.a1 += delta.a1;
+            c.a2 += delta.a2;
+            c.a3 += delta.a3;
+
+            float v0 = data[i];
+            float v3 = v0 - ic2eq;
+            float v1 = c.a1 * ic1eq + c.a2 * v3;
+            float v2 = ic2eq + c.a2 * ic1eq + c.a3 * v3;
+            ic1eq = 2.0f * v1 - ic1eq;
+            ic2eq = 2.0f * v2 - ic2eq;
+
+            if (MODE == SvfMode::LOWPASS) data[i] = v2;
+            else if (MODE == SvfMode::BANDPASS) data[i] = v1;
+            else if (MODE == SvfMode::HIGHPASS) data[i] = v0 - c.k * v1 - v2;
+            else data[i] = v0 - c.k * v1;
+        }
+        state.ic1eq = ic1eq;
+        state.ic2eq = ic2eq;
+    };
+
+    /**
+     * Computes the coefficients from the current
+     * interpolated values of the parameters.
+     */
+    SvfCoefficients computeCoefficients() {
+        coefficientUpdates++;
+        return SvfCoefficients::compute(frequency.getInterpolatedValue(), q.getInterpolatedValue(), sampleRate);
+    };
+
+    /**
+     * Sample rate in Hz.
+     */
+    float sampleRate;
+
+    /**
+     * Selected output.
+     */
+    SvfMode mode;
+
+    /**
+     * Parameters of the filter.
+     */
+    AudioParameter<float> frequency;
+    AudioParameter<float> q;
+
+    /**
+     * Coefficients in use at the end of the last block.
+     */
+    SvfCoefficients coefficients;
+
+    /**
+     * Indicates that some parameter is in transition.
+     */
+    bool dirty;
+
+    /**
+     * Integrator states of each channel.
+     */
+    std::array<State, CHANNEL_NUM> states;
+
+    /**
+     * Number of coefficient computations, for diagnostics.
+     */
+    unsigned int coefficientUpdates;
+};
+
+#endif //MIOSIX_DRUM_STATE_VARIABLE_FILTER_H
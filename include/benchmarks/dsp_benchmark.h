@@ -0,0 +1,17 @@
+#ifndef MIOSIX_DRUM_DSP_BENCHMARK_H
+#define MIOSIX_DRUM_DSP_BENCHMARK_H
+
+/**
+ * On target benchmark of the native audio modules, measured with
+ * the DWT cycle counter. It is enabled by DSP_BENCHMARK_ENABLED in
+ * debug_config.h and prints the results on the serial console.
+ * The same measures on the host are the [benchmark] test cases.
+ */
+namespace DspBenchmark {
+    /**
+     * Runs every measure and prints the results.
+     */
+    void run();
+}
+
+#endif //MIOSIX_DRUM_DSP_BENCHMARK_H
@@ -29,4 +29,25 @@
  */
 #define DAC_MAX_POSITIVE_VALUE 32767
 
+/**
+ * Size in bytes of the static arena used by the Faust
+ * memory manager (DSP instance and static tables).
+ */
+#define FAUST_MEMORY_ARENA_SIZE 2048
+
+/**
+ * Maximum number of Faust parameters stored by the MiosixUI.
+ */
+#define FAUST_UI_MAX_PARAMS 24
+
+/**
+ * Maximum length of a Faust parameter path, including the terminator.
+ */
+#define FAUST_UI_MAX_PATH_LEN 32
+
+/**
+ * Maximum nesting of Faust UI boxes.
+ */
+#define FAUST_UI_MAX_BOX_DEPTH 4
+
 #endif //MIOSIX_AUDIO_AUDIO_CONFIG_H
@@ -0,0 +1,72 @@
+#ifndef MIOSIX_DRUM_DEBUG_CONFIG_H
+#define MIOSIX_DRUM_DEBUG_CONFIG_H
+/**
+ * This header is used to enable the diagnostic
+ * features, which print on the serial console
+ */
+
+/**
+ * When set to 1 the DSP benchmark runs at boot,
+ * before the audio driver is started
+ */
+#define DSP_BENCHMARK_ENABLED 0
+
+/**
+ * When set to 1 the worst interrupt latency, measured
+ * with TIM7 and the DWT cycle counter, is printed every second
+ */
+#define IRQ_LATENCY_PROBE_ENABLED 0
+
+/**
+ * When set to 1 the runs, the missed releases and the
+ * jitter of the BlockScheduler tasks, and the deadline
+ * misses of the audio thread, are printed every second
+ */
+#define SCHEDULER_STATS_ENABLED 0
+
+/**
+ * When set to 1 the CPU load and the stack usage of every
+ * thread are printed every second, WITH_CPU_TIME_COUNTER
+ * must be enabled in miosix_settings.h
+ */
+#define THREAD_STATS_ENABLED 0
+
+/**
+ * Threads shown by the thread statistics
+ */
+#define THREAD_STATS_MAX_THREADS 10
+
+/**
+ * When set to 1 the highest stack usage of the threads
+ * started by main is printed every second, to size their
+ * stacks in thread_stacks.h
+ */
+#define STACK_REPORT_ENABLED 0
+
+/**
+ * When set to 1 any operator new or malloc after the start
+ * of the audio driver prints its size and caller and stops
+ * the system, to find the allocations left in the run time
+ */
+#define HEAP_GUARD_ENABLED 0
+
+/**
+ * Threads allowed to call malloc with the heap guard armed,
+ * the diagnostic threads printing with newlib
+ */
+#define HEAP_GUARD_MAX_ALLOWED_THREADS 8
+
+/**
+ * When set to 1 the trace of the interrupts and of the
+ * critical sections is printed every IRQ_TRACE_DUMP_PERIOD
+ * seconds, to be read by tools/irqtrace, WITH_IRQ_TRACE
+ * must be enabled in miosix_settings.h
+ */
+#define IRQ_TRACE_ENABLED 0
+
+/**
+ * Seconds between two prints of the interrupt trace
+ */
+#define IRQ_TRACE_DUMP_PERIOD 10
+
+#endif //MIOSIX_DRUM_DEBUG_CONFIG_H
@@ -8,7 +8,8 @@
  */
 
 /**
- * Number of samples to be averaged by the ADC to stabilize the read value.
+ * Number of conversions of each slider kept in the circular DMA buffer
+ * of the AdcScanner, averaged on read to stabilize the value.
  */
 #define ADC_AVG_SAMPLES (8)
 
@@ -22,6 +23,46 @@
  */
 #define ADC_RESOLUTION (1)
 
+/**
+ * Minimum change of a slider, between 0 and 1, sent to the synth.
+ * Smaller changes are considered noise of the ADC.
+ */
+#define SLIDER_CHANGE_THRESHOLD (2.0f / 1024.0f)
+
+/**
+ * Distance, between 0 and 1, within which a held slider picks up
+ * the value of its parameter and starts sending its position.
+ */
+#define SLIDER_PICKUP_WINDOW (0.02f)
+
+/**
+ * Timer counts generated by a detent of the encoders,
+ * 4 for encoders with a full quadrature cycle per detent
+ */
+#define ENCODER_COUNTS_PER_DETENT (4)
+
+/**
+ * Time in ms without edges after which the contacts of
+ * a button are considered stable
+ */
+#define BUTTON_DEBOUNCE_TIME (5)
+
+/**
+ * Time in ms after which a button held down generates a long press
+ */
+#define BUTTON_LONG_PRESS_TIME (600)
+
+/**
+ * Button events queue size, a power of two
+ */
+#define BUTTON_EVENT_QUEUE_SIZE (16)
+
+/**
+ * Rows and columns of the HD44780 LCD
+ */
+#define LCD_ROWS (2)
+#define LCD_COLS (16)
+
 /**
  * For STM32F407VG
  * (1): USART1: tx=PA9  rx=PA10 cts=PA11 rts=PA12
@@ -27,27 +27,17 @@
 
 /**
  * ENCODERS
+ * The encoders edit, four per page, the Faust parameters not mapped to the
+ * sliders, the buttons and the gate; their labels, units and ranges come
+ * from the Faust UI and are shown on the LCD.
+ * The curve is an EncoderCurve: {steps, acceleration, exponent, maxGain}.
+ * Turning slowly, "steps" detents sweep the whole range; turning faster
+ * the step is multiplied by min(1 + acceleration * (detents/s) ^ exponent, maxGain).
  */
-
-#define ENCODER1_NAME "/faust_synth/freq"
-#define ENCODER1_MIN 20.0f
-#define ENCODER1_MAX 200.0f
-#define ENCODER1_LCD_NAME "FRQ"
-
-#define ENCODER2_NAME "/faust_synth/ratio"
-#define ENCODER2_MIN 0.0f
-#define ENCODER2_MAX 20.0f
-#define ENCODER2_LCD_NAME "MOD"
-
-#define ENCODER3_NAME "/faust_synth/distortion"
-#define ENCODER3_MIN 0.0f
-#define ENCODER3_MAX 100.0f
-#define ENCODER3_LCD_NAME "FZZ"
-
-#define ENCODER4_NAME "/faust_synth/gain"
-#define ENCODER4_MIN 0.0f
-#define ENCODER4_MAX +96.0f
-#define ENCODER4_LCD_NAME "GAN"
+#define ENCODER1_CURVE {100.0f, 0.02f, 2.0f, 10.0f}
+#define ENCODER2_CURVE {100.0f, 0.02f, 2.0f, 10.0f}
+#define ENCODER3_CURVE {100.0f, 0.02f, 2.0f, 10.0f}
+#define ENCODER4_CURVE {100.0f, 0.02f, 2.0f, 10.0f}
 
 /**
  * Buttons
@@ -57,4 +47,12 @@
 #define BUTTON3_NAME ""
 #define BUTTON4_NAME ""
 
+/**
+ * LCD MENU
+ * Buttons (1 to 4) showing the previous and the next page of parameters,
+ * they are not sent to the synth. 0 disables the button.
+ */
+#define MENU_PREVIOUS_BUTTON 3
+#define MENU_NEXT_BUTTON 4
+
 #endif //MIOSIX_DRUM_PARAMETER_CONFIG_H
@@ -0,0 +1,41 @@
+#ifndef MIOSIX_DRUM_THREAD_PRIORITIES_H
+#define MIOSIX_DRUM_THREAD_PRIORITIES_H
+
+/**
+ * This header is used to modify the urgency of the threads.
+ * With SCHED_TYPE_PRIORITY these are fixed priorities, from
+ * 0 to PRIORITY_MAX-1. With SCHED_TYPE_EDF the audio thread
+ * and the MIDI processing thread are due within a number of
+ * audio blocks from each release, and the priorities only
+ * order the other threads, which run when no deadline is pending
+ */
+
+/**
+ * Audio thread, writing the next block of the DMA
+ */
+#define AUDIO_THREAD_PRIORITY 3
+
+/**
+ * UI thread, handling the controls and refreshing the LCD
+ */
+#define UI_THREAD_PRIORITY 2
+
+/**
+ * MIDI parsing and processing threads
+ */
+#define MIDI_THREAD_PRIORITY 1
+
+/**
+ * Threads printing the diagnostics on the serial console
+ */
+#define REPORT_THREAD_PRIORITY 1
+
+/**
+ * Deadline of the audio thread, in audio blocks from the end of
+ * the DMA transfer releasing it: with the double buffer, the next
+ * block is due before the DMA ends the one it has just started.
+ * The MIDI processing thread is due within its period
+ */
+#define AUDIO_DEADLINE_BLOCKS 1
+
+#endif //MIOSIX_DRUM_THREAD_PRIORITIES_H
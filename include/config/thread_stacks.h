@@ -0,0 +1,32 @@
+#ifndef MIOSIX_DRUM_THREAD_STACKS_H
+#define MIOSIX_DRUM_THREAD_STACKS_H
+
+/**
+ * This header is used to modify the stack size, in bytes, of the
+ * threads started by main, which are statically allocated in the
+ * .threadstacks section. The highest usage of each stack is printed
+ * with STACK_REPORT_ENABLED in debug_config.h.
+ * The sizes must be at least STACK_MIN and divisible by 4
+ */
+
+/**
+ * UI thread, handling the controls and refreshing the LCD
+ */
+#define UI_THREAD_STACK_SIZE 2048
+
+/**
+ * MIDI parsing thread, reading the serial port
+ */
+#define MIDI_PARSING_THREAD_STACK_SIZE 1024
+
+/**
+ * MIDI processing thread, triggering the synth
+ */
+#define MIDI_PROCESSING_THREAD_STACK_SIZE 1024
+
+/**
+ * Threads printing the diagnostics, printf needs a large stack
+ */
+#define REPORT_THREAD_STACK_SIZE 2048
+
+#endif //MIOSIX_DRUM_THREAD_STACKS_H
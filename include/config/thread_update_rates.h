@@ -2,17 +2,23 @@
 #define MIOSIX_DRUM_THREAD_UPDATE_RATES_H
 /**
  * This header is used to modify the rate of refresh
- * of each hardware thread in ms
+ * of each periodic task, in audio blocks of AUDIO_DRIVER_BUFFER_SIZE
+ * samples (2.67ms at 48kHz): the tasks are released by the
+ * BlockScheduler at the end of the blocks, so they never drift
+ * from the audio
  */
 
-#define SLIDER_SLEEP_TIME 200
-
-#define ENCODER_SLEEP_TIME 20
-
-#define BUTTON_SLEEP_TIME 10
-
-#define LCD_SLEEP_TIME 250
+/**
+ * Period of the control scan sampling
+ * the sliders, the encoders and the buttons
+ */
+#define CONTROL_SCAN_BLOCKS 2
 
-#define MIDI_SLEEP_TIME 10
+/**
+ * Period of the MIDI processing thread, released
+ * one block after the control scan
+ */
+#define MIDI_PROCESSING_BLOCKS 2
+#define MIDI_PROCESSING_PHASE 1
 
 #endif //MIOSIX_DRUM_THREAD_UPDATE_RATES_H
@@ -0,0 +1,87 @@
+#ifndef MIOSIX_DRUM_MEMORY_POOL_H
+#define MIOSIX_DRUM_MEMORY_POOL_H
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Alignment of the blocks served by the arenas, enough for
+ * any type of the target, double and long long included.
+ */
+static constexpr size_t MEMORY_POOL_ALIGNMENT = 8;
+
+/**
+ * Monotonic arena stored inside the object. The allocations are served
+ * linearly and they are freed all together by reset(), which makes them
+ * constant time and deterministic. It suits the objects built once at
+ * init and kept for the whole run, and the scratch memory of a
+ * computation that is thrown away at its end.
+ *
+ * @tparam SIZE arena size in bytes
+ */
+template<size_t SIZE>
+class MonotonicArena {
+public:
+    /**
+     * Constructor.
+     */
+    MonotonicArena() : used(0) {};
+
+    /**
+     * Allocates a block from the arena.
+     *
+     * @param size size in bytes of the block
+     * @param alignment alignment of the block, a power of two
+     * @return pointer to the block, nullptr if the arena is exhausted
+     */
+    void *allocate(size_t size, size_t alignment = MEMORY_POOL_ALIGNMENT) {
+        uintptr_t base = reinterpret_cast<uintptr_t>(arena);
+        uintptr_t start = (base + used + alignment - 1) & ~static_cast<uintptr_t>(alignment - 1);
+        if (start - base > SIZE || size > SIZE - (start - base)) return nullptr;
+        used = start - base + size;
+        return reinterpret_cast<void *>(start);
+    };
+
+    /**
+     * The blocks are never freed one by one, use reset() to
+     * release the whole arena.
+     */
+    inline void deallocate(void * /*ptr*/, size_t /*size*/ = 0) {};
+
+    /**
+     * Releases the whole arena, every block previously allocated
+     * becomes invalid.
+     */
+    inline void reset() { used = 0; };
+
+    /**
+     * Returns the number of bytes currently allocated.
+     *
+     * @return used bytes
+     */
+    inline size_t getUsedBytes() const { return used; };
+
+    /**
+     * Returns the arena size.
+     *
+     * @return arena size in bytes
+     */
+    static constexpr size_t getSize() { return SIZE; };
+
+private:
+    MonotonicArena(const MonotonicArena &) = delete;
+
+    MonotonicArena &operator=(const MonotonicArena &) = delete;
+
+    /**
+     * Memory served by the arena.
+     */
+    alignas(MEMORY_POOL_ALIGNMENT) uint8_t arena[SIZE];
+
+    /**
+     * Number of bytes already allocated, padding included.
+     */
+    size_t used;
+};
+
+#endif //MIOSIX_DRUM_MEMORY_POOL_H
@@ -0,0 +1,90 @@
+#ifndef MIOSIX_DRUM_PARAMETER_MAILBOX_H
+#define MIOSIX_DRUM_PARAMETER_MAILBOX_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Mailbox carrying parameter values from the control surface to the audio
+ * thread. Each parameter has its own slot holding the latest posted value
+ * and a pending bit: posting a value overwrites the slot, so a parameter
+ * changed many times between two audio blocks is applied only once,
+ * with its last value.
+ *
+ * It is lock free for a single consumer and any number of producers,
+ * threads or interrupts, as long as each slot has a single writer: the
+ * value is stored before setting the pending bit with an atomic or, so
+ * posts to distinct slots never interfere, and the consumer atomically
+ * takes all the pending bits before reading the values. A value posted
+ * while the consumer is reading may be applied twice, never lost.
+ * If two producers that can preempt each other post to the same slot,
+ * the value is never torn, but the one kept is the last stored rather
+ * than the last posted.
+ *
+ * @tparam SIZE number of parameters, at most 32
+ */
+template<size_t SIZE>
+class ParameterMailbox {
+public:
+    static_assert(SIZE > 0 && SIZE <= 32, "The pending parameters are stored in a 32 bit mask");
+
+    /**
+     * Constructor.
+     */
+    ParameterMailbox() : pending(0) {
+        for (size_t i = 0; i < SIZE; i++) values[i] = 0;
+    };
+
+    /**
+     * Posts the new value of a parameter, the slot must not be written
+     * concurrently by another producer.
+     *
+     * @param index index of the parameter
+     * @param value new value
+     */
+    inline void post(size_t index, float value) {
+        values[index] = value;
+        pending.fetch_or(1u << index, std::memory_order_release);
+    };
+
+    /**
+     * Applies the pending values, in order of index.
+     *
+     * @tparam F callable with signature void(size_t index, float value)
+     * @param apply function applying a value
+     * @return number of applied values
+     */
+    template<typename F>
+    inline size_t drain(F apply) {
+        uint32_t mask = pending.exchange(0, std::memory_order_acquire);
+        size_t applied = 0;
+        for (size_t i = 0; mask != 0; i++, mask >>= 1) {
+            if (mask & 1) {
+                apply(i, values[i]);
+                applied++;
+            }
+        }
+        return applied;
+    };
+
+    /**
+     * Checks if any value is waiting to be applied.
+     *
+     * @return true if at least a parameter is pending
+     */
+    inline bool isPending() const { return pending.load(std::memory_order_relaxed) != 0; };
+
+private:
+    /**
+     * Last posted value of each parameter.
+     */
+    volatile float values[SIZE];
+
+    /**
+     * Bit mask of the parameters posted and not applied yet.
+     */
+    std::atomic<uint32_t> pending;
+};
+
+#endif //MIOSIX_DRUM_PARAMETER_MAILBOX_H
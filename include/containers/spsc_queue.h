@@ -0,0 +1,83 @@
+#ifndef MIOSIX_DRUM_SPSC_QUEUE_H
+#define MIOSIX_DRUM_SPSC_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+
+/**
+ * Fixed size lock free queue for a single producer and a single consumer,
+ * e.g. an interrupt handler and a thread. The producer only writes the
+ * tail and the consumer only writes the head, so neither side has to
+ * disable the interrupts. Producers running in interrupts of the same
+ * priority never preempt each other and count as a single producer.
+ *
+ * @tparam T type of the elements, copied in and out of the queue
+ * @tparam SIZE number of slots, a power of two; SIZE - 1 elements can be stored
+ */
+template<typename T, size_t SIZE>
+class SpscQueue {
+public:
+    static_assert(SIZE >= 2 && (SIZE & (SIZE - 1)) == 0, "The size must be a power of two");
+
+    /**
+     * Constructor.
+     */
+    SpscQueue() : head(0), tail(0) {};
+
+    /**
+     * Adds an element, called by the producer.
+     *
+     * @param element element to add
+     * @return false if the queue is full and the element has been discarded
+     */
+    inline bool push(const T &element) {
+        size_t currentTail = tail.load(std::memory_order_relaxed);
+        size_t nextTail = (currentTail + 1) & (SIZE - 1);
+        if (nextTail == head.load(std::memory_order_acquire)) return false;
+        elements[currentTail] = element;
+        tail.store(nextTail, std::memory_order_release);
+        return true;
+    };
+
+    /**
+     * Removes the oldest element, called by the consumer.
+     *
+     * @param element where the element is copied
+     * @return false if the queue is empty
+     */
+    inline bool pop(T &element) {
+        size_t currentHead = head.load(std::memory_order_relaxed);
+        if (currentHead == tail.load(std::memory_order_acquire)) return false;
+        element = elements[currentHead];
+        head.store((currentHead + 1) & (SIZE - 1), std::memory_order_release);
+        return true;
+    };
+
+    /**
+     * Checks if the queue is empty, the result is only a hint
+     * when called concurrently with push() or pop().
+     *
+     * @return true if there are no elements
+     */
+    inline bool isEmpty() const {
+        return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire);
+    };
+
+private:
+    /**
+     * Storage of the elements.
+     */
+    T elements[SIZE];
+
+    /**
+     * Index of the oldest element, written by the consumer.
+     */
+    std::atomic<size_t> head;
+
+    /**
+     * Index of the next free slot, written by the producer.
+     */
+    std::atomic<size_t> tail;
+};
+
+#endif //MIOSIX_DRUM_SPSC_QUEUE_H
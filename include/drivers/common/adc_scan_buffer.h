@@ -0,0 +1,72 @@
+#ifndef MIOSIX_DRUM_ADC_SCAN_BUFFER_H
+#define MIOSIX_DRUM_ADC_SCAN_BUFFER_H
+
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * Circular buffer filled by a DMA stream with the results of an ADC
+ * in continuous scan mode. Each scan converts CHANNELS inputs in sequence
+ * and the DMA writes them one after the other, wrapping around after
+ * DEPTH scans, so the buffer always holds the last DEPTH conversions of
+ * every channel, interleaved:
+ *
+ * [ch0 ch1 ... chN-1] [ch0 ch1 ... chN-1] ... (DEPTH times)
+ *
+ * The averaging is done in software when a channel is read, without
+ * stopping the DMA: every entry is a complete 16 bit conversion, so at any
+ * time the buffer contains DEPTH valid recent samples for each channel.
+ * This class does not depend on the hardware and can be tested on the host.
+ *
+ * @tparam CHANNELS number of channels of the scan sequence
+ * @tparam DEPTH number of conversions of each channel kept in the buffer
+ */
+template<size_t CHANNELS, size_t DEPTH>
+class AdcScanBuffer {
+public:
+    /**
+     * Constructor.
+     */
+    AdcScanBuffer() { clear(); };
+
+    /**
+     * Average of the last DEPTH conversions of a channel.
+     *
+     * @param channel position of the channel in the scan sequence
+     * @return average value, in ADC units
+     */
+    inline float average(size_t channel) const {
+        uint32_t sum = 0;
+        for (size_t i = 0; i < DEPTH; i++) {
+            sum += samples[i * CHANNELS + channel];
+        }
+        return static_cast<float>(sum) / static_cast<float>(DEPTH);
+    };
+
+    /**
+     * Sets every entry to zero.
+     */
+    inline void clear() {
+        for (size_t i = 0; i < SIZE; i++) samples[i] = 0;
+    };
+
+    /**
+     * Destination address of the DMA transfers.
+     *
+     * @return pointer to the first entry
+     */
+    inline volatile uint16_t *data() { return samples; };
+
+    /**
+     * Number of entries, the number of transfers of a DMA cycle.
+     */
+    static constexpr size_t SIZE = CHANNELS * DEPTH;
+
+private:
+    /**
+     * Conversions, written by the DMA.
+     */
+    volatile uint16_t samples[SIZE];
+};
+
+#endif //MIOSIX_DRUM_ADC_SCAN_BUFFER_H
@@ -2,7 +2,7 @@
 #ifndef MIOSIX_AUDIO_DRIVER_AUDIO_H
 #define MIOSIX_AUDIO_DRIVER_AUDIO_H
 
-#include "../../../miosix/miosix.h"
+#include <cstdint>
 #include "../../config/audio_config.h"
 #include "../../audio/audio_processable.h"
 #include "../../audio/audio_buffer.h"
@@ -52,6 +52,23 @@ public:
         audioProcessable = &newAudioProcessable;
     }
 
+    /**
+     * Sets a function called by the DMA interrupt at the end of each
+     * block, e.g. to clock the control tasks with the audio.
+     * It runs in interrupt context and it must not wake up threads.
+     *
+     * @param listener function called at each block, nullptr to remove it
+     */
+    void setBlockListener(void (*listener)());
+
+    /**
+     * Number of blocks in which the audio thread was late, and the DMA
+     * played a block of silence instead.
+     *
+     * @return deadline misses since the driver was started
+     */
+    uint32_t getDeadlineMisses() const;
+
     /**
      * Getter method for AudioBuffer.
      *
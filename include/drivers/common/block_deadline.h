@@ -0,0 +1,62 @@
+#ifndef MIOSIX_DRUM_BLOCK_DEADLINE_H
+#define MIOSIX_DRUM_BLOCK_DEADLINE_H
+
+#include <limits>
+
+/**
+ * Deadlines, in kernel ticks, of the threads run by the EDF scheduler.
+ *
+ * A thread released at the end of an audio block, by the I2S DMA interrupt
+ * or by the BlockScheduler, is due within a number of blocks: its absolute
+ * deadline is the tick of the release plus the duration of those blocks,
+ * rounded down, since the release happens anywhere between two ticks and
+ * the earlier deadline is met whenever the exact one is.
+ * The other threads have background deadlines, after every block deadline
+ * and before the one of the idle thread, in the order of their priorities.
+ * This class does not depend on the hardware and can be tested on the host.
+ *
+ * @tparam BLOCK_SIZE samples in an audio block
+ * @tparam SAMPLE_RATE sample rate, in Hz
+ * @tparam TICK_FREQ frequency of the kernel tick, in Hz
+ */
+template<unsigned int BLOCK_SIZE, unsigned int SAMPLE_RATE, unsigned int TICK_FREQ>
+class BlockDeadline {
+public:
+    /**
+     * Deadline of a thread from its release.
+     *
+     * @param blocks audio blocks within which the thread is due
+     * @return relative deadline, in ticks
+     */
+    static constexpr long long relative(unsigned int blocks) {
+        return static_cast<long long>(blocks) * BLOCK_SIZE * TICK_FREQ / SAMPLE_RATE;
+    };
+
+    /**
+     * Deadline of a thread released at a tick.
+     *
+     * @param releaseTick kernel tick at the release
+     * @param blocks audio blocks within which the thread is due
+     * @return absolute deadline, in ticks
+     */
+    static constexpr long long absolute(long long releaseTick, unsigned int blocks) {
+        return releaseTick + relative(blocks);
+    };
+
+    /**
+     * Deadline of a thread not released by the audio blocks, which runs
+     * only when no block deadline is pending.
+     *
+     * @param priority priority among the background threads, higher values
+     *                 run first
+     * @return absolute deadline, never reached by the kernel tick
+     */
+    static constexpr long long background(int priority) {
+        // max() is a thread that never runs, max() - 1 the idle thread
+        return std::numeric_limits<long long>::max() - 2 - priority;
+    };
+
+    BlockDeadline() = delete;
+};
+
+#endif //MIOSIX_DRUM_BLOCK_DEADLINE_H
@@ -0,0 +1,67 @@
+#ifndef MIOSIX_DRUM_CHANGE_DETECTOR_H
+#define MIOSIX_DRUM_CHANGE_DETECTOR_H
+
+/**
+ * Reports when a sampled control value changes, so that only the changed
+ * values are sent to the audio thread. A value is reported when it differs
+ * from the last reported one by more than a threshold, which keeps the
+ * noise of an analog input from being sent as a stream of changes.
+ * The first sample is always reported.
+ * This class does not depend on the hardware and can be tested on the host.
+ *
+ * @tparam T type of the value
+ */
+template<typename T>
+class ChangeDetector {
+public:
+    /**
+     * Constructor.
+     *
+     * @param threshold minimum difference reported as a change, zero reports any change
+     */
+    explicit ChangeDetector(T threshold = T()) : threshold(threshold), last(), valid(false) {};
+
+    /**
+     * Processes a new sample.
+     *
+     * @param value sampled value
+     * @return true if the value has to be reported
+     */
+    inline bool update(T value) {
+        T difference = (value > last) ? value - last : last - value;
+        if (valid && !(difference > threshold)) return false;
+        last = value;
+        valid = true;
+        return true;
+    };
+
+    /**
+     * Last reported value.
+     *
+     * @return value
+     */
+    inline T getValue() const { return last; };
+
+    /**
+     * Forgets the last reported value, the next sample is reported.
+     */
+    inline void reset() { valid = false; };
+
+private:
+    /**
+     * Minimum difference reported as a change.
+     */
+    T threshold;
+
+    /**
+     * Last reported value.
+     */
+    T last;
+
+    /**
+     * False until the first sample is reported.
+     */
+    bool valid;
+};
+
+#endif //MIOSIX_DRUM_CHANGE_DETECTOR_H
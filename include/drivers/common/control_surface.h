@@ -0,0 +1,319 @@
+#ifndef MIOSIX_DRUM_CONTROL_SURFACE_H
+#define MIOSIX_DRUM_CONTROL_SURFACE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include "../../config/audio_config.h"
+#include "../../config/hw_config.h"
+#include "../../config/parameter_config.h"
+#include "../../config/thread_update_rates.h"
+#include "change_detector.h"
+#include "debouncer.h"
+#include "encoder_acceleration.h"
+#include "parameter_menu.h"
+#include "soft_takeover.h"
+
+/**
+ * Control surface of the synth: the four sliders, sent to their mapped
+ * parameters, and the four encoders, editing the other parameters through
+ * the LCD menu.
+ *
+ * IRQscan() is the control scan, called by an interrupt every
+ * CONTROL_SCAN_BLOCKS audio blocks. It samples the sliders, posting only the
+ * changed values to the synth once they have picked up the values of the
+ * synth, and the encoders, whose counts go through their velocity curves and
+ * are handed to the UI thread, which edits the menu and refreshes the LCD.
+ * The work of the UI thread is posted to its event queue, at most one event
+ * of each kind waiting at a time, and the encoder increments are exchanged
+ * with atomics, so neither side masks the interrupts.
+ *
+ * The drivers are template parameters, so the firmware and the host latency
+ * simulation run this same code on the real registers and on the fake ones.
+ *
+ * @tparam SYNTH synthesizer, with the slider and parameter interface of FaustAudioProcessor
+ * @tparam SLIDERS AdcScanner of the four sliders
+ * @tparam ENCODER1 first encoder
+ * @tparam ENCODER2 second encoder
+ * @tparam ENCODER3 third encoder
+ * @tparam ENCODER4 fourth encoder
+ * @tparam DISPLAY LCD, a static class with init(), frame() and update()
+ * @tparam QUEUE event queue of the UI thread, with IRQpost(event, woken)
+ */
+template<typename SYNTH, typename SLIDERS, typename ENCODER1, typename ENCODER2, typename ENCODER3,
+        typename ENCODER4, typename DISPLAY, typename QUEUE>
+class ControlSurface {
+public:
+    /**
+     * Menu of the parameters edited by the encoders, four per page.
+     */
+    typedef ParameterMenu<FAUST_UI_MAX_PARAMS, 4> Menu;
+
+    /**
+     * Period of the control scan in seconds.
+     */
+    static constexpr float SCAN_PERIOD =
+            CONTROL_SCAN_BLOCKS * AUDIO_DRIVER_BUFFER_SIZE / static_cast<float>(AUDIO_DRIVER_SAMPLE_RATE);
+
+    /**
+     * Constructor, the controls are initialized by init().
+     *
+     * @param synth synthesizer receiving the controls
+     * @param events event queue run by the UI thread
+     */
+    ControlSurface(SYNTH &synth, QUEUE &events)
+            : synth(synth), events(events), encoderEventsPending(false), pickupPending(false), heldSlider(0),
+              lcdRefreshPending(false),
+              sliderChange{ChangeDetector<float>(SLIDER_CHANGE_THRESHOLD), ChangeDetector<float>(SLIDER_CHANGE_THRESHOLD),
+                           ChangeDetector<float>(SLIDER_CHANGE_THRESHOLD), ChangeDetector<float>(SLIDER_CHANGE_THRESHOLD)},
+              sliderTakeover{SoftTakeover(SLIDER_PICKUP_WINDOW), SoftTakeover(SLIDER_PICKUP_WINDOW),
+                             SoftTakeover(SLIDER_PICKUP_WINDOW), SoftTakeover(SLIDER_PICKUP_WINDOW)},
+              encoderAcceleration{EncoderAcceleration(ENCODER1_CURVE, ENCODER_COUNTS_PER_DETENT),
+                                  EncoderAcceleration(ENCODER2_CURVE, ENCODER_COUNTS_PER_DETENT),
+                                  EncoderAcceleration(ENCODER3_CURVE, ENCODER_COUNTS_PER_DETENT),
+                                  EncoderAcceleration(ENCODER4_CURVE, ENCODER_COUNTS_PER_DETENT)} {
+        for (int i = 0; i < 4; i++) encoderIncrement[i].store(0.0f);
+    };
+
+    /**
+     * Initialization, run by the UI thread before the control scan starts:
+     * builds the menu of the parameters without a physical control, draws
+     * its first page, starts the sliders and the encoders and holds the
+     * sliders on the values of the synth.
+     */
+    void init() {
+        const auto &ui = synth.getUI();
+        for (int i = 0; i < ui.getParamsCount(); i++) {
+            if (synth.isMapped(i)) continue;
+            const auto &parameter = ui.getParameter(i);
+            menu.add(i, parameter.label, parameter.unit, parameter.min, parameter.max, parameter.init, parameter.step);
+        }
+
+        // LCD Initialization, then the first page is drawn
+        DISPLAY::init();
+        lcdRefresh();
+
+        // Sliders Initialization, starts the continuous DMA scan
+        SLIDERS::init();
+
+        // Encoders Initialization
+        ENCODER1::init();
+        ENCODER2::init();
+        ENCODER3::init();
+        ENCODER4::init();
+
+        // The sliders start from the values of the synth
+        holdSliders();
+    };
+
+    /**
+     * Control scan, called by an interrupt every CONTROL_SCAN_BLOCKS audio blocks.
+     *
+     * @return true if the UI thread has been woken up
+     */
+    bool IRQscan() {
+        bool woken = false;
+        for (int i = 0; i < 4; i++) {
+            float position = SLIDERS::read(i);
+            if (sliderChange[i].update(position)) woken |= applySlider(i, position);
+        }
+
+        const int16_t counts[4] = {ENCODER1::getCountIncrement(), ENCODER2::getCountIncrement(),
+                                   ENCODER3::getCountIncrement(), ENCODER4::getCountIncrement()};
+        bool encoderMoved = false;
+        for (int i = 0; i < 4; i++) {
+            float increment = encoderAcceleration[i].update(counts[i], SCAN_PERIOD);
+            if (increment != 0) {
+                float pending = encoderIncrement[i].load();
+                while (!encoderIncrement[i].compare_exchange_weak(pending, pending + increment));
+                encoderMoved = true;
+            }
+        }
+
+        if (encoderMoved && !encoderEventsPending) {
+            bool encoderWoken = false;
+            encoderEventsPending = events.IRQpost([this]() { handleEncoders(); }, encoderWoken);
+            woken |= encoderWoken;
+        }
+        return woken;
+    };
+
+    /**
+     * Button event handling, run by the UI thread: the menu buttons change
+     * page on press, the others are sent to the synth.
+     *
+     * @param event debounced event of a button
+     */
+    void handleButton(const ButtonEvent &event) {
+        // the long presses are not mapped to the synth
+        if (event.type == ButtonEvent::LONG_PRESS) return;
+
+        if (event.button + 1 == MENU_PREVIOUS_BUTTON || event.button + 1 == MENU_NEXT_BUTTON) {
+            if (event.type != ButtonEvent::PRESS) return;
+            if (event.button + 1 == MENU_NEXT_BUTTON) menu.nextPage();
+            else menu.previousPage();
+            lcdRefresh();
+            return;
+        }
+
+        bool pressed = (event.type == ButtonEvent::PRESS);
+        switch (event.button) {
+            case 0: synth.setButton1(pressed); break;
+            case 1: synth.setButton2(pressed); break;
+            case 2: synth.setButton3(pressed); break;
+            case 3: synth.setButton4(pressed); break;
+        }
+    };
+
+    /**
+     * Holds each slider on the value of its parameter in the synth, until the
+     * slider reaches it. Called with the control scan stopped, e.g. before a
+     * preset is recalled, since the takeover state is shared with the scan.
+     */
+    void holdSliders() {
+        const auto &ui = synth.getUI();
+        for (int i = 0; i < 4; i++) {
+            int index = synth.getSliderParameter(i);
+            if (index < 0) continue;
+            sliderTakeover[i].hold(synth.getSliderPosition(i, ui.getParamValue(index)));
+        }
+    };
+
+    /**
+     * LCD update, run by the UI thread: draws the menu page into the frame,
+     * whose changed characters are sent by the display interrupt.
+     */
+    void lcdRefresh() {
+        lcdRefreshPending = false;
+        menu.render(DISPLAY::frame());
+        DISPLAY::update();
+    };
+
+    /**
+     * Menu of the parameters, only used by the UI thread.
+     *
+     * @return menu
+     */
+    inline Menu &getMenu() { return menu; };
+
+    /**
+     * The copy constructor is disabled.
+     */
+    ControlSurface(const ControlSurface &) = delete;
+
+    /**
+     * The assignment operator is disabled.
+     */
+    ControlSurface &operator=(const ControlSurface &) = delete;
+
+private:
+    /**
+     * Applies a new position of a slider, unless it is held.
+     *
+     * @param slider slider, from 0
+     * @param position slider position between 0 and 1
+     * @return true if the UI thread has been woken up
+     */
+    bool applySlider(int slider, float position) {
+        bool woken = false;
+        switch (sliderTakeover[slider].update(position)) {
+            case SoftTakeover::HELD:
+                // showing where the slider has to go
+                heldSlider = slider;
+                if (!pickupPending) pickupPending = events.IRQpost([this]() { showPickup(); }, woken);
+                return woken;
+            case SoftTakeover::PICKUP:
+                // the menu replaces the indication
+                if (!lcdRefreshPending) lcdRefreshPending = events.IRQpost([this]() { lcdRefresh(); }, woken);
+                break;
+            case SoftTakeover::APPLY:
+                break;
+        }
+        switch (slider) {
+            case 0: synth.setSlider1(position); break;
+            case 1: synth.setSlider2(position); break;
+            case 2: synth.setSlider3(position); break;
+            case 3: synth.setSlider4(position); break;
+        }
+        return woken;
+    };
+
+    /**
+     * Encoders handling, run by the UI thread: moves the parameters
+     * of the menu page and sends the changed ones to the synth.
+     */
+    void handleEncoders() {
+        encoderEventsPending = false;
+        bool changed = false;
+        for (int i = 0; i < 4; i++) {
+            float increment = encoderIncrement[i].exchange(0.0f);
+            if (increment != 0 && menu.move(i, increment)) {
+                synth.setParameter(menu.getIndex(i), menu.getValue(i));
+                changed = true;
+            }
+        }
+        if (changed) lcdRefresh();
+    };
+
+    /**
+     * Indication of a held slider, run by the UI thread: shows the value of
+     * its position and the value it has to reach, until the next LCD refresh.
+     */
+    void showPickup() {
+        pickupPending = false;
+        int slider = heldSlider;
+        int index = synth.getSliderParameter(slider);
+        if (index < 0) return;
+        const auto &parameter = synth.getUI().getParameter(index);
+        Menu::renderPickup(DISPLAY::frame(), parameter.label,
+                           synth.getSliderValue(slider, sliderChange[slider].getValue()),
+                           synth.getSliderValue(slider, sliderTakeover[slider].getStored()), parameter.step);
+        DISPLAY::update();
+    };
+
+    SYNTH &synth;
+    QUEUE &events;
+    Menu menu;
+
+    /**
+     * True while the handling of the encoders is waiting in the event queue.
+     */
+    volatile bool encoderEventsPending;
+
+    /**
+     * True while the indication of a held slider is waiting in the event
+     * queue, and last moved held slider.
+     */
+    volatile bool pickupPending;
+    volatile int heldSlider;
+
+    /**
+     * True while an LCD refresh is waiting in the event queue.
+     */
+    volatile bool lcdRefreshPending;
+
+    /**
+     * Change detection of the sliders, only the changed values are posted.
+     */
+    ChangeDetector<float> sliderChange[4];
+
+    /**
+     * Soft takeover of the sliders, which are not sent to the synth until
+     * they reach the values it holds.
+     */
+    SoftTakeover sliderTakeover[4];
+
+    /**
+     * Velocity curves of the encoders and their increments not yet applied
+     * to the menu, as fractions of the range of the parameters. The scan
+     * adds to the increments and the UI thread takes them with an exchange.
+     */
+    EncoderAcceleration encoderAcceleration[4];
+    std::atomic<float> encoderIncrement[4];
+};
+
+template<typename SYNTH, typename SLIDERS, typename ENCODER1, typename ENCODER2, typename ENCODER3,
+        typename ENCODER4, typename DISPLAY, typename QUEUE>
+constexpr float ControlSurface<SYNTH, SLIDERS, ENCODER1, ENCODER2, ENCODER3, ENCODER4, DISPLAY, QUEUE>::SCAN_PERIOD;
+
+#endif //MIOSIX_DRUM_CONTROL_SURFACE_H
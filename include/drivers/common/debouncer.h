@@ -0,0 +1,177 @@
+#ifndef MIOSIX_DRUM_DEBOUNCER_H
+#define MIOSIX_DRUM_DEBOUNCER_H
+
+#include <cstdint>
+
+/**
+ * Event generated by a debounced button.
+ */
+struct ButtonEvent {
+    /**
+     * Kind of event.
+     */
+    enum Type : uint8_t {
+        PRESS,
+        RELEASE,
+        LONG_PRESS
+    };
+
+    /**
+     * Identifier of the button.
+     */
+    uint8_t button;
+
+    /**
+     * Kind of event.
+     */
+    Type type;
+
+    /**
+     * Time of the event, in the units of the Debouncer.
+     */
+    uint32_t time;
+};
+
+/**
+ * Time based debouncer of a button, fed with the edges of its input and
+ * with a periodic tick.
+ *
+ * The first edge changing the state is reported immediately, so a press
+ * is detected without waiting for the contacts to settle. The following
+ * edges are ignored until the input has been stable for the debounce
+ * time; if by then the input differs from the reported state (e.g. a
+ * spike shorter than the debounce time) the change is reported by the tick.
+ * The tick also reports a long press once the button has been held for
+ * the long press time.
+ *
+ * Times are unsigned counters of any unit (e.g. CPU cycles) and their
+ * differences are valid across a wrap. This class does not depend on
+ * the hardware and can be tested on the host.
+ */
+class Debouncer {
+public:
+    /**
+     * Constructor.
+     *
+     * @param debounceTime time without edges after which the input is considered stable
+     * @param longPressTime holding time reported as a long press
+     */
+    Debouncer(uint32_t debounceTime, uint32_t longPressTime)
+            : debounceTime(debounceTime), longPressTime(longPressTime) {
+        reset(false, 0);
+    };
+
+    /**
+     * Sets the state without reporting it, e.g. at the initialization.
+     *
+     * @param level current level of the input, true if pressed
+     * @param now current time
+     */
+    inline void reset(bool level, uint32_t now) {
+        state = level;
+        locked = false;
+        longReported = false;
+        lastEdge = now;
+        pressTime = now;
+    };
+
+    /**
+     * Processes an edge of the input.
+     *
+     * @param level level of the input after the edge, true if pressed
+     * @param now time of the edge
+     * @param type kind of the reported event
+     * @return true if an event has to be reported
+     */
+    inline bool edge(bool level, uint32_t now, ButtonEvent::Type &type) {
+        if (locked && now - lastEdge >= debounceTime) locked = false;
+        lastEdge = now;
+        if (locked || level == state) return false;
+        change(level, now, type);
+        return true;
+    };
+
+    /**
+     * Periodic check of the input, to be called more often than the debounce time.
+     *
+     * @param level current level of the input, true if pressed
+     * @param now current time
+     * @param type kind of the reported event
+     * @return true if an event has to be reported
+     */
+    inline bool tick(bool level, uint32_t now, ButtonEvent::Type &type) {
+        if (locked && now - lastEdge >= debounceTime) {
+            locked = false;
+            if (level != state) {
+                // the input settled on the other level during the lockout
+                lastEdge = now;
+                change(level, now, type);
+                return true;
+            }
+        }
+        if (state && !longReported && now - pressTime >= longPressTime) {
+            longReported = true;
+            type = ButtonEvent::LONG_PRESS;
+            return true;
+        }
+        return false;
+    };
+
+    /**
+     * Debounced state.
+     *
+     * @return true if the button is pressed
+     */
+    inline bool getState() const { return state; };
+
+private:
+    /**
+     * Reports a change of state and starts the lockout.
+     */
+    inline void change(bool level, uint32_t now, ButtonEvent::Type &type) {
+        state = level;
+        locked = true;
+        if (level) {
+            pressTime = now;
+            longReported = false;
+        }
+        type = level ? ButtonEvent::PRESS : ButtonEvent::RELEASE;
+    };
+
+    /**
+     * Time without edges after which the input is stable.
+     */
+    const uint32_t debounceTime;
+
+    /**
+     * Holding time reported as a long press.
+     */
+    const uint32_t longPressTime;
+
+    /**
+     * Last reported state.
+     */
+    bool state;
+
+    /**
+     * True while the edges are ignored.
+     */
+    bool locked;
+
+    /**
+     * True if the current press has already been reported as long.
+     */
+    bool longReported;
+
+    /**
+     * Time of the last edge.
+     */
+    uint32_t lastEdge;
+
+    /**
+     * Time of the last press.
+     */
+    uint32_t pressTime;
+};
+
+#endif //MIOSIX_DRUM_DEBOUNCER_H
@@ -0,0 +1,147 @@
+#ifndef MIOSIX_DRUM_ENCODER_ACCELERATION_H
+#define MIOSIX_DRUM_ENCODER_ACCELERATION_H
+
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+
+/**
+ * Velocity curve of an encoder.
+ * At low speed each detent moves the value by 1 / steps of its range,
+ * when turning faster the step is multiplied by
+ * gain = min(1 + acceleration * velocity ^ exponent, maxGain)
+ * with the velocity in detents per second.
+ */
+struct EncoderCurve {
+    /**
+     * Detents needed to sweep the whole range at low speed.
+     */
+    float steps;
+
+    /**
+     * Gain added per unit of velocity ^ exponent, zero disables the acceleration.
+     */
+    float acceleration;
+
+    /**
+     * Shape of the curve, 1 for a linear increase of the gain.
+     */
+    float exponent;
+
+    /**
+     * Maximum gain.
+     */
+    float maxGain;
+};
+
+/**
+ * Converts the counts of a quadrature encoder into increments of a value
+ * between 0 and 1, following an EncoderCurve.
+ *
+ * The counts are normalised to detents: the counts that do not complete
+ * a detent are kept for the next update, so a value only moves on a click
+ * and always by the same amount at the same speed, whatever the counts
+ * per detent of the encoder. The velocity is estimated from the time
+ * elapsed since the previous detent, averaged with the previous estimate,
+ * so an isolated click after a pause is never accelerated; while the
+ * encoder is still the velocity decays as 1 / elapsed time.
+ * This class does not depend on the hardware and can be tested on the host.
+ */
+class EncoderAcceleration {
+public:
+    /**
+     * Longest time between two detents considered in the velocity, in seconds.
+     */
+    static constexpr float MAX_ELAPSED = 1.0f;
+
+    /**
+     * Constructor.
+     *
+     * @param curve velocity curve
+     * @param countsPerDetent timer counts generated by a detent
+     */
+    EncoderAcceleration(const EncoderCurve &curve, int32_t countsPerDetent)
+            : curve(curve), countsPerDetent(countsPerDetent) {
+        reset();
+    };
+
+    /**
+     * Processes the counts of an update period.
+     *
+     * @param counts signed counts since the previous update
+     * @param dt update period, in seconds
+     * @return increment of the value
+     */
+    inline float update(int32_t counts, float dt) {
+        // detent normalisation, keeping the counts of the incomplete detent
+        remainder += counts;
+        int32_t detents = remainder / countsPerDetent;
+        remainder -= detents * countsPerDetent;
+
+        if (elapsed < MAX_ELAPSED) elapsed += dt;
+        if (detents == 0) {
+            // no detent for this long, the velocity cannot be higher
+            if (velocity * elapsed > 1.0f) velocity = 1.0f / elapsed;
+            return 0.0f;
+        }
+
+        velocity = 0.5f * (velocity + std::abs(detents) / elapsed);
+        elapsed = 0.0f;
+        return detents * getGain() / curve.steps;
+    };
+
+    /**
+     * Current gain of the curve.
+     *
+     * @return multiplier of the step
+     */
+    inline float getGain() const {
+        if (curve.acceleration <= 0.0f) return 1.0f;
+        float gain = 1.0f + curve.acceleration * std::pow(velocity, curve.exponent);
+        return (gain < curve.maxGain) ? gain : curve.maxGain;
+    };
+
+    /**
+     * Averaged velocity.
+     *
+     * @return velocity, in detents per second
+     */
+    inline float getVelocity() const { return velocity; };
+
+    /**
+     * Clears the incomplete detent and the velocity.
+     */
+    inline void reset() {
+        remainder = 0;
+        velocity = 0.0f;
+        elapsed = MAX_ELAPSED;
+    };
+
+private:
+    /**
+     * Velocity curve.
+     */
+    const EncoderCurve curve;
+
+    /**
+     * Timer counts generated by a detent.
+     */
+    const int32_t countsPerDetent;
+
+    /**
+     * Counts of the incomplete detent.
+     */
+    int32_t remainder;
+
+    /**
+     * Averaged velocity, in detents per second.
+     */
+    float velocity;
+
+    /**
+     * Time since the previous detent, in seconds.
+     */
+    float elapsed;
+};
+
+#endif //MIOSIX_DRUM_ENCODER_ACCELERATION_H
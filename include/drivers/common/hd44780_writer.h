@@ -0,0 +1,198 @@
+#ifndef MIOSIX_DRUM_HD44780_WRITER_H
+#define MIOSIX_DRUM_HD44780_WRITER_H
+
+#include <cstddef>
+#include <cstdint>
+#include "lcd_framebuffer.h"
+
+/**
+ * Non blocking writer of an HD44780 character LCD in 4 bit mode, sending
+ * the changed characters of a LcdFramebuffer.
+ *
+ * The transfer is a state machine advanced by step(), called at a fixed
+ * tick by a timer interrupt: every tick performs a single operation on the
+ * bus (setting a nibble, raising or lowering the enable line), so the tick
+ * period is the setup and pulse time of the bus and no call ever waits.
+ * A byte takes six ticks, leaving three ticks between the end of a byte and
+ * the first latch of the next one for the LCD to execute it.
+ *
+ * The address of the LCD is tracked: the set address command is sent only
+ * when the next changed character is not the one following the last written,
+ * since the LCD increments its address after each character.
+ * This class does not depend on the hardware and can be tested on the host.
+ *
+ * @tparam BUS bus policy, with the static functions
+ *             void write(bool rs, uint8_t nibble), setting the register select
+ *             and the data lines, and void enable(bool high), driving the enable line
+ * @tparam ROWS number of rows of the display
+ * @tparam COLS number of columns of the display
+ */
+template<typename BUS, size_t ROWS, size_t COLS>
+class Hd44780Writer {
+public:
+    /**
+     * Constructor.
+     *
+     * @param framebuffer frame to send to the display
+     */
+    explicit Hd44780Writer(LcdFramebuffer<ROWS, COLS> &framebuffer)
+            : framebuffer(framebuffer), state(IDLE), byte(0), rs(false),
+              dataPending(false), pendingData(0), address(INVALID_ADDRESS) {};
+
+    /**
+     * Advances the transfer by one tick.
+     *
+     * @return false if the display shows the whole frame and the ticks can stop
+     */
+    bool step() {
+        switch (state) {
+            case IDLE:
+                if (!load()) return false;
+                BUS::write(rs, byte >> 4);
+                state = HIGH_ENABLE;
+                break;
+            case HIGH_ENABLE:
+                BUS::enable(true);
+                state = HIGH_LATCH;
+                break;
+            case HIGH_LATCH:
+                BUS::enable(false);
+                state = LOW_SETUP;
+                break;
+            case LOW_SETUP:
+                BUS::write(rs, byte & 0x0F);
+                state = LOW_ENABLE;
+                break;
+            case LOW_ENABLE:
+                BUS::enable(true);
+                state = LOW_LATCH;
+                break;
+            case LOW_LATCH:
+                BUS::enable(false);
+                state = IDLE;
+                break;
+        }
+        return true;
+    };
+
+    /**
+     * Forgets the state of the display after it has been initialized,
+     * the whole frame is sent again. The ticks have to be stopped.
+     */
+    void reset() {
+        state = IDLE;
+        dataPending = false;
+        address = INVALID_ADDRESS;
+        framebuffer.invalidate();
+    };
+
+    /**
+     * Checks if a byte is being transferred.
+     *
+     * @return true in the middle of a byte
+     */
+    inline bool isBusy() const { return state != IDLE; };
+
+    /**
+     * Address in the display memory of a character.
+     *
+     * @param row row of the character
+     * @param col column of the character
+     * @return address
+     */
+    static constexpr uint8_t addressOf(size_t row, size_t col) {
+        return ((row & 1) ? 0x40 : 0x00) + ((row > 1) ? COLS : 0) + col;
+    };
+
+private:
+    /**
+     * Address not matching any character, forcing a set address command.
+     */
+    static constexpr uint8_t INVALID_ADDRESS = 0xFF;
+
+    /**
+     * Set address command of the display.
+     */
+    static constexpr uint8_t SET_ADDRESS = 0x80;
+
+    /**
+     * Operation performed by the next tick.
+     */
+    enum State : uint8_t {
+        IDLE,
+        HIGH_ENABLE,
+        HIGH_LATCH,
+        LOW_SETUP,
+        LOW_ENABLE,
+        LOW_LATCH
+    };
+
+    /**
+     * Selects the next byte to send.
+     *
+     * @return false if there is nothing to send
+     */
+    bool load() {
+        if (dataPending) {
+            dataPending = false;
+            setByte(true, pendingData);
+            return true;
+        }
+
+        size_t row, col;
+        char c;
+        if (!framebuffer.nextChange(row, col, c)) return false;
+        uint8_t target = addressOf(row, col);
+        if (target == address) {
+            setByte(true, c);
+        } else {
+            // moving to the character, which is sent by the next byte
+            setByte(false, SET_ADDRESS | target);
+            address = target;
+            pendingData = c;
+            dataPending = true;
+        }
+        return true;
+    };
+
+    /**
+     * Prepares a byte, updating the tracked address after a character.
+     *
+     * @param data true for a character, false for a command
+     * @param value byte to send
+     */
+    inline void setByte(bool data, uint8_t value) {
+        rs = data;
+        byte = value;
+        if (data) address++;
+    };
+
+    /**
+     * Frame to send.
+     */
+    LcdFramebuffer<ROWS, COLS> &framebuffer;
+
+    /**
+     * Operation performed by the next tick.
+     */
+    State state;
+
+    /**
+     * Byte being transferred and its register select.
+     */
+    uint8_t byte;
+    bool rs;
+
+    /**
+     * Character waiting for its set address command to complete.
+     */
+    bool dataPending;
+    uint8_t pendingData;
+
+    /**
+     * Address of the next character written by the display.
+     */
+    uint8_t address;
+};
+
+#endif //MIOSIX_DRUM_HD44780_WRITER_H
@@ -0,0 +1,109 @@
+#ifndef MIOSIX_DRUM_LATENCY_STATS_H
+#define MIOSIX_DRUM_LATENCY_STATS_H
+
+#include <cstdint>
+
+/**
+ * Lateness statistics of a periodic interrupt, computed from the timestamps
+ * taken with a free running cycle counter at the beginning of the handler.
+ *
+ * The interrupt source and the counter are driven by the same clock, so
+ * the ideal entry times are exactly one period apart. The first entry is
+ * the reference and the lateness of every following entry is measured
+ * against its ideal time: the difference between the maximum and the
+ * minimum lateness is the worst latency added by masked interrupts,
+ * critical sections and higher priority handlers.
+ *
+ * An entry delayed by more than one period hides the coalesced events of
+ * the source, which are counted as missed. This class does not depend on
+ * the hardware and can be tested on the host.
+ */
+class LatencyStats {
+public:
+    /**
+     * Constructor.
+     *
+     * @param period period of the interrupt, in counter cycles
+     */
+    explicit LatencyStats(uint32_t period) : period(period) { reset(); };
+
+    /**
+     * Records an entry of the handler.
+     *
+     * @param now value of the counter at the entry
+     */
+    inline void update(uint32_t now) {
+        if (count == 0) expected = now;
+
+        // differences of unsigned timestamps are valid across a wrap
+        int32_t lateness = static_cast<int32_t>(now - expected);
+        if (lateness < minLateness) minLateness = lateness;
+        if (lateness > maxLateness) maxLateness = lateness;
+
+        uint32_t elapsed = 1;
+        if (lateness >= static_cast<int32_t>(period)) {
+            elapsed += static_cast<uint32_t>(lateness) / period;
+            missed += elapsed - 1;
+        }
+        expected += elapsed * period;
+        count++;
+    };
+
+    /**
+     * Clears the statistics, the next entry becomes the reference.
+     */
+    inline void reset() {
+        expected = 0;
+        minLateness = 0;
+        maxLateness = 0;
+        count = 0;
+        missed = 0;
+    };
+
+    /**
+     * Worst latency added to the best observed one.
+     *
+     * @return latency, in counter cycles
+     */
+    inline uint32_t getWorstLatency() const {
+        return static_cast<uint32_t>(maxLateness - minLateness);
+    };
+
+    /**
+     * Number of recorded entries.
+     *
+     * @return entries since the last reset
+     */
+    inline uint32_t getCount() const { return count; };
+
+    /**
+     * Number of events of the source lost because the handler was delayed
+     * by more than one period.
+     *
+     * @return missed events since the last reset
+     */
+    inline uint32_t getMissed() const { return missed; };
+
+private:
+    /**
+     * Period of the interrupt, in counter cycles.
+     */
+    const uint32_t period;
+
+    /**
+     * Ideal entry time of the next event.
+     */
+    uint32_t expected;
+
+    /**
+     * Extreme lateness relative to the first entry.
+     */
+    int32_t minLateness, maxLateness;
+
+    /**
+     * Recorded entries and missed events.
+     */
+    uint32_t count, missed;
+};
+
+#endif //MIOSIX_DRUM_LATENCY_STATS_H
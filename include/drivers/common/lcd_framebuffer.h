@@ -0,0 +1,158 @@
+#ifndef MIOSIX_DRUM_LCD_FRAMEBUFFER_H
+#define MIOSIX_DRUM_LCD_FRAMEBUFFER_H
+
+#include <cstdarg>
+#include <cstddef>
+#include <cstdio>
+
+/**
+ * Character framebuffer of a text LCD.
+ *
+ * The pages are drawn by a thread into the frame, which never blocks since
+ * it is only memory, and the display driver sends to the LCD the characters
+ * that differ from the ones already shown, one at a time, calling
+ * nextChange() from its interrupt. A change of the frame marks it dirty, so
+ * that characters modified while the driver is scanning are picked up by
+ * another scan, and an unchanged frame costs nothing.
+ *
+ * The frame is written by a single thread and scanned by a single driver,
+ * without locks: a character is a single byte, so the driver always sends
+ * either the old or the new version of it and converges to the last frame.
+ * This class does not depend on the hardware and can be tested on the host.
+ *
+ * @tparam ROWS number of rows of the display
+ * @tparam COLS number of columns of the display
+ */
+template<size_t ROWS, size_t COLS>
+class LcdFramebuffer {
+public:
+    /**
+     * Constructor, the frame is blank and every character has to be sent.
+     */
+    LcdFramebuffer() : scanIndex(0), dirty(true) {
+        for (size_t i = 0; i < ROWS * COLS; i++) {
+            frame[i] = ' ';
+            shown[i] = '\0';
+        }
+    };
+
+    /**
+     * Fills the frame with spaces.
+     */
+    void clear() {
+        for (size_t i = 0; i < ROWS * COLS; i++) frame[i] = ' ';
+        dirty = true;
+    };
+
+    /**
+     * Writes a string, clipped at the end of the row.
+     *
+     * @param row row of the first character
+     * @param col column of the first character
+     * @param text null terminated string
+     * @return number of written characters
+     */
+    size_t print(size_t row, size_t col, const char *text) {
+        if (row >= ROWS) return 0;
+        size_t written = 0;
+        for (; col < COLS && text[written] != '\0'; col++, written++) {
+            frame[row * COLS + col] = text[written];
+        }
+        dirty = true;
+        return written;
+    };
+
+    /**
+     * Writes a formatted string, clipped at the end of the row.
+     * The string is formatted on the stack, no memory is allocated.
+     *
+     * @param row row of the first character
+     * @param col column of the first character
+     * @param format printf format string
+     * @return number of written characters
+     */
+    size_t printf(size_t row, size_t col, const char *format, ...) __attribute__((format(printf, 4, 5))) {
+        char line[COLS + 1];
+        va_list arguments;
+        va_start(arguments, format);
+        vsnprintf(line, sizeof(line), format, arguments);
+        va_end(arguments);
+        return print(row, col, line);
+    };
+
+    /**
+     * Character of the frame.
+     *
+     * @param row row of the character
+     * @param col column of the character
+     * @return character
+     */
+    inline char at(size_t row, size_t col) const { return frame[row * COLS + col]; };
+
+    /**
+     * Finds the next character to send to the display, and marks it as shown.
+     * Called by the display driver only.
+     *
+     * @param row row of the character
+     * @param col column of the character
+     * @param c character to send
+     * @return false if the display shows the whole frame
+     */
+    bool nextChange(size_t &row, size_t &col, char &c) {
+        while (true) {
+            while (scanIndex < ROWS * COLS) {
+                size_t i = scanIndex++;
+                char current = frame[i];
+                if (current != shown[i]) {
+                    shown[i] = current;
+                    row = i / COLS;
+                    col = i % COLS;
+                    c = current;
+                    return true;
+                }
+            }
+            if (!dirty) return false;
+            dirty = false;
+            scanIndex = 0;
+        }
+    };
+
+    /**
+     * Forgets the content of the display, e.g. after it has been reset,
+     * so that the whole frame is sent again. Called by the display driver only.
+     */
+    void invalidate() {
+        for (size_t i = 0; i < ROWS * COLS; i++) shown[i] = '\0';
+        dirty = true;
+    };
+
+    /**
+     * Checks if the frame changed since the last scan.
+     *
+     * @return true if the frame has to be scanned
+     */
+    inline bool isDirty() const { return dirty; };
+
+private:
+    /**
+     * Frame drawn by the thread.
+     */
+    volatile char frame[ROWS * COLS];
+
+    /**
+     * Characters already sent to the display.
+     */
+    char shown[ROWS * COLS];
+
+    /**
+     * Position of the scan of the driver.
+     */
+    size_t scanIndex;
+
+    /**
+     * Set when the frame changes, cleared when a scan starts.
+     */
+    volatile bool dirty;
+};
+
+#endif //MIOSIX_DRUM_LCD_FRAMEBUFFER_H
@@ -0,0 +1,319 @@
+#ifndef MIOSIX_DRUM_PARAMETER_MENU_H
+#define MIOSIX_DRUM_PARAMETER_MENU_H
+
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include "lcd_framebuffer.h"
+
+/**
+ * Paged browser of the synth parameters, shown on a character LCD and
+ * edited with a row of encoders.
+ *
+ * The parameters are added with the metadata of the Faust UI (label, unit,
+ * range and step), and are grouped in pages of SLOTS parameters, one for
+ * each encoder. The first row of the LCD shows the last edited parameter
+ * of the page with its value in real units, the second row the short
+ * labels of the page with a marker on the edited one:
+ *
+ *     freq      440 Hz
+ *      ben dis fee>fre
+ *
+ * Labels and units are not copied, they must outlive the menu (the Faust
+ * UI keeps pointers to string literals), and the values are formatted with
+ * integer arithmetic only, so neither the menu nor the rendering allocate.
+ * This class does not depend on the hardware and can be tested on the host.
+ *
+ * @tparam CAPACITY maximum number of parameters
+ * @tparam SLOTS number of parameters of a page
+ */
+template<size_t CAPACITY, size_t SLOTS>
+class ParameterMenu {
+public:
+    /**
+     * Most decimals shown by a value.
+     */
+    static constexpr int MAX_DECIMALS = 3;
+
+    /**
+     * Right arrow of the HD44780 character set.
+     */
+    static constexpr char ARROW = '\x7E';
+
+    /**
+     * Constructor, the menu is empty.
+     */
+    ParameterMenu() : count(0), page(0), focus(0) {};
+
+    /**
+     * Adds a parameter after the others.
+     *
+     * @param index index of the parameter in the synth
+     * @param label label of the parameter
+     * @param unit unit of the value, may be empty
+     * @param min minimum value
+     * @param max maximum value
+     * @param init initial value
+     * @param step resolution of the value, zero if continuous
+     * @return false if the menu is full
+     */
+    bool add(int index, const char *label, const char *unit, float min, float max, float init, float step) {
+        if (count >= CAPACITY) return false;
+        Entry &entry = entries[count++];
+        entry.index = index;
+        entry.label = (label != nullptr) ? label : "";
+        entry.unit = (unit != nullptr) ? unit : "";
+        entry.min = min;
+        entry.max = max;
+        entry.step = step;
+        entry.position = (max > min) ? clip((init - min) / (max - min)) : 0.0f;
+        return true;
+    };
+
+    /**
+     * Number of parameters.
+     *
+     * @return parameter count
+     */
+    inline size_t getCount() const { return count; };
+
+    /**
+     * Number of pages, at least one.
+     *
+     * @return page count
+     */
+    inline size_t getPageCount() const { return (count == 0) ? 1 : (count + SLOTS - 1) / SLOTS; };
+
+    /**
+     * Shown page.
+     *
+     * @return page, from zero
+     */
+    inline size_t getPage() const { return page; };
+
+    /**
+     * Shows the next page, after the last one comes the first.
+     */
+    void nextPage() {
+        page = (page + 1) % getPageCount();
+        focus = 0;
+    };
+
+    /**
+     * Shows the previous page, before the first one comes the last.
+     */
+    void previousPage() {
+        page = (page + getPageCount() - 1) % getPageCount();
+        focus = 0;
+    };
+
+    /**
+     * Checks if an encoder controls a parameter in the shown page.
+     *
+     * @param slot encoder
+     * @return false if the page has no parameter for the encoder
+     */
+    inline bool isBound(size_t slot) const { return slot < SLOTS && page * SLOTS + slot < count; };
+
+    /**
+     * Index in the synth of the parameter controlled by an encoder.
+     *
+     * @param slot encoder
+     * @return index of the parameter, -1 if the encoder is not bound
+     */
+    inline int getIndex(size_t slot) const { return isBound(slot) ? entries[page * SLOTS + slot].index : -1; };
+
+    /**
+     * Value of the parameter controlled by an encoder, rounded to its step.
+     *
+     * @param slot encoder
+     * @return value in real units, 0 if the encoder is not bound
+     */
+    inline float getValue(size_t slot) const { return isBound(slot) ? valueOf(entries[page * SLOTS + slot]) : 0.0f; };
+
+    /**
+     * Moves the parameter controlled by an encoder, which becomes the one
+     * shown in full.
+     *
+     * @param slot encoder
+     * @param increment increment, as a fraction of the range of the parameter
+     * @return true if the value changed
+     */
+    bool move(size_t slot, float increment) {
+        if (!isBound(slot)) return false;
+        focus = slot;
+        Entry &entry = entries[page * SLOTS + slot];
+        float previous = valueOf(entry);
+        entry.position = clip(entry.position + increment);
+        return valueOf(entry) != previous;
+    };
+
+    /**
+     * Draws the shown page in the first two rows of a framebuffer.
+     *
+     * @param frame framebuffer of the LCD
+     */
+    template<size_t ROWS, size_t COLS>
+    void render(LcdFramebuffer<ROWS, COLS> &frame) const {
+        static_assert(ROWS >= 2, "The menu needs two rows");
+        static_assert(COLS >= SLOTS * 2, "Each parameter of a page needs two columns");
+
+        // edited parameter, the value is right aligned and wins over the label
+        if (isBound(focus)) {
+            const Entry &entry = entries[page * SLOTS + focus];
+            char value[COLS + 1];
+            size_t length = formatValue(value, sizeof(value), valueOf(entry), entry.step);
+            if (entry.unit[0] != '\0' && length + 1 < COLS) {
+                length += snprintf(value + length, sizeof(value) - length, " %s", entry.unit);
+                if (length > COLS) length = COLS;
+            }
+            drawFirstRow(frame, entry.label, value, length);
+        } else {
+            drawFirstRow(frame, "", "", 0);
+        }
+
+        // short labels of the page
+        const size_t width = COLS / SLOTS;
+        char line[COLS + 1];
+        blank(line, COLS);
+        for (size_t slot = 0; slot < SLOTS && isBound(slot); slot++) {
+            line[slot * width] = (slot == focus) ? '>' : ' ';
+            copy(line + slot * width + 1, entries[page * SLOTS + slot].label, width - 1);
+        }
+        frame.print(1, 0, line);
+    };
+
+    /**
+     * Draws in the first row a control held by a soft takeover: the label
+     * of its parameter, the value of its position and, after an arrow,
+     * the value it has to reach to pick up the parameter.
+     *
+     * @param frame framebuffer of the LCD
+     * @param label label of the parameter
+     * @param value value of the position of the control
+     * @param target value to reach
+     * @param step resolution of the values
+     */
+    template<size_t ROWS, size_t COLS>
+    static void renderPickup(LcdFramebuffer<ROWS, COLS> &frame, const char *label,
+                             float value, float target, float step) {
+        char values[COLS + 1];
+        size_t length = formatValue(values, sizeof(values), value, step);
+        if (length + 1 < COLS) {
+            values[length++] = ARROW;
+            length += formatValue(values + length, sizeof(values) - length, target, step);
+        }
+        drawFirstRow(frame, label, values, length);
+    };
+
+    /**
+     * Formats a value with the decimals of its step, without using the
+     * floating point printf, which may allocate.
+     *
+     * @param buffer output string
+     * @param size size of the buffer
+     * @param value value to format
+     * @param step resolution of the value, zero for the maximum number of decimals
+     * @return length of the string
+     */
+    static size_t formatValue(char *buffer, size_t size, float value, float step) {
+        int decimals = 0;
+        for (float resolution = 1.0f; decimals < MAX_DECIMALS && !(step >= resolution * 0.999f); resolution /= 10) {
+            decimals++;
+        }
+        long scale = 1;
+        for (int i = 0; i < decimals; i++) scale *= 10;
+
+        long scaled = std::lround(std::fabs(value) * scale);
+        const char *sign = (value < 0 && scaled != 0) ? "-" : "";
+        int length;
+        if (decimals == 0) length = snprintf(buffer, size, "%s%ld", sign, scaled);
+        else length = snprintf(buffer, size, "%s%ld.%0*ld", sign, scaled / scale, decimals, scaled % scale);
+        if (length < 0) return 0;
+        return (static_cast<size_t>(length) < size) ? static_cast<size_t>(length) : size - 1;
+    };
+
+private:
+    /**
+     * Parameter of the menu.
+     */
+    struct Entry {
+        int index;
+        const char *label;
+        const char *unit;
+        float min, max, step;
+
+        /**
+         * Position of the value in its range, between 0 and 1.
+         */
+        float position;
+    };
+
+    /**
+     * Draws the first row with a label on the left and a right aligned
+     * text, which wins over the label.
+     */
+    template<size_t ROWS, size_t COLS>
+    static void drawFirstRow(LcdFramebuffer<ROWS, COLS> &frame, const char *label, const char *text, size_t length) {
+        char line[COLS + 1];
+        blank(line, COLS);
+        copy(line, label, COLS);
+        memcpy(line + COLS - length, text, length);
+        frame.print(0, 0, line);
+    };
+
+    /**
+     * Value of a parameter, rounded to its step.
+     */
+    static float valueOf(const Entry &entry) {
+        float offset = entry.position * (entry.max - entry.min);
+        if (entry.step > 0) offset = std::round(offset / entry.step) * entry.step;
+        float value = entry.min + offset;
+        return (value < entry.max) ? value : entry.max;
+    };
+
+    /**
+     * Clips a position between 0 and 1.
+     */
+    static inline float clip(float position) {
+        return (position < 0.0f) ? 0.0f : (position > 1.0f) ? 1.0f : position;
+    };
+
+    /**
+     * Fills a line with spaces.
+     */
+    static inline void blank(char *line, size_t length) {
+        memset(line, ' ', length);
+        line[length] = '\0';
+    };
+
+    /**
+     * Copies at most length characters of a string, without the terminator.
+     */
+    static inline void copy(char *destination, const char *source, size_t length) {
+        for (size_t i = 0; i < length && source[i] != '\0'; i++) destination[i] = source[i];
+    };
+
+    /**
+     * Parameters, in order of page.
+     */
+    Entry entries[CAPACITY];
+
+    /**
+     * Number of parameters.
+     */
+    size_t count;
+
+    /**
+     * Shown page.
+     */
+    size_t page;
+
+    /**
+     * Encoder of the parameter shown in full.
+     */
+    size_t focus;
+};
+
+#endif //MIOSIX_DRUM_PARAMETER_MENU_H
@@ -0,0 +1,218 @@
+#ifndef MIOSIX_DRUM_PERIODIC_SCHEDULER_H
+#define MIOSIX_DRUM_PERIODIC_SCHEDULER_H
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Statistics of a periodic task.
+ * The delay of a run is the time from its release to its start,
+ * and the jitter is the spread of the delays.
+ */
+struct PeriodicTaskStats {
+    /**
+     * Runs of the task.
+     */
+    uint32_t runs;
+
+    /**
+     * Releases lost because the scheduler or the task were late
+     * by at least a period.
+     */
+    uint32_t missed;
+
+    /**
+     * Extreme delays, in clock cycles.
+     */
+    uint32_t minDelay, maxDelay;
+
+    /**
+     * Spread of the delays.
+     *
+     * @return jitter, in clock cycles
+     */
+    inline uint32_t getJitter() const { return (runs > 0) ? maxDelay - minDelay : 0; };
+};
+
+/**
+ * Scheduler of periodic tasks released at absolute deadlines of a tick
+ * counter, e.g. the number of audio blocks played.
+ *
+ * Each task has a period and a phase in ticks, and its next release is
+ * always computed from the previous one, never from the time it ran, so
+ * the releases do not drift however late the tasks run. When run() is
+ * called late by more than a period, the releases in between are counted
+ * as missed and the task runs once.
+ *
+ * The delay of each run from the release is measured with a free running
+ * clock (the DWT cycle counter on the target, a simulated one on the host),
+ * either when the task is called or, for tasks that only wake up a thread,
+ * when the thread reports its start with record().
+ * The tasks are added before the scheduler runs, or with run() masked.
+ * This class does not depend on the hardware and can be tested on the host.
+ *
+ * @tparam SIZE maximum number of tasks
+ * @tparam CLOCK clock policy, with a static function uint32_t read()
+ */
+template<size_t SIZE, typename CLOCK>
+class PeriodicScheduler {
+public:
+    /**
+     * Task function, called with its id.
+     * It returns true if it woke up a thread of higher priority.
+     */
+    typedef bool (*Task)(size_t id);
+
+    /**
+     * Constructor, without tasks.
+     */
+    PeriodicScheduler() : count(0) {};
+
+    /**
+     * Adds a task.
+     *
+     * @param task task function
+     * @param period period, in ticks
+     * @param phase tick of the first release
+     * @param measured true to measure the delay when the task is called,
+     *                 false if the task reports its start with record()
+     * @return id of the task, -1 if there is no space or the period is zero
+     */
+    int add(Task task, uint32_t period, uint32_t phase = 0, bool measured = true) {
+        if (count >= SIZE || period == 0) return -1;
+        Entry &entry = entries[count];
+        entry.task = task;
+        entry.period = period;
+        entry.next = phase;
+        entry.release = 0;
+        entry.measured = measured;
+        clearStats(entry.stats);
+        return static_cast<int>(count++);
+    };
+
+    /**
+     * Runs the tasks released at a tick, in order of id.
+     *
+     * @param now current tick
+     * @param releaseTime clock at the beginning of the tick
+     * @return true if a task woke up a thread of higher priority
+     */
+    bool run(uint32_t now, uint32_t releaseTime) {
+        bool woken = false;
+        for (size_t i = 0; i < count; i++) {
+            Entry &entry = entries[i];
+            // differences of unsigned ticks are valid across a wrap
+            int32_t late = static_cast<int32_t>(now - entry.next);
+            if (late < 0) continue;
+
+            uint32_t skipped = static_cast<uint32_t>(late) / entry.period;
+            entry.stats.missed += skipped;
+            entry.next += (skipped + 1) * entry.period;
+            entry.release = releaseTime;
+            if (entry.measured) record(i, CLOCK::read());
+            woken |= entry.task(i);
+        }
+        return woken;
+    };
+
+    /**
+     * Records the start of a run of a task.
+     *
+     * @param id id of the task
+     * @param startTime clock at the start of the run
+     */
+    void record(size_t id, uint32_t startTime) {
+        PeriodicTaskStats &stats = entries[id].stats;
+        uint32_t delay = startTime - entries[id].release;
+        if (stats.runs == 0 || delay < stats.minDelay) stats.minDelay = delay;
+        if (stats.runs == 0 || delay > stats.maxDelay) stats.maxDelay = delay;
+        stats.runs++;
+    };
+
+    /**
+     * Counts a release lost by a task, e.g. a thread still running its
+     * previous period.
+     *
+     * @param id id of the task
+     */
+    inline void miss(size_t id) { entries[id].stats.missed++; };
+
+    /**
+     * Period of a task.
+     *
+     * @param id id of the task
+     * @return period, in ticks
+     */
+    inline uint32_t getPeriod(size_t id) const { return entries[id].period; };
+
+    /**
+     * Tick of the next release of a task.
+     *
+     * @param id id of the task
+     * @return absolute tick
+     */
+    inline uint32_t getNextRelease(size_t id) const { return entries[id].next; };
+
+    /**
+     * Statistics of a task.
+     *
+     * @param id id of the task
+     * @return statistics since the task was added or the last reset
+     */
+    inline const PeriodicTaskStats &getStats(size_t id) const { return entries[id].stats; };
+
+    /**
+     * Clears the statistics of every task.
+     */
+    void resetStats() {
+        for (size_t i = 0; i < count; i++) clearStats(entries[i].stats);
+    };
+
+    /**
+     * Number of tasks.
+     *
+     * @return task count
+     */
+    inline size_t getCount() const { return count; };
+
+private:
+    /**
+     * Periodic task.
+     */
+    struct Entry {
+        Task task;
+        uint32_t period;
+
+        /**
+         * Tick of the next release.
+         */
+        uint32_t next;
+
+        /**
+         * Clock at the last release.
+         */
+        uint32_t release;
+
+        bool measured;
+        PeriodicTaskStats stats;
+    };
+
+    static void clearStats(PeriodicTaskStats &stats) {
+        stats.runs = 0;
+        stats.missed = 0;
+        stats.minDelay = 0;
+        stats.maxDelay = 0;
+    };
+
+    /**
+     * Tasks, in order of id.
+     */
+    Entry entries[SIZE];
+
+    /**
+     * Number of tasks, incremented after the task is written.
+     */
+    volatile size_t count;
+};
+
+#endif //MIOSIX_DRUM_PERIODIC_SCHEDULER_H
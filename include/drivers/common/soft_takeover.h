@@ -0,0 +1,110 @@
+#ifndef MIOSIX_DRUM_SOFT_TAKEOVER_H
+#define MIOSIX_DRUM_SOFT_TAKEOVER_H
+
+#include <cstdint>
+
+/**
+ * Soft takeover of an absolute control, e.g. a slider, whose position does
+ * not match the value of its parameter after the value has been set by
+ * something else (the initial value of the synth, a recalled preset).
+ *
+ * While held, the positions of the control are not applied, so the stored
+ * value is not overwritten by a jump to the physical position. The control
+ * picks up the value, and from then on is applied, when it comes within a
+ * window of the stored value or crosses it, which also catches a fast
+ * movement jumping over the window between two samples.
+ * This class does not depend on the hardware and can be tested on the host.
+ */
+class SoftTakeover {
+public:
+    /**
+     * Outcome of a new position of the control: HELD if it is not applied,
+     * PICKUP if the control has just picked up the value and is applied,
+     * APPLY if it is applied.
+     */
+    enum Result : uint8_t {
+        HELD,
+        PICKUP,
+        APPLY
+    };
+
+    /**
+     * Constructor, the control is applied from the first position.
+     *
+     * @param window distance from the stored value within which the control picks it up
+     */
+    explicit SoftTakeover(float window) : window(window), stored(0), side(0), held(false) {};
+
+    /**
+     * Holds the control until it reaches a value.
+     *
+     * @param value stored value of the parameter, in the units of the control
+     */
+    inline void hold(float value) {
+        stored = value;
+        side = 0;
+        held = true;
+    };
+
+    /**
+     * Releases the control, which is applied from the next position.
+     */
+    inline void release() { held = false; };
+
+    /**
+     * Processes a new position of the control.
+     *
+     * @param position position of the control
+     * @return whether the position has to be applied
+     */
+    inline Result update(float position) {
+        if (!held) return APPLY;
+
+        float difference = position - stored;
+        int8_t newSide = (difference > 0) ? 1 : -1;
+        if ((difference <= window && difference >= -window) || (side != 0 && newSide != side)) {
+            held = false;
+            return PICKUP;
+        }
+        side = newSide;
+        return HELD;
+    };
+
+    /**
+     * Checks if the control is held.
+     *
+     * @return true until the control picks up the stored value
+     */
+    inline bool isHeld() const { return held; };
+
+    /**
+     * Value the control has to reach.
+     *
+     * @return stored value, in the units of the control
+     */
+    inline float getStored() const { return stored; };
+
+private:
+    /**
+     * Distance within which the control picks up the value.
+     */
+    const float window;
+
+    /**
+     * Value the control has to reach.
+     */
+    float stored;
+
+    /**
+     * Side of the stored value where the control was last seen,
+     * -1 below, 1 above, 0 before the first position.
+     */
+    int8_t side;
+
+    /**
+     * True until the control picks up the value.
+     */
+    bool held;
+};
+
+#endif //MIOSIX_DRUM_SOFT_TAKEOVER_H
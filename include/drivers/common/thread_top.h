@@ -0,0 +1,137 @@
+#ifndef MIOSIX_DRUM_THREAD_TOP_H
+#define MIOSIX_DRUM_THREAD_TOP_H
+
+#include <algorithm>
+#include <cstddef>
+
+/**
+ * Table of the CPU load and of the stack usage of the threads, like the
+ * top command, computed from successive snapshots of the CPU time counter
+ * of the kernel.
+ *
+ * The load of a thread is the CPU time it used since the previous snapshot,
+ * or since its creation if it is new, divided by the time used by all the
+ * threads in the same interval. The idle thread is part of the snapshot, so
+ * the loads add up to the elapsed time. The threads are matched across the
+ * snapshots by their pointer, and the rows are sorted by decreasing load.
+ * This class does not depend on the kernel and can be tested on the host.
+ *
+ * @tparam U type of the snapshot entries, with the fields thread, cpuTime,
+ *           stackSize, stackUsed and watermarkOk of miosix::ThreadUsage
+ * @tparam SIZE maximum number of threads in the table
+ */
+template<typename U, size_t SIZE>
+class ThreadTop {
+public:
+    /**
+     * Row of the table.
+     */
+    struct Row {
+        const void *thread;
+        const char *name;
+        float load;
+        unsigned int stackUsed;
+        unsigned int stackSize;
+        bool overflow;
+    };
+
+    ThreadTop() : rowCount(0), nameCount(0) {};
+
+    /**
+     * Names a thread in the table, the threads without a name have nullptr.
+     *
+     * @param thread thread, as the thread field of the snapshot
+     * @param name name, not copied
+     * @return false if there are already SIZE names
+     */
+    bool setName(const void *thread, const char *name) {
+        for (size_t i = 0; i < nameCount; i++) {
+            if (names[i].thread != thread) continue;
+            names[i].name = name;
+            return true;
+        }
+        if (nameCount == SIZE) return false;
+        names[nameCount++] = {thread, name};
+        return true;
+    };
+
+    /**
+     * Computes the table from a new snapshot.
+     *
+     * @param usage snapshot of the threads
+     * @param count number of threads in the snapshot, only the first SIZE
+     *              are in the table
+     * @return number of rows
+     */
+    size_t update(const U *usage, size_t count) {
+        count = std::min(count, SIZE);
+        unsigned long long delta[SIZE];
+        unsigned long long total = 0;
+        for (size_t i = 0; i < count; i++) {
+            delta[i] = usage[i].cpuTime - previousTime(usage[i].thread);
+            total += delta[i];
+        }
+
+        for (size_t i = 0; i < count; i++) {
+            rows[i].thread = usage[i].thread;
+            rows[i].name = getName(usage[i].thread);
+            rows[i].load = total > 0 ? static_cast<float>(delta[i]) / static_cast<float>(total) : 0.0f;
+            rows[i].stackUsed = usage[i].stackUsed;
+            rows[i].stackSize = usage[i].stackSize;
+            rows[i].overflow = !usage[i].watermarkOk || usage[i].stackUsed >= usage[i].stackSize;
+            previous[i] = {usage[i].thread, usage[i].cpuTime};
+        }
+        rowCount = count;
+        std::stable_sort(rows, rows + rowCount, [](const Row &a, const Row &b) { return a.load > b.load; });
+        return rowCount;
+    };
+
+    /**
+     * @return number of rows of the last update
+     */
+    inline size_t getRowCount() const { return rowCount; };
+
+    /**
+     * @param i row, less than getRowCount()
+     * @return the row, sorted by decreasing load
+     */
+    inline const Row &getRow(size_t i) const { return rows[i]; };
+
+private:
+    /**
+     * CPU time of a thread in the previous snapshot, 0 if it is new.
+     */
+    unsigned long long previousTime(const void *thread) const {
+        for (size_t i = 0; i < rowCount; i++)
+            if (previous[i].thread == thread) return previous[i].cpuTime;
+        return 0;
+    };
+
+    const char *getName(const void *thread) const {
+        for (size_t i = 0; i < nameCount; i++)
+            if (names[i].thread == thread) return names[i].name;
+        return nullptr;
+    };
+
+    /**
+     * Rows of the last update, and the CPU times of its snapshot in the
+     * order of the snapshot.
+     */
+    Row rows[SIZE];
+    struct {
+        const void *thread;
+        unsigned long long cpuTime;
+    } previous[SIZE];
+    size_t rowCount;
+
+    /**
+     * Names of the threads.
+     */
+    struct {
+        const void *thread;
+        const char *name;
+    } names[SIZE];
+    size_t nameCount;
+};
+
+#endif //MIOSIX_DRUM_THREAD_TOP_H
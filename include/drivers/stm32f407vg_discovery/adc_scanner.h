@@ -0,0 +1,143 @@
+#ifndef MIOSIX_DRUM_ADC_SCANNER_H
+#define MIOSIX_DRUM_ADC_SCANNER_H
+
+#include <cstdint>
+#include "../../config/hw_config.h"
+#include "../common/adc_scan_buffer.h"
+#include "registers.h"
+#include "memory_sections.h"
+#include "potentiometer.h"
+
+/**
+ * Templated static class converting continuously the channels of a set of
+ * Potentiometers with ADC1 in scan mode. The results are moved by DMA2
+ * Stream0 into a circular AdcScanBuffer, and are averaged when read,
+ * so reading a potentiometer never waits for a conversion nor
+ * disables the interrupts.
+ *
+ * With ADCCLK at 14MHz and a sampling time of 480 cycles a conversion
+ * takes ~35us, so with 4 potentiometers the buffer covers the last
+ * ADC_AVG_SAMPLES * 141us.
+ *
+ * @tparam POTENTIOMETERS Potentiometer types, in the order of the scan sequence
+ */
+template<typename... POTENTIOMETERS>
+class AdcScanner
+{
+public:
+
+    /**
+     * Number of scanned channels
+     */
+    static constexpr size_t CHANNELS = sizeof...(POTENTIOMETERS);
+
+    /**
+     * Static function used to initialize the pins, the ADC and the DMA
+     * and to start the conversions
+     */
+    static void init()
+    {
+        static_assert(CHANNELS >= 1 && CHANNELS <= 16, "The ADC sequence length must be between 1 and 16");
+        const uint8_t channels[CHANNELS] = {POTENTIOMETERS::CHANNEL...};
+
+        // Analog mode for every pin
+        int pins[] = {(POTENTIOMETERS::initPin(), 0)...};
+        (void) pins;
+
+        {
+            miosix::FastInterruptDisableLock dLock;
+            RCC->APB2ENR |= RCC_APB2ENR_ADC1EN;
+            RCC->AHB1ENR |= RCC_AHB1ENR_DMA2EN;
+            RCC_SYNC();
+        }
+
+        // Prescaler, ADCCLK = PCLK2 / 6
+        ADC->CCR = (2 << 16);
+
+        // Scan mode and resolution
+        ADC1->CR1 = ADC_CR1_SCAN | (ADC_RESOLUTION << 24);
+
+        // Right aligned, continuous conversion, DMA requests not stopped after the last transfer
+        ADC1->CR2 = ADC_CR2_CONT | ADC_CR2_DMA | ADC_CR2_DDS;
+
+        // Sequence length, channels order and sampling time (480 cycles)
+        ADC1->SQR1 = (CHANNELS - 1) << 20;
+        ADC1->SQR2 = 0;
+        ADC1->SQR3 = 0;
+        ADC1->SMPR1 = 0;
+        ADC1->SMPR2 = 0;
+        for (size_t i = 0; i < CHANNELS; i++) {
+            if (i < 6) ADC1->SQR3 |= channels[i] << (5 * i);
+            else if (i < 12) ADC1->SQR2 |= channels[i] << (5 * (i - 6));
+            else ADC1->SQR1 |= channels[i] << (5 * (i - 12));
+
+            if (channels[i] < 10) ADC1->SMPR2 |= 7 << (3 * channels[i]);
+            else ADC1->SMPR1 |= 7 << (3 * (channels[i] - 10));
+        }
+
+        // DMA2 Stream0 Channel0 (ADC1), circular peripheral to memory transfers
+        buffer.clear();
+        DMA2_Stream0->CR = 0;
+        while (DMA2_Stream0->CR & DMA_SxCR_EN);
+        DMA2_Stream0->PAR = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(&ADC1->DR));
+        DMA2_Stream0->M0AR = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(buffer.data()));
+        DMA2_Stream0->NDTR = buffer.SIZE;
+        DMA2_Stream0->CR = DMA_SxCR_MSIZE_0 |   //Write 16bit at a time to RAM
+                           DMA_SxCR_PSIZE_0 |   //Read  16bit at a time from the ADC
+                           DMA_SxCR_MINC |      //Increment RAM pointer
+                           DMA_SxCR_CIRC |      //Restart from the beginning of the buffer
+                           DMA_SxCR_EN;         //Start the DMA
+
+        // Enable, wait to stabilize the ADC and start the conversions
+        ADC1->CR2 |= ADC_CR2_ADON;
+        miosix::delayUs(100);
+        ADC1->CR2 |= ADC_CR2_SWSTART;
+    }
+
+    /**
+     * Reads the averaged value of a potentiometer
+     * @param index position of the potentiometer in POTENTIOMETERS
+     * @return average of the last ADC_AVG_SAMPLES conversions, between 0 and 1
+     */
+    static inline float read(size_t index)
+    {
+        return buffer.average(index) / ADC_MAX_VALUE;
+    }
+
+    /**
+     * Circular buffer written by the DMA, also written by the host
+     * models of the ADC, which cannot follow the DMA addresses
+     * @return conversions buffer
+     */
+    static inline AdcScanBuffer<CHANNELS, ADC_AVG_SAMPLES> &getBuffer()
+    {
+        return buffer;
+    }
+
+private:
+
+    /**
+     * Circular buffer written by the DMA, in the DMA reachable memory
+     */
+    static AdcScanBuffer<CHANNELS, ADC_AVG_SAMPLES> buffer;
+
+    /**
+     * Static class, constructor disabled
+     */
+    AdcScanner() = delete;
+
+    /**
+     * Static class, copy constructor disabled
+     */
+    AdcScanner(const AdcScanner &) = delete;
+
+    /**
+     * Static class, assignment operator disabled
+     */
+    AdcScanner &operator=(const AdcScanner &) = delete;
+};
+
+template<typename... POTENTIOMETERS>
+DMA_RAM AdcScanBuffer<AdcScanner<POTENTIOMETERS...>::CHANNELS, ADC_AVG_SAMPLES> AdcScanner<POTENTIOMETERS...>::buffer;
+
+#endif //MIOSIX_DRUM_ADC_SCANNER_H
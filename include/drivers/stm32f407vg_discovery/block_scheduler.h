@@ -0,0 +1,141 @@
+#ifndef MIOSIX_DRUM_BLOCK_SCHEDULER_H
+#define MIOSIX_DRUM_BLOCK_SCHEDULER_H
+
+#include "../../../miosix/miosix.h"
+#include "../common/audio.h"
+#include "../common/periodic_scheduler.h"
+#include "cycle_counter.h"
+
+/**
+ * Static class running the periodic control tasks at absolute deadlines
+ * aligned to the audio blocks: the I2S DMA interrupt counts the blocks and
+ * pends the TIM6 interrupt, used as a software interrupt, which releases
+ * the tasks whose deadline is the current block. The tasks never drift
+ * from the audio and their jitter, measured from the end of the DMA
+ * transfer with the DWT cycle counter, is kept for each task.
+ *
+ * A task is either a function called from the interrupt, with the same
+ * rules of any interrupt handler (short, only the miosix functions starting
+ * with IRQ, returning true when it wakes up a higher priority thread),
+ * or a thread blocked in wait() until its next release.
+ * The interrupt priority is the same of the kernel tick, below the I2S DMA
+ * interrupt, but the interrupts do not preempt each other (priority grouping
+ * 7): a running task delays the next DMA interrupt, and with it the audio
+ * thread, until it returns. The tasks released at the same block, together
+ * with the processing of a block by the audio thread, must therefore run
+ * within the block period (2.67ms at 48kHz with 128 samples), and should
+ * take a small fraction of it. print() reports the longest run of the
+ * interrupt against the block period.
+ */
+class BlockScheduler {
+public:
+    /**
+     * Maximum number of tasks
+     */
+    static constexpr size_t MAX_TASKS = 4;
+
+    /**
+     * Starts counting the audio blocks, before the audio driver is started
+     * @param audioDriver driver calling the scheduler at the end of each block
+     */
+    static void init(AudioDriver &audioDriver);
+
+    /**
+     * Adds a task called from the interrupt
+     * @param task task function, returning true if it woke up a higher priority thread
+     * @param periodBlocks period in audio blocks
+     * @param phase offset of the releases in audio blocks, to spread the tasks
+     * @return id of the task, -1 if there is no space
+     */
+    static int add(bool (*task)(size_t id), unsigned int periodBlocks, unsigned int phase = 0);
+
+    /**
+     * Adds a periodic thread, which then calls wait() at each period
+     * @param periodBlocks period in audio blocks
+     * @param phase offset of the releases in audio blocks, to spread the tasks
+     * @return id of the task, -1 if there is no space
+     */
+    static int addThread(unsigned int periodBlocks, unsigned int phase = 0);
+
+    /**
+     * Blocks the calling thread until the next release of its task,
+     * a release coming while the thread is running is counted as missed
+     * @param id id returned by addThread()
+     */
+    static void wait(int id);
+
+    /**
+     * Number of audio blocks played since init()
+     * @return block count, wrapping around
+     */
+    static inline uint32_t getBlocks() { return blocks; };
+
+    /**
+     * Statistics of a task, in clock cycles, read without disabling the interrupts
+     * @param id id of the task
+     * @return runs, missed releases and delays from the end of the block
+     */
+    static const PeriodicTaskStats &getStats(int id);
+
+    /**
+     * Prints the statistics of every task and the longest run of the
+     * interrupt, in microseconds, and clears them
+     */
+    static void print();
+
+    /**
+     * Counts an audio block and releases the tasks, called by the I2S DMA interrupt
+     */
+    static void IRQblock();
+
+    /**
+     * Interrupt handler implementation, called by TIM6_DAC_IRQHandler
+     */
+    static void IRQhandler();
+
+private:
+    /**
+     * Task waking up a periodic thread
+     */
+    static bool wakeThread(size_t id);
+
+    /**
+     * Scheduler of the tasks, clocked by the audio blocks
+     */
+    static PeriodicScheduler<MAX_TASKS, CycleCounter> scheduler;
+
+    /**
+     * Threads waiting for their release, indexed by task id
+     */
+    static miosix::Thread *waiting[MAX_TASKS];
+
+    /**
+     * Audio blocks played and clock at the end of the last one
+     */
+    static volatile uint32_t blocks;
+    static volatile uint32_t releaseTime;
+
+    /**
+     * Longest run of the tasks of a block since the last print(),
+     * and the block period, in clock cycles
+     */
+    static volatile uint32_t maxRunTime;
+    static uint32_t blockTime;
+
+    /**
+     * Static class, constructor disabled
+     */
+    BlockScheduler() = delete;
+
+    /**
+     * Static class, copy constructor disabled
+     */
+    BlockScheduler(const BlockScheduler &) = delete;
+
+    /**
+     * Static class, assignment operator disabled
+     */
+    BlockScheduler &operator=(const BlockScheduler &) = delete;
+};
+
+#endif //MIOSIX_DRUM_BLOCK_SCHEDULER_H
@@ -1,6 +1,6 @@
 #ifndef MIOSIX_DRUM_BUTTON_H
 #define MIOSIX_DRUM_BUTTON_H
-#include "../../../miosix/miosix.h"
+#include "registers.h"
 #include "utility.h"
 
 /**
@@ -13,6 +13,16 @@ template <uint32_t GPIO_BASE, int PIN>
 class Button
 {
 public:
+    /**
+     * GPIO base of the button
+     */
+    static constexpr uint32_t GPIO_ADDRESS = GPIO_BASE;
+
+    /**
+     * Pin of the button, also its EXTI line
+     */
+    static constexpr int PIN_NUMBER = PIN;
+
     /**
      * Function to be called to initialize the static class
      */
@@ -20,7 +30,7 @@ public:
     {
         {
             miosix::FastInterruptDisableLock dLock;
-            GPIO_TypeDef *GPIO = (GPIO_TypeDef *) GPIO_BASE;
+            GPIO_TypeDef *GPIO = peripheral<GPIO_TypeDef>(GPIO_BASE);
 
             // GPIO Setup
             GPIOUtility::enableRCC(GPIO);
@@ -34,18 +44,14 @@ public:
 
     /**
      * Get the current state of the button
+     * The input data register is read with a single load, which is atomic,
+     * so the interrupts are not disabled
      * @return true if the button is being pressed, false otherwise
      */
     static bool getState()
     {
-        bool currentState;
-        GPIO_TypeDef *GPIO = (GPIO_TypeDef *) GPIO_BASE;
-        {
-            miosix::FastInterruptDisableLock dLock;
-            currentState = (GPIO->IDR & (1 << PIN)) >> PIN;
-        }
-
-        return currentState;
+        GPIO_TypeDef *GPIO = peripheral<GPIO_TypeDef>(GPIO_BASE);
+        return (GPIO->IDR & (1 << PIN)) >> PIN;
     }
 
 private:
@@ -0,0 +1,129 @@
+#ifndef MIOSIX_DRUM_BUTTON_EVENTS_H
+#define MIOSIX_DRUM_BUTTON_EVENTS_H
+
+#include "../../../miosix/miosix.h"
+#include "../../config/hw_config.h"
+#include "../../containers/spsc_queue.h"
+#include "../common/debouncer.h"
+#include "cycle_counter.h"
+
+/**
+ * Static class generating debounced events from a set of Buttons.
+ * Every edge of a button raises an EXTI interrupt, which timestamps it
+ * with the DWT cycle counter and feeds it to the Debouncer of the button:
+ * a press is reported on its first edge, without waiting for the next poll.
+ * The events are pushed into a lock free queue and a listener is called,
+ * in interrupt context, to wake up the consumer.
+ *
+ * IRQtick() has to be called periodically, more often than the debounce
+ * time, to detect the long presses and the spikes. The EXTI interrupts have
+ * the same priority of the BlockScheduler, so the producers never preempt
+ * each other and the queue has a single producer.
+ *
+ * Each button uses the EXTI line of its pin number, so two buttons
+ * cannot use the same pin number on different ports.
+ */
+class ButtonEvents {
+public:
+    /**
+     * Initializes the event generation, to be called before adding the buttons
+     * @param eventListener called from the interrupts when events are available,
+     * returns true if it wakes up a higher priority thread
+     */
+    static void init(bool (*eventListener)());
+
+    /**
+     * Initializes a button and enables the interrupt of its edges
+     * @tparam BUTTON Button type
+     * @param id identifier of the button in its events
+     */
+    template<typename BUTTON>
+    static void add(uint8_t id)
+    {
+        BUTTON::init();
+        addLine(BUTTON::PIN_NUMBER, (BUTTON::GPIO_ADDRESS - GPIOA_BASE) / (GPIOB_BASE - GPIOA_BASE), id);
+    }
+
+    /**
+     * Removes the oldest event from the queue, to be called by a single consumer
+     * @param event where the event is copied
+     * @return false if there are no events
+     */
+    static bool pop(ButtonEvent &event) { return events.pop(event); }
+
+    /**
+     * Periodic check of the buttons, to be called from an interrupt
+     * with the same priority of the EXTI interrupts
+     * @return true if the listener woke up a higher priority thread
+     */
+    static bool IRQtick();
+
+    /**
+     * Interrupt handler implementation, called by the EXTI interrupts
+     */
+    static void IRQhandler();
+
+private:
+    /**
+     * Button connected to an EXTI line
+     */
+    struct Line {
+        Line() : gpio(nullptr), id(0), debouncer(BUTTON_DEBOUNCE_TIME * CycleCounter::getCyclesPerMs(),
+                                                 BUTTON_LONG_PRESS_TIME * CycleCounter::getCyclesPerMs()) {}
+
+        GPIO_TypeDef *gpio;
+        uint8_t id;
+        Debouncer debouncer;
+    };
+
+    /**
+     * Connects a button to the EXTI line of its pin
+     * @param line pin number of the button
+     * @param port GPIO port of the button, 0 for GPIOA
+     * @param id identifier of the button
+     */
+    static void addLine(unsigned int line, unsigned int port, uint8_t id);
+
+    /**
+     * Pushes an event and tells the listener
+     * @return true if the listener woke up a higher priority thread
+     */
+    static bool IRQpush(const Line &line, ButtonEvent::Type type, uint32_t time);
+
+    /**
+     * Buttons of each EXTI line
+     */
+    static Line lines[16];
+
+    /**
+     * Mask of the EXTI lines in use
+     */
+    static uint16_t lineMask;
+
+    /**
+     * Events waiting for the consumer
+     */
+    static SpscQueue<ButtonEvent, BUTTON_EVENT_QUEUE_SIZE> events;
+
+    /**
+     * Function waking up the consumer
+     */
+    static bool (*listener)();
+
+    /**
+     * Static class, constructor disabled
+     */
+    ButtonEvents() = delete;
+
+    /**
+     * Static class, copy constructor disabled
+     */
+    ButtonEvents(const ButtonEvents &) = delete;
+
+    /**
+     * Static class, assignment operator disabled
+     */
+    ButtonEvents &operator=(const ButtonEvents &) = delete;
+};
+
+#endif //MIOSIX_DRUM_BUTTON_EVENTS_H
@@ -0,0 +1,40 @@
+#ifndef MIOSIX_DRUM_CONTROL_PINS_H
+#define MIOSIX_DRUM_CONTROL_PINS_H
+
+#include "encoder.h"
+#include "button.h"
+#include "potentiometer.h"
+#include "adc_scanner.h"
+
+/**
+ * Pins of the control surface of the STM32F407 Discovery board, shared by
+ * the firmware and by the host simulation, which runs the same drivers on
+ * the fake registers.
+ */
+
+/**
+ * Encoders Pin Definition
+ */
+typedef Encoder<TIM1_BASE, GPIOE_BASE, 9, 11> encoder1;
+typedef Encoder<TIM3_BASE, GPIOB_BASE, 4, 5> encoder2;
+typedef Encoder<TIM4_BASE, GPIOD_BASE, 12, 13> encoder3;
+typedef Encoder<TIM5_BASE, GPIOA_BASE, 0, 1> encoder4;
+
+/**
+ * Buttons Pin Definition
+ */
+typedef Button<GPIOD_BASE, 0> button1;
+typedef Button<GPIOD_BASE, 1> button2;
+typedef Button<GPIOD_BASE, 2> button3;
+typedef Button<GPIOD_BASE, 3> button4;
+
+/**
+ * ADC Pin Definition
+ */
+typedef Potentiometer<GPIOA_BASE, 2, 2> slider1;
+typedef Potentiometer<GPIOA_BASE, 5, 5> slider2;
+typedef Potentiometer<GPIOA_BASE, 6, 6> slider3;
+typedef Potentiometer<GPIOA_BASE, 7, 7> slider4;
+typedef AdcScanner<slider1, slider2, slider3, slider4> sliders;
+
+#endif //MIOSIX_DRUM_CONTROL_PINS_H
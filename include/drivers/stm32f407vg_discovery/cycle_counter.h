@@ -0,0 +1,49 @@
+#ifndef MIOSIX_DRUM_CYCLE_COUNTER_H
+#define MIOSIX_DRUM_CYCLE_COUNTER_H
+
+#include "../../../miosix/miosix.h"
+
+/**
+ * Static class wrapping the DWT cycle counter of the Cortex-M4,
+ * which counts the core clock cycles (SystemCoreClock, 168MHz) and wraps
+ * around every ~25s. Differences of two readings are valid across a wrap.
+ */
+class CycleCounter {
+public:
+    /**
+     * Enables the trace unit and starts the counter. Calling it again
+     * does not reset the counter, so every user can initialize it.
+     */
+    static void init() {
+        if (DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk) return;
+        CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+        DWT->CYCCNT = 0;
+        DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    };
+
+    /**
+     * Reads the counter.
+     *
+     * @return current cycle count
+     */
+    static inline uint32_t read() { return DWT->CYCCNT; };
+
+    /**
+     * Converts the times to cycles with the clock configuration,
+     * SystemCoreClock is initialized before the constructors run.
+     *
+     * @return cycles in a millisecond
+     */
+    static inline uint32_t getCyclesPerMs() { return SystemCoreClock / 1000; };
+
+    /**
+     * Converts the cycles to times with the clock configuration.
+     *
+     * @return cycles in a microsecond
+     */
+    static inline uint32_t getCyclesPerUs() { return SystemCoreClock / 1000000; };
+
+    CycleCounter() = delete;
+};
+
+#endif //MIOSIX_DRUM_CYCLE_COUNTER_H
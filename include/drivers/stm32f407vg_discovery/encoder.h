@@ -1,7 +1,8 @@
 #ifndef MIOSIX_DRUM_ENCODER_H
 #define MIOSIX_DRUM_ENCODER_H
-#include "../../../miosix/miosix.h"
+#include <algorithm>
 #include <math.h>
+#include "registers.h"
 #include "utility.h"
 
 /**
@@ -20,8 +21,8 @@ public:
      */
     static void init()
     {
-        TIM_TypeDef* TIM = (TIM_TypeDef*) TIM_BASE;
-        GPIO_TypeDef* GPIO = (GPIO_TypeDef*) GPIO_BASE;
+        TIM_TypeDef* TIM = peripheral<TIM_TypeDef>(TIM_BASE);
+        GPIO_TypeDef* GPIO = peripheral<GPIO_TypeDef>(GPIO_BASE);
 
         {
             miosix::FastInterruptDisableLock dLock;
@@ -42,6 +43,7 @@ public:
             // Value to count up to
             TIM->ARR = 0xFFFF;
             TIM->CNT = 0x7FFF;
+            lastCount = 0x7FFF;
 
             // Setup (RM9000, pg. 616)
             TIM->CCMR1 |= (TIM_CCMR1_CC1S_0 | TIM_CCMR1_CC2S_0);
@@ -77,16 +79,25 @@ public:
      */
     static float getIncrement()
     {
-        TIM_TypeDef* TIM = (TIM_TypeDef*) TIM_BASE;
-        uint16_t counterValue;
-        {
-            miosix::FastInterruptDisableLock dLock;
-            // Read Counter
-            counterValue = TIM->CNT;
-            // Reset Counter
-            TIM->CNT = 0x7FFF;
-        }
-        return (counterValue - 0x7FFF) / 5000.0f;
+        return getCountIncrement() / 5000.0f;
+    }
+
+    /**
+     * Get the timer counts since the previous call, four for each detent
+     * of a standard encoder, to be converted with an EncoderAcceleration.
+     * The counter is never written: a single read takes a snapshot of it and
+     * the increment is the difference with the previous snapshot, modulo 2^16.
+     * No step can be lost between a read and a reset, and the interrupts
+     * are not disabled
+     * @return Signed counts
+     */
+    static int16_t getCountIncrement()
+    {
+        TIM_TypeDef* TIM = peripheral<TIM_TypeDef>(TIM_BASE);
+        uint16_t counterValue = TIM->CNT;
+        int16_t counts = static_cast<int16_t>(counterValue - lastCount);
+        lastCount = counterValue;
+        return counts;
     }
 
 private:
@@ -109,6 +120,11 @@ private:
      * Current Stored Value
       */
     static float value;
+
+    /**
+     * Counter snapshot taken by the last call to getIncrement
+     */
+    static uint16_t lastCount;
 };
 
 /**
@@ -117,4 +133,7 @@ private:
 template <uint32_t TIM_BASE, uint32_t GPIO_BASE, int PIN1, int PIN2>
 float Encoder<TIM_BASE, GPIO_BASE, PIN1, PIN2>::value = 0.0f;
 
+template <uint32_t TIM_BASE, uint32_t GPIO_BASE, int PIN1, int PIN2>
+uint16_t Encoder<TIM_BASE, GPIO_BASE, PIN1, PIN2>::lastCount = 0x7FFF;
+
 #endif //MIOSIX_DRUM_ENCODER_H
@@ -0,0 +1,154 @@
+#ifndef MIOSIX_DRUM_HD44780_DISPLAY_H
+#define MIOSIX_DRUM_HD44780_DISPLAY_H
+
+#include "../../../miosix/miosix.h"
+#include "../common/lcd_framebuffer.h"
+#include "../common/hd44780_writer.h"
+#include "hd44780_timer.h"
+
+/**
+ * Templated static class driving an HD44780 character LCD in 4 bit mode
+ * without blocking the calling thread.
+ * The pages are drawn into a LcdFramebuffer, and update() starts the
+ * Hd44780Timer interrupt, which sends only the characters that changed
+ * since the last update, one bus operation per tick. Only the
+ * initialization uses busy delays, and it runs once in thread context.
+ * The frame has to be drawn by a single thread
+ * @tparam RS register select pin, a miosix::Gpio
+ * @tparam E enable pin, a miosix::Gpio
+ * @tparam D4 data pin 4, a miosix::Gpio
+ * @tparam D5 data pin 5, a miosix::Gpio
+ * @tparam D6 data pin 6, a miosix::Gpio
+ * @tparam D7 data pin 7, a miosix::Gpio
+ * @tparam ROWS number of rows of the display
+ * @tparam COLS number of columns of the display
+ */
+template<typename RS, typename E, typename D4, typename D5, typename D6, typename D7,
+        size_t ROWS, size_t COLS>
+class Hd44780Display {
+public:
+    /**
+     * Initializes the pins and the LCD, then starts sending the blank frame.
+     * Called once from a thread, it sleeps about 60ms
+     */
+    static void init() {
+        RS::mode(miosix::Mode::OUTPUT);
+        E::mode(miosix::Mode::OUTPUT);
+        D4::mode(miosix::Mode::OUTPUT);
+        D5::mode(miosix::Mode::OUTPUT);
+        D6::mode(miosix::Mode::OUTPUT);
+        D7::mode(miosix::Mode::OUTPUT);
+        E::low();
+        miosix::Thread::sleep(50);
+
+        // Same initialization sequence of miosix::Lcd44780, switching to 4 bit mode
+        Bus::write(false, 0x2);
+        pulse();
+        miosix::delayUs(50);
+        sendBlocking(false, (ROWS == 1) ? 0x20 : 0x28); //Function set, 4 bit, lines
+        miosix::Thread::sleep(5);
+        sendBlocking(false, 0x0C);                       //Display on, cursor off
+        sendBlocking(false, 0x06);                       //Entry mode, increment
+        sendBlocking(false, 0x01);                       //Clear
+        miosix::Thread::sleep(2);
+
+        writer.reset();
+        Hd44780Timer::init(step);
+        update();
+    }
+
+    /**
+     * Frame displayed by the LCD, drawn by the thread
+     * @return framebuffer
+     */
+    static LcdFramebuffer<ROWS, COLS> &frame() { return framebuffer; }
+
+    /**
+     * Sends the changes of the frame to the LCD, returning immediately
+     */
+    static void update() {
+        if (framebuffer.isDirty()) Hd44780Timer::start();
+    }
+
+private:
+    /**
+     * Bus policy of the Hd44780Writer, driving the GPIOs
+     */
+    struct Bus {
+        static void write(bool rs, uint8_t nibble) {
+            if (rs) RS::high(); else RS::low();
+            if (nibble & 0x1) D4::high(); else D4::low();
+            if (nibble & 0x2) D5::high(); else D5::low();
+            if (nibble & 0x4) D6::high(); else D6::low();
+            if (nibble & 0x8) D7::high(); else D7::low();
+        }
+
+        static void enable(bool high) {
+            if (high) E::high(); else E::low();
+        }
+    };
+
+    /**
+     * Latches the nibble on the bus, used by the initialization only
+     */
+    static void pulse() {
+        miosix::delayUs(1);
+        Bus::enable(true);
+        miosix::delayUs(1);
+        Bus::enable(false);
+    }
+
+    /**
+     * Sends a byte waiting for its execution, used by the initialization only
+     * @param rs true for a character, false for a command
+     * @param byte byte to send
+     */
+    static void sendBlocking(bool rs, uint8_t byte) {
+        Bus::write(rs, byte >> 4);
+        pulse();
+        Bus::write(rs, byte & 0x0F);
+        pulse();
+        miosix::delayUs(50);
+    }
+
+    /**
+     * Step of the transfer, called by the Hd44780Timer interrupt
+     * @return false when the LCD shows the whole frame
+     */
+    static bool step() { return writer.step(); }
+
+    /**
+     * Frame drawn by the thread
+     */
+    static LcdFramebuffer<ROWS, COLS> framebuffer;
+
+    /**
+     * Transfer state machine, advanced by the timer interrupt
+     */
+    static Hd44780Writer<Bus, ROWS, COLS> writer;
+
+    /**
+     * Static class, constructor disabled
+     */
+    Hd44780Display() = delete;
+
+    /**
+     * Static class, copy constructor disabled
+     */
+    Hd44780Display(const Hd44780Display &) = delete;
+
+    /**
+     * Static class, assignment operator disabled
+     */
+    Hd44780Display &operator=(const Hd44780Display &) = delete;
+};
+
+template<typename RS, typename E, typename D4, typename D5, typename D6, typename D7, size_t ROWS, size_t COLS>
+LcdFramebuffer<ROWS, COLS> Hd44780Display<RS, E, D4, D5, D6, D7, ROWS, COLS>::framebuffer;
+
+template<typename RS, typename E, typename D4, typename D5, typename D6, typename D7, size_t ROWS, size_t COLS>
+Hd44780Writer<typename Hd44780Display<RS, E, D4, D5, D6, D7, ROWS, COLS>::Bus, ROWS, COLS>
+        Hd44780Display<RS, E, D4, D5, D6, D7, ROWS, COLS>::writer(
+        Hd44780Display<RS, E, D4, D5, D6, D7, ROWS, COLS>::framebuffer);
+
+#endif //MIOSIX_DRUM_HD44780_DISPLAY_H
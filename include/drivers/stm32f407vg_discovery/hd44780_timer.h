@@ -0,0 +1,65 @@
+#ifndef MIOSIX_DRUM_HD44780_TIMER_H
+#define MIOSIX_DRUM_HD44780_TIMER_H
+
+#include "../../../miosix/miosix.h"
+
+/**
+ * Static class clocking the non blocking transfer to the HD44780 LCD:
+ * TIM14 calls a step function every TICK_US, until it returns false.
+ * The timer only runs while there is something to send, and it is
+ * started again by start() when the frame changes.
+ * The step function runs in interrupt context, it does not wake up threads.
+ */
+class Hd44780Timer {
+public:
+    /**
+     * Tick period in microseconds, the setup and enable pulse time of the bus
+     */
+    static constexpr unsigned int TICK_US = 20;
+
+    /**
+     * Configures the timer, which is stopped
+     * @param stepFunction function advancing the transfer, called from the interrupt,
+     * returning false when there is nothing left to send
+     */
+    static void init(bool (*stepFunction)());
+
+    /**
+     * Starts the ticks if they are stopped, called after changing the frame
+     */
+    static void start();
+
+    /**
+     * Checks if the ticks are running
+     * @return true while the transfer is in progress
+     */
+    static bool isRunning();
+
+    /**
+     * Interrupt handler implementation, called by TIM8_TRG_COM_TIM14_IRQHandler
+     */
+    static void IRQhandler();
+
+private:
+    /**
+     * Function advancing the transfer
+     */
+    static bool (*step)();
+
+    /**
+     * Static class, constructor disabled
+     */
+    Hd44780Timer() = delete;
+
+    /**
+     * Static class, copy constructor disabled
+     */
+    Hd44780Timer(const Hd44780Timer &) = delete;
+
+    /**
+     * Static class, assignment operator disabled
+     */
+    Hd44780Timer &operator=(const Hd44780Timer &) = delete;
+};
+
+#endif //MIOSIX_DRUM_HD44780_TIMER_H
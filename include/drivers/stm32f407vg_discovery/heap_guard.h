@@ -0,0 +1,63 @@
+#ifndef MIOSIX_DRUM_HEAP_GUARD_H
+#define MIOSIX_DRUM_HEAP_GUARD_H
+
+#include <cstddef>
+
+/**
+ * Static class trapping the heap allocations done while the audio is
+ * running. When HEAP_GUARD_ENABLED is set the global operator new and
+ * the newlib allocator behind malloc, calloc and realloc are wrapped, and
+ * once the guard is armed any allocation prints its size and the address
+ * of its caller on the serial console and stops the system with the
+ * interrupts disabled, so that a debugger attached to the board shows the
+ * allocating code in the backtrace.
+ * The diagnostic threads call allowMalloc(), since newlib allocates the
+ * stdout buffer and the numbers of the float conversions of their printf
+ * on first use.
+ */
+class HeapGuard {
+public:
+    /**
+     * Arms the guard, called once every object has been built, right
+     * before the audio driver is started. Does nothing if the guard
+     * is not enabled
+     */
+    static void arm();
+
+    /**
+     * @return true if the guard is armed
+     */
+    static bool isArmed();
+
+    /**
+     * Lets the calling thread use malloc after the guard is armed, up to
+     * HEAP_GUARD_MAX_ALLOWED_THREADS threads. Its operator new is still
+     * trapped. Does nothing if the guard is not enabled
+     */
+    static void allowMalloc();
+
+    /**
+     * Trap implementation, called by operator new and malloc once the guard is armed
+     * @param size size of the allocation
+     * @param caller return address of operator new
+     */
+    [[noreturn]] static void trap(size_t size, void *caller);
+
+private:
+    /**
+     * Static class, constructor disabled
+     */
+    HeapGuard() = delete;
+
+    /**
+     * Static class, copy constructor disabled
+     */
+    HeapGuard(const HeapGuard &) = delete;
+
+    /**
+     * Static class, assignment operator disabled
+     */
+    HeapGuard &operator=(const HeapGuard &) = delete;
+};
+
+#endif //MIOSIX_DRUM_HEAP_GUARD_H
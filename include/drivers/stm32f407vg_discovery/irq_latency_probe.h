@@ -0,0 +1,77 @@
+#ifndef MIOSIX_DRUM_IRQ_LATENCY_PROBE_H
+#define MIOSIX_DRUM_IRQ_LATENCY_PROBE_H
+
+#include "../../../miosix/miosix.h"
+#include "../common/latency_stats.h"
+
+/**
+ * Static class measuring the worst interrupt latency of the system.
+ * TIM7 raises an interrupt every PERIOD_CYCLES core cycles, and its handler
+ * timestamps the entry with the DWT CycleCounter. Since the timer and the
+ * core share the same clock, any lateness of an entry compared to the
+ * previous ones is caused by the code that kept the interrupt waiting.
+ * The interrupt has the highest priority, but with the priority grouping 7
+ * set by the kernel no handler preempts another: the probe waits both for
+ * the code running with the interrupts disabled and for any handler already
+ * running, the I2S DMA, SysTick, TIM6 block tasks, EXTI and TIM14 ones.
+ * The worst latency is therefore the longest masked section or handler,
+ * which is also the worst delay these add to the I2S DMA interrupt feeding
+ * the audio; IRQTrace tells which of them it was.
+ */
+class IrqLatencyProbe {
+public:
+    /**
+     * Period of the probe interrupt, in core cycles (100us)
+     */
+    static constexpr uint32_t PERIOD_CYCLES = 16800;
+
+    /**
+     * Starts the cycle counter and the probe interrupt
+     */
+    static void init();
+
+    /**
+     * Statistics of the probe interrupt, updated by its handler
+     * @return latency statistics, in core cycles
+     */
+    static const LatencyStats &getStats() { return stats; }
+
+    /**
+     * Restarts the measure from the next interrupt
+     */
+    static void reset();
+
+    /**
+     * Prints the worst latency measured so far on the serial console,
+     * caused by masked sections or by other handlers
+     */
+    static void print();
+
+    /**
+     * Interrupt handler implementation, called by TIM7_IRQHandler
+     */
+    static void IRQhandler();
+
+private:
+    /**
+     * Statistics of the probe interrupt
+     */
+    static LatencyStats stats;
+
+    /**
+     * Static class, constructor disabled
+     */
+    IrqLatencyProbe() = delete;
+
+    /**
+     * Static class, copy constructor disabled
+     */
+    IrqLatencyProbe(const IrqLatencyProbe &) = delete;
+
+    /**
+     * Static class, assignment operator disabled
+     */
+    IrqLatencyProbe &operator=(const IrqLatencyProbe &) = delete;
+};
+
+#endif //MIOSIX_DRUM_IRQ_LATENCY_PROBE_H
@@ -0,0 +1,42 @@
+#ifndef MIOSIX_DRUM_MEMORY_SECTIONS_H
+#define MIOSIX_DRUM_MEMORY_SECTIONS_H
+
+/**
+ * Linker section annotations for the STM32F407VG memories.
+ *
+ * The 64KB core coupled memory (CCM, 0x10000000) is accessed by the CPU
+ * with zero wait states and without contending the bus matrix with the DMA,
+ * but it is not visible by the DMA controllers. Use CCM_RAM for DSP state,
+ * tables and scratch buffers, and DMA_RAM for every buffer that is read or
+ * written by a DMA stream, which is placed in the 128KB main SRAM.
+ *
+ * Objects placed with CCM_RAM are zeroed at boot like .bss, objects placed
+ * with DMA_RAM are not initialized, and must be initialized by their owner.
+ * THREAD_STACK places the miosix::ThreadMemory of the threads created with
+ * a static stack in the main SRAM too, in their own section so that their
+ * total size shows in the link map, and they are not initialized either.
+ */
+
+#ifdef MIOSIX_DRUM_FAKE_REGISTERS
+// the host tests have a single memory
+#define CCM_RAM
+#define DMA_RAM
+#define THREAD_STACK
+#else
+/**
+ * Places a variable in the core coupled memory.
+ */
+#define CCM_RAM __attribute__((section(".ccmram")))
+
+/**
+ * Places a variable in the main SRAM, reachable by the DMA.
+ */
+#define DMA_RAM __attribute__((section(".dmaram")))
+
+/**
+ * Places the memory of a thread in the main SRAM, in the .threadstacks section.
+ */
+#define THREAD_STACK __attribute__((section(".threadstacks")))
+#endif
+
+#endif //MIOSIX_DRUM_MEMORY_SECTIONS_H
@@ -1,8 +1,8 @@
 #ifndef MIOSIX_DRUM_POTENTIOMETER_H
 #define MIOSIX_DRUM_POTENTIOMETER_H
 
-#include "../../../miosix/miosix.h"
 #include "../../config/hw_config.h"
+#include "registers.h"
 #include "utility.h"
 
 #if ADC_RESOLUTION == 0
@@ -18,10 +18,11 @@
 #endif
 
 /**
- * Templated static class that allows to initialize
- * and get the state of an ADC1 channel from a pin at any given time
+ * Templated static class describing a potentiometer connected to an ADC1 channel.
  * In order to choose a pin, please refer to the datasheet,
- * searching for ADC1 available pins, and choosing the right ADC_CHANNEL related to them
+ * searching for ADC1 available pins, and choosing the right ADC_CHANNEL related to them.
+ * The conversions are performed by an AdcScanner, that reads all
+ * its potentiometers in a single DMA driven scan sequence.
  * @tparam GPIO_BASE GPIO base for ADC pin
  * @tparam PIN GPIO pin to be used as ADC input
  * @tparam ADC_CHANNEL ADC channel related to the pin (See Datasheet)
@@ -32,94 +33,29 @@ class Potentiometer
 public:
 
     /**
-     * Static function used to initialize the ADC and the relative pins
+     * ADC channel of the potentiometer
      */
-    static void init()
+    static constexpr uint8_t CHANNEL = ADC_CHANNEL;
+
+    /**
+     * Static function used to set the pin in analog mode
+     */
+    static void initPin()
     {
-        GPIO_TypeDef* GPIO = (GPIO_TypeDef*) GPIO_BASE;
+        GPIO_TypeDef* GPIO = peripheral<GPIO_TypeDef>(GPIO_BASE);
         {
             miosix::FastInterruptDisableLock dLock;
 
-            // Enable ADC1 Clock
-            RCC->APB2ENR |= (1 << 8);
-
             // Enable GPIO clock
             GPIOUtility::enableRCC(GPIO);
 
-            // Prescaler
-            ADC->CCR = (2 << 16);
-
-            // Resolution
-            ADC1->CR1 |= (1 << 8);  // Scan Mode
-            ADC1->CR1 |= (ADC_RESOLUTION << 24); // 8-bit resolution
-
-            // Data Alignment
-            ADC1->CR2 &= ~(1 << 11); // Left aligned
-            ADC1->CR2 |= (1 << 10);  // EOC bit is set at the end of each regular conversion
-            ADC1->CR2 |= (1 << 1);   // Continuous conversion mode
-
-            // Sampling time for adc channel
-            ADC1->SMPR2 |= (1 << 3 * ADC_CHANNEL);
-
-            // Sequence for 1 channel conversions
-            ADC1->SQR1 |= (1 << 1);
-
             // Analog Mode
             GPIO->MODER |= (3 << PIN * 2);
-
-            //Enable
-            ADC1->CR2 |= 1 << 0;
-
-            // Wait to stabilize ADC
-            miosix::delayUs(100);
         }
     }
 
-    /**
-     * Read values from the ADC and update the current state
-     * @return Data read from the ADC channel, averaged to filter out some noise
-     */
-    static float read()
-    {
-        // Averaging
-        float result = 0;
-        for (int i = 0; i < ADC_AVG_SAMPLES; ++i)
-            result += readChannel();
-
-        result /= (float) ADC_AVG_SAMPLES;
-        result /= ADC_MAX_VALUE;
-        return result;
-    }
-
 private:
 
-    /**
-     * Performs a single read from the specified channel
-     * @param channel Channel in which to perform the read operation
-     * @return Value read from the ADC channel
-     */
-    static uint16_t readChannel()
-    {
-        miosix::FastInterruptDisableLock dLock;
-        // Clear sequence register
-        ADC1->SQR3 = 0;
-
-        // Conversion of just one channel in a regular sequence
-        ADC1->SQR3 |= (ADC_CHANNEL << 0);
-
-        // Clear status register
-        ADC1->SR = 0;
-
-        // start the conversion
-        ADC1->CR2 |= (1<<30);
-
-        //wait for the conversion to finish (EOC)
-        while (!(ADC1->SR & (1<<1)));
-
-        //Extract val from DataRegister
-        return  (ADC1->DR);
-    }
-
     /**
      * Static class, constructor disabled
      */
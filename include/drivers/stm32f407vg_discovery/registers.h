@@ -0,0 +1,29 @@
+#ifndef MIOSIX_DRUM_REGISTERS_H
+#define MIOSIX_DRUM_REGISTERS_H
+
+/**
+ * Access to the peripheral registers for the hardware input drivers.
+ * On the target the registers are the memory mapped ones of the CMSIS
+ * headers. The host tests define MIOSIX_DRUM_FAKE_REGISTERS and provide
+ * fake_registers.h, which maps the same base addresses to plain memory,
+ * so the driver templates compile and run on the host unchanged.
+ */
+#ifdef MIOSIX_DRUM_FAKE_REGISTERS
+#include "fake_registers.h"
+#else
+#include "../../../miosix/miosix.h"
+
+/**
+ * Registers of a peripheral
+ * @tparam T register block, e.g. TIM_TypeDef
+ * @param base base address of the peripheral
+ * @return pointer to the registers
+ */
+template<typename T>
+inline T *peripheral(uint32_t base)
+{
+    return reinterpret_cast<T *>(base);
+}
+#endif
+
+#endif //MIOSIX_DRUM_REGISTERS_H
@@ -0,0 +1,118 @@
+#ifndef MIOSIX_DRUM_STATIC_THREAD_H
+#define MIOSIX_DRUM_STATIC_THREAD_H
+
+#include "../../../miosix/miosix.h"
+#include "memory_sections.h"
+
+/**
+ * Thread of the application with a statically allocated stack and a fixed
+ * priority, created by miosix::Thread::createStatic instead of std::thread,
+ * which goes through pthread and allocates a stack of the default size in
+ * the heap. Each thread has its own stack size, and its memory is declared
+ * with THREAD_STACK, so the RAM of every thread shows in the link map:
+ *
+ *     THREAD_STACK static miosix::ThreadMemory<1024> midiStack;
+ *     static StaticThread midiThread("midi", midiStack, midiProcessing, MIDI_THREAD_PRIORITY);
+ *
+ * The threads are linked in a list in the order of their construction,
+ * startAll() starts them and report() prints their stack usage.
+ */
+class StaticThread {
+public:
+    /**
+     * Constructor, the thread is started by start() or startAll()
+     *
+     * @param name name of the thread in the reports
+     * @param memory statically allocated memory of the thread
+     * @param function entry point of the thread
+     * @param priority fixed priority, or the order among the background threads with EDF
+     */
+    template<unsigned int STACK_SIZE>
+    StaticThread(const char *name, miosix::ThreadMemory<STACK_SIZE> &memory, void (*function)(), short priority)
+            : StaticThread(name, memory.words, STACK_SIZE, function, priority) {};
+
+    /**
+     * Starts the thread, detached. Its function must never return, as
+     * its memory cannot be reused
+     *
+     * @return false if the thread is already started or the kernel cannot add it
+     */
+    bool start();
+
+    /**
+     * Starts every thread not started yet, in the order of their construction
+     *
+     * @return false if a thread could not be started
+     */
+    static bool startAll();
+
+    /**
+     * Prints the stack size and the highest stack usage of every thread
+     */
+    static void report();
+
+    /**
+     * @return the kernel thread, nullptr if not started
+     */
+    inline miosix::Thread *getThread() const { return thread; };
+
+    /**
+     * @return the name of the thread
+     */
+    inline const char *getName() const { return name; };
+
+    /**
+     * @return the stack size in bytes
+     */
+    inline unsigned int getStackSize() const { return stackSize; };
+
+    /**
+     * @return the highest stack usage in bytes, measured from the fill pattern
+     */
+    unsigned int getStackUsed() const;
+
+    /**
+     * @return false if the watermark below the stack was overwritten
+     */
+    bool isWatermarkOk() const;
+
+    /**
+     * @return the first thread constructed, nullptr if none
+     */
+    inline static StaticThread *getFirst() { return first; };
+
+    /**
+     * @return the thread constructed after this one, nullptr if none
+     */
+    inline StaticThread *getNext() const { return next; };
+
+private:
+    StaticThread(const char *name, unsigned int *memory, unsigned int stackSize, void (*function)(),
+                 short priority);
+
+    StaticThread(const StaticThread &) = delete;
+
+    StaticThread &operator=(const StaticThread &) = delete;
+
+    /**
+     * Entry point of every thread, calls the function of the StaticThread
+     * @param argv the StaticThread
+     */
+    static void *launch(void *argv);
+
+    const char *name;
+    unsigned int *memory;
+    unsigned int stackSize;
+    void (*function)();
+    short priority;
+    miosix::Thread *thread;
+    StaticThread *next;
+
+    /**
+     * List of the threads, zero initialized before any constructor runs
+     */
+    static StaticThread *first;
+    static StaticThread *last;
+};
+
+#endif //MIOSIX_DRUM_STATIC_THREAD_H
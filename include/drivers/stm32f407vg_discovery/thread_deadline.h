@@ -0,0 +1,51 @@
+#ifndef MIOSIX_DRUM_THREAD_DEADLINE_H
+#define MIOSIX_DRUM_THREAD_DEADLINE_H
+
+#include "../../../miosix/miosix.h"
+#include "../../config/audio_config.h"
+#include "../../config/thread_priorities.h"
+#include "../common/block_deadline.h"
+
+/**
+ * Static class setting the urgency of the threads for the scheduler
+ * selected in miosix_settings.h, so the threads are written once for both.
+ *
+ * With SCHED_TYPE_PRIORITY a thread has a fixed priority, and a release
+ * only wakes it up. With SCHED_TYPE_EDF a thread released at the end of an
+ * audio block gets the deadline of the blocks within which it is due, set
+ * by the interrupt releasing it so that the scheduler compares the new
+ * deadline, and the other threads have background deadlines.
+ */
+class ThreadDeadline {
+public:
+    /**
+     * Deadlines of the audio blocks, in kernel ticks
+     */
+    typedef BlockDeadline<AUDIO_DRIVER_BUFFER_SIZE, AUDIO_DRIVER_SAMPLE_RATE, miosix::TICK_FREQ> Deadlines;
+
+    /**
+     * Sets the urgency of the calling thread, at its start
+     * @param priority fixed priority, or the order among the background threads with EDF
+     */
+    static void set(short priority);
+
+    /**
+     * Urgency of a thread for the selected scheduler, to create it with
+     * @param priority fixed priority, or the order among the background threads with EDF
+     * @return priority of the kernel thread
+     */
+    static miosix::Priority getPriority(short priority);
+
+    /**
+     * Wakes up a thread waiting for its release, called in an interrupt
+     * at the end of an audio block. The thread must not hold a mutex
+     * @param thread released thread
+     * @param blocks audio blocks within which the thread is due, used with EDF
+     * @return true if the thread is more urgent than the running one
+     */
+    static bool IRQrelease(miosix::Thread *thread, unsigned int blocks);
+
+    ThreadDeadline() = delete;
+};
+
+#endif //MIOSIX_DRUM_THREAD_DEADLINE_H
@@ -1,6 +1,6 @@
 #ifndef MIOSIX_DRUM_UTILITY_H
 #define MIOSIX_DRUM_UTILITY_H
-#include "../../../miosix/miosix.h"
+#include "registers.h"
 
 /**
  * Namespace containing utility functions related to GPIOs
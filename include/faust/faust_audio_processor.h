@@ -4,8 +4,16 @@
 #include "../audio/audio_processor.h"
 #include "../config/audio_config.h"
 #include "../config/parameter_config.h"
+#include "../containers/parameter_mailbox.h"
 #include "faust_synth.h"
 
+/**
+ * AudioProcessor running the Faust synthesizer.
+ * The setters can be called from any thread or interrupt, each parameter
+ * being set by a single one: the values are posted in a ParameterMailbox
+ * and applied by the audio thread at the beginning of the next block,
+ * so the Faust zones are only written by the audio thread
+ */
 class FaustAudioProcessor : public AudioProcessor {
 public:
     /**
@@ -16,7 +24,7 @@ public:
     FaustAudioProcessor(AudioDriver &audioDriver);
 
     /**
-     * Process buffers
+     * Applies the pending parameter values and processes the buffers
      */
     void process() override;
 
@@ -49,32 +57,12 @@ public:
     void setSlider4(float value);
 
     /**
-     * Set encoder 1 value, mappings between encoder and faust parameters
-     * can be made through the parameter_config.h file
-     * @param value Slider value between 0 and 1
-     */
-    void setEncoder1(float value);
-
-    /**
-     * Set encoder 2 value, mappings between encoder and faust parameters
-     * can be made through the parameter_config.h file
-     * @param value Slider value between 0 and 1
-     */
-    void setEncoder2(float value);
-
-    /**
-     * Set encoder 3 value, mappings between encoder and faust parameters
-     * can be made through the parameter_config.h file
-     * @param value Slider value between 0 and 1
+     * Set the value of any Faust parameter, used by the LCD menu to reach
+     * the parameters not mapped to a physical control
+     * @param index index of the parameter in the Faust UI, invalid indexes are ignored
+     * @param value value in the units of the parameter
      */
-    void setEncoder3(float value);
-
-    /**
-     * Set encoder 4 value, mappings between encoder and faust parameters
-     * can be made through the parameter_config.h file
-     * @param value Slider value between 0 and 1
-     */
-    void setEncoder4(float value);
+    void setParameter(int index, float value);
 
     /**
      * Set button 1 value, mappings between button and faust parameters
@@ -114,16 +102,91 @@ public:
      */
     void gateOff();
 
+    /**
+     * Faust UI, describing the parameters of the synth
+     * @return Faust UI control, whose metadata can be read by any thread
+     */
+    const MiosixUI &getUI() const { return control; }
+
+    /**
+     * Index of the Faust parameter mapped to a slider
+     * @param slider slider, from 0
+     * @return index of the parameter in the Faust UI, -1 if not mapped
+     */
+    int getSliderParameter(int slider) const;
+
+    /**
+     * Value sent to the synth for a slider position, as done by the slider setters
+     * @param slider slider, from 0
+     * @param position slider position between 0 and 1
+     * @return value in the units of the mapped parameter
+     */
+    float getSliderValue(int slider, float position) const;
+
+    /**
+     * Slider position sending a value to the synth, used to hold the
+     * sliders on the values set by the synth until they pick them up
+     * @param slider slider, from 0
+     * @param value value in the units of the mapped parameter
+     * @return slider position, clipped between 0 and 1
+     */
+    float getSliderPosition(int slider, float value) const;
+
+    /**
+     * Checks if a Faust parameter is mapped to a slider, a button or the gate
+     * @param index index of the parameter in the Faust UI
+     * @return true if the parameter has its own control
+     */
+    bool isMapped(int index) const;
+
 private:
     /**
-     * Faust processor coming from the compilation of faust_synth.dsp
+     * Parameters mapped to the physical controls and the MIDI
+     */
+    enum Parameter {
+        SLIDER1, SLIDER2, SLIDER3, SLIDER4,
+        BUTTON1, BUTTON2, BUTTON3, BUTTON4,
+        GATE,
+        PARAMETER_NUM
+    };
+
+    /**
+     * Posts the value of a Faust parameter, invalid indexes are ignored
+     * @param index index of the parameter in the Faust UI
+     * @param value value in the units of the parameter
      */
-    FaustSynth synth;
+    void post(int index, float value);
+
+    /**
+     * Static arena holding the Faust processor and its tables,
+     * no heap allocation is performed by the Faust code.
+     * Being a member, it lives in the same memory of the FaustAudioProcessor
+     * instance (the core coupled memory when declared with CCM_RAM)
+     */
+    StaticMemoryManager<FAUST_MEMORY_ARENA_SIZE> memoryManager;
+
+    /**
+     * Faust processor coming from the compilation of faust_synth.dsp,
+     * allocated inside memoryManager
+     */
+    FaustSynth *synth;
 
     /**
      * Faust UI control coming from the compilation of faust_synth.dsp
      */
-    MapUI control;
+    MiosixUI control;
+
+    /**
+     * Indexes of the Faust parameters mapped to the controls,
+     * resolved once from the paths in parameter_config.h
+     */
+    int parameterIndex[PARAMETER_NUM];
+
+    /**
+     * Values set by the control surface, the LCD menu and the MIDI,
+     * waiting for the next block, with a slot for each Faust parameter
+     */
+    ParameterMailbox<FAUST_UI_MAX_PARAMS> mailbox;
 
     /**
      * Array containing the output buffer raw pointers to be passed to faust
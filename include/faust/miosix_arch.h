@@ -0,0 +1,402 @@
+#ifndef MIOSIX_DRUM_MIOSIX_ARCH_H
+#define MIOSIX_DRUM_MIOSIX_ARCH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <array>
+#include "../config/audio_config.h"
+#include "../containers/memory_pool.h"
+
+/**
+ * Faust architecture definitions tailored for Miosix.
+ * It replaces the generic misc.h, MapUI.h and dsp.h headers so that the
+ * generated code does not depend on std::map, std::string or the heap,
+ * and it is included by the code generated from src/faust/arch.cpp.
+ */
+
+#ifndef FAUSTFLOAT
+#define FAUSTFLOAT float
+#endif
+
+/**
+ * Soundfiles are not supported, the struct is only
+ * declared to match the signature used by Faust.
+ */
+struct Soundfile;
+
+/**
+ * Metadata interface, used by the metadata() method of the generated DSP.
+ */
+struct Meta {
+    virtual ~Meta() {};
+
+    virtual void declare(const char *key, const char *value) = 0;
+};
+
+/**
+ * User Interface interface, used by the buildUserInterface() method
+ * of the generated DSP. Its methods are only called once during the setup,
+ * never while computing audio.
+ */
+struct UI {
+    virtual ~UI() {}
+
+    // -- widget's layouts
+    virtual void openTabBox(const char *label) = 0;
+
+    virtual void openHorizontalBox(const char *label) = 0;
+
+    virtual void openVerticalBox(const char *label) = 0;
+
+    virtual void closeBox() = 0;
+
+    // -- active widgets
+    virtual void addButton(const char *label, FAUSTFLOAT *zone) = 0;
+
+    virtual void addCheckButton(const char *label, FAUSTFLOAT *zone) = 0;
+
+    virtual void addVerticalSlider(const char *label, FAUSTFLOAT *zone, FAUSTFLOAT init,
+                                   FAUSTFLOAT min, FAUSTFLOAT max, FAUSTFLOAT step) = 0;
+
+    virtual void addHorizontalSlider(const char *label, FAUSTFLOAT *zone, FAUSTFLOAT init,
+                                     FAUSTFLOAT min, FAUSTFLOAT max, FAUSTFLOAT step) = 0;
+
+    virtual void addNumEntry(const char *label, FAUSTFLOAT *zone, FAUSTFLOAT init,
+                             FAUSTFLOAT min, FAUSTFLOAT max, FAUSTFLOAT step) = 0;
+
+    // -- passive widgets
+    virtual void addHorizontalBargraph(const char *label, FAUSTFLOAT *zone, FAUSTFLOAT min, FAUSTFLOAT max) = 0;
+
+    virtual void addVerticalBargraph(const char *label, FAUSTFLOAT *zone, FAUSTFLOAT min, FAUSTFLOAT max) = 0;
+
+    // -- soundfiles
+    virtual void addSoundfile(const char *label, const char *filename, Soundfile **sfZone) = 0;
+
+    // -- metadata declarations
+    virtual void declare(FAUSTFLOAT * /*zone*/, const char * /*key*/, const char * /*val*/) {}
+};
+
+/**
+ * DSP memory manager, used by the generated code (compiled with -mem)
+ * to allocate the static tables and the DSP instances.
+ */
+struct dsp_memory_manager {
+    virtual ~dsp_memory_manager() {}
+
+    virtual void *allocate(size_t size) = 0;
+
+    virtual void destroy(void *ptr) = 0;
+};
+
+/**
+ * Base class of the generated DSP. The generated code is compiled
+ * with -nvi, so this class has no virtual methods and every call
+ * to compute() is statically dispatched.
+ */
+class dsp {
+};
+
+/**
+ * Memory manager backed by a static MonotonicArena. The allocations are
+ * served linearly and they are never freed, which makes them constant time
+ * and deterministic. The arena is stored inside the object, so its
+ * placement in memory is decided by the placement of the instance.
+ *
+ * @tparam SIZE arena size in bytes
+ */
+template<size_t SIZE>
+class StaticMemoryManager : public dsp_memory_manager {
+public:
+    /**
+     * Allocates a block from the arena, aligned to 8 bytes.
+     *
+     * @param size size in bytes of the block
+     * @return pointer to the block, nullptr if the arena is exhausted
+     */
+    void *allocate(size_t size) override { return arena.allocate(size); };
+
+    /**
+     * The blocks are never freed one by one, use reset() to
+     * release the whole arena.
+     *
+     * @param ptr block to release
+     */
+    void destroy(void * /*ptr*/) override {};
+
+    /**
+     * Releases the whole arena, every block previously allocated
+     * becomes invalid.
+     */
+    inline void reset() { arena.reset(); };
+
+    /**
+     * Returns the number of bytes currently allocated.
+     *
+     * @return used bytes
+     */
+    inline size_t getUsedBytes() const { return arena.getUsedBytes(); };
+
+    /**
+     * Returns the arena size.
+     *
+     * @return arena size in bytes
+     */
+    inline size_t getSize() const { return SIZE; };
+
+private:
+    /**
+     * Memory served by the manager.
+     */
+    MonotonicArena<SIZE> arena;
+};
+
+/**
+ * Creates a DSP instance inside the memory of a dsp_memory_manager.
+ *
+ * @tparam DSP generated DSP class
+ * @param manager memory manager that will hold the instance
+ * @return the new instance, nullptr if the memory manager is exhausted
+ */
+template<typename DSP>
+DSP *createDSP(dsp_memory_manager *manager) {
+    void *memory = manager->allocate(sizeof(DSP));
+    return (memory == nullptr) ? nullptr : new(memory) DSP();
+}
+
+/**
+ * Flat array User Interface.
+ * It stores the complete path, the zone and the metadata of each
+ * parameter in a fixed size array, so that the parameters can be
+ * resolved once by path and then accessed by index.
+ */
+class MiosixUI : public UI {
+public:
+    /**
+     * Struct describing a single Faust parameter.
+     */
+    struct Parameter {
+        char path[FAUST_UI_MAX_PATH_LEN];
+        const char *label;
+        const char *unit;
+        FAUSTFLOAT *zone;
+        FAUSTFLOAT init;
+        FAUSTFLOAT min;
+        FAUSTFLOAT max;
+        FAUSTFLOAT step;
+    };
+
+    /**
+     * Constructor.
+     */
+    MiosixUI() : paramsCount(0), boxDepth(0), pendingUnit(nullptr) {};
+
+    // -- widget's layouts
+    void openTabBox(const char *label) override { pushLabel(label); };
+
+    void openHorizontalBox(const char *label) override { pushLabel(label); };
+
+    void openVerticalBox(const char *label) override { pushLabel(label); };
+
+    void closeBox() override { if (boxDepth > 0) boxDepth--; };
+
+    // -- active widgets
+    void addButton(const char *label, FAUSTFLOAT *zone) override {
+        addParameter(label, zone, 0, 0, 1, 1);
+    };
+
+    void addCheckButton(const char *label, FAUSTFLOAT *zone) override {
+        addParameter(label, zone, 0, 0, 1, 1);
+    };
+
+    void addVerticalSlider(const char *label, FAUSTFLOAT *zone, FAUSTFLOAT init,
+                           FAUSTFLOAT min, FAUSTFLOAT max, FAUSTFLOAT step) override {
+        addParameter(label, zone, init, min, max, step);
+    };
+
+    void addHorizontalSlider(const char *label, FAUSTFLOAT *zone, FAUSTFLOAT init,
+                             FAUSTFLOAT min, FAUSTFLOAT max, FAUSTFLOAT step) override {
+        addParameter(label, zone, init, min, max, step);
+    };
+
+    void addNumEntry(const char *label, FAUSTFLOAT *zone, FAUSTFLOAT init,
+                     FAUSTFLOAT min, FAUSTFLOAT max, FAUSTFLOAT step) override {
+        addParameter(label, zone, init, min, max, step);
+    };
+
+    // -- passive widgets
+    void addHorizontalBargraph(const char *label, FAUSTFLOAT *zone, FAUSTFLOAT min, FAUSTFLOAT max) override {
+        addParameter(label, zone, min, min, max, 0);
+    };
+
+    void addVerticalBargraph(const char *label, FAUSTFLOAT *zone, FAUSTFLOAT min, FAUSTFLOAT max) override {
+        addParameter(label, zone, min, min, max, 0);
+    };
+
+    // -- soundfiles
+    void addSoundfile(const char * /*label*/, const char * /*filename*/, Soundfile ** /*sfZone*/) override {};
+
+    // -- metadata declarations
+    void declare(FAUSTFLOAT *zone, const char *key, const char *val) override {
+        // Faust declares the metadata of a zone before adding it
+        if (zone != nullptr && strcmp(key, "unit") == 0) pendingUnit = val;
+    };
+
+    /**
+     * Returns the number of parameters.
+     *
+     * @return parameter count
+     */
+    inline int getParamsCount() const { return paramsCount; };
+
+    /**
+     * Returns the index of a parameter from its complete path
+     * (e.g. "/faust_synth/freq") or from its label.
+     *
+     * @param path complete path or label of the parameter
+     * @return index of the parameter, -1 if not found
+     */
+    int getParamIndex(const char *path) const {
+        for (int i = 0; i < paramsCount; i++) {
+            if (strcmp(parameters[i].path, path) == 0) return i;
+        }
+        for (int i = 0; i < paramsCount; i++) {
+            if (strcmp(parameters[i].label, path) == 0) return i;
+        }
+        return -1;
+    };
+
+    /**
+     * Returns the complete path of a parameter.
+     *
+     * @param index index of the parameter
+     * @return complete path, empty string if the index is not valid
+     */
+    inline const char *getParamAddress(int index) const {
+        return isValid(index) ? parameters[index].path : "";
+    };
+
+    /**
+     * Returns the description of a parameter.
+     * The index must be valid.
+     *
+     * @param index index of the parameter
+     * @return parameter description
+     */
+    inline const Parameter &getParameter(int index) const { return parameters[index]; };
+
+    /**
+     * Sets the value of a parameter, invalid indexes are ignored.
+     *
+     * @param index index of the parameter
+     * @param value new value
+     */
+    inline void setParamValue(int index, FAUSTFLOAT value) {
+        if (isValid(index)) *parameters[index].zone = value;
+    };
+
+    /**
+     * Gets the value of a parameter.
+     *
+     * @param index index of the parameter
+     * @return current value, 0 if the index is not valid
+     */
+    inline FAUSTFLOAT getParamValue(int index) const {
+        return isValid(index) ? *parameters[index].zone : FAUSTFLOAT(0);
+    };
+
+    /**
+     * Sets the value of a parameter by path. This performs a linear
+     * search, prefer resolving the index once with getParamIndex().
+     *
+     * @param path complete path or label of the parameter
+     * @param value new value
+     */
+    inline void setParamValue(const char *path, FAUSTFLOAT value) { setParamValue(getParamIndex(path), value); };
+
+    /**
+     * Gets the value of a parameter by path.
+     *
+     * @param path complete path or label of the parameter
+     * @return current value, 0 if the parameter is not found
+     */
+    inline FAUSTFLOAT getParamValue(const char *path) const { return getParamValue(getParamIndex(path)); };
+
+private:
+    /**
+     * Checks whether an index refers to an existing parameter.
+     */
+    inline bool isValid(int index) const { return index >= 0 && index < paramsCount; };
+
+    /**
+     * Pushes a box label on the path stack.
+     */
+    void pushLabel(const char *label) {
+        if (boxDepth < FAUST_UI_MAX_BOX_DEPTH) boxLabels[boxDepth] = label;
+        boxDepth++;
+    };
+
+    /**
+     * Stores a new parameter, building its complete path
+     * from the labels of the open boxes.
+     */
+    void addParameter(const char *label, FAUSTFLOAT *zone, FAUSTFLOAT init,
+                      FAUSTFLOAT min, FAUSTFLOAT max, FAUSTFLOAT step) {
+        const char *unit = pendingUnit;
+        pendingUnit = nullptr;
+        if (paramsCount >= FAUST_UI_MAX_PARAMS) return;
+
+        Parameter &parameter = parameters[paramsCount++];
+        parameter.path[0] = '\0';
+        int depth = (boxDepth < FAUST_UI_MAX_BOX_DEPTH) ? boxDepth : FAUST_UI_MAX_BOX_DEPTH;
+        for (int i = 0; i < depth; i++) appendToPath(parameter.path, boxLabels[i]);
+        appendToPath(parameter.path, label);
+
+        parameter.label = label;
+        parameter.unit = (unit != nullptr) ? unit : "";
+        parameter.zone = zone;
+        parameter.init = init;
+        parameter.min = min;
+        parameter.max = max;
+        parameter.step = step;
+    };
+
+    /**
+     * Appends "/label" to a path, truncating it if too long.
+     */
+    static void appendToPath(char *path, const char *label) {
+        size_t length = strlen(path);
+        if (length + 1 >= FAUST_UI_MAX_PATH_LEN) return;
+        path[length++] = '/';
+        strncpy(path + length, label, FAUST_UI_MAX_PATH_LEN - length - 1);
+        path[FAUST_UI_MAX_PATH_LEN - 1] = '\0';
+    };
+
+    /**
+     * Parameters collected from buildUserInterface().
+     */
+    std::array<Parameter, FAUST_UI_MAX_PARAMS> parameters;
+
+    /**
+     * Number of valid entries in parameters.
+     */
+    int paramsCount;
+
+    /**
+     * Labels of the currently open boxes.
+     */
+    std::array<const char *, FAUST_UI_MAX_BOX_DEPTH> boxLabels;
+
+    /**
+     * Number of currently open boxes.
+     */
+    int boxDepth;
+
+    /**
+     * Unit declared for the next parameter, nullptr if none.
+     */
+    const char *pendingUnit;
+};
+
+#endif //MIOSIX_DRUM_MIOSIX_ARCH_H
@@ -128,9 +128,10 @@ private:
     ParseState lastState;
 
     /**
-     * Buffer Mutex
+     * Buffer Mutex, only entering the kernel when the MIDI
+     * parsing and processing threads contend for it
      */
-     miosix::Mutex bufferMutex;
+     miosix::AdaptiveMutex bufferMutex;
 };
 
 #endif //MICROAUDIO_MIDIPARSER_H
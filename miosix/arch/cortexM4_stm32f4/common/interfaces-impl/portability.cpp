@@ -34,6 +34,7 @@
 #include "kernel/scheduler/tick_interrupt.h"
 #include "core/interrupts.h"
 #include "kernel/process.h"
+#include "kernel/irq_trace.h"
 #include <algorithm>
 #include <cstdio>
 #include <cstring>
@@ -71,6 +72,24 @@ void SVC_Handler()
     restoreContext();
 }
 
+#ifdef WITH_TICKLESS_IDLE
+/**
+ * \internal
+ * timer interrupt routine of the tickless idle mode, replacing SysTick.
+ * Since inside naked functions only assembler code is allowed, this function
+ * only calls the ctxsave/ctxrestore macros (which are in assembler), and calls
+ * the implementation code in ISR_preempt()
+ */
+void TIM2_IRQHandler() __attribute__((naked));
+void TIM2_IRQHandler()
+{
+    saveContext();
+    //Call ISR_preempt(). Name is a C++ mangled name.
+    asm volatile("bl _ZN14miosix_private11ISR_preemptEv");
+    restoreContext();
+}
+#endif //WITH_TICKLESS_IDLE
+
 #ifdef SCHED_TYPE_CONTROL_BASED
 /**
  * \internal
@@ -102,8 +121,22 @@ namespace miosix_private {
 void ISR_preempt() __attribute__((noinline));
 void ISR_preempt()
 {
+    #ifdef WITH_IRQ_TRACE
+    #ifdef WITH_TICKLESS_IDLE
+    const short tickIRQn=TIM2_IRQn;
+    #else //WITH_TICKLESS_IDLE
+    const short tickIRQn=SysTick_IRQn;
+    #endif //WITH_TICKLESS_IDLE
+    miosix::IRQTrace::IRQenter(tickIRQn);
+    #endif //WITH_IRQ_TRACE
     IRQstackOverflowCheck();
+    #ifdef WITH_TICKLESS_IDLE
+    TicklessTimerHardware::IRQclearInterrupt();
+    #endif //WITH_TICKLESS_IDLE
     miosix::IRQtickInterrupt();
+    #ifdef WITH_IRQ_TRACE
+    miosix::IRQTrace::IRQexit(tickIRQn);
+    #endif //WITH_IRQ_TRACE
 }
 
 /**
@@ -304,10 +337,16 @@ void IRQportableStartKernel()
     NVIC_SetPriority(SVCall_IRQn,3);//High priority for SVC (Max=0, min=15)
     NVIC_SetPriority(SysTick_IRQn,3);//High priority for SysTick (Max=0, min=15)
     NVIC_SetPriority(MemoryManagement_IRQn,2);//Higher priority for MemoryManagement (Max=0, min=15)
+    #ifdef WITH_TICKLESS_IDLE
+    //The tick interrupt is TIM2, started by the kernel
+    NVIC_SetPriority(TIM2_IRQn,3);//Same priority as SysTick
+    NVIC_EnableIRQ(TIM2_IRQn);
+    #else //WITH_TICKLESS_IDLE
     SysTick->LOAD=SystemCoreClock/miosix::TICK_FREQ;
     //Start SysTick, set to generate interrupts
     SysTick->CTRL=SysTick_CTRL_ENABLE_Msk | SysTick_CTRL_TICKINT_Msk |
             SysTick_CTRL_CLKSOURCE_Msk;
+    #endif //WITH_TICKLESS_IDLE
 
     #ifdef WITH_PROCESSES
     miosix::IRQenableMPUatBoot();
@@ -333,6 +372,74 @@ void sleepCpu()
     __WFI();
 }
 
+#ifdef WITH_TICKLESS_IDLE
+void TicklessTimerHardware::IRQinit()
+{
+    RCC->APB1ENR|=RCC_APB1ENR_TIM2EN;
+    RCC_SYNC();
+    DBGMCU->APB1FZ|=DBGMCU_APB1_FZ_DBG_TIM2_STOP; //Tim2 stops while debugging
+    TIM2->CR1=0; //Upcounter, not started, no special options
+    TIM2->CR2=0; //No special options
+    TIM2->SMCR=0; //No external trigger
+    TIM2->CNT=0; //Clear timer
+    //get timer frequency considering APB1 prescaler
+    //consider that timer clock is twice APB1 clock when the APB1 prescaler has
+    //a division factor greater than 2
+    int timerClock=SystemCoreClock;
+    int apb1prescaler=(RCC->CFGR>>10) & 7;
+    if(apb1prescaler>4) timerClock>>=(apb1prescaler-4);
+    TIM2->PSC=(timerClock/COUNTER_FREQ)-1;
+    TIM2->ARR=0xffffffff; //Free running on all the 32 bits
+    TIM2->CCMR1=0; //Channel 1 in output compare, output frozen
+    TIM2->CCR1=0xffffffff; //This will be initialized later with IRQsetCompare
+    //This is very important: without this the prescaler shadow register may
+    //not be updated
+    TIM2->EGR=TIM_EGR_UG;
+    TIM2->SR=0;
+    TIM2->DIER=TIM_DIER_CC1IE; //Enable interrupt on compare
+    TIM2->CR1=TIM_CR1_CEN; //Start timer
+}
+
+unsigned int TicklessTimerHardware::IRQread()
+{
+    return TIM2->CNT;
+}
+
+void TicklessTimerHardware::IRQsetCompare(unsigned int count)
+{
+    //CCR1 is not preloaded, the new value is compared from now on
+    TIM2->CCR1=count;
+}
+
+void TicklessTimerHardware::IRQpend()
+{
+    NVIC_SetPendingIRQ(TIM2_IRQn);
+}
+
+void TicklessTimerHardware::IRQclearInterrupt()
+{
+    TIM2->SR=0;
+}
+#endif //WITH_TICKLESS_IDLE
+
+#if defined(WITH_CPU_TIME_COUNTER) || defined(WITH_IRQ_TRACE)
+void CPUTimeCounterHardware::IRQinit()
+{
+    //The cycle counter may be already used, e.g. to measure latencies, and
+    //in that case it is not reset
+    if(DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk) return;
+    CoreDebug->DEMCR|=CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT=0;
+    DWT->CTRL|=DWT_CTRL_CYCCNTENA_Msk;
+}
+
+unsigned int CPUTimeCounterHardware::getFrequency()
+{
+    //The cycle counter counts the core clock
+    return SystemCoreClock;
+}
+#endif //WITH_CPU_TIME_COUNTER || WITH_IRQ_TRACE
+
 #ifdef SCHED_TYPE_CONTROL_BASED
 void AuxiliaryTimer::IRQinit()
 {
@@ -197,6 +197,15 @@ inline void portableSwitchToUserspace()
 
 #endif //WITH_PROCESSES
 
+#if defined(WITH_CPU_TIME_COUNTER) || defined(WITH_IRQ_TRACE)
+
+inline unsigned int CPUTimeCounterHardware::IRQread()
+{
+    return DWT->CYCCNT;
+}
+
+#endif //WITH_CPU_TIME_COUNTER || WITH_IRQ_TRACE
+
 /**
  * \}
  */
@@ -78,6 +78,17 @@ namespace miosix {
 //#define SCHED_TYPE_CONTROL_BASED
 //#define SCHED_TYPE_EDF
 
+/// \def WITH_TICKLESS_IDLE
+/// If uncommented the periodic tick interrupt stops while the idle thread is
+/// running. The kernel tick is kept from a free running timer, whose compare
+/// interrupt is programmed at the next wakeup of a sleeping thread.
+/// Sleeps keep the tick resolution, as the kernel time is still counted in
+/// ticks: a sleep shorter than a tick ends at the next tick, and nanosleep()
+/// and usleep() truncate the time to whole ticks.
+/// Only supported by the cortexM4_stm32f4 architecture, where the timer is
+/// TIM2 instead of SysTick.
+//#define WITH_TICKLESS_IDLE
+
 //
 // Filesystem options
 //
@@ -151,6 +162,30 @@ const unsigned char MAX_OPEN_FILES=8;
  */
 #define JTAG_DISABLE_SLEEP
 
+/// \def WITH_CPU_TIME_COUNTER
+/// If uncommented the kernel adds to each thread the CPU time it used at every
+/// context switch, measured with a free running hardware counter, and
+/// CPUTimeCounter takes snapshots of the CPU time and of the stack usage of
+/// all the threads.
+/// Only supported by the cortexM4_stm32f4 architecture, where the counter is
+/// the DWT cycle counter.
+//#define WITH_CPU_TIME_COUNTER
+
+/// \def WITH_IRQ_TRACE
+/// If uncommented the interrupt disable locks record where the interrupts are
+/// disabled and enabled back, the kernel tick and the instrumented interrupt
+/// handlers record their start and end, and IRQTrace keeps the last
+/// IRQ_TRACE_EVENTS of these events, timestamped with a free running hardware
+/// counter, to find what delays the interrupts. The fast locks are no longer
+/// inlined, which makes them slower, so it should only be enabled while
+/// measuring.
+/// Only supported by the cortexM4_stm32f4 architecture, where the counter is
+/// the DWT cycle counter.
+//#define WITH_IRQ_TRACE
+
+/// Events kept by IRQTrace (MUST be a power of two)
+const unsigned int IRQ_TRACE_EVENTS=512;
+
 /// Minimum stack size (MUST be divisible by 4)
 const unsigned int STACK_MIN=256;
 
@@ -196,6 +231,11 @@ const short int PRIORITY_MAX=64;
 /// The meaning of a thread's priority depends on the chosen scheduler.
 const unsigned char MAIN_PRIORITY=1;
 
+/// Threads that can wait on an AdaptiveMutex without allocating memory.
+/// Its kernel mutex reserves their room when it is constructed, so the
+/// contention does not use the heap while the system is running.
+const unsigned int ADAPTIVE_MUTEX_WAITERS=4;
+
 
 
 //
@@ -0,0 +1,116 @@
+#ifndef CALLBACK_RING_H
+#define CALLBACK_RING_H
+
+#include <atomic>
+#include <new>
+#include "callback.h"
+
+namespace miosix {
+
+/**
+ * Lock free ring of Callback slots for a single producer and a single
+ * consumer, the storage of LockFreeEventQueue.
+ *
+ * The producer constructs the function object directly in a free slot and
+ * then publishes it by writing the put counter, the consumer calls it in
+ * place, destroys it and then releases the slot by writing the get counter.
+ * Each counter is written by one side only, so neither side disables the
+ * interrupts and no Callback is ever copied. The counters run freely and
+ * their difference is the number of events, so all the slots are used.<br>
+ * This class does not depend on the kernel, so it can be tested on the host.
+ * \param NumSlots number of slots, a power of two
+ * \param SlotSize size of the Callback objects
+ */
+template<unsigned NumSlots, unsigned SlotSize>
+class CallbackRing
+{
+public:
+    static_assert(NumSlots>0 && (NumSlots & (NumSlots-1))==0,
+            "The number of slots must be a power of two");
+
+    /**
+     * Constructor.
+     */
+    CallbackRing() : put(0), get(0) {}
+
+    /**
+     * Adds an event, called by the producer.
+     * \param functor function object, constructed in the free slot
+     * \return false if there was no free slot
+     */
+    template<typename T>
+    bool push(T functor)
+    {
+        unsigned int p=put.load(std::memory_order_relaxed);
+        if(p-get.load(std::memory_order_acquire)>=NumSlots) return false;
+        //The slot is empty, so this only constructs the function object
+        events[p & (NumSlots-1)]=functor;
+        put.store(p+1,std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Calls the oldest event and removes it, called by the consumer.
+     * The slot is released also if the event throws.
+     * \return false if there were no events
+     * \throws any exception that is thrown by the event function
+     */
+    bool runOne()
+    {
+        unsigned int g=get.load(std::memory_order_relaxed);
+        if(g==put.load(std::memory_order_acquire)) return false;
+        Release release(this,g);
+        events[g & (NumSlots-1)]();
+        return true;
+    }
+
+    /**
+     * \return the number of events, only a hint when called concurrently
+     * with push() or runOne()
+     */
+    unsigned int size() const
+    {
+        return put.load(std::memory_order_acquire)-
+               get.load(std::memory_order_acquire);
+    }
+
+    /**
+     * \return true if there are no events, only a hint when called
+     * concurrently with push() or runOne()
+     */
+    bool empty() const
+    {
+        return size()==0;
+    }
+
+private:
+    CallbackRing(const CallbackRing&);
+    CallbackRing& operator= (const CallbackRing&);
+
+    /**
+     * Destroys the event that was called and releases its slot
+     */
+    class Release
+    {
+    public:
+        Release(CallbackRing *ring, unsigned int g) : ring(ring), g(g) {}
+
+        ~Release()
+        {
+            ring->events[g & (NumSlots-1)].clear();
+            ring->get.store(g+1,std::memory_order_release);
+        }
+
+    private:
+        CallbackRing *ring;
+        unsigned int g;
+    };
+
+    Callback<SlotSize> events[NumSlots]; ///< Slots of the events
+    std::atomic<unsigned int> put; ///< Events added, written by the producer
+    std::atomic<unsigned int> get; ///< Events run, written by the consumer
+};
+
+} //namespace miosix
+
+#endif //CALLBACK_RING_H
@@ -34,6 +34,7 @@
 #include <functional>
 #include <miosix.h>
 #include "callback.h"
+#include "callback_ring.h"
 
 namespace miosix {
 
@@ -455,6 +456,171 @@ private:
     Callback<SlotSize> events[NumSlots]; ///< Fixed size queue of events
 };
 
+/**
+ * A fixed size event queue for a single producer and a single consumer.
+ * 
+ * Like FixedEventQueue it makes no use of the heap, but posting and running
+ * events is lock free: the producer constructs the event directly in a slot
+ * and the consumer calls it in place, so no Callback is copied and the
+ * interrupts are only disabled when the consumer has to wait for an event or
+ * has to be woken.
+ * 
+ * Events can be posted by a single interrupt handler, or by interrupt
+ * handlers of the same priority as they never preempt each other, or by a
+ * single thread, but not by both. A single thread can call run() or
+ * runOne().
+ * 
+ * \param NumSlots maximum queue length, a power of two
+ * \param SlotSize size of the Callback objects, see FixedEventQueue
+ */
+template<unsigned NumSlots, unsigned SlotSize=20>
+class LockFreeEventQueue
+{
+public:
+    /**
+     * Constructor.
+     */
+    LockFreeEventQueue() : waiting(0) {}
+
+    /**
+     * Post an event in the queue, or return if the queue was full.
+     * Can be called only by the producer thread.
+     * 
+     * \param event function function to be called in the thread that calls
+     * run() or runOne(). The copy constructors of the bound parameters must
+     * not allocate memory.
+     * \return false if there was no space in the queue
+     */
+    template<typename T>
+    bool postNonBlocking(T event)
+    {
+        if(ring.push(event)==false) return false;
+        if(waiting==0) return true;
+        bool hppw=false;
+        {
+            FastInterruptDisableLock dLock;
+            IRQwakeConsumer(&hppw);
+        }
+        if(hppw) Thread::yield();
+        return true;
+    }
+
+    /**
+     * Post an event in the queue, or return if the queue was full.
+     * Can be called only by the producer interrupt handlers.
+     * 
+     * \param event function function to be called in the thread that calls
+     * run() or runOne(). The copy constructors of the bound parameters must
+     * not allocate memory.
+     * \return false if there was no space in the queue
+     */
+    template<typename T>
+    bool IRQpost(T event)
+    {
+        if(ring.push(event)==false) return false;
+        IRQwakeConsumer(0);
+        return true;
+    }
+
+    /**
+     * Post an event in the queue, or return if the queue was full.
+     * Can be called only by the producer interrupt handlers.
+     * 
+     * \param event function function to be called in the thread that calls
+     * run() or runOne(). The copy constructors of the bound parameters must
+     * not allocate memory.
+     * \param hppw returns true if a higher priority thread was awakened as
+     * part of posting the event. Can be used inside an IRQ to call the
+     * scheduler.
+     * \return false if there was no space in the queue
+     */
+    template<typename T>
+    bool IRQpost(T event, bool& hppw)
+    {
+        hppw=false;
+        if(ring.push(event)==false) return false;
+        IRQwakeConsumer(&hppw);
+        return true;
+    }
+
+    /**
+     * This function blocks waiting for events being posted, and when available
+     * it calls the event function. To return from this event loop an event
+     * function must throw an exception.
+     * 
+     * \throws any exception that is thrown by the event functions
+     */
+    void run()
+    {
+        for(;;)
+        {
+            while(ring.runOne()) ;
+            FastInterruptDisableLock dLock;
+            //Checked with interrupts disabled, an event posted after this
+            //finds the thread in waiting and wakes it
+            while(ring.empty())
+            {
+                waiting=Thread::IRQgetCurrentThread();
+                Thread::IRQwait();
+                {
+                    FastInterruptEnableLock eLock(dLock);
+                    Thread::yield();
+                }
+            }
+            waiting=0;
+        }
+    }
+
+    /**
+     * Run at most one event. This function does not block.
+     * 
+     * \throws any exception that is thrown by the event functions
+     */
+    void runOne()
+    {
+        ring.runOne();
+    }
+
+    /**
+     * \return the number of events in the queue
+     */
+    unsigned int size() const
+    {
+        return ring.size();
+    }
+
+    /**
+     * \return true if the queue has no events
+     */
+    bool empty() const
+    {
+        return ring.empty();
+    }
+
+private:
+    LockFreeEventQueue(const LockFreeEventQueue&);
+    LockFreeEventQueue& operator= (const LockFreeEventQueue&);
+
+    /**
+     * Wakes the consumer thread if it is waiting for an event. Can be called
+     * only with interrupts disabled or within an interrupt handler.
+     * \param hppw if not null, set to true if the consumer has a higher
+     * priority than the current thread, otherwise the variable is not modified
+     */
+    void IRQwakeConsumer(bool *hppw)
+    {
+        Thread *t=waiting;
+        if(t==0) return;
+        waiting=0;
+        t->IRQwakeup();
+        if(hppw && t->IRQgetPriority()>Thread::IRQgetCurrentThread()->IRQgetPriority())
+            *hppw=true;
+    }
+
+    CallbackRing<NumSlots,SlotSize> ring; ///< Slots of the events
+    Thread * volatile waiting; ///< Consumer waiting for an event, if any
+};
+
 } //namespace miosix
 
 #endif //E20_H
@@ -310,6 +310,87 @@ private:
 };
 #endif //SCHED_TYPE_CONTROL_BASED
 
+#ifdef WITH_TICKLESS_IDLE
+/**
+ * \internal
+ * Free running 32 bit counter with a compare interrupt, that replaces the
+ * periodic tick interrupt in the tickless idle mode. The interrupt must call
+ * IRQtickInterrupt() as the periodic one.
+ */
+class TicklessTimerHardware
+{
+public:
+    ///Frequency of the counter
+    static const unsigned int COUNTER_FREQ=1000000;
+
+    ///Counts in a kernel tick
+    static const unsigned int COUNTS_PER_TICK=COUNTER_FREQ/miosix::TICK_FREQ;
+
+    /**
+     * Initializes and starts the counter, with the interrupt disabled.
+     */
+    static void IRQinit();
+
+    /**
+     * \return the value of the counter
+     */
+    static unsigned int IRQread();
+
+    /**
+     * Programs the interrupt when the counter reaches a value.
+     * \param count value of the counter
+     */
+    static void IRQsetCompare(unsigned int count);
+
+    /**
+     * Causes the interrupt as soon as the interrupts are enabled.
+     */
+    static void IRQpend();
+
+    /**
+     * Clears the interrupt flag, called by the interrupt.
+     */
+    static void IRQclearInterrupt();
+
+private:
+    //Unwanted functions
+    TicklessTimerHardware();
+    TicklessTimerHardware& operator= (TicklessTimerHardware& );
+};
+#endif //WITH_TICKLESS_IDLE
+
+#if defined(WITH_CPU_TIME_COUNTER) || defined(WITH_IRQ_TRACE)
+/**
+ * \internal
+ * Free running 32 bit counter used to measure the CPU time of the threads
+ * and to timestamp the events of IRQTrace.
+ * It is read at every context switch, so reading it must be fast.
+ */
+class CPUTimeCounterHardware
+{
+public:
+    /**
+     * Starts the counter, if it is not already running.
+     */
+    static void IRQinit();
+
+    /**
+     * \return the value of the counter, wrapping around
+     */
+    static inline unsigned int IRQread();
+
+    /**
+     * \return the frequency of the counter, in Hz
+     */
+    static unsigned int getFrequency();
+
+private:
+    //Unwanted functions
+    CPUTimeCounterHardware();
+    CPUTimeCounterHardware& operator= (CPUTimeCounterHardware& );
+};
+#endif //WITH_CPU_TIME_COUNTER || WITH_IRQ_TRACE
+
 /**
  * \}
  */
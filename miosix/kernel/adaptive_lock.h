@@ -0,0 +1,120 @@
+#ifndef ADAPTIVE_LOCK_H
+#define	ADAPTIVE_LOCK_H
+
+namespace miosix {
+
+/**
+ * \internal
+ * Lock word of AdaptiveMutex, which enters the kernel only on contention.
+ *
+ * The word is zero when the lock is free and holds the owner when it is
+ * locked. Locking and unlocking without contention is a single compare and
+ * swap of the word, and the kernel knows nothing about the owner.<br>
+ * A thread finding the lock taken pauses the kernel, sets the low bit of the
+ * word and makes the owner also the owner of a kernel mutex, as if it had
+ * locked it, then waits on that mutex, which gives the owner its priority.
+ * From then on the compare and swap of the owner fails because of the bit,
+ * so it unlocks through the kernel mutex, which restores its priority and
+ * hands the lock to the first waiter. The word goes back to zero when the
+ * kernel mutex is released with no waiters.<br>
+ * The slow path changes the word with compare and swap too, since a thread
+ * may be preempted in the middle of its fast path.<br>
+ * This class does not depend on the kernel, so it can be tested on the host.
+ * \param P class with
+ * - typedef Word, unsigned integer with the size of a pointer
+ * - static Word compareAndSwap(volatile Word *p, Word prev, Word next),
+ *   returning the previous value of *p
+ * - typedef Pause, class pausing the kernel in its constructor and
+ *   restarting it in its destructor
+ * - typedef Waiters, kernel mutex with priority inheritance, with the member
+ *   functions void PKadopt(Word owner), making the owner of the lock its owner,
+ *   void PKlock(Pause& pause), blocking the current thread until it owns it,
+ *   and Word PKunlock(Pause& pause, bool& hppw), releasing it and returning
+ *   the new owner or zero, setting hppw if a higher priority thread was woken
+ */
+template<typename P>
+class AdaptiveLock
+{
+public:
+    typedef typename P::Word Word;
+
+    /**
+     * Constructor, the lock is free.
+     */
+    AdaptiveLock() : word(0), waiters() {}
+
+    /**
+     * Locks, blocking if the lock is taken.
+     * \param self current thread
+     */
+    void lock(Word self)
+    {
+        if(P::compareAndSwap(&word,0,self)==0) return;
+        typename P::Pause pause;
+        for(;;)
+        {
+            Word w=word;
+            if(w==0)
+            {
+                //Released before the kernel was paused
+                if(P::compareAndSwap(&word,0,self)==0) return;
+            } else if(w & CONTENDED) break;
+            else if(P::compareAndSwap(&word,w,w | CONTENDED)==w)
+            {
+                //The owner now unlocks through the kernel mutex
+                waiters.PKadopt(w);
+                break;
+            }
+        }
+        //The unlocking thread writes our id in the word
+        waiters.PKlock(pause);
+    }
+
+    /**
+     * Locks only if the lock is free.
+     * \param self current thread
+     * \return true if the lock was acquired
+     */
+    bool tryLock(Word self)
+    {
+        return P::compareAndSwap(&word,0,self)==0;
+    }
+
+    /**
+     * Unlocks.
+     * \param self current thread, the owner of the lock
+     * \return true if a higher priority thread was woken
+     */
+    bool unlock(Word self)
+    {
+        if(P::compareAndSwap(&word,self,0)==self) return false;
+        typename P::Pause pause;
+        bool hppw=false;
+        Word next=waiters.PKunlock(pause,hppw);
+        //No fast path succeeds while the bit is set, so a plain store is fine
+        word= next==0 ? 0 : next | CONTENDED;
+        return hppw;
+    }
+
+    /**
+     * \return the owner of the lock, or zero if it is free
+     */
+    Word getOwner() const
+    {
+        return word & ~CONTENDED;
+    }
+
+private:
+    AdaptiveLock(const AdaptiveLock&);
+    AdaptiveLock& operator= (const AdaptiveLock&);
+
+    ///Bit of the word set while the owner is known to the kernel mutex
+    static const Word CONTENDED=1;
+
+    volatile Word word; ///< Owner and contended bit
+    typename P::Waiters waiters; ///< Kernel mutex used on contention
+};
+
+} //namespace miosix
+
+#endif //ADAPTIVE_LOCK_H
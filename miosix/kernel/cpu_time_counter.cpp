@@ -0,0 +1,82 @@
+#include "cpu_time_counter.h"
+#include <algorithm>
+
+#ifdef WITH_CPU_TIME_COUNTER
+
+namespace miosix {
+
+int CPUTimeCounter::getSnapshot(ThreadUsage *usage, int size)
+{
+    //The list of threads does not change while the kernel is paused
+    PauseKernelLock pLock;
+    int count=0;
+    {
+        //The CPU time of the running thread is also changed by interrupts
+        FastInterruptDisableLock dLock;
+        IRQprofileContextSwitch();
+        for(Thread *walk=head;walk!=nullptr;walk=walk->timeCounterNext)
+        {
+            if(count<size)
+            {
+                usage[count].thread=walk;
+                usage[count].cpuTime=walk->cpuTime;
+            }
+            count++;
+        }
+    }
+
+    //The stack is between the watermark and the Thread class, allocated at
+    //its top, and grows downwards, so the unused part is at the bottom
+    const int watermarkWords=WATERMARK_LEN/sizeof(unsigned int);
+    for(int i=0;i<std::min(count,size);i++)
+    {
+        const Thread *thread=usage[i].thread;
+        const unsigned int *bottom=thread->watermark+watermarkWords;
+        const unsigned int *top=reinterpret_cast<const unsigned int*>(thread);
+        const unsigned int *walk=bottom;
+        while(walk<top && *walk==STACK_FILL) walk++;
+        usage[i].stackSize=(top-bottom)*sizeof(unsigned int);
+        usage[i].stackUsed=(top-walk)*sizeof(unsigned int);
+        usage[i].watermarkOk=true;
+        for(int j=0;j<watermarkWords;j++)
+            if(thread->watermark[j]!=WATERMARK_FILL) usage[i].watermarkOk=false;
+    }
+    return count;
+}
+
+unsigned int CPUTimeCounter::getFrequency()
+{
+    return miosix_private::CPUTimeCounterHardware::getFrequency();
+}
+
+void CPUTimeCounter::IRQinit()
+{
+    miosix_private::CPUTimeCounterHardware::IRQinit();
+    last=miosix_private::CPUTimeCounterHardware::IRQread();
+}
+
+void CPUTimeCounter::addThread(Thread *thread)
+{
+    //Also called before the kernel is started, where pausing it is harmless
+    PauseKernelLock lock;
+    thread->timeCounterNext=head;
+    head=thread;
+}
+
+void CPUTimeCounter::removeThread(Thread *thread)
+{
+    PauseKernelLock lock;
+    for(Thread **walk=&head;*walk!=nullptr;walk=&(*walk)->timeCounterNext)
+    {
+        if(*walk!=thread) continue;
+        *walk=thread->timeCounterNext;
+        break;
+    }
+}
+
+unsigned int CPUTimeCounter::last=0;
+Thread *CPUTimeCounter::head=nullptr;
+
+} //namespace miosix
+
+#endif //WITH_CPU_TIME_COUNTER
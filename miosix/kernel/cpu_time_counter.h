@@ -0,0 +1,104 @@
+#ifndef CPU_TIME_COUNTER_H
+#define	CPU_TIME_COUNTER_H
+
+#include "config/miosix_settings.h"
+#include "interfaces/portability.h"
+#include "kernel.h"
+
+#ifdef WITH_CPU_TIME_COUNTER
+
+namespace miosix {
+
+extern volatile Thread *cur;///\internal Do not use outside the kernel
+
+/**
+ * CPU time and stack usage of a thread, in a snapshot taken by
+ * CPUTimeCounter::getSnapshot()
+ */
+struct ThreadUsage
+{
+    Thread *thread;            ///< Thread, it may no longer exist
+    unsigned long long cpuTime;///< CPU time used, in counter cycles
+    unsigned int stackSize;    ///< Size of the stack, in bytes
+    unsigned int stackUsed;    ///< Highest stack usage, in bytes
+    bool watermarkOk;          ///< False if the stack overflowed
+};
+
+/**
+ * Per-thread CPU time accounting, enabled by WITH_CPU_TIME_COUNTER.<br>
+ * At every call of the scheduler the cycles of a free running hardware
+ * counter elapsed since the previous call are added to the thread that was
+ * running, including the interrupts that happened meanwhile. The counter
+ * is 32 bit, so the scheduler must run, or a snapshot be taken, at least
+ * once per wrap of the counter (25s with the DWT cycle counter at 168MHz),
+ * which the tick interrupt of the priority scheduler always does.<br>
+ * The stack usage is the part of the stack no longer filled with
+ * STACK_FILL, the pattern written when the thread was created.
+ */
+class CPUTimeCounter
+{
+public:
+    /**
+     * Takes a snapshot of the CPU time and of the stack usage of all the
+     * threads, the idle thread included. The CPU times are read at the same
+     * instant, with interrupts disabled, then the stacks are scanned with the
+     * kernel paused.
+     * \param usage array where the snapshot is stored
+     * \param size size of the array
+     * \return the number of threads, of which at most size are stored
+     */
+    static int getSnapshot(ThreadUsage *usage, int size);
+
+    /**
+     * \return the frequency of the counter, in Hz
+     */
+    static unsigned int getFrequency();
+
+    /**
+     * \internal
+     * Starts the counter, called before the kernel is started.
+     */
+    static void IRQinit();
+
+    /**
+     * \internal
+     * Adds the cycles elapsed since the last call to the running thread,
+     * called by the scheduler before choosing the next thread.
+     */
+    static void IRQprofileContextSwitch()
+    {
+        unsigned int now=miosix_private::CPUTimeCounterHardware::IRQread();
+        const_cast<Thread*>(cur)->cpuTime+=now-last;
+        last=now;
+    }
+
+    /**
+     * \internal
+     * Adds a thread to the list of all the threads, called when it is
+     * constructed.
+     * \param thread thread
+     */
+    static void addThread(Thread *thread);
+
+    /**
+     * \internal
+     * Removes a thread from the list of all the threads, called when it is
+     * destroyed.
+     * \param thread thread
+     */
+    static void removeThread(Thread *thread);
+
+private:
+    //Unwanted functions
+    CPUTimeCounter();
+    CPUTimeCounter& operator= (const CPUTimeCounter&);
+
+    static unsigned int last;///<\internal Counter at the last call
+    static Thread *head;///<\internal List of all the threads
+};
+
+} //namespace miosix
+
+#endif //WITH_CPU_TIME_COUNTER
+
+#endif //CPU_TIME_COUNTER_H
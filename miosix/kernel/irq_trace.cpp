@@ -0,0 +1,75 @@
+#include "irq_trace.h"
+#include "kernel.h"
+#include <cstdio>
+
+#ifdef WITH_IRQ_TRACE
+
+namespace miosix {
+
+TraceRing<IRQ_TRACE_EVENTS> IRQTrace::ring;
+
+void IRQTrace::dump()
+{
+    ring.freeze();
+    //Printed one at a time from the ring, not to need a copy of it
+    unsigned int end=ring.getCount();
+    unsigned int count=end<IRQ_TRACE_EVENTS ? end : IRQ_TRACE_EVENTS;
+    iprintf("irqtrace begin %u %u\n",getFrequency(),count);
+    for(unsigned int i=end-count;i!=end;i++)
+    {
+        TraceEvent e;
+        if(ring.get(i,e)==false) continue;
+        iprintf("%08x %u %d %08x\n",e.time,e.type,e.id,e.site);
+    }
+    iprintf("irqtrace end\n");
+    ring.resume();
+}
+
+unsigned int IRQTrace::getFrequency()
+{
+    return miosix_private::CPUTimeCounterHardware::getFrequency();
+}
+
+void IRQTrace::IRQinit()
+{
+    miosix_private::CPUTimeCounterHardware::IRQinit();
+}
+
+//
+// class FastInterruptDisableLock
+//
+
+//Not inlined, so the return address is the code using the lock
+
+FastInterruptDisableLock::FastInterruptDisableLock()
+{
+    fastDisableInterrupts();
+    IRQTrace::IRQcriticalSectionEnter(__builtin_return_address(0));
+}
+
+FastInterruptDisableLock::~FastInterruptDisableLock()
+{
+    IRQTrace::IRQcriticalSectionLeave(__builtin_return_address(0));
+    fastEnableInterrupts();
+}
+
+//
+// class FastInterruptEnableLock
+//
+
+FastInterruptEnableLock::FastInterruptEnableLock(FastInterruptDisableLock& l)
+{
+    (void)l;
+    IRQTrace::IRQcriticalSectionLeave(__builtin_return_address(0));
+    fastEnableInterrupts();
+}
+
+FastInterruptEnableLock::~FastInterruptEnableLock()
+{
+    fastDisableInterrupts();
+    IRQTrace::IRQcriticalSectionEnter(__builtin_return_address(0));
+}
+
+} //namespace miosix
+
+#endif //WITH_IRQ_TRACE
@@ -0,0 +1,115 @@
+#ifndef IRQ_TRACE_H
+#define	IRQ_TRACE_H
+
+#include "config/miosix_settings.h"
+#include "interfaces/portability.h"
+#include "trace_ring.h"
+
+#ifdef WITH_IRQ_TRACE
+
+namespace miosix {
+
+/**
+ * Trace of the interrupts and of the critical sections, enabled by
+ * WITH_IRQ_TRACE.<br>
+ * The start and the end of the instrumented interrupt handlers, and the
+ * code disabling and enabling back the interrupts, are recorded with the
+ * value of a free running hardware counter in a TraceRing, so the trace
+ * shows how late an interrupt started and which critical section or other
+ * interrupt was running meanwhile. The critical sections are recorded by
+ * FastInterruptDisableLock and FastInterruptEnableLock, by the outermost
+ * InterruptDisableLock and InterruptEnableLock, and by the lock of the EDF
+ * deadline list, with the address of the code that constructed or destroyed
+ * them. The trace is printed on the console by dump(), in the format read by
+ * tools/irqtrace.<br>
+ * Code calling fastDisableInterrupts() directly, and the interrupt handlers
+ * not calling IRQenter() and IRQexit(), such as the serial port and the
+ * context switch ones, are not recorded: a delay they cause is attributed to
+ * whatever was recorded as ending last before the delayed interrupt.
+ */
+class IRQTrace
+{
+public:
+    /**
+     * Records the start of an interrupt handler, to be called first
+     * \param id interrupt number, as the IRQn_Type of the handler
+     */
+    static void IRQenter(short id)
+    {
+        record(TRACE_IRQ_ENTER,id,0);
+    }
+
+    /**
+     * Records the end of an interrupt handler, to be called last
+     * \param id interrupt number, as the IRQn_Type of the handler
+     */
+    static void IRQexit(short id)
+    {
+        record(TRACE_IRQ_EXIT,id,0);
+    }
+
+    /**
+     * \internal
+     * Records that the interrupts have been disabled, called with the
+     * interrupts disabled
+     * \param site address of the code
+     */
+    static void IRQcriticalSectionEnter(void *site)
+    {
+        record(TRACE_CS_ENTER,0,site);
+    }
+
+    /**
+     * \internal
+     * Records that the interrupts are going to be enabled back, called
+     * with the interrupts disabled
+     * \param site address of the code
+     */
+    static void IRQcriticalSectionLeave(void *site)
+    {
+        record(TRACE_CS_LEAVE,0,site);
+    }
+
+    /**
+     * Prints the recorded events on the console, oldest first. No event is
+     * recorded while they are printed. Can only be called by a thread.
+     */
+    static void dump();
+
+    /**
+     * \return the frequency of the counter, in Hz
+     */
+    static unsigned int getFrequency();
+
+    /**
+     * \internal
+     * Starts the counter, called before the kernel is started.
+     */
+    static void IRQinit();
+
+private:
+    //Unwanted functions
+    IRQTrace();
+    IRQTrace& operator= (const IRQTrace&);
+
+    /**
+     * Adds an event to the ring
+     */
+    static void record(unsigned short type, short id, void *site)
+    {
+        TraceEvent event;
+        event.time=miosix_private::CPUTimeCounterHardware::IRQread();
+        event.site=reinterpret_cast<unsigned int>(site);
+        event.type=type;
+        event.id=id;
+        ring.record(event);
+    }
+
+    static TraceRing<IRQ_TRACE_EVENTS> ring;///<\internal Recorded events
+};
+
+} //namespace miosix
+
+#endif //WITH_IRQ_TRACE
+
+#endif //IRQ_TRACE_H
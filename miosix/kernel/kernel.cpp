@@ -35,6 +35,10 @@
 #include "sync.h"
 #include "stage_2_boot.h"
 #include "process.h"
+#include "timer_wheel.h"
+#include "tickless_timer.h"
+#include "cpu_time_counter.h"
+#include "irq_trace.h"
 #include "kernel/scheduler/scheduler.h"
 #include "stdlib_integration/libc_integration.h"
 #include <stdexcept>
@@ -62,7 +66,18 @@ volatile Thread *cur=NULL;///<\internal Thread currently running
 ///\internal True if there are threads in the DELETED status. Used by idle thread
 static volatile bool exist_deleted=false;
 
-static SleepData *sleeping_list=NULL;///<\internal list of sleeping threads
+///\internal Sleeping threads, in a timer wheel to add and wake them in
+///constant time. Zero initialized, as it has no constructor
+static TimerWheel<SleepData,4> sleeping_list;
+
+#ifdef WITH_TICKLESS_IDLE
+///\internal Kernel tick kept from the free running counter. Zero initialized,
+///as it has no constructor
+static TicklessTimer<miosix_private::TicklessTimerHardware> tickless_timer;
+
+///\internal Idle thread, while it runs the tick interrupt is not periodic
+static Thread *idle_thread=nullptr;
+#endif //WITH_TICKLESS_IDLE
 
 static volatile long long tick=0;///<\internal Kernel tick
 
@@ -115,6 +130,11 @@ void disableInterrupts()
     //so disabling them again won't hurt
     miosix_private::doDisableInterrupts();
     if(interruptDisableNesting==0xff) errorHandler(NESTING_OVERFLOW);
+    #ifdef WITH_IRQ_TRACE
+    //Only the outermost lock is recorded, with the code that took it
+    if(interruptDisableNesting==0 && kernel_started==true)
+        IRQTrace::IRQcriticalSectionEnter(__builtin_return_address(0));
+    #endif //WITH_IRQ_TRACE
     interruptDisableNesting++;
 }
 
@@ -128,6 +148,9 @@ void enableInterrupts()
     interruptDisableNesting--;
     if(interruptDisableNesting==0 && kernel_started==true)
     {
+        #ifdef WITH_IRQ_TRACE
+        IRQTrace::IRQcriticalSectionLeave(__builtin_return_address(0));
+        #endif //WITH_IRQ_TRACE
         miosix_private::doEnableInterrupts();
     }
 }
@@ -193,6 +216,24 @@ void startKernel()
 
     // Idle thread needs to be set after main (see control_scheduler.cpp)
     Scheduler::IRQsetIdleThread(idle);
+
+    #ifdef WITH_TICKLESS_IDLE
+    // Start the counter of the tick, its interrupt is enabled by
+    // IRQportableStartKernel() like the periodic one
+    idle_thread=idle;
+    miosix_private::TicklessTimerHardware::IRQinit();
+    tickless_timer.IRQstart();
+    #endif //WITH_TICKLESS_IDLE
+
+    #ifdef WITH_CPU_TIME_COUNTER
+    // The CPU time of main and idle starts being counted here
+    CPUTimeCounter::IRQinit();
+    #endif //WITH_CPU_TIME_COUNTER
+
+    #ifdef WITH_IRQ_TRACE
+    // The events recorded during the boot all have a zero timestamp
+    IRQTrace::IRQinit();
+    #endif //WITH_IRQ_TRACE
     
     // Make the C standard library use per-thread reeentrancy structure
     setCReentrancyCallback(Thread::getCReent);
@@ -228,9 +269,9 @@ long long getTick()
 
 /**
  * \internal
- * Used by Thread::sleep() to add a thread to sleeping list. The list is sorted
- * by the wakeup_time field to reduce time required to wake threads during
- * context switch.
+ * Used by Thread::sleep() to add a thread to sleeping list. The list is a
+ * timer wheel, so the insertion takes constant time regardless of the number
+ * of sleeping threads.
  * Also sets thread SLEEP_FLAG. It is labeled IRQ not because it is meant to be
  * used inside an IRQ, but because interrupts must be disabled prior to calling
  * this function.
@@ -238,23 +279,7 @@ long long getTick()
 void IRQaddToSleepingList(SleepData *x)
 {
     x->p->flags.IRQsetSleep(true);
-    if((sleeping_list==NULL)||(x->wakeup_time <= sleeping_list->wakeup_time))
-    {
-        x->next=sleeping_list;
-        sleeping_list=x;   
-    } else {
-       SleepData *cur=sleeping_list;
-       for(;;)
-       {
-           if((cur->next==NULL)||(x->wakeup_time <= cur->next->wakeup_time))
-           {
-               x->next=cur->next;
-               cur->next=x;
-               break;
-           }
-           cur=cur->next;
-       }
-    }
+    sleeping_list.add(x);
 }
 
 /**
@@ -268,20 +293,53 @@ void IRQaddToSleepingList(SleepData *x)
 bool IRQwakeThreads()
 {
     tick++;//Increment tick
-    bool result=false;
-    for(;;)
-    {
-        if(sleeping_list==NULL) break;//If no item in list, return
-        //Since list is sorted, if we don't need to wake the first element
-        //we don't need to wake the other too
-        if(tick != sleeping_list->wakeup_time) break;
-        sleeping_list->p->flags.IRQsetSleep(false);//Wake thread
-        sleeping_list=sleeping_list->next;//Remove from list
-        result=true;
-    }
+    //The timer wheel advances with the tick, and returns the threads whose
+    //wakeup time is the new tick
+    return sleeping_list.tick([](SleepData *d){
+        d->p->flags.IRQsetSleep(false);//Wake thread
+    });
+}
+
+#ifdef WITH_TICKLESS_IDLE
+
+/**
+ * \internal
+ * Called by the tick interrupt in place of IRQwakeThreads() in the tickless
+ * idle mode. Increases the system tick by all the ticks elapsed since the
+ * last interrupt, which are more than one after the idle thread has run, and
+ * wakes the threads whose wakeup time has passed.
+ * It is used by the kernel, and should not be used by end users.
+ * \return true if some thread was woken.
+ */
+bool IRQticklessWakeThreads()
+{
+    bool result=tickless_timer.IRQupdate(sleeping_list,[](SleepData *d){
+        d->p->flags.IRQsetSleep(false);//Wake thread
+    });
+    tick=sleeping_list.getTime();
     return result;
 }
 
+/**
+ * \internal
+ * Called after the scheduler has chosen the thread to run, programs the tick
+ * interrupt at the next tick, or at the next wakeup of the sleeping threads
+ * if the idle thread is going to run.
+ * It is used by the kernel, and should not be used by end users.
+ * \param force if false the interrupt is programmed only if the idle thread
+ * is starting or stopping to run. When a thread leaves the idle thread the
+ * next tick is usually past, and the interrupt happens immediately, adding
+ * the elapsed ticks
+ */
+void IRQticklessProgram(bool force)
+{
+    bool idle= cur==idle_thread;
+    if(force || idle!=tickless_timer.isIdle())
+        tickless_timer.IRQprogram(sleeping_list,idle);
+}
+
+#endif //WITH_TICKLESS_IDLE
+
 /*
 Memory layout for a thread
 	|------------------------|
@@ -303,24 +361,7 @@ Thread *Thread::create(void *(*startfunc)(void *), unsigned int stacksize,
     
     Thread *thread=doCreate(startfunc,stacksize,argv,options,false);
     if(thread==NULL) return NULL;
-    
-    //Add thread to thread list
-    {
-        //Handling the list of threads, critical section is required
-        PauseKernelLock lock;
-        if(Scheduler::PKaddThread(thread,priority)==false)
-        {
-            //Reached limit on number of threads
-            unsigned int *base=thread->watermark;
-            thread->~Thread();
-            free(base); //Delete ALL thread memory
-            return NULL;
-        }
-    }
-    #ifdef SCHED_TYPE_EDF
-    if(isKernelRunning()) yield(); //The new thread might have a closer deadline
-    #endif //SCHED_TYPE_EDF
-    return thread;
+    return addThread(thread,priority);
 }
 
 Thread *Thread::create(void (*startfunc)(void *), unsigned int stacksize,
@@ -331,6 +372,38 @@ Thread *Thread::create(void (*startfunc)(void *), unsigned int stacksize,
             stacksize,priority,argv,options);
 }
 
+Thread *Thread::createStatic(void *(*startfunc)(void *), unsigned int *memory,
+        unsigned int stacksize, Priority priority, void *argv,
+        unsigned short options)
+{
+    //Check to see if input parameters are valid
+    if(priority.validate()==false || stacksize<STACK_MIN || memory==NULL)
+        return NULL;
+
+    Thread *thread=doCreate(startfunc,stacksize,argv,options,false,memory);
+    if(thread==NULL) return NULL;
+    return addThread(thread,priority);
+}
+
+unsigned int Thread::getStackUsed(const unsigned int *memory,
+        unsigned int stacksize)
+{
+    //The stack is between the watermark and the Thread class, allocated at
+    //its top, and grows downwards, so the unused part is at the bottom
+    const unsigned int *bottom=memory+WATERMARK_LEN/sizeof(unsigned int);
+    const unsigned int *top=memory+stackMemorySize(stacksize)/sizeof(unsigned int);
+    const unsigned int *walk=bottom;
+    while(walk<top && *walk==STACK_FILL) walk++;
+    return (top-walk)*sizeof(unsigned int);
+}
+
+bool Thread::isWatermarkOk(const unsigned int *memory)
+{
+    for(unsigned int i=0;i<WATERMARK_LEN/sizeof(unsigned int);i++)
+        if(memory[i]!=WATERMARK_FILL) return false;
+    return true;
+}
+
 void Thread::yield()
 {
     miosix_private::doYield();
@@ -586,28 +659,25 @@ int Thread::getStackSize()
 }
 
 Thread *Thread::doCreate(void*(*startfunc)(void*) , unsigned int stacksize,
-                      void* argv, unsigned short options, bool defaultReent)
+                      void* argv, unsigned short options, bool defaultReent,
+                      unsigned int *memory)
 {
-    unsigned int fullStackSize=WATERMARK_LEN+CTXSAVE_ON_STACK+stacksize;
-    
-    //Align fullStackSize to the platform required stack alignment
-    fullStackSize+=CTXSAVE_STACK_ALIGNMENT-1;
-    fullStackSize/=CTXSAVE_STACK_ALIGNMENT;
-    fullStackSize*=CTXSAVE_STACK_ALIGNMENT;
+    //Aligned to the platform required stack alignment
+    unsigned int fullStackSize=stackMemorySize(stacksize);
     
     //Allocate memory for the thread, return if fail
-    unsigned int *base=static_cast<unsigned int*>(malloc(sizeof(Thread)+
-            fullStackSize));
+    unsigned int *base=memory;
+    if(base==NULL) base=static_cast<unsigned int*>(malloc(memorySize(stacksize)));
     if(base==NULL) return NULL;
     
     //At the top of thread memory allocate the Thread class with placement new
     void *threadClass=base+(fullStackSize/sizeof(unsigned int));
     Thread *thread=new (threadClass) Thread(base,stacksize,defaultReent);
+    if(memory) thread->flags.IRQsetStaticMemory();
     
     if(thread->cReentrancyData==nullptr)
     {
-         thread->~Thread();
-         free(base); //Delete ALL thread memory
+         deallocate(thread); //Delete ALL thread memory
          return NULL;
     }
 
@@ -700,6 +770,34 @@ void Thread::threadLauncher(void *(*threadfunc)(void*), void *argv)
     errorHandler(UNEXPECTED);
 }
 
+Thread *Thread::addThread(Thread *thread, Priority priority)
+{
+    //Add thread to thread list
+    {
+        //Handling the list of threads, critical section is required
+        PauseKernelLock lock;
+        if(Scheduler::PKaddThread(thread,priority)==false)
+        {
+            //Reached limit on number of threads
+            deallocate(thread); //Delete ALL thread memory
+            return NULL;
+        }
+    }
+    #ifdef SCHED_TYPE_EDF
+    if(isKernelRunning()) yield(); //The new thread might have a closer deadline
+    #endif //SCHED_TYPE_EDF
+    return thread;
+}
+
+void Thread::deallocate(Thread *thread)
+{
+    //Call destructor manually because of placement new
+    void *base=thread->watermark;
+    bool staticMemory=thread->flags.isStaticMemory();
+    thread->~Thread();
+    if(staticMemory==false) free(base);
+}
+
 Thread *Thread::allocateIdleThread()
 {
     //NOTE: this function is only called once before the kernel is started, so
@@ -775,7 +873,7 @@ void Thread::setupUserspaceContext(unsigned int entry, unsigned int *gotBase,
 #endif //WITH_PROCESSES
 
 Thread::Thread(unsigned int *watermark, unsigned int stacksize,
-               bool defaultReent) : schedData(), flags(), savedPriority(0),
+               bool defaultReent) : schedData(), flags(this), savedPriority(0),
                mutexLocked(0), mutexWaiting(0), watermark(watermark),
                ctxsave(), stacksize(stacksize)
 {
@@ -789,6 +887,10 @@ Thread::Thread(unsigned int *watermark, unsigned int stacksize,
     proc=kernel;
     userCtxsave=nullptr;
     #endif //WITH_PROCESSES
+    #ifdef WITH_CPU_TIME_COUNTER
+    cpuTime=0;
+    CPUTimeCounter::addThread(this);
+    #endif //WITH_CPU_TIME_COUNTER
 }
 
 Thread::~Thread()
@@ -801,6 +903,9 @@ Thread::~Thread()
     #ifdef WITH_PROCESSES
     if(userCtxsave) delete[] userCtxsave;
     #endif //WITH_PROCESSES
+    #ifdef WITH_CPU_TIME_COUNTER
+    CPUTimeCounter::removeThread(this);
+    #endif //WITH_CPU_TIME_COUNTER
 }
 
 //
@@ -810,31 +915,31 @@ Thread::~Thread()
 void Thread::ThreadFlags::IRQsetWait(bool waiting)
 {
     if(waiting) flags |= WAIT; else flags &= ~WAIT;
-    Scheduler::IRQwaitStatusHook();
+    Scheduler::IRQwaitStatusHook(t);
 }
 
 void Thread::ThreadFlags::IRQsetJoinWait(bool waiting)
 {
     if(waiting) flags |= WAIT_JOIN; else flags &= ~WAIT_JOIN;
-    Scheduler::IRQwaitStatusHook();
+    Scheduler::IRQwaitStatusHook(t);
 }
 
 void Thread::ThreadFlags::IRQsetCondWait(bool waiting)
 {
     if(waiting) flags |= WAIT_COND; else flags &= ~WAIT_COND;
-    Scheduler::IRQwaitStatusHook();
+    Scheduler::IRQwaitStatusHook(t);
 }
 
 void Thread::ThreadFlags::IRQsetSleep(bool sleeping)
 {
     if(sleeping) flags |= SLEEP; else flags &= ~SLEEP;
-    Scheduler::IRQwaitStatusHook();
+    Scheduler::IRQwaitStatusHook(t);
 }
 
 void Thread::ThreadFlags::IRQsetDeleted()
 {
     flags |= DELETED;
-    Scheduler::IRQwaitStatusHook();
+    Scheduler::IRQwaitStatusHook(t);
 }
 
 } //namespace miosix
@@ -189,11 +189,13 @@ private:
 /**
  * This class is a RAII lock for disabling interrupts. This call avoids
  * the error of not reenabling interrupts since it is done automatically.
- * As opposed to InterruptDisableLock, this version doesn't support nesting
+ * As opposed to InterruptDisableLock, this version doesn't support nesting.
+ * With WITH_IRQ_TRACE it is recorded by IRQTrace, and it is not inlined.
  */
 class FastInterruptDisableLock
 {
 public:
+    #ifndef WITH_IRQ_TRACE
     /**
      * Constructor, disables interrupts.
      */
@@ -209,6 +211,10 @@ public:
     {
         fastEnableInterrupts();
     }
+    #else //WITH_IRQ_TRACE
+    FastInterruptDisableLock();
+    ~FastInterruptDisableLock();
+    #endif //WITH_IRQ_TRACE
 
 private:
     //Unwanted methods
@@ -219,10 +225,12 @@ private:
 /**
  * This class allows to temporarily re enable interrpts in a scope where
  * they are disabled with an FastInterruptDisableLock.
+ * With WITH_IRQ_TRACE it is recorded by IRQTrace, and it is not inlined.
  */
 class FastInterruptEnableLock
 {
 public:
+    #ifndef WITH_IRQ_TRACE
     /**
      * Constructor, enables back interrupts.
      * \param l the InteruptDisableLock that disabled interrupts. Note that
@@ -244,6 +252,10 @@ public:
     {
         fastDisableInterrupts();
     }
+    #else //WITH_IRQ_TRACE
+    FastInterruptEnableLock(FastInterruptDisableLock& l);
+    ~FastInterruptEnableLock();
+    #endif //WITH_IRQ_TRACE
 
 private:
     //Unwanted methods
@@ -466,6 +478,69 @@ public:
                             Priority priority=Priority(), void *argv=NULL,
                             unsigned short options=DEFAULT);
 
+    /**
+     * Producer method, creates a new thread in statically allocated memory,
+     * declared with ThreadMemory, instead of allocating it in the heap.
+     * The stack size is then known at link time, and the memory is not
+     * freed when the thread terminates, but it can't be reused.
+     * \param startfunc the entry point function for the thread
+     * \param memory memory of the thread, the words of a ThreadMemory
+     * \param stacksize size of thread stack, the one of the ThreadMemory
+     * \param priority the thread's priority, between 0 (lower) and
+     * PRIORITY_MAX-1 (higher)
+     * \param argv a void* pointer that is passed as pararmeter to the entry
+     * point function
+     * \param options thread options, such ad Thread::JOINABLE
+     * \return a reference to the thread created, or NULL in case of errors.
+     *
+     * Can be called when the kernel is paused.
+     */
+    static Thread *createStatic(void *(*startfunc)(void *),
+                            unsigned int *memory, unsigned int stacksize,
+                            Priority priority=Priority(), void *argv=NULL,
+                            unsigned short options=DEFAULT);
+
+    /**
+     * Measures the stack usage of a thread created with createStatic, as
+     * the part of the stack no longer filled with STACK_FILL.
+     * \param memory memory of the thread, as passed to createStatic
+     * \param stacksize size of thread stack, as passed to createStatic
+     * \return the highest stack usage of the thread, in bytes
+     *
+     * Can be called while the thread runs.
+     */
+    static unsigned int getStackUsed(const unsigned int *memory,
+                            unsigned int stacksize);
+
+    /**
+     * \param memory memory of a thread, as passed to createStatic
+     * \return false if the watermark of the thread was overwritten by a
+     * stack overflow
+     */
+    static bool isWatermarkOk(const unsigned int *memory);
+
+    /**
+     * \param stacksize size of thread stack
+     * \return the size in bytes of the memory of a thread, holding the
+     * watermark, the stack and the Thread class, used by ThreadMemory
+     */
+    static constexpr unsigned int memorySize(unsigned int stacksize)
+    {
+        return stackMemorySize(stacksize)+sizeof(Thread);
+    }
+
+    /**
+     * \param stacksize size of thread stack
+     * \return the size in bytes of the watermark and the stack of a thread,
+     * aligned to the platform required stack alignment
+     */
+    static constexpr unsigned int stackMemorySize(unsigned int stacksize)
+    {
+        return (WATERMARK_LEN+CTXSAVE_ON_STACK+stacksize+
+            CTXSAVE_STACK_ALIGNMENT-1)/CTXSAVE_STACK_ALIGNMENT*
+            CTXSAVE_STACK_ALIGNMENT;
+    }
+
     /**
      * When called, suggests the kernel to pause the current thread, and run
      * another one.
@@ -724,8 +799,10 @@ private:
     public:
         /**
          * Constructor, sets flags to default.
+         * \param t thread to which the flags belong, passed to the scheduler
+         * when its status changes
          */
-        ThreadFlags() : flags(0) {}
+        ThreadFlags(Thread *t) : t(t), flags(0) {}
 
         /**
          * Set the wait flag of the thread.
@@ -789,6 +866,15 @@ private:
             if(userspace) flags |= USERSPACE; else flags &= ~USERSPACE;
         }
 
+        /**
+         * Set the static memory flag. This flag can't be cleared.
+         * Can only be called with interrupts disabled or within an interrupt.
+         */
+        void IRQsetStaticMemory()
+        {
+            flags |= STATIC_MEMORY;
+        }
+
         /**
          * \return true if the wait flag is set
          */
@@ -840,6 +926,11 @@ private:
          */
         bool isInUserspace() const { return flags & USERSPACE; }
 
+        /**
+         * \return true if the memory of the thread is statically allocated
+         */
+        bool isStaticMemory() const { return flags & STATIC_MEMORY; }
+
     private:
         ///\internal Thread is in the wait status. A call to wakeup will change
         ///this
@@ -868,6 +959,10 @@ private:
         ///\internal Thread is running in userspace
         static const unsigned int USERSPACE=1<<7;
 
+        ///\internal Thread memory is not allocated in the heap
+        static const unsigned int STATIC_MEMORY=1<<8;
+
+        Thread *t;///<\internal thread to which the flags belong
         unsigned short flags;///<\internal flags are stored here
     };
     
@@ -926,11 +1021,30 @@ private:
      * \param argv argument passed to the thread entry point
      * \param options thread options
      * \param defaultReent true if the default C reentrancy data should be used
+     * \param memory statically allocated memory of memorySize(stacksize)
+     * bytes, or NULL to allocate it in the heap
      * \return a pointer to a thread, or NULL in case there are not enough
      * resources to create one.
      */
     static Thread *doCreate(void *(*startfunc)(void *), unsigned int stacksize,
-					void *argv, unsigned short options, bool defaultReent);
+					void *argv, unsigned short options, bool defaultReent,
+					unsigned int *memory=NULL);
+
+    /**
+     * Helper function to add a new thread to the scheduler, or to delete it
+     * if the scheduler can't take it.
+     * \param thread thread returned by doCreate
+     * \param priority the thread's priority
+     * \return the thread, or NULL in case of errors
+     */
+    static Thread *addThread(Thread *thread, Priority priority);
+
+    /**
+     * Calls the destructor of a thread, and frees its memory if it was
+     * allocated in the heap.
+     * \param thread thread to deallocate
+     */
+    static void deallocate(Thread *thread);
 
     /**
      * Thread launcher, all threads start from this member function, which calls
@@ -992,6 +1106,11 @@ private:
     ///pointer is null
     unsigned int *userCtxsave;
     #endif //WITH_PROCESSES
+    #ifdef WITH_CPU_TIME_COUNTER
+    ///CPU time used by the thread, in cycles of the CPUTimeCounter
+    unsigned long long cpuTime;
+    Thread *timeCounterNext;///< Next thread in the list of CPUTimeCounter
+    #endif //WITH_CPU_TIME_COUNTER
     
     //friend functions
     //Needs access to watermark, ctxsave
@@ -1025,12 +1144,42 @@ private:
     friend int ::pthread_cond_broadcast(pthread_cond_t *cond);
     //Needs access to cppReent
     friend class CppReentrancyAccessor;
+    #ifdef WITH_CPU_TIME_COUNTER
+    //Needs access to watermark, cpuTime, timeCounterNext
+    friend class CPUTimeCounter;
+    #endif //WITH_CPU_TIME_COUNTER
     #ifdef WITH_PROCESSES
     //Needs PKcreateUserspace(), setupUserspaceContext(), switchToUserspace()
     friend class Process;
     #endif //WITH_PROCESSES
 };
 
+/**
+ * Statically allocated memory of a thread created with Thread::createStatic.
+ * It holds the watermark, the stack and the Thread class, laid out as the
+ * memory that Thread::create allocates in the heap, so the RAM used by the
+ * thread is known at link time.
+ * \code
+ * static ThreadMemory<1024> memory;
+ * Thread::createStatic(entry,memory.words,memory.stackSize,priority);
+ * \endcode
+ * \param StackSize size of thread stack, at least STACK_MIN and divisible
+ * by 4
+ */
+template<unsigned int StackSize>
+struct ThreadMemory
+{
+    static_assert(StackSize>=STACK_MIN,"Stack smaller than STACK_MIN");
+    static_assert(StackSize%4==0,"Stack size not divisible by 4");
+    static_assert(alignof(Thread)<=CTXSAVE_STACK_ALIGNMENT,"Thread alignment");
+
+    static const unsigned int stackSize=StackSize; ///< Size of thread stack
+    static const unsigned int size=Thread::memorySize(StackSize); ///< In bytes
+
+    ///Memory of the thread, filled by Thread::createStatic
+    alignas(CTXSAVE_STACK_ALIGNMENT) unsigned int words[size/sizeof(unsigned int)];
+};
+
 /**
  * Function object to compare the priority of two threads.
  */
@@ -1065,7 +1214,7 @@ struct SleepData
     ///the thread will wake
     long long wakeup_time;
     
-    SleepData *next;///<\internal Next thread in the list
+    SleepData *next;///<\internal Next thread in the same timer wheel slot
 };
 
 /**
@@ -92,9 +92,7 @@ void ControlScheduler::PKremoveDeadThreads()
             threadListSize--;
             SP_Tr-=bNominal; //One thread less, reduce round time
         }
-        void *base=toBeDeleted->watermark;
-        toBeDeleted->~Thread();
-        free(base); //Delete ALL thread memory
+        Thread::deallocate(toBeDeleted); //Delete ALL thread memory
     }
     if(threadList!=0)
     {
@@ -109,9 +107,7 @@ void ControlScheduler::PKremoveDeadThreads()
                 threadListSize--;
                 SP_Tr-=bNominal; //One thread less, reduce round time
             }
-            void *base=toBeDeleted->watermark;
-            toBeDeleted->~Thread();
-            free(base); //Delete ALL thread memory
+            Thread::deallocate(toBeDeleted); //Delete ALL thread memory
         }
     }
     {
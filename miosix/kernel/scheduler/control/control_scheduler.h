@@ -129,8 +129,9 @@ public:
      * This member function is called by the kernel every time a thread changes
      * its running status. For example when a thread become sleeping, waiting,
      * deleted or if it exits the sleeping or waiting status
+     * \param thread thread whose status changed
      */
-    static void IRQwaitStatusHook()
+    static void IRQwaitStatusHook(Thread *)
     {
         #ifdef ENABLE_FEEDFORWARD
         IRQrecalculateAlfa();
@@ -0,0 +1,101 @@
+#ifndef EDF_DEADLINE_LIST_H
+#define	EDF_DEADLINE_LIST_H
+
+namespace miosix {
+
+/**
+ * \internal
+ * List of the threads of the EDF scheduler, ordered by absolute deadline.
+ * The scheduler runs the first ready element of the list, so the ready
+ * element with the closest deadline. An element is added before the ones
+ * with the same deadline.<br>
+ * The class has no constructor so that a static instance is zero
+ * initialized, and does not depend on the kernel, so it can be tested on the
+ * host.
+ * \param T type of the elements, usually Thread
+ * \param L class with the static member functions T*& next(T *t), returning
+ * the link to the next element embedded in the element, and
+ * long long deadline(T *t), returning the deadline of the element
+ */
+template<typename T, typename L>
+class EDFDeadlineList
+{
+public:
+    /**
+     * Adds an element, before the elements with a later or equal deadline.
+     * \param t element, not already in the list
+     */
+    void add(T *t)
+    {
+        long long deadline=L::deadline(t);
+        T **walk=&head;
+        while(*walk!=nullptr && L::deadline(*walk)<deadline)
+            walk=&L::next(*walk);
+        L::next(t)=*walk;
+        *walk=t;
+    }
+
+    /**
+     * Removes an element.
+     * \param t element
+     * \return false if the element was not in the list
+     */
+    bool remove(T *t)
+    {
+        for(T **walk=&head;*walk!=nullptr;walk=&L::next(*walk))
+        {
+            if(*walk!=t) continue;
+            *walk=L::next(t);
+            L::next(t)=nullptr;
+            return true;
+        }
+        return false;
+    }
+
+    /**
+     * Removes the elements matching a condition.
+     * \param condition function returning true for the elements to remove
+     * \param removed function called with each removed element, which may
+     * destroy it
+     */
+    template<typename C, typename F>
+    void removeIf(C condition, F removed)
+    {
+        T **walk=&head;
+        while(*walk!=nullptr)
+        {
+            T *t=*walk;
+            if(condition(t))
+            {
+                *walk=L::next(t);
+                removed(t);
+            } else walk=&L::next(t);
+        }
+    }
+
+    /**
+     * \param condition function returning true for the element to find
+     * \return the element with the closest deadline matching the condition,
+     * or nullptr if there is none
+     */
+    template<typename C>
+    T *find(C condition) const
+    {
+        for(T *walk=head;walk!=nullptr;walk=L::next(walk))
+            if(condition(walk)) return walk;
+        return nullptr;
+    }
+
+    /**
+     * \return true if the list has no elements
+     */
+    bool empty() const { return head==nullptr; }
+
+private:
+    ///Element with the closest deadline
+    T *head;
+};
+
+} //namespace miosix
+
+#endif //EDF_DEADLINE_LIST_H
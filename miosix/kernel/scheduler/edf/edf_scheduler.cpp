@@ -28,6 +28,7 @@
 #include "edf_scheduler.h"
 #include "kernel/error.h"
 #include "kernel/process.h"
+#include "kernel/irq_trace.h"
 #include <algorithm>
 
 using namespace std;
@@ -40,151 +41,145 @@ namespace miosix {
 extern volatile Thread *cur;
 extern unsigned char kernel_running;
 
+/**
+ * \internal
+ * Disables interrupts while the deadline list is edited, since
+ * EDFScheduler::IRQsetPriority() edits it from interrupts. Unlike
+ * FastInterruptDisableLock it does nothing if interrupts are already disabled,
+ * as in PKexists() called by Thread::IRQexists(), and before the kernel is
+ * started. With WITH_IRQ_TRACE it is recorded by IRQTrace, with the address of
+ * the scheduler function using it, so it is not inlined.
+ */
+class DeadlineListLock
+{
+public:
+    #ifndef WITH_IRQ_TRACE
+    DeadlineListLock() : enabled(areInterruptsEnabled())
+    {
+        if(enabled) fastDisableInterrupts();
+    }
+
+    ~DeadlineListLock()
+    {
+        if(enabled) fastEnableInterrupts();
+    }
+    #else //WITH_IRQ_TRACE
+    __attribute__((noinline)) DeadlineListLock()
+        : enabled(areInterruptsEnabled())
+    {
+        if(enabled==false) return;
+        fastDisableInterrupts();
+        IRQTrace::IRQcriticalSectionEnter(__builtin_return_address(0));
+    }
+
+    __attribute__((noinline)) ~DeadlineListLock()
+    {
+        if(enabled==false) return;
+        IRQTrace::IRQcriticalSectionLeave(__builtin_return_address(0));
+        fastEnableInterrupts();
+    }
+    #endif //WITH_IRQ_TRACE
+
+private:
+    //Unwanted methods
+    DeadlineListLock(const DeadlineListLock&);
+    DeadlineListLock& operator= (const DeadlineListLock&);
+
+    bool enabled; ///< True if interrupts were enabled
+};
+
 //
 // class EDFScheduler
 //
 
 bool EDFScheduler::PKaddThread(Thread *thread, EDFSchedulerPriority priority)
 {
+    DeadlineListLock dLock;
     thread->schedData.deadline=priority;
-    add(thread);
+    threads.add(thread);
     return true;
 }
 
 bool EDFScheduler::PKexists(Thread *thread)
 {
-    Thread *walk=head;
-    while(walk!=0)
-    {
-        if(walk==thread && (! (walk->flags.isDeleted()))) return true;
-        walk=walk->schedData.next;
-    }
-    return false;
+    DeadlineListLock dLock;
+    return threads.find([thread](Thread *walk){
+        return walk==thread && (! (walk->flags.isDeleted()));
+    })!=nullptr;
 }
 
 void EDFScheduler::PKremoveDeadThreads()
 {
-    //Delete all threads at the beginning of the list
-    for(;;)
+    //The dead threads are unlinked with interrupts disabled, and chained
+    //through their own link to be deleted with interrupts enabled
+    Thread *dead=nullptr;
     {
-        if(head==0) errorHandler(UNEXPECTED); //Empty list is wrong.
-        if(head->flags.isDeleted()==false) break;
-        Thread *toBeDeleted=head;
-        head=head->schedData.next;
-        void *base=toBeDeleted->watermark;
-        toBeDeleted->~Thread();
-        free(base); //Delete ALL thread memory
+        DeadlineListLock dLock;
+        if(threads.empty()) errorHandler(UNEXPECTED); //Empty list is wrong.
+        threads.removeIf([](Thread *walk){ return walk->flags.isDeleted(); },
+            [&dead](Thread *toBeDeleted){
+                toBeDeleted->schedData.next=dead;
+                dead=toBeDeleted;
+            });
     }
-    //When we get here this->head is not null and does not need to be deleted
-    Thread *walk=head;
-    for(;;)
+    while(dead!=nullptr)
     {
-        if(walk->schedData.next==0) break;
-        if(walk->schedData.next->flags.isDeleted())
-        {
-            Thread *toBeDeleted=walk->schedData.next;
-            walk->schedData.next=walk->schedData.next->schedData.next;
-            void *base=toBeDeleted->watermark;
-            toBeDeleted->~Thread();
-            free(base); //Delete ALL thread memory
-        } else walk=walk->schedData.next;
+        Thread *toBeDeleted=dead;
+        dead=dead->schedData.next;
+        Thread::deallocate(toBeDeleted); //Delete ALL thread memory
     }
 }
 
 void EDFScheduler::PKsetPriority(Thread *thread,
         EDFSchedulerPriority newPriority)
+{
+    DeadlineListLock dLock;
+    IRQsetPriority(thread,newPriority);
+}
+
+void EDFScheduler::IRQsetPriority(Thread *thread,
+        EDFSchedulerPriority newPriority)
 {
     remove(thread);
     thread->schedData.deadline=newPriority;
-    add(thread);
+    threads.add(thread);
 }
 
 void EDFScheduler::IRQsetIdleThread(Thread *idleThread)
 {
     idleThread->schedData.deadline=numeric_limits<long long>::max()-1;
-    add(idleThread);
+    threads.add(idleThread);
 }
 
 void EDFScheduler::IRQfindNextThread()
 {
     if(kernel_running!=0) return;//If kernel is paused, do nothing
     
-    Thread *walk=head;
-    for(;;)
-    {
-        if(walk==0) errorHandler(UNEXPECTED);
-        if(walk->flags.isReady())
-        {
-            cur=walk;
-            #ifdef WITH_PROCESSES
-            if(const_cast<Thread*>(cur)->flags.isInUserspace()==false)
-            {
-                ctxsave=cur->ctxsave;
-                MPUConfiguration::IRQdisable();
-            } else {
-                ctxsave=cur->userCtxsave;
-                //A kernel thread is never in userspace, so the cast is safe
-                static_cast<Process*>(cur->proc)->mpu.IRQenable();
-            }
-            #else //WITH_PROCESSES
-            ctxsave=cur->ctxsave;
-            #endif //WITH_PROCESSES
-            return;
-        }
-        walk=walk->schedData.next;
-    }
-}
-
-void EDFScheduler::add(Thread *thread)
-{
-    long long newDeadline=thread->schedData.deadline.get();
-    if(head==0)
+    //The idle thread is always ready, so a thread is always found
+    Thread *walk=threads.find([](Thread *t){ return t->flags.isReady(); });
+    if(walk==nullptr) errorHandler(UNEXPECTED);
+    cur=walk;
+    #ifdef WITH_PROCESSES
+    if(const_cast<Thread*>(cur)->flags.isInUserspace()==false)
     {
-        head=thread;
-        return;
-    }
-    if(newDeadline<=head->schedData.deadline.get())
-    {
-        thread->schedData.next=head;
-        head=thread;
-        return;
-    }
-    Thread *walk=head;
-    for(;;)
-    {
-        if(walk->schedData.next==0 || newDeadline<=
-           walk->schedData.next->schedData.deadline.get())
-        {
-            thread->schedData.next=walk->schedData.next;
-            walk->schedData.next=thread;
-            break;
-        }
-        walk=walk->schedData.next;
+        ctxsave=cur->ctxsave;
+        MPUConfiguration::IRQdisable();
+    } else {
+        ctxsave=cur->userCtxsave;
+        //A kernel thread is never in userspace, so the cast is safe
+        static_cast<Process*>(cur->proc)->mpu.IRQenable();
     }
+    #else //WITH_PROCESSES
+    ctxsave=cur->ctxsave;
+    #endif //WITH_PROCESSES
 }
 
 void EDFScheduler::remove(Thread *thread)
 {
-    if(head==0) errorHandler(UNEXPECTED);
-    if(head==thread)
-    {
-        head=head->schedData.next;
-        return;
-    }
-    Thread *walk=head;
-    for(;;)
-    {
-        if(walk->schedData.next==0) errorHandler(UNEXPECTED);
-        if(walk->schedData.next==thread)
-        {
-            walk->schedData.next=walk->schedData.next->schedData.next;
-            break;
-        }
-        walk=walk->schedData.next;
-    }
+    if(threads.remove(thread)==false) errorHandler(UNEXPECTED);
 }
 
-Thread *EDFScheduler::head=0;
+EDFScheduler::DeadlineList EDFScheduler::threads;
 
 } //namespace miosix
 
@@ -30,6 +30,7 @@
 
 #include "config/miosix_settings.h"
 #include "edf_scheduler_types.h"
+#include "edf_deadline_list.h"
 #include "kernel/kernel.h"
 #include <list>
 
@@ -84,6 +85,16 @@ public:
      */
     static void PKsetPriority(Thread *thread, EDFSchedulerPriority newPriority);
 
+    /**
+     * \internal
+     * Same as PKsetPriority, but meant to be called with interrupts disabled,
+     * for example to release a thread with a new deadline from an interrupt.
+     * \param thread thread whose priority needs to be changed.
+     * \param newPriority new thread priority.
+     * Priority must be a positive value.
+     */
+    static void IRQsetPriority(Thread *thread, EDFSchedulerPriority newPriority);
+
     /**
      * \internal
      * Get the priority of a thread.
@@ -119,8 +130,9 @@ public:
      * This member function is called by the kernel every time a thread changes
      * its running status. For example when a thread become sleeping, waiting,
      * deleted or if it exits the sleeping or waiting status
+     * \param thread thread whose status changed
      */
-    static void IRQwaitStatusHook() {}
+    static void IRQwaitStatusHook(Thread *) {}
 
     /**
      * This function is used to develop interrupt driven peripheral drivers.<br>
@@ -139,10 +151,24 @@ public:
 private:
 
     /**
-     * Add a thread to the list of threads, keeping the list ordered by deadline
-     * \param thread thread to add
+     * \internal
+     * Gives the deadline list access to the link and the deadline embedded in
+     * the threads
      */
-    static void add(Thread *thread);
+    struct DeadlineLinks
+    {
+        static Thread*& next(Thread *thread)
+        {
+            return thread->schedData.next;
+        }
+
+        static long long deadline(Thread *thread)
+        {
+            return thread->schedData.deadline.get();
+        }
+    };
+
+    typedef EDFDeadlineList<Thread,DeadlineLinks> DeadlineList;
 
     /**
      * Remove a thread to the list of threads.
@@ -150,7 +176,10 @@ private:
      */
     static void remove(Thread *thread);
 
-    static Thread *head;///<\internal Head of threads list, ordered by deadline
+    ///\internal List of threads, ordered by deadline. Zero initialized, as it
+    ///has no constructor. As IRQsetPriority() moves the threads from the
+    ///interrupts, it is always accessed with interrupts disabled
+    static DeadlineList threads;
 };
 
 } //namespace miosix
@@ -0,0 +1,145 @@
+#ifndef PRIORITY_READY_QUEUE_H
+#define	PRIORITY_READY_QUEUE_H
+
+namespace miosix {
+
+/**
+ * \internal
+ * Links of an element in the ready list of its priority. Both pointers are
+ * null when the element is not in the ready queue.
+ */
+template<typename T>
+struct ReadyQueueLinks
+{
+    T *next;///< Next element in the ready list of the same priority
+    T *prev;///< Previous element in the ready list of the same priority
+};
+
+/**
+ * \internal
+ * Ready queue of the priority scheduler, which selects the next element to
+ * run in constant time regardless of the number of elements that are not
+ * ready.<br>
+ * There is one circular doubly linked list for each priority, holding only
+ * the ready elements, and a bitmap with a bit set for each priority whose
+ * list is not empty. The highest ready priority is the most significant set
+ * bit of the bitmap, found with a single count leading zeros instruction.
+ * <br>Within a priority the elements are scheduled round robin. The list
+ * pointer of each priority points to the element selected last, so the
+ * next one to run is the one that follows it, and an element that becomes
+ * ready is inserted before it, to run after all the other ready elements of
+ * the same priority.<br>
+ * The class has no constructor so that a static instance is zero
+ * initialized, and does not depend on the kernel, so it can be tested on the
+ * host.
+ * \param T type of the elements, usually Thread
+ * \param LEVELS number of priorities, from 0 to LEVELS-1, at most 32
+ * \param L class with a static member function ReadyQueueLinks<T>& get(T *t)
+ * returning the links embedded in the element
+ */
+template<typename T, int LEVELS, typename L>
+class PriorityReadyQueue
+{
+public:
+    static_assert(LEVELS>0 && LEVELS<=32, "One bit per priority in bitmap");
+
+    /**
+     * Adds an element to the ready list of its priority, as the last one to
+     * run before the element selected last, usually the running one.
+     * \param t element, not already in the queue
+     * \param level priority of the element
+     */
+    void add(T *t, int level)
+    {
+        ReadyQueueLinks<T>& links=L::get(t);
+        T *last=lists[level];
+        if(last==nullptr)
+        {
+            links.next=t;
+            links.prev=t;
+            lists[level]=t;
+            bitmap|=1u<<level;
+        } else {
+            T *prev=L::get(last).prev;
+            links.next=last;
+            links.prev=prev;
+            L::get(prev).next=t;
+            L::get(last).prev=t;
+        }
+    }
+
+    /**
+     * Removes an element from the ready list of its priority, without
+     * changing the order in which the other elements are selected.
+     * \param t element, in the queue
+     * \param level priority of the element
+     */
+    void remove(T *t, int level)
+    {
+        ReadyQueueLinks<T>& links=L::get(t);
+        if(links.next==t)
+        {
+            lists[level]=nullptr;
+            bitmap&=~(1u<<level);
+        } else {
+            L::get(links.prev).next=links.next;
+            L::get(links.next).prev=links.prev;
+            if(lists[level]==t) lists[level]=links.prev;
+        }
+        links.next=nullptr;
+        links.prev=nullptr;
+    }
+
+    /**
+     * \param t element
+     * \return true if the element is in the queue
+     */
+    static bool contains(T *t)
+    {
+        return L::get(t).next!=nullptr;
+    }
+
+    /**
+     * \return true if no element is ready
+     */
+    bool empty() const { return bitmap==0; }
+
+    /**
+     * \return the highest priority with a ready element, -1 if the queue is
+     * empty
+     */
+    int highestPriority() const
+    {
+        if(bitmap==0) return -1;
+        return 31-__builtin_clz(bitmap);
+    }
+
+    /**
+     * Selects the next element to run, the one following the element
+     * selected last in the list of the highest ready priority.
+     * \return the selected element, or nullptr if the queue is empty
+     */
+    T *next()
+    {
+        if(bitmap==0) return nullptr;
+        int level=31-__builtin_clz(bitmap);
+        T *t=L::get(lists[level]).next;
+        lists[level]=t;
+        return t;
+    }
+
+    /**
+     * \return the bitmap of the priorities with a ready element
+     */
+    unsigned int getBitmap() const { return bitmap; }
+
+private:
+    ///Bit i set if lists[i] is not empty
+    unsigned int bitmap;
+    ///Ready list of each priority, points to the element selected last
+    T *lists[LEVELS];
+};
+
+} //namespace miosix
+
+#endif //PRIORITY_READY_QUEUE_H
@@ -53,6 +53,10 @@ bool PriorityScheduler::PKaddThread(Thread *thread,
         thread->schedData.next=thread_list[priority.get()]->schedData.next;
         thread_list[priority.get()]->schedData.next=thread;
     }
+    //The ready queue is also modified by interrupts, and this is called by
+    //startKernel with interrupts already disabled, so use the nesting lock
+    InterruptDisableLock dLock;
+    if(thread->flags.isReady()) ready.add(thread,priority.get());
     return true;
 }
 
@@ -89,10 +93,7 @@ void PriorityScheduler::PKremoveDeadThreads()
             if(thread_list[i]->schedData.next==thread_list[i])
             {
                 //Only one element in the list
-                //Call destructor manually because of placement new
-                void *base=thread_list[i]->watermark;
-                thread_list[i]->~Thread();
-                free(base); //Delete ALL thread memory
+                Thread::deallocate(thread_list[i]); //Delete ALL thread memory
                 thread_list[i]=NULL;
                 break;
             }
@@ -109,10 +110,7 @@ void PriorityScheduler::PKremoveDeadThreads()
             thread_list[i]=thread_list[i]->schedData.next;//Remove from list
             //Fix the tail of the circular list
             tail->schedData.next=thread_list[i];
-            //Call destructor manually because of placement new
-            void *base=d->watermark;
-            d->~Thread();
-            free(base);//Delete ALL thread memory
+            Thread::deallocate(d); //Delete ALL thread memory
         }
         if(thread_list[i]==NULL) continue;
         //If it comes here, the first item is not NULL, and doesn't have
@@ -127,10 +125,7 @@ void PriorityScheduler::PKremoveDeadThreads()
                 Thread *d=temp->schedData.next;//Save a pointer to the thread
                 //Remove from list
                 temp->schedData.next=temp->schedData.next->schedData.next;
-                //Call destructor manually because of placement new
-                void *base=d->watermark;
-                d->~Thread();
-                free(base);//Delete ALL thread memory
+                Thread::deallocate(d); //Delete ALL thread memory
             } else temp=temp->schedData.next;
         }
     }
@@ -140,8 +135,18 @@ void PriorityScheduler::PKsetPriority(Thread *thread,
         PrioritySchedulerPriority newPriority)
 {
     PrioritySchedulerPriority oldPriority=getPriority(thread);
-    //First set priority to the new value
-    thread->schedData.priority=newPriority;
+    //First set priority to the new value, and move the thread to the ready
+    //list of the new priority, with interrupts disabled as the ready queue
+    //and the priority are used by IRQwaitStatusHook()
+    {
+        InterruptDisableLock dLock;
+        thread->schedData.priority=newPriority;
+        if(ReadyQueue::contains(thread))
+        {
+            ready.remove(thread,oldPriority.get());
+            ready.add(thread,newPriority.get());
+        }
+    }
     //Then remove the thread from its old list
     if(thread_list[oldPriority.get()]==thread)
     {
@@ -200,36 +205,28 @@ void PriorityScheduler::IRQsetIdleThread(Thread *idleThread)
 void PriorityScheduler::IRQfindNextThread()
 {
     if(kernel_running!=0) return;//If kernel is paused, do nothing
-    for(int i=PRIORITY_MAX-1;i>=0;i--)
+    //The highest ready priority is found from the bitmap of the ready queue,
+    //and the ready list of that priority is rotated so that next time a
+    //different thread, if available, will be chosen first
+    Thread *temp=ready.next();
+    if(temp!=nullptr)
     {
-        if(thread_list[i]==NULL) continue;
-        Thread *temp=thread_list[i]->schedData.next;
-        for(;;)
+        //Found a READY thread, so run this one
+        cur=temp;
+        #ifdef WITH_PROCESSES
+        if(const_cast<Thread*>(cur)->flags.isInUserspace()==false)
         {
-            if(temp->flags.isReady())
-            {
-                //Found a READY thread, so run this one
-                cur=temp;
-                #ifdef WITH_PROCESSES
-                if(const_cast<Thread*>(cur)->flags.isInUserspace()==false)
-                {
-                    ctxsave=cur->ctxsave;
-                    MPUConfiguration::IRQdisable();
-                } else {
-                    ctxsave=cur->userCtxsave;
-                    //A kernel thread is never in userspace, so the cast is safe
-                    static_cast<Process*>(cur->proc)->mpu.IRQenable();
-                }
-                #else //WITH_PROCESSES
-                ctxsave=temp->ctxsave;
-                #endif //WITH_PROCESSES
-                //Rotate to next thread so that next time the list is walked
-                //a different thread, if available, will be chosen first
-                thread_list[i]=temp;
-                return;
-            } else temp=temp->schedData.next;
-            if(temp==thread_list[i]->schedData.next) break;
+            ctxsave=cur->ctxsave;
+            MPUConfiguration::IRQdisable();
+        } else {
+            ctxsave=cur->userCtxsave;
+            //A kernel thread is never in userspace, so the cast is safe
+            static_cast<Process*>(cur->proc)->mpu.IRQenable();
         }
+        #else //WITH_PROCESSES
+        ctxsave=temp->ctxsave;
+        #endif //WITH_PROCESSES
+        return;
     }
     //No thread found, run the idle thread
     cur=idle;
@@ -241,6 +238,7 @@ void PriorityScheduler::IRQfindNextThread()
 
 Thread *PriorityScheduler::thread_list[PRIORITY_MAX]={0};
 Thread *PriorityScheduler::idle=0;
+PriorityScheduler::ReadyQueue PriorityScheduler::ready;
 
 } //namespace miosix
 
@@ -120,9 +120,22 @@ public:
      * \internal
      * This member function is called by the kernel every time a thread changes
      * its running status. For example when a thread become sleeping, waiting,
-     * deleted or if it exits the sleeping or waiting status
+     * deleted or if it exits the sleeping or waiting status.<br>
+     * Moves the thread in or out of the ready queue.
+     * \param thread thread whose status changed
      */
-    static void IRQwaitStatusHook() {}
+    static void IRQwaitStatusHook(Thread *thread)
+    {
+        //Threads not yet added, and the idle thread, are not in the lists
+        if(thread->schedData.next==nullptr) return;
+        bool queued=ReadyQueue::contains(thread);
+        if(thread->flags.isReady())
+        {
+            if(!queued) ready.add(thread,thread->schedData.priority.get());
+        } else {
+            if(queued) ready.remove(thread,thread->schedData.priority.get());
+        }
+    }
 
     /**
      * \internal
@@ -141,11 +154,30 @@ public:
 
 private:
 
+    /**
+     * \internal
+     * Gives the ready queue access to the links embedded in the threads
+     */
+    struct ReadyLinks
+    {
+        static ReadyQueueLinks<Thread>& get(Thread *thread)
+        {
+            return thread->schedData.ready;
+        }
+    };
+
+    typedef PriorityReadyQueue<Thread,PRIORITY_MAX,ReadyLinks> ReadyQueue;
+
     ///\internal Vector of lists of threads, there's one list for each priority
     ///Each list s a circular list.
     ///(since 0=NULL, using aggregate initialization)
     static Thread *thread_list[PRIORITY_MAX];
 
+    ///\internal Ready threads, there's a ready list for each priority and a
+    ///bitmap of the non empty lists, so the next thread is found in constant
+    ///time. Zero initialized, as it has no constructor
+    static ReadyQueue ready;
+
     ///\internal idle thread
     static Thread *idle;
 };
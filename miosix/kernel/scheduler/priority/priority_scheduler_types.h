@@ -26,6 +26,7 @@
  ***************************************************************************/
 
 #include "config/miosix_settings.h"
+#include "priority_ready_queue.h"
 
 #ifndef PRIORITY_SCHEDULER_TYPES_H
 #define	PRIORITY_SCHEDULER_TYPES_H
@@ -113,12 +114,16 @@ inline bool operator !=(PrioritySchedulerPriority a, PrioritySchedulerPriority b
 class PrioritySchedulerData
 {
 public:
+    PrioritySchedulerData() : next(nullptr), ready{nullptr,nullptr} {}
+
     ///Thread priority. Used to speed up the implementation of getPriority.<br>
     ///Note that to change the priority of a thread it is not enough to change
     ///this.<br>It is also necessary to move the thread from the old prority
     ///list to the new priority list.
     PrioritySchedulerPriority priority;
     Thread *next;///<Pointer to next thread of the same priority. CIRCULAR list
+    ///Links in the ready list of the same priority, null if not ready
+    ReadyQueueLinks<Thread> ready;
 };
 
 } //namespace miosix
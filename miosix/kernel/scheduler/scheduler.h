@@ -32,11 +32,16 @@
 #include "kernel/scheduler/priority/priority_scheduler.h"
 #include "kernel/scheduler/control/control_scheduler.h"
 #include "kernel/scheduler/edf/edf_scheduler.h"
+#include "kernel/cpu_time_counter.h"
 
 namespace miosix {
 
 class Thread; //Forward declaration
 
+#ifdef WITH_TICKLESS_IDLE
+void IRQticklessProgram(bool force);///\internal Do not use outside the kernel
+#endif //WITH_TICKLESS_IDLE
+
 /**
  * \internal
  * This class is the common interface between the kernel and the scheduling
@@ -146,10 +151,11 @@ public:
      * This member function is called by the kernel every time a thread changes
      * its running status. For example when a thread become sleeping, waiting,
      * deleted or if it exits the sleeping or waiting status
+     * \param thread thread whose status changed
      */
-    static void IRQwaitStatusHook()
+    static void IRQwaitStatusHook(Thread *thread)
     {
-        T::IRQwaitStatusHook();
+        T::IRQwaitStatusHook(thread);
     }
 
     /**
@@ -166,7 +172,14 @@ public:
      */
     static void IRQfindNextThread()
     {
+        #ifdef WITH_CPU_TIME_COUNTER
+        //Charge the time since the last call to the thread that was running
+        CPUTimeCounter::IRQprofileContextSwitch();
+        #endif //WITH_CPU_TIME_COUNTER
         T::IRQfindNextThread();
+        #ifdef WITH_TICKLESS_IDLE
+        IRQticklessProgram(false);
+        #endif //WITH_TICKLESS_IDLE
     }
 
 };
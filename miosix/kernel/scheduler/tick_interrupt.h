@@ -40,10 +40,18 @@ extern unsigned char kernel_running;///\internal Do not use outside the kernel
 extern volatile bool tick_skew;///\internal Do not use outside the kernel
 extern volatile Thread *cur;///\internal Do not use outside the kernel
 extern bool IRQwakeThreads();///\internal Do not use outside the kernel
+#ifdef WITH_TICKLESS_IDLE
+extern bool IRQticklessWakeThreads();///\internal Do not use outside the kernel
+#endif //WITH_TICKLESS_IDLE
 
 inline void IRQtickInterrupt()
 {
+    #ifdef WITH_TICKLESS_IDLE
+    //Add the ticks elapsed since the last interrupt and wake threads, if any
+    bool woken=IRQticklessWakeThreads();
+    #else //WITH_TICKLESS_IDLE
     bool woken=IRQwakeThreads();//Increment tick and wake threads,if any
+    #endif //WITH_TICKLESS_IDLE
     (void)woken; //Avoid unused variable warning.
 
     #ifdef SCHED_TYPE_PRIORITY
@@ -70,6 +78,11 @@ inline void IRQtickInterrupt()
         if(kernel_running!=0) tick_skew=true;
     }
     #endif
+
+    #ifdef WITH_TICKLESS_IDLE
+    //The compare interrupt fires once, so program the next one
+    IRQticklessProgram(true);
+    #endif //WITH_TICKLESS_IDLE
 }
 
 }
@@ -283,6 +283,18 @@ bool Mutex::PKunlock(PauseKernelLock& dLock)
     }
 }
 
+void Mutex::PKadopt(Thread *t)
+{
+    if(owner!=0) errorHandler(UNEXPECTED);
+    owner=t;
+    //Save original thread priority, if the thread has not yet locked
+    //another mutex
+    if(owner->mutexLocked==0) owner->savedPriority=owner->getPriority();
+    //Add this mutex to the list of mutexes locked by owner
+    this->next=owner->mutexLocked;
+    owner->mutexLocked=this;
+}
+
 unsigned int Mutex::PKunlockAllDepthLevels(PauseKernelLock& dLock)
 {
     Thread *p=Thread::getCurrentThread();
@@ -357,6 +369,32 @@ unsigned int Mutex::PKunlockAllDepthLevels(PauseKernelLock& dLock)
     return result;
 }
 
+//
+// class AdaptiveMutex
+//
+
+AdaptiveMutex::Waiters::Waiters()
+{
+    mutex.waiting.reserve(ADAPTIVE_MUTEX_WAITERS);
+}
+
+void AdaptiveMutex::Waiters::PKadopt(unsigned int owner)
+{
+    mutex.PKadopt(reinterpret_cast<Thread*>(owner));
+}
+
+void AdaptiveMutex::Waiters::PKlock(PauseKernelLock& dLock)
+{
+    mutex.PKlock(dLock);
+}
+
+unsigned int AdaptiveMutex::Waiters::PKunlock(PauseKernelLock& dLock,
+        bool& hppw)
+{
+    hppw=mutex.PKunlock(dLock);
+    return reinterpret_cast<unsigned int>(mutex.owner);
+}
+
 //
 // class ConditionVariable
 //
@@ -31,6 +31,8 @@
 #define SYNC_H
 
 #include "kernel.h"
+#include "adaptive_lock.h"
+#include "interfaces/atomic_ops.h"
 #include <vector>
 
 namespace miosix {
@@ -255,6 +257,13 @@ private:
      */
     unsigned int PKunlockAllDepthLevels(PauseKernelLock& dLock);
 
+    /**
+     * Makes a thread the owner of the mutex as if it had locked it, can be
+     * called only with the kernel paused and the mutex free.
+     * \param t thread that becomes the owner
+     */
+    void PKadopt(Thread *t);
+
     /// Thread currently inside critical section, if NULL the critical section
     /// is free
     Thread *owner;
@@ -272,6 +281,108 @@ private:
     //Friends
     friend class ConditionVariable;
     friend class Thread;
+    friend class AdaptiveMutex;
+};
+
+/**
+ * A non recursive mutex with priority inheritance that enters the kernel
+ * only on contention.<br>
+ * Locking and unlocking a free mutex is a single compare and swap, without
+ * pausing the kernel, while a thread that finds the mutex locked pauses the
+ * kernel and waits on a Mutex, whose priority inheritance raises the
+ * priority of the owner as with Mutex. A thread never spins, since on a
+ * single core the owner cannot run while the waiting thread spins.<br>
+ * It cannot be used with ConditionVariable. Like Mutex, it must not be
+ * deleted while locked.
+ */
+class AdaptiveMutex
+{
+public:
+    /**
+     * Constructor, initializes the mutex.
+     */
+    AdaptiveMutex() {}
+
+    /**
+     * Locks the critical section. If the critical section is already locked,
+     * the thread will be queued in a wait list.
+     */
+    void lock()
+    {
+        lockWord.lock(self());
+    }
+
+    /**
+     * Acquires the lock only if the critical section is not already locked.
+     * \return true if the lock was acquired
+     */
+    bool tryLock()
+    {
+        return lockWord.tryLock(self());
+    }
+
+    /**
+     * Unlocks the critical section.
+     */
+    void unlock()
+    {
+        #ifdef SCHED_TYPE_EDF
+        //The other thread might have a closer deadline
+        if(lockWord.unlock(self())) Thread::yield();
+        #else //SCHED_TYPE_EDF
+        lockWord.unlock(self());
+        #endif //SCHED_TYPE_EDF
+    }
+
+private:
+    //Unwanted methods
+    AdaptiveMutex(const AdaptiveMutex& s);///< No public copy constructor
+    AdaptiveMutex& operator = (const AdaptiveMutex& s);///< No publc operator =
+
+    /**
+     * Kernel mutex of the lock word, used on contention, with room for
+     * ADAPTIVE_MUTEX_WAITERS waiting threads
+     */
+    class Waiters
+    {
+    public:
+        Waiters();
+
+        void PKadopt(unsigned int owner);
+        void PKlock(PauseKernelLock& dLock);
+        unsigned int PKunlock(PauseKernelLock& dLock, bool& hppw);
+
+    private:
+        Mutex mutex;
+    };
+
+    /**
+     * Operations of the lock word on the target
+     */
+    struct Policy
+    {
+        typedef unsigned int Word;
+        typedef PauseKernelLock Pause;
+        typedef AdaptiveMutex::Waiters Waiters;
+
+        static Word compareAndSwap(volatile Word *p, Word prev, Word next)
+        {
+            //Keeps the accesses of the critical section before an unlock
+            asm volatile("":::"memory");
+            return atomicCompareAndSwap(reinterpret_cast<volatile int*>(p),
+                    prev,next);
+        }
+    };
+
+    /**
+     * \return the current thread as a lock word
+     */
+    static unsigned int self()
+    {
+        return reinterpret_cast<unsigned int>(Thread::getCurrentThread());
+    }
+
+    AdaptiveLock<Policy> lockWord; ///< Owner, and kernel mutex on contention
 };
 
 /**
@@ -0,0 +1,110 @@
+#ifndef TICKLESS_TIMER_H
+#define	TICKLESS_TIMER_H
+
+namespace miosix {
+
+/**
+ * \internal
+ * Kernel tick of the tickless idle mode, kept from a free running hardware
+ * counter with a compare interrupt instead of a periodic interrupt.<br>
+ * The ticks are accounted from the counter: each time the interrupt fires
+ * or the tick is needed, all the whole ticks elapsed since the last
+ * accounted one are added at once, so no tick is lost however late the
+ * interrupt is, and the tick never drifts from the counter.<br>
+ * While threads are running the compare interrupt is programmed at the next
+ * tick, to preempt them as the periodic tick does. When the idle thread is
+ * going to run, it is programmed at the next event of the sleeping threads
+ * timer wheel, so the CPU sleeps until the first thread has to wake, and no
+ * interrupt competes with the ones of the peripherals in the meantime.
+ * The counter only keeps the tick exact: the wheel, and all the kernel time,
+ * are still counted in ticks, so no thread wakes between two ticks.<br>
+ * The class has no constructor so that a static instance is zero
+ * initialized, and does not depend on the kernel, so it can be tested on the
+ * host with a simulated counter.
+ * \param HW hardware timer, a class with
+ * - static const unsigned int COUNTS_PER_TICK, the counts in a kernel tick
+ * - static unsigned int IRQread(), the value of the 32 bit counter
+ * - static void IRQsetCompare(unsigned int count), programs the interrupt
+ *   when the counter reaches count
+ * - static void IRQpend(), causes the interrupt as soon as possible
+ */
+template<typename HW>
+class TicklessTimer
+{
+public:
+    ///Longest time the interrupt can be programmed ahead, so that the
+    ///difference between the counter and the compare value fits in an int
+    static const unsigned int MAX_TICKS=0x7fffffff/HW::COUNTS_PER_TICK;
+
+    /**
+     * Starts counting the ticks from the current value of the counter, and
+     * programs the interrupt at the next tick.
+     */
+    void IRQstart()
+    {
+        last=HW::IRQread();
+        IRQprogramTicks(1);
+    }
+
+    /**
+     * Advances the tick, and the sleeping threads, to the current value of
+     * the counter.
+     * \param wheel timer wheel of the sleeping threads, whose time is the tick
+     * \param expired function called with each thread to wake
+     * \return true if some thread was woken
+     */
+    template<typename WHEEL, typename F>
+    bool IRQupdate(WHEEL& wheel, F expired)
+    {
+        unsigned int elapsed=(HW::IRQread()-last)/HW::COUNTS_PER_TICK;
+        if(elapsed==0) return false;
+        last+=elapsed*HW::COUNTS_PER_TICK;
+        return wheel.advance(wheel.getTime()+elapsed,expired);
+    }
+
+    /**
+     * Programs the interrupt at the next tick if threads are running, or at
+     * the next event of the sleeping threads if the idle thread is running.
+     * \param wheel timer wheel of the sleeping threads, whose time is the tick
+     * \param idle true if the idle thread is going to run
+     */
+    template<typename WHEEL>
+    void IRQprogram(const WHEEL& wheel, bool idle)
+    {
+        long long ticks=1;
+        if(idle)
+        {
+            ticks=wheel.nextEvent()-wheel.getTime();
+            if(ticks>MAX_TICKS) ticks=MAX_TICKS;
+        }
+        IRQprogramTicks(static_cast<unsigned int>(ticks));
+        programmedIdle=idle;
+    }
+
+    /**
+     * \return true if the interrupt was last programmed for the idle thread
+     */
+    bool isIdle() const { return programmedIdle; }
+
+private:
+    /**
+     * Programs the interrupt a number of ticks after the last accounted one,
+     * or causes it immediately if the counter is already past that time.
+     * \param ticks ticks, at least 1
+     */
+    void IRQprogramTicks(unsigned int ticks)
+    {
+        unsigned int compare=last+ticks*HW::COUNTS_PER_TICK;
+        HW::IRQsetCompare(compare);
+        if(static_cast<int>(compare-HW::IRQread())<=0) HW::IRQpend();
+    }
+
+    ///Value of the counter at the last accounted tick
+    unsigned int last;
+    ///True if the interrupt was programmed for the idle thread
+    bool programmedIdle;
+};
+
+} //namespace miosix
+
+#endif //TICKLESS_TIMER_H
@@ -0,0 +1,215 @@
+#ifndef TIMER_WHEEL_H
+#define	TIMER_WHEEL_H
+
+namespace miosix {
+
+/**
+ * \internal
+ * Hierarchical timer wheel used by the kernel to keep the sleeping threads.
+ * Adding an element and expiring the elements of a tick take constant time,
+ * regardless of the number of elements in the wheel.<br>
+ * Each level has SLOTS slots, and a slot of level k spans SLOTS^k ticks, so
+ * level 0 has a slot for each of the next ticks, level 1 a slot for each
+ * group of SLOTS ticks and so on. An element is added to the lowest level
+ * whose slot also holds the current time in the level above, so its slot
+ * is always ahead of the current one. When the time reaches the start of a
+ * slot of level k>0, the elements of that slot are added again, and move to
+ * the lower levels: every element is moved at most LEVELS-1 times before
+ * expiring. The elements too far in the future for all the levels are kept
+ * in a separate list, added again each time the highest level wraps.<br>
+ * Each level also has a bitmap of its non empty slots.<br>
+ * The elements are intrusive, the wheel uses their fields
+ * long long wakeup_time, the absolute tick at which they expire, and
+ * T *next, to make the list of a slot.<br>
+ * The class has no constructor so that a static instance is zero
+ * initialized, starting at tick 0, and does not depend on the kernel, so it
+ * can be tested on the host.
+ * \param T type of the elements, usually SleepData
+ * \param LEVELS number of levels, the wheel spans 32^LEVELS ticks
+ */
+template<typename T, int LEVELS>
+class TimerWheel
+{
+public:
+    static_assert(LEVELS>0 && LEVELS<=6, "The wheel spans 32^LEVELS ticks");
+
+    ///Number of slots of each level, one bit in the bitmap for each slot
+    static const int SLOTS=32;
+
+    /**
+     * Adds an element, expiring at its wakeup_time. An element whose
+     * wakeup_time is not after the current time expires at the next tick.
+     * \param t element, not already in the wheel
+     */
+    void add(T *t)
+    {
+        insert(t,t->wakeup_time>now ? t->wakeup_time : now+1);
+    }
+
+    /**
+     * Advances the wheel to the next tick, and removes the elements that
+     * expire at that tick.
+     * \param expired function called with each expired element, after it has
+     * been removed from the wheel
+     * \return true if some element expired
+     */
+    template<typename F>
+    bool tick(F expired)
+    {
+        now++;
+        //Move the elements of the slots reached by the time to the lower
+        //levels, starting from the highest level
+        if((now & ((1ll<<(BITS*LEVELS))-1))==0)
+        {
+            T *list=far;
+            far=nullptr;
+            reAdd(list);
+        }
+        for(int level=LEVELS-1;level>0;level--)
+        {
+            if((now & ((1ll<<(BITS*level))-1))!=0) continue;
+            int slot=(now>>(BITS*level)) & (SLOTS-1);
+            T *list=slots[level][slot];
+            if(list==nullptr) continue;
+            slots[level][slot]=nullptr;
+            bitmaps[level]&=~(1u<<slot);
+            reAdd(list);
+        }
+        //The slot of level 0 holds only elements expiring now
+        int slot=now & (SLOTS-1);
+        T *list=slots[0][slot];
+        if(list==nullptr) return false;
+        slots[0][slot]=nullptr;
+        bitmaps[0]&=~(1u<<slot);
+        while(list!=nullptr)
+        {
+            T *next=list->next;
+            list->next=nullptr;
+            expired(list);
+            list=next;
+        }
+        return true;
+    }
+
+    /**
+     * Advances the wheel to a time, in a number of steps that depends only on
+     * the elements in the wheel, as the ticks where tick() has nothing to do
+     * are skipped.
+     * \param time new current time, not before the current time
+     * \param expired function called with each expired element, after it has
+     * been removed from the wheel
+     * \return true if some element expired
+     */
+    template<typename F>
+    bool advance(long long time, F expired)
+    {
+        bool result=false;
+        while(now<time)
+        {
+            long long next=nextEvent();
+            if(next>time)
+            {
+                now=time;
+                break;
+            }
+            now=next-1;
+            if(tick(expired)) result=true;
+        }
+        return result;
+    }
+
+    /**
+     * \return the next time at which tick() expires some element or moves
+     * the elements of a slot to the lower levels. When the wheel is empty,
+     * the time when the highest level wraps
+     */
+    long long nextEvent() const
+    {
+        //The slots of a level are ahead of the ones of the level below, and
+        //the first non empty one is found from the bitmap
+        for(int level=0;level<LEVELS;level++)
+        {
+            int current=(now>>(BITS*level)) & (SLOTS-1);
+            unsigned int ahead=bitmaps[level] & ~((2u<<current)-1);
+            if(ahead==0) continue;
+            long long group=now>>(BITS*(level+1))<<(BITS*(level+1));
+            return group+(static_cast<long long>(__builtin_ctz(ahead))<<(BITS*level));
+        }
+        return ((now>>(BITS*LEVELS))+1)<<(BITS*LEVELS);
+    }
+
+    /**
+     * \return the current time of the wheel, the last tick
+     */
+    long long getTime() const { return now; }
+
+    /**
+     * \return true if the wheel has no elements
+     */
+    bool empty() const
+    {
+        if(far!=nullptr) return false;
+        for(int level=0;level<LEVELS;level++) if(bitmaps[level]) return false;
+        return true;
+    }
+
+    /**
+     * \param level level of the wheel
+     * \return the bitmap of the non empty slots of the level
+     */
+    unsigned int getBitmap(int level) const { return bitmaps[level]; }
+
+private:
+    /**
+     * Inserts an element in the slot of a time.
+     * \param t element
+     * \param when time, not before the current time
+     */
+    void insert(T *t, long long when)
+    {
+        for(int level=0;level<LEVELS;level++)
+        {
+            int shift=BITS*(level+1);
+            if((when>>shift)!=(now>>shift)) continue;
+            int slot=(when>>(BITS*level)) & (SLOTS-1);
+            t->next=slots[level][slot];
+            slots[level][slot]=t;
+            bitmaps[level]|=1u<<slot;
+            return;
+        }
+        t->next=far;
+        far=t;
+    }
+
+    /**
+     * Adds again the elements of a list, at their new level. Elements
+     * expiring at the current time go to the current slot of level 0, which
+     * is expired after the other levels.
+     * \param list elements, linked with their next field
+     */
+    void reAdd(T *list)
+    {
+        while(list!=nullptr)
+        {
+            T *next=list->next;
+            insert(list,list->wakeup_time);
+            list=next;
+        }
+    }
+
+    ///Bits of the time that index the slots of a level
+    static const int BITS=5;
+
+    ///Current time, the last tick
+    long long now;
+    ///Lists of the elements in each slot of each level
+    T *slots[LEVELS][SLOTS];
+    ///Bit i of bitmaps[k] set if slots[k][i] is not empty
+    unsigned int bitmaps[LEVELS];
+    ///Elements beyond the highest level
+    T *far;
+};
+
+} //namespace miosix
+
+#endif //TIMER_WHEEL_H
@@ -0,0 +1,143 @@
+#ifndef TRACE_RING_H
+#define TRACE_RING_H
+
+#include <atomic>
+
+namespace miosix {
+
+/**
+ * Types of the events of IRQTrace
+ */
+enum TraceEventType
+{
+    TRACE_IRQ_ENTER=1, ///< An interrupt handler started
+    TRACE_IRQ_EXIT=2,  ///< An interrupt handler ended
+    TRACE_CS_ENTER=3,  ///< The interrupts were disabled
+    TRACE_CS_LEAVE=4   ///< The interrupts were enabled back
+};
+
+/**
+ * Event of a TraceRing
+ */
+struct TraceEvent
+{
+    unsigned int time; ///< Value of the free running counter
+    unsigned int site; ///< Address of the code, zero for the interrupts
+    unsigned short type; ///< One of TraceEventType
+    short id; ///< Interrupt number, for the interrupt events
+};
+
+/**
+ * Lock free ring of the last N trace events, written by any number of
+ * threads and interrupts, which overwrite the oldest events.
+ *
+ * A writer claims a slot by incrementing the event counter with an atomic
+ * operation, so writers preempting each other never share a slot, then
+ * writes the event and stamps the slot with the value of the counter.
+ * A reader only takes the slots with the expected stamp, read again after
+ * copying the event, so an event overwritten or still being written while
+ * it is read is dropped rather than torn. The writers are stopped with
+ * freeze() while the ring is read, to keep its content stable.<br>
+ * All the members are zero at start, so the ring can be used before the
+ * constructors of the static objects run.<br>
+ * This class does not depend on the kernel, so it can be tested on the host.
+ * \param N number of events, a power of two
+ */
+template<unsigned int N>
+class TraceRing
+{
+public:
+    static_assert(N>0 && (N & (N-1))==0,"The size must be a power of two");
+
+    /**
+     * Adds an event, overwriting the oldest one if the ring is full.
+     * Can be called from any thread or interrupt.
+     * \param event event to add
+     */
+    void record(const TraceEvent& event)
+    {
+        if(frozen.load(std::memory_order_relaxed)) return;
+        unsigned int i=next.fetch_add(1,std::memory_order_relaxed);
+        Slot& slot=slots[i & (N-1)];
+        slot.stamp.store(i-N,std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        slot.event=event;
+        slot.stamp.store(i,std::memory_order_release);
+    }
+
+    /**
+     * Stops adding the events, until resume() is called
+     */
+    void freeze()
+    {
+        frozen.store(true,std::memory_order_relaxed);
+    }
+
+    /**
+     * Starts adding the events again
+     */
+    void resume()
+    {
+        frozen.store(false,std::memory_order_relaxed);
+    }
+
+    /**
+     * Copies the events, oldest first. The ring should be frozen.
+     * \param events array where the events are copied
+     * \param size size of the array, the newest events are copied
+     * \return the number of events copied
+     */
+    unsigned int snapshot(TraceEvent *events, unsigned int size) const
+    {
+        unsigned int end=getCount();
+        unsigned int count=end<N ? end : N;
+        if(count>size) count=size;
+        unsigned int copied=0;
+        for(unsigned int i=end-count;i!=end;i++)
+            if(get(i,events[copied])) copied++;
+        return copied;
+    }
+
+    /**
+     * Copies a single event, to read the ring without a copy of it.
+     * \param i value of getCount() when the event was added, the events
+     * from getCount()-N to getCount()-1 are in the ring
+     * \param event where the event is copied
+     * \return false if the event is no longer in the ring, or was
+     * being written
+     */
+    bool get(unsigned int i, TraceEvent& event) const
+    {
+        const Slot& slot=slots[i & (N-1)];
+        if(slot.stamp.load(std::memory_order_acquire)!=i) return false;
+        event=slot.event;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return slot.stamp.load(std::memory_order_relaxed)==i;
+    }
+
+    /**
+     * \return the number of events added since the start, wrapping around
+     */
+    unsigned int getCount() const
+    {
+        return next.load(std::memory_order_acquire);
+    }
+
+private:
+    /**
+     * Event and the value of the event counter that claimed it
+     */
+    struct Slot
+    {
+        std::atomic<unsigned int> stamp;
+        TraceEvent event;
+    };
+
+    Slot slots[N]; ///< Events
+    std::atomic<unsigned int> next; ///< Events added, wrapping around
+    std::atomic<bool> frozen; ///< True while the events are not added
+};
+
+} //namespace miosix
+
+#endif //TRACE_RING_H
@@ -0,0 +1,129 @@
+#include "../../include/benchmarks/dsp_benchmark.h"
+#include "../../include/config/debug_config.h"
+
+// compiled only when enabled, to keep the objects under test out of the CCM
+#if DSP_BENCHMARK_ENABLED
+
+#include <cstdio>
+#include "../../include/config/audio_config.h"
+#include "../../include/audio/audio_buffer.h"
+#include "../../include/audio/biquad.h"
+#include "../../include/audio/state_variable_filter.h"
+#include "../../include/audio/oversampler.h"
+#include "../../include/audio/sample_voice.h"
+#include "../../miosix/_examples/sad_trombone/sad_trombone.h"
+#include "../../include/drivers/stm32f407vg_discovery/cycle_counter.h"
+#include "../../include/drivers/stm32f407vg_discovery/memory_sections.h"
+
+namespace {
+    /**
+     * Number of measured blocks for each test.
+     */
+    const unsigned int BENCHMARK_BLOCKS = 64;
+
+    typedef AudioBuffer<float, 1, AUDIO_DRIVER_BUFFER_SIZE> MonoBuffer;
+
+    /**
+     * Objects under test, in the core coupled memory like the audio path.
+     */
+    CCM_RAM MonoBuffer buffer;
+    CCM_RAM BiquadCascade<1, 1> singleBiquad(AUDIO_DRIVER_SAMPLE_RATE);
+    CCM_RAM BiquadCascade<1, 4> fourBiquads(AUDIO_DRIVER_SAMPLE_RATE);
+    CCM_RAM StateVariableFilter<1> svf(AUDIO_DRIVER_SAMPLE_RATE);
+    CCM_RAM Oversampler<2, AUDIO_DRIVER_BUFFER_SIZE> oversampler2x;
+    CCM_RAM Oversampler<4, AUDIO_DRIVER_BUFFER_SIZE> oversampler4x;
+    CCM_RAM SampleVoice voice;
+
+    /**
+     * The ADPCM data of the sad_trombone example, read from flash.
+     * The PCM16 sample reads the same bytes, to measure the same memory.
+     */
+    const Sample adpcmSample = {"adpcm", SampleFormat::IMA_ADPCM, sad_trombone_bin,
+                                2 * sad_trombone_bin_len, 44100.0f};
+    const Sample pcmSample = {"pcm16", SampleFormat::PCM16, sad_trombone_bin,
+                              sad_trombone_bin_len / 2, 44100.0f};
+
+    /**
+     * Linear congruential generator, returns values between -1 and 1.
+     */
+    float noise() {
+        static uint32_t seed = 22222;
+        seed = seed * 1664525u + 1013904223u;
+        return static_cast<float>(static_cast<int32_t>(seed)) / 2147483648.0f;
+    }
+
+    /**
+     * Fills the buffer with white noise.
+     */
+    void fillBuffer() {
+        float *data = buffer.getWritePointer(0);
+        for (size_t i = 0; i < AUDIO_DRIVER_BUFFER_SIZE; i++) {
+            data[i] = noise();
+        }
+    }
+
+    /**
+     * Measures the average cycles per sample of a block function.
+     */
+    template<typename F>
+    void measure(const char *name, F function) {
+        uint32_t total = 0;
+        for (unsigned int block = 0; block < BENCHMARK_BLOCKS; block++) {
+            fillBuffer();
+            uint32_t start = CycleCounter::read();
+            function();
+            total += CycleCounter::read() - start;
+        }
+        float perSample = static_cast<float>(total) / (BENCHMARK_BLOCKS * AUDIO_DRIVER_BUFFER_SIZE);
+        printf("%-28s %8.2f cycles/sample\n", name, perSample);
+    }
+
+    /**
+     * Identity function, used to measure the resampling cost alone.
+     */
+    struct Identity {
+        inline float operator()(float x) const { return x; };
+    };
+}
+
+void DspBenchmark::run() {
+    CycleCounter::init();
+    Identity identity;
+    printf("DSP benchmark, block of %d samples\n", AUDIO_DRIVER_BUFFER_SIZE);
+
+    singleBiquad.setType(0, BiquadType::LOWPASS);
+    measure("biquad", [] { singleBiquad.processBlock(buffer); });
+    measure("biquad, interpolated", [] {
+        singleBiquad.setFrequency(0, 1000.0f + 100.0f * noise());
+        singleBiquad.processBlock(buffer);
+    });
+    measure("4 biquads", [] { fourBiquads.processBlock(buffer); });
+    measure("svf", [] { svf.processBlock(buffer); });
+    measure("svf, interpolated", [] {
+        svf.setFrequency(1000.0f + 100.0f * noise());
+        svf.processBlock(buffer);
+    });
+    measure("oversampler 2x", [&identity] {
+        oversampler2x.process(buffer.getWritePointer(0), AUDIO_DRIVER_BUFFER_SIZE, identity);
+    });
+    measure("oversampler 4x", [&identity] {
+        oversampler4x.process(buffer.getWritePointer(0), AUDIO_DRIVER_BUFFER_SIZE, identity);
+    });
+
+    voice.setInterpolation(SampleInterpolation::LINEAR);
+    measure("sample pcm16 linear", [] {
+        if (!voice.isActive()) voice.trigger(pcmSample);
+        voice.process(buffer.getWritePointer(0), AUDIO_DRIVER_BUFFER_SIZE);
+    });
+    measure("sample adpcm linear", [] {
+        if (!voice.isActive()) voice.trigger(adpcmSample);
+        voice.process(buffer.getWritePointer(0), AUDIO_DRIVER_BUFFER_SIZE);
+    });
+    voice.setInterpolation(SampleInterpolation::CUBIC);
+    measure("sample adpcm cubic", [] {
+        if (!voice.isActive()) voice.trigger(adpcmSample);
+        voice.process(buffer.getWritePointer(0), AUDIO_DRIVER_BUFFER_SIZE);
+    });
+}
+
+#endif //DSP_BENCHMARK_ENABLED
@@ -1,9 +1,14 @@
 #include <array>
+#include <new>
+#include <type_traits>
 #include "miosix.h"
 #include "include/drivers/common/audio.h"
 #include "include/config/audio_config.h"
 #include "include/drivers/stm32f407vg_discovery/cs43l22dac.h"
+#include "include/drivers/stm32f407vg_discovery/memory_sections.h"
+#include "include/drivers/stm32f407vg_discovery/thread_deadline.h"
 #include "kernel/scheduler/scheduler.h"
+#include "kernel/irq_trace.h"
 #include "../include/audio/audio_processor.h"
 #include "../include/audio/audio_buffer.h"
 #include "../include/audio/audio_math.h"
@@ -15,10 +20,26 @@
 // instance of an AudioProcessable with an empty processor
 static AudioProcessableDummy audioProcessableDummy;
 
+/**
+ * Type of the double buffer read by the DMA.
+ */
+typedef miosix::BufferQueue<int16_t, AUDIO_DRIVER_BUFFER_SIZE * 2, DOUBLE_BUFFER_BUFFERS> DoubleBuffer;
+
+/**
+ * Storage of the double buffer, it is read by the DMA so it must
+ * be placed in the main SRAM and not in the core coupled memory.
+ */
+DMA_RAM static std::aligned_storage<sizeof(DoubleBuffer), alignof(DoubleBuffer)>::type doubleBufferStorage;
+
+/**
+ * Storage of the empty buffer, read by the DMA as well.
+ */
+DMA_RAM static std::array<int16_t, AUDIO_DRIVER_BUFFER_SIZE * 2> emptyBufferStorage;
+
 /**
  * double buffer containing an interleaved int values for a 16bit DAC.
  */
-static miosix::BufferQueue<int16_t, AUDIO_DRIVER_BUFFER_SIZE * 2, DOUBLE_BUFFER_BUFFERS> *doubleBuffer;
+static DoubleBuffer *doubleBuffer;
 
 /**
  * An empty buffer that is used in case of errors in the audio processing.
@@ -31,6 +52,17 @@ static std::array<int16_t, AUDIO_DRIVER_BUFFER_SIZE * 2> *emptyBuffer;
  */
 static miosix::Thread *writerThread;
 
+/**
+ * Function called by the DMA interrupt at the end of each block.
+ */
+static void (*volatile blockListener)() = nullptr;
+
+/**
+ * Blocks in which the DMA found no buffer written by the audio thread,
+ * and played the empty buffer.
+ */
+static volatile uint32_t deadlineMisses = 0;
+
 
 /**
  * This function is used to fill the DMA with a buffer.
@@ -42,7 +74,9 @@ void refillDMA_IRQ(miosix::BufferQueue<int16_t, AUDIO_DRIVER_BUFFER_SIZE * 2, DO
     const int16_t *rawBuffer = nullptr;
     unsigned int size = 0;
     if (bufferQueue->tryGetReadableBuffer(rawBuffer, size) == false) {
+        // the audio thread missed the deadline of the block
         rawBuffer = emptyBuffer->data();
+        deadlineMisses = deadlineMisses + 1;
     }
 
     DMA1_Stream5->CR = 0;
@@ -87,9 +121,11 @@ AudioDriver::AudioDriver()
             AUDIO_DRIVER_SAMPLE_RATE == 22050 ||
             AUDIO_DRIVER_SAMPLE_RATE == 44100, "The AUDIO_DRIVER_SAMPLE_RATE value is invalid");
 
-    // creating the buffers for the output
-    doubleBuffer = new miosix::BufferQueue<int16_t, AUDIO_DRIVER_BUFFER_SIZE * 2, DOUBLE_BUFFER_BUFFERS>();
-    emptyBuffer = new std::array<int16_t, AUDIO_DRIVER_BUFFER_SIZE * 2>();
+    // creating the buffers for the output in the DMA reachable memory,
+    // they are constructed here since static initialization order
+    // across translation units is not defined
+    doubleBuffer = new(&doubleBufferStorage) DoubleBuffer();
+    emptyBuffer = &emptyBufferStorage;
     emptyBuffer->fill(0);
 
     // Set up sample rate attribute
@@ -105,8 +141,7 @@ AudioDriver::AudioDriver()
 }
 
 AudioDriver::~AudioDriver() {
-    delete doubleBuffer;
-    delete emptyBuffer;
+    doubleBuffer->~DoubleBuffer();
 }
 
 void AudioDriver::init() {
@@ -117,10 +152,9 @@ void AudioDriver::init() {
     // default volume
     setVolume(1);
 
-    // saving the writer thread
+    // saving the writer thread, the most urgent one
     writerThread = miosix::Thread::getCurrentThread();
-    writerThread->setPriority(miosix::PRIORITY_MAX); // TODO: note to fedetft, setPriority not set_priority
-
+    ThreadDeadline::set(AUDIO_THREAD_PRIORITY);
 
 }
 
@@ -209,6 +243,14 @@ void AudioDriver::setSampleRate(uint32_t sampleRate) {
     }
 }
 
+void AudioDriver::setBlockListener(void (*listener)()) {
+    blockListener = listener;
+}
+
+uint32_t AudioDriver::getDeadlineMisses() const {
+    return deadlineMisses;
+}
+
 void AudioDriver::setVolume(float newVolume) {
     // clipping between 0 and 1
     newVolume = std::min(newVolume, 1.0f);
@@ -236,6 +278,10 @@ void __attribute__((naked)) DMA1_Stream5_IRQHandler() {
  * DMA end of transfer interrupt actual implementation
  */
 void __attribute__((used)) I2SdmaHandlerImpl() {
+#ifdef WITH_IRQ_TRACE
+    miosix::IRQTrace::IRQenter(DMA1_Stream5_IRQn);
+#endif
+
     // removing the interrupts flags
     DMA1->HIFCR = DMA_HIFCR_CTCIF5 |
                   DMA_HIFCR_CTEIF5 |
@@ -247,12 +293,16 @@ void __attribute__((used)) I2SdmaHandlerImpl() {
     refillDMA_IRQ(doubleBuffer);
 //    doubleBuffer->bufferEmptied();
 
-    // waking up the reader
-    writerThread->IRQwakeup();
+    // notifying the end of the block
+    if (blockListener != nullptr) blockListener();
 
-    // forcing the scheduler to run the writerThread
-    if (writerThread->IRQgetPriority() > miosix::Thread::IRQgetCurrentThread()->IRQgetPriority())
+    // releasing the writer, due before the DMA ends the block just started,
+    // and forcing the scheduler to run it
+    if (ThreadDeadline::IRQrelease(writerThread, AUDIO_DEADLINE_BLOCKS))
         miosix::Scheduler::IRQfindNextThread();
 
+#ifdef WITH_IRQ_TRACE
+    miosix::IRQTrace::IRQexit(DMA1_Stream5_IRQn);
+#endif
 }
 
@@ -0,0 +1,125 @@
+#include "include/drivers/stm32f407vg_discovery/block_scheduler.h"
+#include "include/drivers/stm32f407vg_discovery/thread_deadline.h"
+#include <cstdio>
+#include "miosix.h"
+#include "kernel/scheduler/scheduler.h"
+#include "kernel/irq_trace.h"
+
+PeriodicScheduler<BlockScheduler::MAX_TASKS, CycleCounter> BlockScheduler::scheduler;
+miosix::Thread *BlockScheduler::waiting[BlockScheduler::MAX_TASKS] = {nullptr};
+volatile uint32_t BlockScheduler::blocks = 0;
+volatile uint32_t BlockScheduler::releaseTime = 0;
+volatile uint32_t BlockScheduler::maxRunTime = 0;
+uint32_t BlockScheduler::blockTime = 0;
+
+void BlockScheduler::init(AudioDriver &audioDriver) {
+    CycleCounter::init();
+    blockTime = static_cast<uint32_t>(audioDriver.getBufferSize() * (SystemCoreClock / audioDriver.getSampleRate()));
+
+    // TIM6 is not started, its interrupt is only pended by IRQblock()
+    NVIC_SetPriority(TIM6_DAC_IRQn, 3); //Same priority of the kernel tick
+    NVIC_ClearPendingIRQ(TIM6_DAC_IRQn);
+    NVIC_EnableIRQ(TIM6_DAC_IRQn);
+    audioDriver.setBlockListener(IRQblock);
+}
+
+int BlockScheduler::add(bool (*task)(size_t id), unsigned int periodBlocks, unsigned int phase) {
+    // the first release is at the end of the next block
+    miosix::FastInterruptDisableLock dLock;
+    return scheduler.add(task, periodBlocks, blocks + 1 + phase);
+}
+
+int BlockScheduler::addThread(unsigned int periodBlocks, unsigned int phase) {
+    miosix::FastInterruptDisableLock dLock;
+    return scheduler.add(wakeThread, periodBlocks, blocks + 1 + phase, false);
+}
+
+void BlockScheduler::wait(int id) {
+    {
+        miosix::FastInterruptDisableLock dLock;
+        waiting[id] = miosix::Thread::IRQgetCurrentThread();
+        // looping until the task releases the thread
+        while (waiting[id] != nullptr) {
+            miosix::Thread::IRQwait();
+            {
+                miosix::FastInterruptEnableLock eLock(dLock);
+                miosix::Thread::yield();
+            }
+        }
+    }
+    uint32_t start = CycleCounter::read();
+    miosix::FastInterruptDisableLock dLock;
+    scheduler.record(id, start);
+}
+
+const PeriodicTaskStats &BlockScheduler::getStats(int id) {
+    return scheduler.getStats(id);
+}
+
+void BlockScheduler::print() {
+    PeriodicTaskStats stats[MAX_TASKS];
+    size_t count;
+    uint32_t runTime;
+    {
+        miosix::FastInterruptDisableLock dLock;
+        count = scheduler.getCount();
+        for (size_t i = 0; i < count; i++) stats[i] = scheduler.getStats(i);
+        scheduler.resetStats();
+        runTime = maxRunTime;
+        maxRunTime = 0;
+    }
+    float cyclesPerUs = CycleCounter::getCyclesPerUs();
+    for (size_t i = 0; i < count; i++) {
+        printf("Task %u: %lu runs, %lu missed, delay %.2f to %.2f us, jitter %.2f us\n",
+               static_cast<unsigned>(i), static_cast<unsigned long>(stats[i].runs),
+               static_cast<unsigned long>(stats[i].missed), stats[i].minDelay / cyclesPerUs,
+               stats[i].maxDelay / cyclesPerUs, stats[i].getJitter() / cyclesPerUs);
+    }
+    printf("Tasks: longest run %.2f us of the %.2f us block\n", runTime / cyclesPerUs, blockTime / cyclesPerUs);
+}
+
+void BlockScheduler::IRQblock() {
+    releaseTime = CycleCounter::read();
+    blocks = blocks + 1;
+    NVIC_SetPendingIRQ(TIM6_DAC_IRQn);
+}
+
+void BlockScheduler::IRQhandler() {
+#ifdef WITH_IRQ_TRACE
+    miosix::IRQTrace::IRQenter(TIM6_DAC_IRQn);
+#endif
+
+    uint32_t start = CycleCounter::read();
+    bool woken = scheduler.run(blocks, releaseTime);
+    // the next DMA interrupt waits for the tasks to return
+    uint32_t runTime = CycleCounter::read() - start;
+    if (runTime > maxRunTime) maxRunTime = runTime;
+    // running the woken threads when the interrupt returns
+    if (woken) miosix::Scheduler::IRQfindNextThread();
+
+#ifdef WITH_IRQ_TRACE
+    miosix::IRQTrace::IRQexit(TIM6_DAC_IRQn);
+#endif
+}
+
+bool BlockScheduler::wakeThread(size_t id) {
+    miosix::Thread *thread = waiting[id];
+    if (thread == nullptr) {
+        // the thread is still running its previous period
+        scheduler.miss(id);
+        return false;
+    }
+    waiting[id] = nullptr;
+    // the thread is due by its next release
+    return ThreadDeadline::IRQrelease(thread, scheduler.getPeriod(id));
+}
+
+/**
+ * Block scheduler software interrupt, saving the context since the
+ * tasks may wake up a thread
+ */
+void __attribute__((naked)) TIM6_DAC_IRQHandler() {
+    saveContext();
+    asm volatile("bl _ZN14BlockScheduler10IRQhandlerEv");
+    restoreContext();
+}
@@ -0,0 +1,111 @@
+#include "include/drivers/stm32f407vg_discovery/button_events.h"
+#include "include/drivers/stm32f407vg_discovery/cycle_counter.h"
+#include "miosix.h"
+#include "kernel/scheduler/scheduler.h"
+#include "kernel/irq_trace.h"
+
+ButtonEvents::Line ButtonEvents::lines[16];
+uint16_t ButtonEvents::lineMask = 0;
+SpscQueue<ButtonEvent, BUTTON_EVENT_QUEUE_SIZE> ButtonEvents::events;
+bool (*ButtonEvents::listener)() = nullptr;
+
+void ButtonEvents::init(bool (*eventListener)()) {
+    listener = eventListener;
+    CycleCounter::init();
+    {
+        miosix::FastInterruptDisableLock dLock;
+        RCC->APB2ENR |= RCC_APB2ENR_SYSCFGEN;
+        RCC_SYNC();
+    }
+}
+
+void ButtonEvents::addLine(unsigned int line, unsigned int port, uint8_t id) {
+    lines[line].gpio = (GPIO_TypeDef *) (GPIOA_BASE + port * (GPIOB_BASE - GPIOA_BASE));
+    lines[line].id = id;
+    lines[line].debouncer.reset((lines[line].gpio->IDR >> line) & 1, CycleCounter::read());
+
+    IRQn_Type irq;
+    if (line <= 4) irq = static_cast<IRQn_Type>(EXTI0_IRQn + line);
+    else if (line <= 9) irq = EXTI9_5_IRQn;
+    else irq = EXTI15_10_IRQn;
+
+    {
+        miosix::FastInterruptDisableLock dLock;
+        lineMask |= 1 << line;
+
+        // Port of the line, both edges
+        SYSCFG->EXTICR[line / 4] &= ~(0xf << ((line % 4) * 4));
+        SYSCFG->EXTICR[line / 4] |= port << ((line % 4) * 4);
+        EXTI->RTSR |= 1 << line;
+        EXTI->FTSR |= 1 << line;
+        EXTI->PR = 1 << line;
+        EXTI->IMR |= 1 << line;
+    }
+
+    NVIC_SetPriority(irq, 3); //Same priority of the BlockScheduler
+    NVIC_EnableIRQ(irq);
+}
+
+bool ButtonEvents::IRQpush(const Line &line, ButtonEvent::Type type, uint32_t time) {
+    if (!events.push({line.id, type, time})) return false;
+    return listener && listener();
+}
+
+bool ButtonEvents::IRQtick() {
+    uint32_t now = CycleCounter::read();
+    bool woken = false;
+    ButtonEvent::Type type;
+    for (unsigned int line = 0; line < 16; line++) {
+        if (!(lineMask & (1 << line))) continue;
+        bool level = (lines[line].gpio->IDR >> line) & 1;
+        if (lines[line].debouncer.tick(level, now, type)) woken |= IRQpush(lines[line], type, now);
+    }
+    return woken;
+}
+
+void ButtonEvents::IRQhandler() {
+#ifdef WITH_IRQ_TRACE
+    // the handler is shared by the EXTI lines, the active one is in IPSR
+    const short irq = static_cast<short>(__get_IPSR()) - 16;
+    miosix::IRQTrace::IRQenter(irq);
+#endif
+
+    uint32_t now = CycleCounter::read();
+    uint32_t pending = EXTI->PR & lineMask;
+    EXTI->PR = pending;
+
+    bool woken = false;
+    ButtonEvent::Type type;
+    for (unsigned int line = 0; pending != 0; line++, pending >>= 1) {
+        if (!(pending & 1)) continue;
+        bool level = (lines[line].gpio->IDR >> line) & 1;
+        if (lines[line].debouncer.edge(level, now, type)) woken |= IRQpush(lines[line], type, now);
+    }
+
+    // running the woken consumer when the interrupt returns
+    if (woken)
+        miosix::Scheduler::IRQfindNextThread();
+
+#ifdef WITH_IRQ_TRACE
+    miosix::IRQTrace::IRQexit(irq);
+#endif
+}
+
+/**
+ * EXTI interrupts of the buttons, saving the context
+ * since the listener may wake up a thread
+ */
+#define BUTTON_EVENTS_IRQ(handler) \
+void __attribute__((naked)) handler() { \
+    saveContext(); \
+    asm volatile("bl _ZN12ButtonEvents10IRQhandlerEv"); \
+    restoreContext(); \
+}
+
+BUTTON_EVENTS_IRQ(EXTI0_IRQHandler)
+BUTTON_EVENTS_IRQ(EXTI1_IRQHandler)
+BUTTON_EVENTS_IRQ(EXTI2_IRQHandler)
+BUTTON_EVENTS_IRQ(EXTI3_IRQHandler)
+BUTTON_EVENTS_IRQ(EXTI4_IRQHandler)
+BUTTON_EVENTS_IRQ(EXTI9_5_IRQHandler)
+BUTTON_EVENTS_IRQ(EXTI15_10_IRQHandler)
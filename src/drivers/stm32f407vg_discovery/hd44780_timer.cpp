@@ -0,0 +1,59 @@
+#include "include/drivers/stm32f407vg_discovery/hd44780_timer.h"
+#include "miosix.h"
+#include "kernel/irq_trace.h"
+
+bool (*Hd44780Timer::step)() = nullptr;
+
+void Hd44780Timer::init(bool (*stepFunction)()) {
+    step = stepFunction;
+    {
+        miosix::FastInterruptDisableLock dLock;
+        RCC->APB1ENR |= RCC_APB1ENR_TIM14EN;
+        RCC_SYNC();
+    }
+
+    // The timer clock is twice the APB1 clock, half the core clock:
+    // prescaled to 1MHz, one update every TICK_US
+    TIM14->CR1 = 0;
+    TIM14->PSC = SystemCoreClock / 2 / 1000000 - 1;
+    TIM14->ARR = TICK_US - 1;
+    TIM14->CNT = 0;
+    TIM14->EGR = TIM_EGR_UG;
+    TIM14->SR = 0;
+    TIM14->DIER = TIM_DIER_UIE;
+
+    NVIC_SetPriority(TIM8_TRG_COM_TIM14_IRQn, 3); //Same priority of the kernel tick
+    NVIC_ClearPendingIRQ(TIM8_TRG_COM_TIM14_IRQn);
+    NVIC_EnableIRQ(TIM8_TRG_COM_TIM14_IRQn);
+}
+
+void Hd44780Timer::start() {
+    // The frame is marked as changed before reading CEN: if the interrupt is
+    // stopping the timer it runs entirely before or after this check, and in
+    // the first case its last step already sees the change
+    if ((TIM14->CR1 & TIM_CR1_CEN) == 0) TIM14->CR1 = TIM_CR1_CEN;
+}
+
+bool Hd44780Timer::isRunning() {
+    return (TIM14->CR1 & TIM_CR1_CEN) != 0;
+}
+
+void Hd44780Timer::IRQhandler() {
+#ifdef WITH_IRQ_TRACE
+    miosix::IRQTrace::IRQenter(TIM8_TRG_COM_TIM14_IRQn);
+#endif
+
+    TIM14->SR = 0;
+    if (step == nullptr || !step()) TIM14->CR1 = 0;
+
+#ifdef WITH_IRQ_TRACE
+    miosix::IRQTrace::IRQexit(TIM8_TRG_COM_TIM14_IRQn);
+#endif
+}
+
+/**
+ * LCD transfer timer interrupt, no context switch is needed
+ */
+void TIM8_TRG_COM_TIM14_IRQHandler() {
+    Hd44780Timer::IRQhandler();
+}
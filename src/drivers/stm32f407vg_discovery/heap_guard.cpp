@@ -0,0 +1,148 @@
+#include "include/drivers/stm32f407vg_discovery/heap_guard.h"
+#include "include/config/debug_config.h"
+#include <reent.h>
+
+#if HEAP_GUARD_ENABLED
+
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include "miosix.h"
+#include "filesystem/console/console_device.h"
+
+/**
+ * True once the guard is armed, never cleared
+ */
+static volatile bool armed = false;
+
+/**
+ * Threads whose malloc calls are not trapped
+ */
+static miosix::Thread *allowed[HEAP_GUARD_MAX_ALLOWED_THREADS];
+
+void HeapGuard::arm() {
+    armed = true;
+}
+
+bool HeapGuard::isArmed() {
+    return armed;
+}
+
+void HeapGuard::allowMalloc() {
+    miosix::FastInterruptDisableLock dLock;
+    for (auto &thread : allowed) {
+        if (thread != nullptr) continue;
+        thread = miosix::Thread::IRQgetCurrentThread();
+        return;
+    }
+}
+
+/**
+ * @return true if an allocation of newlib has to be trapped
+ */
+static bool isMallocTrapped() {
+    if (!armed) return false;
+    miosix::Thread *current = miosix::Thread::getCurrentThread();
+    for (auto thread : allowed) {
+        if (thread == current) return false;
+    }
+    return true;
+}
+
+void HeapGuard::trap(size_t size, void *caller) {
+    miosix::disableInterrupts();
+    // siprintf only formats integers, so it does not allocate
+    static char message[80];
+    siprintf(message, "\r\n***Heap allocation of %u bytes from %p after the audio start\r\n",
+             static_cast<unsigned int>(size), caller);
+    miosix::DefaultConsole::instance().IRQget()->IRQwrite(message);
+    for (;;);
+}
+
+/**
+ * Replacement of the global operator new, the default one of libstdc++
+ * is used as long as the guard is disabled
+ */
+void *operator new(size_t size) {
+    if (armed) HeapGuard::trap(size, __builtin_return_address(0));
+    void *ptr = malloc(size == 0 ? 1 : size);
+    if (ptr == nullptr) throw std::bad_alloc();
+    return ptr;
+}
+
+void *operator new(size_t size, const std::nothrow_t &) noexcept {
+    if (armed) HeapGuard::trap(size, __builtin_return_address(0));
+    return malloc(size == 0 ? 1 : size);
+}
+
+void *operator new[](size_t size) {
+    if (armed) HeapGuard::trap(size, __builtin_return_address(0));
+    void *ptr = malloc(size == 0 ? 1 : size);
+    if (ptr == nullptr) throw std::bad_alloc();
+    return ptr;
+}
+
+void *operator new[](size_t size, const std::nothrow_t &) noexcept {
+    if (armed) HeapGuard::trap(size, __builtin_return_address(0));
+    return malloc(size == 0 ? 1 : size);
+}
+
+void operator delete(void *ptr) noexcept {
+    free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept {
+    free(ptr);
+}
+
+void operator delete(void *ptr, size_t) noexcept {
+    free(ptr);
+}
+
+void operator delete[](void *ptr, size_t) noexcept {
+    free(ptr);
+}
+
+#else //HEAP_GUARD_ENABLED
+
+void HeapGuard::arm() {}
+
+bool HeapGuard::isArmed() {
+    return false;
+}
+
+void HeapGuard::allowMalloc() {}
+
+void HeapGuard::trap(size_t, void *) {
+    for (;;);
+}
+
+static inline bool isMallocTrapped() {
+    return false;
+}
+
+#endif //HEAP_GUARD_ENABLED
+
+/**
+ * Wrappers of the newlib allocator, behind malloc, calloc, realloc and the
+ * buffers allocated inside newlib. The Makefile links them with --wrap,
+ * also when the guard is disabled, in which case they only forward the calls
+ */
+extern "C" void *__real__malloc_r(struct _reent *r, size_t size);
+extern "C" void *__real__calloc_r(struct _reent *r, size_t count, size_t size);
+extern "C" void *__real__realloc_r(struct _reent *r, void *ptr, size_t size);
+
+extern "C" void *__wrap__malloc_r(struct _reent *r, size_t size) {
+    if (isMallocTrapped()) HeapGuard::trap(size, __builtin_return_address(0));
+    return __real__malloc_r(r, size);
+}
+
+extern "C" void *__wrap__calloc_r(struct _reent *r, size_t count, size_t size) {
+    if (isMallocTrapped()) HeapGuard::trap(count * size, __builtin_return_address(0));
+    return __real__calloc_r(r, count, size);
+}
+
+extern "C" void *__wrap__realloc_r(struct _reent *r, void *ptr, size_t size) {
+    if (isMallocTrapped()) HeapGuard::trap(size, __builtin_return_address(0));
+    return __real__realloc_r(r, ptr, size);
+}
@@ -0,0 +1,62 @@
+#include "include/drivers/stm32f407vg_discovery/irq_latency_probe.h"
+#include "include/config/debug_config.h"
+
+// compiled only when enabled, to leave TIM7 and its interrupt free
+#if IRQ_LATENCY_PROBE_ENABLED
+
+#include <cstdio>
+#include "miosix.h"
+#include "include/drivers/stm32f407vg_discovery/cycle_counter.h"
+
+LatencyStats IrqLatencyProbe::stats(IrqLatencyProbe::PERIOD_CYCLES);
+
+void IrqLatencyProbe::init() {
+    CycleCounter::init();
+    {
+        miosix::FastInterruptDisableLock dLock;
+        RCC->APB1ENR |= RCC_APB1ENR_TIM7EN;
+        RCC_SYNC();
+    }
+
+    // The timer clock is twice the APB1 clock, half the core clock
+    TIM7->CR1 = 0;
+    TIM7->PSC = 0;
+    TIM7->ARR = PERIOD_CYCLES / 2 - 1;
+    TIM7->CNT = 0;
+    TIM7->EGR = TIM_EGR_UG;
+    TIM7->SR = 0;
+    TIM7->DIER = TIM_DIER_UIE;
+
+    NVIC_SetPriority(TIM7_IRQn, 0); //Highest priority, above the DMA
+    NVIC_ClearPendingIRQ(TIM7_IRQn);
+    NVIC_EnableIRQ(TIM7_IRQn);
+    TIM7->CR1 = TIM_CR1_CEN;
+}
+
+void IrqLatencyProbe::reset() {
+    miosix::FastInterruptDisableLock dLock;
+    stats.reset();
+}
+
+void IrqLatencyProbe::print() {
+    // read without disabling the interrupts, the values may be one entry apart
+    uint32_t worst = stats.getWorstLatency();
+    printf("IRQ latency (masked sections and handlers): worst %lu cycles (%.2f us), %lu missed in %lu interrupts\n",
+           static_cast<unsigned long>(worst), worst / static_cast<float>(CycleCounter::getCyclesPerUs()),
+           static_cast<unsigned long>(stats.getMissed()), static_cast<unsigned long>(stats.getCount()));
+}
+
+void IrqLatencyProbe::IRQhandler() {
+    uint32_t now = CycleCounter::read();
+    TIM7->SR = 0;
+    stats.update(now);
+}
+
+/**
+ * Probe timer interrupt, no context switch is needed
+ */
+void TIM7_IRQHandler() {
+    IrqLatencyProbe::IRQhandler();
+}
+
+#endif //IRQ_LATENCY_PROBE_ENABLED
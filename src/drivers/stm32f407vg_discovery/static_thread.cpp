@@ -0,0 +1,49 @@
+#include "include/drivers/stm32f407vg_discovery/static_thread.h"
+#include "include/drivers/stm32f407vg_discovery/thread_deadline.h"
+#include <cstdio>
+
+StaticThread *StaticThread::first = nullptr;
+StaticThread *StaticThread::last = nullptr;
+
+StaticThread::StaticThread(const char *name, unsigned int *memory, unsigned int stackSize, void (*function)(),
+                           short priority)
+        : name(name), memory(memory), stackSize(stackSize), function(function), priority(priority),
+          thread(nullptr), next(nullptr) {
+    if (last == nullptr) first = this;
+    else last->next = this;
+    last = this;
+}
+
+bool StaticThread::start() {
+    if (thread != nullptr) return false;
+    thread = miosix::Thread::createStatic(launch, memory, stackSize, ThreadDeadline::getPriority(priority), this);
+    return thread != nullptr;
+}
+
+bool StaticThread::startAll() {
+    bool started = true;
+    for (StaticThread *walk = first; walk != nullptr; walk = walk->next) {
+        if (walk->thread == nullptr && !walk->start()) started = false;
+    }
+    return started;
+}
+
+void StaticThread::report() {
+    for (StaticThread *walk = first; walk != nullptr; walk = walk->next) {
+        printf("%-8s stack %u/%u bytes%s\n", walk->name, walk->getStackUsed(), walk->stackSize,
+               walk->isWatermarkOk() ? "" : " OVERFLOW");
+    }
+}
+
+unsigned int StaticThread::getStackUsed() const {
+    return miosix::Thread::getStackUsed(memory, stackSize);
+}
+
+bool StaticThread::isWatermarkOk() const {
+    return miosix::Thread::isWatermarkOk(memory);
+}
+
+void *StaticThread::launch(void *argv) {
+    static_cast<StaticThread *>(argv)->function();
+    return nullptr;
+}
@@ -0,0 +1,27 @@
+#include "include/drivers/stm32f407vg_discovery/thread_deadline.h"
+#include "kernel/scheduler/scheduler.h"
+
+void ThreadDeadline::set(short priority) {
+    miosix::Thread::setPriority(getPriority(priority));
+}
+
+miosix::Priority ThreadDeadline::getPriority(short priority) {
+#ifdef SCHED_TYPE_EDF
+    return miosix::Priority(Deadlines::background(priority));
+#else
+    return miosix::Priority(priority);
+#endif
+}
+
+bool ThreadDeadline::IRQrelease(miosix::Thread *thread, unsigned int blocks) {
+#ifdef SCHED_TYPE_EDF
+    // the thread is waiting and holds no mutex, so there is no inherited
+    // priority to keep and its deadline is moved directly, the kernel only
+    // edits the deadline list with the interrupts disabled
+    miosix::EDFScheduler::IRQsetPriority(thread, Deadlines::absolute(miosix::getTick(), blocks));
+#else
+    (void) blocks;
+#endif
+    thread->IRQwakeup();
+    return thread->IRQgetPriority() > miosix::Thread::IRQgetCurrentThread()->IRQgetPriority();
+}
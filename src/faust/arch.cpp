@@ -1,14 +1,13 @@
 // Edited from Author: Romain Michon (rmichonATccrmaDOTstanfordDOTedu)
 
-// needed by any faust arch file
-#include "faust/misc.h"
-
-// allows to control a faust DSP module in a simple manner by using parameter's path
-#include "faust/gui/MapUI.h"
-
-// needed by any faust arch file
-#include "faust/dsp/dsp.h"
-
-// tags used by the faust compiler to paste the generated c++ code
+// Miosix architecture: static memory manager, flat array UI and
+// a non virtual dsp base class (compile with -mem -nvi)
+#include "miosix_arch.h"
+
+// tags used by the faust compiler to paste the generated c++ code,
+// which leaves some parameters unused
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
 <<includeIntrinsic>>
-<<includeclass>>
\ No newline at end of file
+<<includeclass>>
+#pragma GCC diagnostic pop
@@ -1,74 +1,132 @@
 #include "../../include/faust/faust_audio_processor.h"
+#include "kernel/error.h"
+
+/**
+ * Allocator of the faust module, static member of the generated class
+ */
+dsp_memory_manager *FaustSynth::fManager = nullptr;
+
+/**
+ * Size of a block in the arena, which starts each block at its alignment
+ */
+static constexpr size_t arenaBlock(size_t size) {
+    return (size + MEMORY_POOL_ALIGNMENT - 1) & ~(MEMORY_POOL_ALIGNMENT - 1);
+}
+
+// classInit() allocates the signal generator and the 257 samples table of
+// the generated code, then createDSP() allocates the module
+static_assert(FAUST_MEMORY_ARENA_SIZE >= arenaBlock(sizeof(FaustSynthSIG0)) + arenaBlock(sizeof(float) * 257) +
+                                        arenaBlock(sizeof(FaustSynth)),
+              "FAUST_MEMORY_ARENA_SIZE is too small for the Faust module and its tables");
+
+/**
+ * Ranges of the parameters mapped to the sliders
+ */
+static const float sliderMin[4] = {SLIDER1_MIN, SLIDER2_MIN, SLIDER3_MIN, SLIDER4_MIN};
+static const float sliderMax[4] = {SLIDER1_MAX, SLIDER2_MAX, SLIDER3_MAX, SLIDER4_MAX};
 
 FaustAudioProcessor::FaustAudioProcessor(AudioDriver &audioDriver)
         : AudioProcessor(audioDriver) {
     float currentSampleRate = audioDriver.getSampleRate();
 
-    synth.init(currentSampleRate); // initializing the faust module
-    synth.buildUserInterface(&control); // linking the faust module to the controler
+    // allocating the faust module and its tables inside the static arena
+    FaustSynth::fManager = &memoryManager;
+    FaustSynth::classInit(currentSampleRate);
+    synth = createDSP<FaustSynth>(&memoryManager);
+    if (synth == nullptr) miosix::errorHandler(miosix::OUT_OF_MEMORY);
+
+    synth->instanceInit(currentSampleRate); // initializing the faust module
+    synth->buildUserInterface(&control); // linking the faust module to the controler
+
+    // resolving the parameter paths only once
+    parameterIndex[SLIDER1] = control.getParamIndex(SLIDER1_NAME);
+    parameterIndex[SLIDER2] = control.getParamIndex(SLIDER2_NAME);
+    parameterIndex[SLIDER3] = control.getParamIndex(SLIDER3_NAME);
+    parameterIndex[SLIDER4] = control.getParamIndex(SLIDER4_NAME);
+    parameterIndex[BUTTON1] = control.getParamIndex(BUTTON1_NAME);
+    parameterIndex[BUTTON2] = control.getParamIndex(BUTTON2_NAME);
+    parameterIndex[BUTTON3] = control.getParamIndex(BUTTON3_NAME);
+    parameterIndex[BUTTON4] = control.getParamIndex(BUTTON4_NAME);
+    parameterIndex[GATE] = control.getParamIndex("/faust_synth/gate");
 }
 
 void FaustAudioProcessor::process() {
+    // applying only the parameters changed since the last block
+    mailbox.drain([this](size_t index, float value) {
+        control.setParamValue(index, value);
+    });
+
     audioBuffers[0] = getBuffer().getWritePointer(0);
     audioBuffers[1] = getBuffer().getWritePointer(1);
 
-    synth.compute(getBufferSize(), NULL, audioBuffers); // computing one block with faust
+    synth->compute(getBufferSize(), NULL, audioBuffers); // computing one block with faust
 }
 
 void FaustAudioProcessor::setSlider1(float value) {
-    control.setParamValue(SLIDER1_NAME, SLIDER1_MIN + value * (SLIDER1_MAX - SLIDER1_MIN));
+    post(parameterIndex[SLIDER1], SLIDER1_MIN + value * (SLIDER1_MAX - SLIDER1_MIN));
 }
 
 void FaustAudioProcessor::setSlider2(float value) {
-    control.setParamValue(SLIDER2_NAME, SLIDER2_MIN + value * (SLIDER2_MAX - SLIDER2_MIN));
+    post(parameterIndex[SLIDER2], SLIDER2_MIN + value * (SLIDER2_MAX - SLIDER2_MIN));
 }
 
 
 void FaustAudioProcessor::setSlider3(float value) {
-    control.setParamValue(SLIDER3_NAME, SLIDER3_MIN + value * (SLIDER3_MAX - SLIDER3_MIN));
+    post(parameterIndex[SLIDER3], SLIDER3_MIN + value * (SLIDER3_MAX - SLIDER3_MIN));
 }
 
 void FaustAudioProcessor::setSlider4(float value) {
-    control.setParamValue(SLIDER4_NAME, SLIDER4_MIN + value * (SLIDER4_MAX - SLIDER4_MIN));
-}
-
-void FaustAudioProcessor::setEncoder1(float value) {
-    control.setParamValue(ENCODER1_NAME, ENCODER1_MIN + value * (ENCODER1_MAX - ENCODER1_MIN));
-}
-
-void FaustAudioProcessor::setEncoder2(float value) {
-    control.setParamValue(ENCODER2_NAME, ENCODER2_MIN + value * (ENCODER2_MAX - ENCODER2_MIN));
+    post(parameterIndex[SLIDER4], SLIDER4_MIN + value * (SLIDER4_MAX - SLIDER4_MIN));
 }
 
-void FaustAudioProcessor::setEncoder3(float value) {
-    control.setParamValue(ENCODER3_NAME, ENCODER3_MIN + value * (ENCODER3_MAX - ENCODER3_MIN));
-}
-
-void FaustAudioProcessor::setEncoder4(float value) {
-    control.setParamValue(ENCODER4_NAME, ENCODER4_MIN + value * (ENCODER4_MAX - ENCODER4_MIN));
+void FaustAudioProcessor::setParameter(int index, float value) {
+    post(index, value);
 }
 
 void FaustAudioProcessor::setButton1(bool value) {
-    control.setParamValue(BUTTON1_NAME, value);
+    post(parameterIndex[BUTTON1], value);
 }
 
 void FaustAudioProcessor::setButton2(bool value) {
-    control.setParamValue(BUTTON2_NAME, value);
+    post(parameterIndex[BUTTON2], value);
 }
 
 void FaustAudioProcessor::setButton3(bool value) {
-    control.setParamValue(BUTTON3_NAME, value);
+    post(parameterIndex[BUTTON3], value);
 }
 
 void FaustAudioProcessor::setButton4(bool value) {
-    control.setParamValue(BUTTON4_NAME, value);
+    post(parameterIndex[BUTTON4], value);
 }
 
 void FaustAudioProcessor::gateOn() {
-    control.setParamValue("/faust_synth/gate", 1);
+    post(parameterIndex[GATE], 1);
 }
 
 void FaustAudioProcessor::gateOff() {
-    control.setParamValue("/faust_synth/gate", 0);
+    post(parameterIndex[GATE], 0);
+}
+
+int FaustAudioProcessor::getSliderParameter(int slider) const {
+    return parameterIndex[SLIDER1 + slider];
+}
+
+float FaustAudioProcessor::getSliderValue(int slider, float position) const {
+    return sliderMin[slider] + position * (sliderMax[slider] - sliderMin[slider]);
 }
 
+float FaustAudioProcessor::getSliderPosition(int slider, float value) const {
+    float position = (value - sliderMin[slider]) / (sliderMax[slider] - sliderMin[slider]);
+    return (position < 0.0f) ? 0.0f : (position > 1.0f) ? 1.0f : position;
+}
+
+bool FaustAudioProcessor::isMapped(int index) const {
+    for (int i = 0; i < PARAMETER_NUM; i++) {
+        if (parameterIndex[i] == index) return true;
+    }
+    return false;
+}
+
+void FaustAudioProcessor::post(int index, float value) {
+    if (index >= 0 && index < control.getParamsCount()) mailbox.post(index, value);
+}
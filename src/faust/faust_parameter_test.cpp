@@ -3,9 +3,9 @@
 
 int main() {
     FaustSynth synth;
-    MapUI control;
+    MiosixUI control;
     synth.buildUserInterface(&control);
 
     for (int i = 0; i < control.getParamsCount(); i++)
         std::cout << control.getParamAddress(i) << "\n";
-}
\ No newline at end of file
+}
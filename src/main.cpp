@@ -1,42 +1,30 @@
 #include <cstdint>
-#include <thread>
-#include <util/lcd44780.h>
+#include <cstdio>
 #include "miosix.h"
+#include "kernel/cpu_time_counter.h"
+#include "kernel/irq_trace.h"
+#include "e20/e20.h"
 #include "include/drivers/common/audio.h"
-#include "include/drivers/common/lcd_interface.h"
-#include "include/drivers/stm32f407vg_discovery/encoder.h"
-#include "include/drivers/stm32f407vg_discovery/button.h"
-#include "include/drivers/stm32f407vg_discovery/potentiometer.h"
+#include "include/drivers/stm32f407vg_discovery/control_pins.h"
+#include "include/drivers/stm32f407vg_discovery/button_events.h"
 #include "include/drivers/stm32f407vg_discovery/midi_in.h"
+#include "include/drivers/stm32f407vg_discovery/memory_sections.h"
+#include "include/drivers/stm32f407vg_discovery/irq_latency_probe.h"
+#include "include/drivers/stm32f407vg_discovery/block_scheduler.h"
+#include "include/drivers/stm32f407vg_discovery/thread_deadline.h"
+#include "include/drivers/stm32f407vg_discovery/hd44780_display.h"
+#include "include/drivers/stm32f407vg_discovery/heap_guard.h"
+#include "include/drivers/stm32f407vg_discovery/static_thread.h"
+#include "include/drivers/common/control_surface.h"
+#include "include/drivers/common/thread_top.h"
 #include "include/faust/faust_audio_processor.h"
 #include "include/midi/midi_parser.h"
 #include "include/config/thread_update_rates.h"
+#include "include/config/thread_stacks.h"
+#include "include/config/debug_config.h"
+#include "include/benchmarks/dsp_benchmark.h"
 
 
-/**
- * Encoders Pin Definition
- */
-typedef Encoder<TIM1_BASE, GPIOE_BASE, 9, 11> encoder1;
-typedef Encoder<TIM3_BASE, GPIOB_BASE, 4, 5> encoder2;
-typedef Encoder<TIM4_BASE, GPIOD_BASE, 12, 13> encoder3;
-typedef Encoder<TIM5_BASE, GPIOA_BASE, 0, 1> encoder4;
-
-/**
- * Buttons Pin Definition
- */
-typedef Button<GPIOD_BASE, 0> button1;
-typedef Button<GPIOD_BASE, 1> button2;
-typedef Button<GPIOD_BASE, 2> button3;
-typedef Button<GPIOD_BASE, 3> button4;
-
-/**
- * ADC Pin Definition
- */
-typedef Potentiometer<GPIOA_BASE, 2, 2> slider1;
-typedef Potentiometer<GPIOA_BASE, 5, 5> slider2;
-typedef Potentiometer<GPIOA_BASE, 6, 6> slider3;
-typedef Potentiometer<GPIOA_BASE, 7, 7> slider4;
-
 /**
  * LCD Pin Definition
  */
@@ -48,10 +36,12 @@ typedef miosix::Gpio<GPIOC_BASE, 1> rs;
 typedef miosix::Gpio<GPIOC_BASE, 2> e;
 
 /**
- * Audio Driver and Synthesizer declaration
+ * Audio Driver and Synthesizer declaration, both placed in the core coupled
+ * memory together with their float buffers, the Faust state and tables.
+ * The DMA buffers of the AudioDriver are kept in the main SRAM.
  */
-static AudioDriver audioDriver;
-static FaustAudioProcessor synth(audioDriver);
+CCM_RAM static AudioDriver audioDriver;
+CCM_RAM static FaustAudioProcessor synth(audioDriver);
 
 /**
  * Midi Parser declaration and initialization
@@ -59,103 +49,82 @@ static FaustAudioProcessor synth(audioDriver);
 static MidiParser midiParser;
 
 /**
- * LCD Initialization, declaration of shared LCDPage and its mutex
+ * LCD declaration, initialized by the UI thread
  */
-static miosix::Lcd44780 display(rs::getPin(), e::getPin(), d4::getPin(),
-                                d5::getPin(), d6::getPin(), d7::getPin(), 2, 16);
-LCDUtils::LCDPage lcdPage;
-miosix::Mutex lcdMutex;
+typedef Hd44780Display<rs, e, d4, d5, d6, d7, LCD_ROWS, LCD_COLS> display;
 
 /**
- * Slider UI Thread Function
+ * Events posted by the control scan to the UI thread. The scan and the
+ * button interrupts have the same priority, so they are a single producer
  */
-void sliderUI() {
-    // Sliders Initialization
-    slider1::init();
-    slider2::init();
-    slider3::init();
-    slider4::init();
+static miosix::LockFreeEventQueue<4> uiEvents;
 
-    while (true) {
-        synth.setSlider1(slider1::read());
-        synth.setSlider2(slider2::read());
-        synth.setSlider3(slider3::read());
-        synth.setSlider4(slider4::read());
-        miosix::Thread::sleep(SLIDER_SLEEP_TIME);
-    }
-}
+/**
+ * Sliders and encoders, sampled by the control scan, with the menu of the
+ * parameters edited by the encoders
+ */
+typedef ControlSurface<FaustAudioProcessor, sliders, encoder1, encoder2, encoder3, encoder4, display,
+        miosix::LockFreeEventQueue<4>> Controls;
+static Controls controls(synth, uiEvents);
 
 /**
- * Encoder UI Thread Function
+ * True while the handling of the button events is waiting in uiEvents
  */
-void encoderUI() {
-    // Encoders Initialization
-    encoder1::init();
-    encoder2::init();
-    encoder3::init();
-    encoder4::init();
+static volatile bool buttonEventsPending = false;
 
-    while (true) {
-        // Read from the encoders
-        float e1 = encoder1::getValue();
-        float e2 = encoder2::getValue();
-        float e3 = encoder3::getValue();
-        float e4 = encoder4::getValue();
-
-        // Set encoder to synth
-        synth.setEncoder1(e1);
-        synth.setEncoder2(e2);
-        synth.setEncoder3(e3);
-        synth.setEncoder4(e4);
-
-        // Update shared variable lcdPage to reflect the changes on the LCD
-        {
-            miosix::Lock<miosix::Mutex> l(lcdMutex);
-            lcdPage.p[0].value = (int) (e1 * 999);
-            lcdPage.p[1].value = (int) (e2 * 999);
-            lcdPage.p[2].value = (int) (e3 * 999);
-            lcdPage.p[3].value = (int) (e4 * 999);
-        }
-        miosix::Thread::sleep(ENCODER_SLEEP_TIME);
-    }
+/**
+ * Button events handling, run by the UI thread
+ */
+void handleButtonEvents() {
+    buttonEventsPending = false;
+    ButtonEvent event;
+    while (ButtonEvents::pop(event)) controls.handleButton(event);
 }
 
 /**
- * Encoder UI Thread Function
+ * Listener of the button events, called by their interrupts
+ * @return true if the UI thread has been woken up
  */
-void buttonUI() {
-    // Buttons Initialization
-    button1::init();
-    button2::init();
-    button3::init();
-    button4::init();
-
-    while (true) {
-        synth.setButton1(button1::getState());
-        synth.setButton2(button2::getState());
-        synth.setButton3(button3::getState());
-        synth.setButton4(button4::getState());
-        miosix::Thread::sleep(BUTTON_SLEEP_TIME);
+bool buttonEventsReady() {
+    bool woken = false;
+    if (!buttonEventsPending) {
+        buttonEventsPending = uiEvents.IRQpost(handleButtonEvents, woken);
     }
+    return woken;
 }
 
 /**
- * LCD update UI Thread Function
+ * Control scan, called by the BlockScheduler interrupt every CONTROL_SCAN_BLOCKS.
+ * Samples the sliders and the encoders, see ControlSurface::IRQscan().
+ * The buttons generate their own events, the scan only checks
+ * their long presses
+ * @return true if the UI thread has been woken up
  */
-void lcdUI() {
-    // Setup
-    lcdPage.p[0].name = ENCODER1_LCD_NAME;
-    lcdPage.p[1].name = ENCODER2_LCD_NAME;
-    lcdPage.p[2].name = ENCODER3_LCD_NAME;
-    lcdPage.p[3].name = ENCODER4_LCD_NAME;
+bool scanControls(size_t) {
+    bool woken = controls.IRQscan();
+    woken |= ButtonEvents::IRQtick();
+    return woken;
+}
 
-    while (true) {
-        {
-            miosix::Lock<miosix::Mutex> l(lcdMutex);
-            LCDUtils::lcdPrintPage(display, lcdPage);
-            miosix::Thread::sleep(LCD_SLEEP_TIME);
-        }
-    }
+/**
+ * UI Thread Function, initializes the controls and runs the
+ * events posted by the control scan
+ */
+void controlUI() {
+    // Menu, LCD, sliders and encoders
+    controls.init();
+
+    // Buttons Initialization, their edges generate debounced events
+    ButtonEvents::init(buttonEventsReady);
+    ButtonEvents::add<button1>(0);
+    ButtonEvents::add<button2>(1);
+    ButtonEvents::add<button3>(2);
+    ButtonEvents::add<button4>(3);
+
+    // A single task, aligned to the audio blocks, samples every control
+    BlockScheduler::add(scanControls, CONTROL_SCAN_BLOCKS);
+
+    uiEvents.run();
 }
 
 /**
@@ -174,36 +143,196 @@ void midiParsing() {
 }
 
 /**
- * Processing of MIDI data
+ * Processing of MIDI data, released every MIDI_PROCESSING_BLOCKS
+ * by the BlockScheduler. It stays a thread since the parser
+ * queue is protected by a mutex
  */
 void midiProcessing() {
+    int task = BlockScheduler::addThread(MIDI_PROCESSING_BLOCKS, MIDI_PROCESSING_PHASE);
     while (true) {
-        if (midiParser.isNoteAvaiable()) {
+        BlockScheduler::wait(task);
+        while (midiParser.isNoteAvaiable()) {
             MidiNote note = midiParser.popNote();
             if (note.msgType == MidiNote::NOTE_ON && note.velocity > (uint8_t) 0)
                 synth.gateOn();
             else if (note.msgType == MidiNote::NOTE_OFF || note.velocity == 0)
                 synth.gateOff();
         }
-        miosix::Thread::sleep(MIDI_SLEEP_TIME);
     }
 }
 
+#if IRQ_LATENCY_PROBE_ENABLED
+/**
+ * Periodic print of the worst interrupt latency
+ */
+void irqLatencyReport() {
+    HeapGuard::allowMalloc();
+    IrqLatencyProbe::init();
+
+    while (true) {
+        miosix::Thread::sleep(1000);
+        IrqLatencyProbe::print();
+    }
+}
+#endif
+
+#if SCHEDULER_STATS_ENABLED
+/**
+ * Periodic print of the jitter of the control tasks and of the
+ * deadline misses of the audio thread, every second from the
+ * absolute start tick so the prints do not drift
+ */
+void schedulerReport() {
+    HeapGuard::allowMalloc();
+    long long next = miosix::getTick();
+
+    while (true) {
+        next += miosix::TICK_FREQ;
+        miosix::Thread::sleepUntil(next);
+        BlockScheduler::print();
+        printf("Audio: %lu deadline misses\n", static_cast<unsigned long>(audioDriver.getDeadlineMisses()));
+    }
+}
+#endif
+
+#if THREAD_STATS_ENABLED
+#ifndef WITH_CPU_TIME_COUNTER
+#error "THREAD_STATS_ENABLED requires WITH_CPU_TIME_COUNTER in miosix_settings.h"
+#endif
+
+/**
+ * CPU load and stack usage of the threads, the audio thread is named
+ * by main before the report thread is started, the static threads by
+ * the report thread
+ */
+static ThreadTop<miosix::ThreadUsage, THREAD_STATS_MAX_THREADS> threadTop;
+
+/**
+ * Periodic print of the CPU load and of the stack usage of every thread,
+ * every second from the absolute start tick
+ */
+void threadReport() {
+    static miosix::ThreadUsage usage[THREAD_STATS_MAX_THREADS];
+    HeapGuard::allowMalloc();
+    long long next = miosix::getTick();
+
+    while (true) {
+        next += miosix::TICK_FREQ;
+        miosix::Thread::sleepUntil(next);
+        for (StaticThread *thread = StaticThread::getFirst(); thread != nullptr; thread = thread->getNext())
+            if (thread->getThread() != nullptr) threadTop.setName(thread->getThread(), thread->getName());
+        int count = miosix::CPUTimeCounter::getSnapshot(usage, THREAD_STATS_MAX_THREADS);
+        size_t rows = threadTop.update(usage, static_cast<size_t>(count));
+        for (size_t i = 0; i < rows; i++) {
+            const auto &row = threadTop.getRow(i);
+            printf("%-8s %p %5.1f%% CPU, stack %u/%u bytes%s\n", row.name != nullptr ? row.name : "",
+                   row.thread, static_cast<double>(row.load * 100.0f), row.stackUsed, row.stackSize,
+                   row.overflow ? " OVERFLOW" : "");
+        }
+        if (count > THREAD_STATS_MAX_THREADS) printf("%d threads not shown\n", count - THREAD_STATS_MAX_THREADS);
+    }
+}
+#endif
+
+#if IRQ_TRACE_ENABLED
+#ifndef WITH_IRQ_TRACE
+#error "IRQ_TRACE_ENABLED requires WITH_IRQ_TRACE in miosix_settings.h"
+#endif
+
+/**
+ * Periodic print of the trace of the interrupts and of the critical
+ * sections, for tools/irqtrace
+ */
+void irqTraceReport() {
+    HeapGuard::allowMalloc();
+    long long next = miosix::getTick();
+
+    while (true) {
+        next += IRQ_TRACE_DUMP_PERIOD * miosix::TICK_FREQ;
+        miosix::Thread::sleepUntil(next);
+        miosix::IRQTrace::dump();
+    }
+}
+#endif
+
+#if STACK_REPORT_ENABLED
+/**
+ * Periodic print of the highest stack usage of the static threads,
+ * every second from the absolute start tick
+ */
+void stackReport() {
+    HeapGuard::allowMalloc();
+    long long next = miosix::getTick();
+
+    while (true) {
+        next += miosix::TICK_FREQ;
+        miosix::Thread::sleepUntil(next);
+        StaticThread::report();
+    }
+}
+#endif
+
+/**
+ * Threads started by main, with their stacks in the .threadstacks section.
+ * The UI thread is above the MIDI threads and below the audio, to handle
+ * the buttons quickly
+ */
+THREAD_STACK static miosix::ThreadMemory<UI_THREAD_STACK_SIZE> uiStack;
+static StaticThread uiThread("ui", uiStack, controlUI, UI_THREAD_PRIORITY);
+
+THREAD_STACK static miosix::ThreadMemory<MIDI_PARSING_THREAD_STACK_SIZE> midiParsingStack;
+static StaticThread midiParsingThread("midi in", midiParsingStack, midiParsing, MIDI_THREAD_PRIORITY);
+
+THREAD_STACK static miosix::ThreadMemory<MIDI_PROCESSING_THREAD_STACK_SIZE> midiProcessingStack;
+static StaticThread midiProcessingThread("midi", midiProcessingStack, midiProcessing, MIDI_THREAD_PRIORITY);
+
+#if IRQ_LATENCY_PROBE_ENABLED
+THREAD_STACK static miosix::ThreadMemory<REPORT_THREAD_STACK_SIZE> irqLatencyStack;
+static StaticThread irqLatencyThread("latency", irqLatencyStack, irqLatencyReport, REPORT_THREAD_PRIORITY);
+#endif
+
+#if SCHEDULER_STATS_ENABLED
+THREAD_STACK static miosix::ThreadMemory<REPORT_THREAD_STACK_SIZE> schedulerStatsStack;
+static StaticThread schedulerStatsThread("sched", schedulerStatsStack, schedulerReport, REPORT_THREAD_PRIORITY);
+#endif
+
+#if THREAD_STATS_ENABLED
+THREAD_STACK static miosix::ThreadMemory<REPORT_THREAD_STACK_SIZE> threadStatsStack;
+static StaticThread threadStatsThread("top", threadStatsStack, threadReport, REPORT_THREAD_PRIORITY);
+#endif
+
+#if IRQ_TRACE_ENABLED
+THREAD_STACK static miosix::ThreadMemory<REPORT_THREAD_STACK_SIZE> irqTraceStack;
+static StaticThread irqTraceThread("irqtrace", irqTraceStack, irqTraceReport, REPORT_THREAD_PRIORITY);
+#endif
+
+#if STACK_REPORT_ENABLED
+THREAD_STACK static miosix::ThreadMemory<REPORT_THREAD_STACK_SIZE> stackReportStack;
+static StaticThread stackReportThread("stacks", stackReportStack, stackReport, REPORT_THREAD_PRIORITY);
+#endif
 
 int main() {
+#if DSP_BENCHMARK_ENABLED
+    DspBenchmark::run();
+#endif
+
     // Audio Driver initialization
     audioDriver.init();
     audioDriver.setAudioProcessable(synth);
 
-    // Hardware UI Threads
-    std::thread encoderUIThread(encoderUI);
-    std::thread buttonUIThread(buttonUI);
-    std::thread sliderUIThread(sliderUI);
-    std::thread lcdUIThread(lcdUI);
+    // The control tasks are clocked by the audio blocks
+    BlockScheduler::init(audioDriver);
+
+#if THREAD_STATS_ENABLED
+    // main becomes the audio thread
+    threadTop.setName(miosix::Thread::getCurrentThread(), "audio");
+#endif
+
+    // Hardware UI, MIDI and diagnostic threads
+    StaticThread::startAll();
 
-    // MIDI Threads
-    std::thread midiParsingThread(midiParsing);
-    std::thread midiProcessingThread(midiProcessing);
+    // Everything is built, from now on the heap is not used
+    HeapGuard::arm();
 
     // Audio Thread
     audioDriver.start();
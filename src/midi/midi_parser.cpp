@@ -3,7 +3,7 @@
 MidiNote MidiParser::popNote() {
     MidiNote note;
     {
-        miosix::Lock<miosix::Mutex> l(bufferMutex);
+        miosix::Lock<miosix::AdaptiveMutex> l(bufferMutex);
         note = noteMessageBuffer.front();
         noteMessageBuffer.pop();
     }
@@ -13,7 +13,7 @@ MidiNote MidiParser::popNote() {
 ControlChange MidiParser::popCC() {
     ControlChange cc;
     {
-        miosix::Lock<miosix::Mutex> l(bufferMutex);
+        miosix::Lock<miosix::AdaptiveMutex> l(bufferMutex);
         cc = ccMessageBuffer.front();
         ccMessageBuffer.pop();
     }
@@ -21,12 +21,12 @@ ControlChange MidiParser::popCC() {
 }
 
 bool MidiParser::isNoteAvaiable() {
-    miosix::Lock<miosix::Mutex> l(bufferMutex);
+    miosix::Lock<miosix::AdaptiveMutex> l(bufferMutex);
     return !noteMessageBuffer.empty();
 }
 
 bool MidiParser::isCCAvaiable() {
-    miosix::Lock<miosix::Mutex> l(bufferMutex);
+    miosix::Lock<miosix::AdaptiveMutex> l(bufferMutex);
     return !ccMessageBuffer.empty();
 }
 
@@ -78,7 +78,7 @@ void MidiParser::parseByte(uint8_t byte) {
             state = STATUS;
             lastState = NOTE_DATA2;
             {
-                miosix::Lock<miosix::Mutex> l(bufferMutex);
+                miosix::Lock<miosix::AdaptiveMutex> l(bufferMutex);
                 noteMessageBuffer.push(currentNote);
             }
             break;
@@ -95,7 +95,7 @@ void MidiParser::parseByte(uint8_t byte) {
             state = STATUS;
             lastState = CC_DATA2;
             {
-                miosix::Lock<miosix::Mutex> l(bufferMutex);
+                miosix::Lock<miosix::AdaptiveMutex> l(bufferMutex);
                 ccMessageBuffer.push(currentCC);
             }
             break;
@@ -0,0 +1,227 @@
+#include "catch.hpp"
+#include "benchmark.h"
+#include "kernel/adaptive_lock.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using miosix::AdaptiveLock;
+
+namespace {
+    /**
+     * Thread of the host kernel, with the priority fields of miosix::Thread.
+     */
+    struct HostThread {
+        int priority;
+        int savedPriority;
+    };
+
+    /**
+     * Kernel of the tests: std::atomic compare and swap, a global mutex to
+     * pause the kernel and a kernel mutex with priority inheritance.
+     */
+    struct HostKernel {
+        typedef uintptr_t Word;
+
+        static Word compareAndSwap(volatile Word *p, Word prev, Word next) {
+            static_assert(sizeof(std::atomic<Word>) == sizeof(Word), "The lock word is not an atomic");
+            auto atomic = reinterpret_cast<volatile std::atomic<Word> *>(p);
+            atomic->compare_exchange_strong(prev, next);
+            return prev;
+        }
+
+        class Pause {
+        public:
+            Pause() : lock(kernel) { pauses++; }
+
+            std::unique_lock<std::mutex> lock;
+        };
+
+        class Waiters {
+        public:
+            Waiters() : owner(nullptr) {}
+
+            void PKadopt(Word w) {
+                owner = reinterpret_cast<HostThread *>(w);
+                owner->savedPriority = owner->priority;
+            }
+
+            void PKlock(Pause &pause) {
+                HostThread *self = current;
+                waiting.push_back(self);
+                owner->priority = std::max(owner->priority, self->priority);
+                while (owner != self) cv.wait(pause.lock);
+            }
+
+            Word PKunlock(Pause &, bool &hppw) {
+                HostThread *previous = owner;
+                previous->priority = previous->savedPriority;
+                if (waiting.empty()) {
+                    owner = nullptr;
+                    return 0;
+                }
+                auto first = std::max_element(waiting.begin(), waiting.end(), [](HostThread *a, HostThread *b) {
+                    return a->priority < b->priority;
+                });
+                owner = *first;
+                waiting.erase(first);
+                owner->savedPriority = owner->priority;
+                for (HostThread *t : waiting) owner->priority = std::max(owner->priority, t->priority);
+                hppw = owner->priority > previous->priority;
+                cv.notify_all();
+                return reinterpret_cast<Word>(owner);
+            }
+
+        private:
+            HostThread *owner;
+            std::vector<HostThread *> waiting;
+            std::condition_variable cv;
+        };
+
+        static std::mutex kernel;
+        static std::atomic<size_t> pauses;
+        static thread_local HostThread *current;
+    };
+
+    std::mutex HostKernel::kernel;
+    std::atomic<size_t> HostKernel::pauses(0);
+    thread_local HostThread *HostKernel::current = nullptr;
+
+    typedef AdaptiveLock<HostKernel> Lock;
+
+    uintptr_t self() { return reinterpret_cast<uintptr_t>(HostKernel::current); }
+
+    /**
+     * Priority of a thread, read with the kernel paused.
+     */
+    int priorityOf(const HostThread &t) {
+        HostKernel::Pause pause;
+        return t.priority;
+    }
+
+    /**
+     * Lock taking the path of Mutex every time: the kernel is paused, as by
+     * PauseKernelLock, with an atomic increment of a counter, and the owner
+     * and its priority are recorded.
+     */
+    class KernelLock {
+    public:
+        void lock() {
+            paused++;
+            owner = HostKernel::current;
+            owner->savedPriority = owner->priority;
+            paused--;
+        }
+
+        void unlock() {
+            paused++;
+            if (owner->priority != owner->savedPriority) owner->priority = owner->savedPriority;
+            owner = nullptr;
+            paused--;
+        }
+
+    private:
+        HostThread *volatile owner = nullptr;
+        std::atomic<int> paused{0};
+    };
+}
+
+TEST_CASE("AdaptiveLock", "[adaptive lock]") {
+    HostThread low = {1, 1}, high = {3, 3};
+    HostKernel::current = &low;
+    Lock lock;
+
+    SECTION("no kernel entry without contention") {
+        size_t pauses = HostKernel::pauses;
+        for (int i = 0; i < 1000; i++) {
+            lock.lock(self());
+            REQUIRE(lock.getOwner() == self());
+            REQUIRE_FALSE(lock.unlock(self()));
+        }
+        REQUIRE(lock.tryLock(self()));
+        REQUIRE_FALSE(lock.tryLock(reinterpret_cast<uintptr_t>(&high)));
+        lock.unlock(self());
+        REQUIRE(lock.getOwner() == 0);
+        REQUIRE(HostKernel::pauses == pauses);
+    }
+
+    SECTION("priority inheritance when blocking") {
+        lock.lock(self());
+        uintptr_t ownerAfterLock = 0;
+        std::thread waiter([&] {
+            HostKernel::current = &high;
+            lock.lock(self());
+            ownerAfterLock = lock.getOwner();
+            lock.unlock(self());
+        });
+        // the owner gets the priority of the waiter
+        while (priorityOf(low) != 3) std::this_thread::yield();
+        REQUIRE(lock.getOwner() == self());
+
+        // the unlock goes through the kernel and restores the priority
+        REQUIRE(lock.unlock(self()));
+        REQUIRE(priorityOf(low) == 1);
+        waiter.join();
+        // the lock is handed over to the waiter
+        REQUIRE(ownerAfterLock == reinterpret_cast<uintptr_t>(&high));
+        REQUIRE(priorityOf(high) == 3);
+
+        // back to the fast path
+        size_t pauses = HostKernel::pauses;
+        lock.lock(self());
+        lock.unlock(self());
+        REQUIRE(HostKernel::pauses == pauses);
+    }
+}
+
+TEST_CASE("AdaptiveLock with contending threads", "[adaptive lock]") {
+    Lock lock;
+    const int THREADS = 4;
+    const int ITERATIONS = 50000;
+    long long counter = 0;
+
+    std::vector<std::thread> threads;
+    std::vector<HostThread> hostThreads(THREADS);
+    for (int i = 0; i < THREADS; i++) {
+        hostThreads[i] = {i, i};
+        threads.emplace_back([&, i] {
+            HostKernel::current = &hostThreads[i];
+            for (int j = 0; j < ITERATIONS; j++) {
+                lock.lock(self());
+                counter++;
+                lock.unlock(self());
+            }
+        });
+    }
+    for (auto &t : threads) t.join();
+
+    REQUIRE(counter == static_cast<long long>(THREADS) * ITERATIONS);
+    REQUIRE(lock.getOwner() == 0);
+    // the inherited priorities are all restored
+    for (int i = 0; i < THREADS; i++) REQUIRE(hostThreads[i].priority == i);
+}
+
+TEST_CASE("Adaptive lock benchmark", "[.benchmark]") {
+    HostThread thread = {1, 1};
+    HostKernel::current = &thread;
+    Lock adaptive;
+    KernelLock kernel;
+    std::mutex stdMutex;
+
+    Benchmark::report("AdaptiveLock, uncontended lock and unlock", Benchmark::measure([&] {
+        adaptive.lock(self());
+        adaptive.unlock(self());
+    }, 1000000));
+    Benchmark::report("kernel path, lock and unlock", Benchmark::measure([&] {
+        kernel.lock();
+        kernel.unlock();
+    }, 1000000));
+    Benchmark::report("std::mutex, lock and unlock", Benchmark::measure([&] {
+        stdMutex.lock();
+        stdMutex.unlock();
+    }, 1000000));
+}
@@ -0,0 +1,60 @@
+#ifndef MIOSIX_DRUM_ADC_DMA_MODEL_H
+#define MIOSIX_DRUM_ADC_DMA_MODEL_H
+
+#include <cstddef>
+#include <cstdint>
+#include "../include/drivers/common/adc_scan_buffer.h"
+
+/**
+ * Host model of the ADC in continuous scan mode and of the circular
+ * DMA stream writing into an AdcScanBuffer: each call to convert()
+ * stores one conversion, following the scan sequence and wrapping
+ * around at the end of the buffer like the DMA in circular mode.
+ *
+ * @tparam CHANNELS number of channels of the scan sequence
+ * @tparam DEPTH number of conversions of each channel kept in the buffer
+ */
+template<size_t CHANNELS, size_t DEPTH>
+class AdcDmaModel {
+public:
+    /**
+     * Constructor.
+     *
+     * @param buffer buffer written by the model
+     */
+    AdcDmaModel(AdcScanBuffer<CHANNELS, DEPTH> &buffer) : buffer(buffer), index(0) {};
+
+    /**
+     * Stores the next conversion of the sequence.
+     *
+     * @param value converted value
+     */
+    void convert(uint16_t value) {
+        buffer.data()[index] = value;
+        index = (index + 1) % AdcScanBuffer<CHANNELS, DEPTH>::SIZE;
+    };
+
+    /**
+     * Performs a whole scan of the sequence.
+     *
+     * @param values one value for each channel
+     */
+    void scan(const uint16_t (&values)[CHANNELS]) {
+        for (size_t channel = 0; channel < CHANNELS; channel++) convert(values[channel]);
+    };
+
+    /**
+     * Channel of the next conversion.
+     */
+    size_t nextChannel() const { return index % CHANNELS; };
+
+private:
+    AdcScanBuffer<CHANNELS, DEPTH> &buffer;
+
+    /**
+     * Next entry written, as the NDTR counter of the DMA stream.
+     */
+    size_t index;
+};
+
+#endif //MIOSIX_DRUM_ADC_DMA_MODEL_H
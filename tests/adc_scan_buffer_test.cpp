@@ -0,0 +1,57 @@
+#include "catch.hpp"
+#include "adc_dma_model.h"
+#include "../include/drivers/common/adc_scan_buffer.h"
+
+TEST_CASE("AdcScanBuffer averaging", "[adc]") {
+    AdcScanBuffer<4, 8> buffer;
+    AdcDmaModel<4, 8> dma(buffer);
+
+    SECTION("Empty buffer") {
+        for (size_t channel = 0; channel < 4; channel++) {
+            REQUIRE(buffer.average(channel) == 0);
+        }
+    }
+
+    SECTION("Channels are not mixed") {
+        for (int i = 0; i < 8; i++) dma.scan({100, 200, 300, 1023});
+        REQUIRE(buffer.average(0) == 100);
+        REQUIRE(buffer.average(1) == 200);
+        REQUIRE(buffer.average(2) == 300);
+        REQUIRE(buffer.average(3) == 1023);
+    }
+
+    SECTION("Noise is averaged") {
+        for (int i = 0; i < 8; i++) {
+            uint16_t noisy = static_cast<uint16_t>((i % 2) ? 510 : 514);
+            dma.scan({noisy, 0, 0, 0});
+        }
+        REQUIRE(buffer.average(0) == 512);
+    }
+
+    SECTION("Circular writes keep the last conversions") {
+        for (int i = 0; i < 8; i++) dma.scan({0, 0, 0, 0});
+        for (int i = 0; i < 3; i++) dma.scan({800, 0, 0, 0});
+        REQUIRE(buffer.average(0) == Approx(300));
+        for (int i = 0; i < 100; i++) dma.scan({800, 0, 0, 0});
+        REQUIRE(buffer.average(0) == 800);
+    }
+
+    SECTION("Reading in the middle of a scan") {
+        for (int i = 0; i < 8; i++) dma.scan({10, 20, 30, 40});
+        // the DMA has written only the first two channels of the new scan
+        dma.convert(18);
+        dma.convert(28);
+        REQUIRE(dma.nextChannel() == 2);
+        REQUIRE(buffer.average(0) == Approx(11));
+        REQUIRE(buffer.average(1) == Approx(21));
+        REQUIRE(buffer.average(2) == 30);
+        REQUIRE(buffer.average(3) == 40);
+    }
+
+    SECTION("Full scale values do not overflow") {
+        AdcScanBuffer<1, 64> deep;
+        AdcDmaModel<1, 64> deepDma(deep);
+        for (int i = 0; i < 64; i++) deepDma.convert(65535);
+        REQUIRE(deep.average(0) == 65535);
+    }
+}
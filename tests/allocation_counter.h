@@ -0,0 +1,19 @@
+#ifndef MIOSIX_DRUM_ALLOCATION_COUNTER_H
+#define MIOSIX_DRUM_ALLOCATION_COUNTER_H
+
+#include <cstddef>
+
+/**
+ * Counter of the heap allocations performed by the test program,
+ * implemented by replacing the global operator new.
+ */
+namespace AllocationCounter {
+    /**
+     * Returns the number of calls to operator new since the program start.
+     *
+     * @return allocation count
+     */
+    size_t getCount();
+}
+
+#endif //MIOSIX_DRUM_ALLOCATION_COUNTER_H
@@ -0,0 +1,73 @@
+#ifndef MIOSIX_DRUM_BENCHMARK_H
+#define MIOSIX_DRUM_BENCHMARK_H
+
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+#include <iostream>
+#include <string>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+/**
+ * Minimal helpers used by the host benchmarks, which are tagged
+ * [.benchmark] and run only when explicitly selected:
+ * ./test_main [benchmark]
+ */
+namespace Benchmark {
+    /**
+     * Returns a timestamp in CPU cycles when available,
+     * in nanoseconds otherwise.
+     */
+    inline uint64_t now() {
+#if defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#else
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+    }
+
+    /**
+     * Unit of the values returned by now().
+     */
+    inline const char *unit() {
+#if defined(__x86_64__) || defined(__i386__)
+        return "cycles";
+#else
+        return "ns";
+#endif
+    }
+
+    /**
+     * Measures the average cost of a function.
+     *
+     * @param function function to measure
+     * @param iterations number of measured calls
+     * @return average cost of a call, see unit()
+     */
+    template<typename F>
+    double measure(F function, size_t iterations) {
+        // warm up
+        for (size_t i = 0; i < iterations / 10 + 1; i++) function();
+
+        uint64_t start = now();
+        for (size_t i = 0; i < iterations; i++) function();
+        uint64_t end = now();
+        return static_cast<double>(end - start) / static_cast<double>(iterations);
+    }
+
+    /**
+     * Prints a benchmark result.
+     *
+     * @param name name of the measure
+     * @param value measured value, see unit()
+     */
+    inline void report(const std::string &name, double value) {
+        std::cout << name << ": " << value << " " << unit() << "\n";
+    }
+}
+
+#endif //MIOSIX_DRUM_BENCHMARK_H
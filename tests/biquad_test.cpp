@@ -0,0 +1,204 @@
+#include "catch.hpp"
+#include "benchmark.h"
+#include "../include/audio/biquad.h"
+#include "../include/audio/state_variable_filter.h"
+#include <cmath>
+
+static const float SAMPLE_RATE = 48000.0f;
+static const size_t BLOCK = 128;
+
+/**
+ * Magnitude in dB of the response of a biquad at a frequency.
+ */
+static double magnitude(const BiquadCoefficients &c, double frequency) {
+    double w = 2.0 * M_PI * frequency / SAMPLE_RATE;
+    // H(e^jw) = (b0 + b1 z^-1 + b2 z^-2) / (1 + a1 z^-1 + a2 z^-2)
+    double numRe = c.b0 + c.b1 * std::cos(w) + c.b2 * std::cos(2 * w);
+    double numIm = -c.b1 * std::sin(w) - c.b2 * std::sin(2 * w);
+    double denRe = 1.0 + c.a1 * std::cos(w) + c.a2 * std::cos(2 * w);
+    double denIm = -c.a1 * std::sin(w) - c.a2 * std::sin(2 * w);
+    return 10.0 * std::log10((numRe * numRe + numIm * numIm) / (denRe * denRe + denIm * denIm));
+}
+
+/**
+ * Gain in dB of a filter measured on a steady state sinusoid.
+ */
+template<typename FILTER>
+static double measuredGain(FILTER &filter, double frequency) {
+    AudioBuffer<float, 1, BLOCK> buffer;
+    double phase = 0, inputPower = 0, outputPower = 0;
+    for (size_t block = 0; block < 64; block++) {
+        float *data = buffer.getWritePointer(0);
+        for (size_t i = 0; i < BLOCK; i++) {
+            data[i] = static_cast<float>(std::sin(phase));
+            phase += 2.0 * M_PI * frequency / SAMPLE_RATE;
+        }
+        // skipping the transient
+        if (block >= 32) for (size_t i = 0; i < BLOCK; i++) inputPower += data[i] * data[i];
+        filter.processBlock(buffer);
+        if (block >= 32) for (size_t i = 0; i < BLOCK; i++) outputPower += data[i] * data[i];
+    }
+    return 10.0 * std::log10(outputPower / inputPower);
+}
+
+TEST_CASE("BiquadCoefficients responses", "[biquad]") {
+    BiquadCoefficients lowpass = BiquadCoefficients::compute(BiquadType::LOWPASS, 1000, 0.707f, 0, SAMPLE_RATE);
+    REQUIRE(magnitude(lowpass, 10) == Approx(0).margin(0.01));
+    REQUIRE(magnitude(lowpass, 1000) == Approx(-3.01).margin(0.05));
+    REQUIRE(magnitude(lowpass, 10000) < -40);
+
+    BiquadCoefficients highpass = BiquadCoefficients::compute(BiquadType::HIGHPASS, 1000, 0.707f, 0, SAMPLE_RATE);
+    REQUIRE(magnitude(highpass, 20000) == Approx(0).margin(0.05));
+    REQUIRE(magnitude(highpass, 1000) == Approx(-3.01).margin(0.05));
+    REQUIRE(magnitude(highpass, 50) < -40);
+
+    BiquadCoefficients bandpass = BiquadCoefficients::compute(BiquadType::BANDPASS, 2000, 2, 0, SAMPLE_RATE);
+    REQUIRE(magnitude(bandpass, 2000) == Approx(0).margin(0.01));
+    REQUIRE(magnitude(bandpass, 200) < -15);
+
+    BiquadCoefficients notch = BiquadCoefficients::compute(BiquadType::NOTCH, 2000, 2, 0, SAMPLE_RATE);
+    REQUIRE(magnitude(notch, 2000) < -60);
+    REQUIRE(magnitude(notch, 100) == Approx(0).margin(0.05));
+
+    BiquadCoefficients peak = BiquadCoefficients::compute(BiquadType::PEAK, 3000, 1, 6, SAMPLE_RATE);
+    REQUIRE(magnitude(peak, 3000) == Approx(6).margin(0.01));
+    REQUIRE(magnitude(peak, 20) == Approx(0).margin(0.05));
+
+    BiquadCoefficients lowShelf = BiquadCoefficients::compute(BiquadType::LOWSHELF, 500, 0.707f, -9, SAMPLE_RATE);
+    REQUIRE(magnitude(lowShelf, 10) == Approx(-9).margin(0.05));
+    REQUIRE(magnitude(lowShelf, 15000) == Approx(0).margin(0.05));
+
+    BiquadCoefficients highShelf = BiquadCoefficients::compute(BiquadType::HIGHSHELF, 5000, 0.707f, 4, SAMPLE_RATE);
+    REQUIRE(magnitude(highShelf, 23000) == Approx(4).margin(0.05));
+    REQUIRE(magnitude(highShelf, 20) == Approx(0).margin(0.05));
+}
+
+TEST_CASE("BiquadCascade filtering", "[biquad]") {
+    BiquadCascade<1, 2> cascade(SAMPLE_RATE);
+
+    SECTION("Flat by default") {
+        REQUIRE(measuredGain(cascade, 1000) == Approx(0).margin(0.01));
+    }
+
+    SECTION("Sections are cascaded") {
+        cascade.setType(0, BiquadType::PEAK);
+        cascade.setType(1, BiquadType::PEAK);
+        cascade.setFrequency(0, 2000);
+        cascade.setFrequency(1, 2000);
+        cascade.setGain(0, 3);
+        cascade.setGain(1, 3);
+        REQUIRE(measuredGain(cascade, 2000) == Approx(6).margin(0.1));
+    }
+
+    SECTION("Channels are independent") {
+        BiquadCascade<2, 1> stereo(SAMPLE_RATE);
+        stereo.setType(0, BiquadType::LOWPASS);
+        AudioBuffer<float, 2, BLOCK> buffer;
+        buffer.getWritePointer(0)[0] = 1.0f;
+        stereo.processBlock(buffer);
+        for (size_t i = 0; i < BLOCK; i++) {
+            REQUIRE(buffer.getWritePointer(1)[i] == 0);
+        }
+    }
+}
+
+TEST_CASE("BiquadCascade coefficient updates", "[biquad]") {
+    BiquadCascade<1, 1> cascade(SAMPLE_RATE);
+    cascade.setType(0, BiquadType::LOWPASS);
+    AudioBuffer<float, 1, BLOCK> buffer;
+
+    // no computation while the parameters are steady
+    unsigned int updates = cascade.getCoefficientUpdates();
+    for (int i = 0; i < 10; i++) cascade.processBlock(buffer);
+    REQUIRE(cascade.getCoefficientUpdates() == updates);
+
+    // one computation per block during the transition, then none
+    cascade.setFrequency(0, 5000);
+    for (int i = 0; i < 10; i++) cascade.processBlock(buffer);
+    unsigned int transitionBlocks = (AUDIO_PARAMETER_DEFAULT_TRANSITION_SAMPLES + BLOCK - 1) / BLOCK;
+    REQUIRE(cascade.getCoefficientUpdates() == updates + transitionBlocks);
+
+    // the final coefficients are the ones of the new frequency
+    REQUIRE(measuredGain(cascade, 5000) == Approx(-3.01).margin(0.1));
+}
+
+TEST_CASE("BiquadCascade interpolated sweep is stable", "[biquad]") {
+    BiquadCascade<1, 1> cascade(SAMPLE_RATE);
+    cascade.setType(0, BiquadType::LOWPASS);
+    cascade.setQ(0, 10);
+    AudioBuffer<float, 1, BLOCK> buffer;
+
+    float maxOutput = 0;
+    for (int block = 0; block < 400; block++) {
+        cascade.setFrequency(0, (block % 2) ? 50.0f : 20000.0f);
+        float *data = buffer.getWritePointer(0);
+        for (size_t i = 0; i < BLOCK; i++) data[i] = (i % 64 < 32) ? 0.5f : -0.5f;
+        cascade.processBlock(buffer);
+        for (size_t i = 0; i < BLOCK; i++) maxOutput = std::max(maxOutput, std::abs(data[i]));
+    }
+    REQUIRE(std::isfinite(maxOutput));
+    REQUIRE(maxOutput < 20);
+}
+
+TEST_CASE("StateVariableFilter responses", "[biquad]") {
+    StateVariableFilter<1> svf(SAMPLE_RATE);
+    svf.setFrequency(1000);
+    svf.setQ(0.707f);
+
+    SECTION("Lowpass") {
+        svf.setMode(SvfMode::LOWPASS);
+        REQUIRE(measuredGain(svf, 100) == Approx(0).margin(0.05));
+        REQUIRE(measuredGain(svf, 1000) == Approx(-3.01).margin(0.1));
+        REQUIRE(measuredGain(svf, 10000) < -35);
+    }
+
+    SECTION("Highpass") {
+        svf.setMode(SvfMode::HIGHPASS);
+        REQUIRE(measuredGain(svf, 10000) == Approx(0).margin(0.05));
+        REQUIRE(measuredGain(svf, 1000) == Approx(-3.01).margin(0.1));
+        REQUIRE(measuredGain(svf, 100) < -35);
+    }
+
+    SECTION("Bandpass and notch") {
+        svf.setQ(2);
+        svf.setMode(SvfMode::BANDPASS);
+        REQUIRE(measuredGain(svf, 1000) == Approx(20 * std::log10(2.0)).margin(0.1));
+        svf.setMode(SvfMode::NOTCH);
+        REQUIRE(measuredGain(svf, 1000) < -30);
+        REQUIRE(measuredGain(svf, 50) == Approx(0).margin(0.05));
+    }
+
+    SECTION("Coefficients are computed only during transitions") {
+        AudioBuffer<float, 1, BLOCK> buffer;
+        for (int i = 0; i < 10; i++) svf.processBlock(buffer);
+        unsigned int updates = svf.getCoefficientUpdates();
+        for (int i = 0; i < 10; i++) svf.processBlock(buffer);
+        REQUIRE(svf.getCoefficientUpdates() == updates);
+    }
+}
+
+TEST_CASE("Filter benchmark", "[.benchmark]") {
+    AudioBuffer<float, 1, BLOCK> buffer;
+    float *data = buffer.getWritePointer(0);
+    for (size_t i = 0; i < BLOCK; i++) data[i] = static_cast<float>(std::sin(0.1 * i));
+
+    BiquadCascade<1, 1> single(SAMPLE_RATE);
+    single.setType(0, BiquadType::LOWPASS);
+    Benchmark::report("biquad, per sample",
+                      Benchmark::measure([&] { single.processBlock(buffer); }, 100000) / BLOCK);
+
+    float frequency = 1000;
+    Benchmark::report("biquad with parameter change, per sample", Benchmark::measure([&] {
+        frequency = (frequency > 2000) ? 1000 : frequency + 10;
+        single.setFrequency(0, frequency);
+        single.processBlock(buffer);
+    }, 100000) / BLOCK);
+
+    BiquadCascade<1, 4> four(SAMPLE_RATE);
+    Benchmark::report("4 biquads, per sample",
+                      Benchmark::measure([&] { four.processBlock(buffer); }, 100000) / BLOCK);
+
+    StateVariableFilter<1> svf(SAMPLE_RATE);
+    Benchmark::report("svf, per sample",
+                      Benchmark::measure([&] { svf.processBlock(buffer); }, 100000) / BLOCK);
+}
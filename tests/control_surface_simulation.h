@@ -0,0 +1,238 @@
+#ifndef MIOSIX_DRUM_CONTROL_SURFACE_SIMULATION_H
+#define MIOSIX_DRUM_CONTROL_SURFACE_SIMULATION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "fake_registers.h"
+#include "adc_dma_model.h"
+#include "e20/callback_ring.h"
+#include "../include/config/audio_config.h"
+#include "../include/config/hw_config.h"
+#include "../include/config/thread_update_rates.h"
+#include "../include/drivers/common/audio.h"
+#include "../include/drivers/common/control_surface.h"
+#include "../include/drivers/common/lcd_framebuffer.h"
+#include "../include/drivers/stm32f407vg_discovery/control_pins.h"
+#include "../include/faust/faust_audio_processor.h"
+
+/**
+ * Host simulation of the control surface and of the audio driver, to
+ * measure the latency in samples from a scripted movement of a control
+ * to its first effect on the played audio.
+ *
+ * The synth is the FaustAudioProcessor of the firmware, and the control
+ * scan and the UI events are the ControlSurface of main.cpp, with the
+ * sliders and the encoders of control_pins.h on the fake registers. The
+ * simulation follows the timing of the target, one audio block at a time:
+ * - during the block the ADC converts the sliders every ADC_SCAN_SAMPLES;
+ * - at the end of the block the DMA interrupt starts playing the block
+ *   queued in the double buffer, and every CONTROL_SCAN_BLOCKS the block
+ *   scheduler runs the control scan, which posts the changed sliders to
+ *   the mailbox of the synth and hands the encoder increments to the UI
+ *   thread;
+ * - the audio thread drains the mailbox and renders the next block,
+ *   played after the queued one;
+ * - last, at a lower priority, the UI thread runs its events, moving the
+ *   menu parameters and posting them, so they reach the audio with the
+ *   following block.
+ */
+class ControlSurfaceSimulation {
+public:
+    /**
+     * LCD of the simulation, a framebuffer without a controller.
+     */
+    class Display {
+    public:
+        static void init() {};
+
+        static LcdFramebuffer<LCD_ROWS, LCD_COLS> &frame() {
+            static LcdFramebuffer<LCD_ROWS, LCD_COLS> framebuffer;
+            return framebuffer;
+        };
+
+        static void update() {};
+
+        Display() = delete;
+    };
+
+    /**
+     * Event queue of the UI thread, run by the simulation after the audio.
+     */
+    class EventQueue {
+    public:
+        template<typename T>
+        bool IRQpost(T event, bool &woken) {
+            woken = false;
+            return ring.push(event);
+        };
+
+        void run() {
+            while (ring.runOne()) {}
+        };
+
+    private:
+        miosix::CallbackRing<4, 20> ring;
+    };
+
+    typedef ControlSurface<FaustAudioProcessor, sliders, encoder1, encoder2, encoder3, encoder4, Display,
+            EventQueue> Controls;
+
+    /**
+     * Samples of an audio block.
+     */
+    static constexpr size_t BLOCK = AUDIO_DRIVER_BUFFER_SIZE;
+
+    /**
+     * Samples between two conversions of the same slider, four conversions
+     * of ~35us each.
+     */
+    static constexpr size_t ADC_SCAN_SAMPLES = 7;
+
+    /**
+     * Constructor, the drivers are initialized on clear registers by the
+     * UI thread, the sliders are at zero and the first block is rendered,
+     * as in AudioDriver::start().
+     *
+     * @param record false to play without keeping the output, so that the
+     *               simulation allocates nothing after its construction
+     */
+    explicit ControlSurfaceSimulation(bool record = true)
+            : synth(driver), controls(synth, events), dma(sliders::getBuffer()), record(record), time(0),
+              blocks(0), adcCountdown(0) {
+        FakeRegisters::reset();
+        driver.init();
+        driver.setAudioProcessable(synth);
+        controls.init();
+        for (size_t i = 0; i < 4; i++) position[i] = 0;
+
+        // the empty buffer played first, then the first rendered block
+        if (record) output.assign(BLOCK, 0.0f);
+        renderBlock();
+    };
+
+    /**
+     * Moves a slider, the ADC converts the new position from now on.
+     *
+     * @param slider slider, from 0
+     * @param newPosition position between 0 and 1
+     */
+    void moveSlider(size_t slider, float newPosition) {
+        position[slider] = newPosition;
+    };
+
+    /**
+     * Turns an encoder, its timer counts the steps immediately.
+     *
+     * @param encoder encoder, from 0
+     * @param detents detents, negative counterclockwise
+     */
+    void turnEncoder(size_t encoder, int detents) {
+        const uint32_t timers[4] = {TIM1_BASE, TIM3_BASE, TIM4_BASE, TIM5_BASE};
+        TIM_TypeDef *timer = peripheral<TIM_TypeDef>(timers[encoder]);
+        timer->CNT = static_cast<uint16_t>(timer->CNT + detents * ENCODER_COUNTS_PER_DETENT);
+    };
+
+    /**
+     * Plays audio blocks.
+     *
+     * @param count number of blocks
+     */
+    void run(size_t count) {
+        for (size_t i = 0; i < count; i++) {
+            for (size_t sample = 0; sample < BLOCK; sample++) {
+                if (adcCountdown == 0) {
+                    const uint16_t values[4] = {convert(0), convert(1), convert(2), convert(3)};
+                    dma.scan(values);
+                    adcCountdown = ADC_SCAN_SAMPLES;
+                }
+                adcCountdown--;
+            }
+            time += BLOCK;
+            blocks++;
+
+            // DMA interrupt, then the audio thread and the UI thread
+            if (blocks % CONTROL_SCAN_BLOCKS == 0) controls.IRQscan();
+            renderBlock();
+            events.run();
+        }
+    };
+
+    /**
+     * Synth of the simulation.
+     *
+     * @return synth
+     */
+    inline FaustAudioProcessor &getSynth() { return synth; };
+
+    /**
+     * Control surface of the simulation.
+     *
+     * @return control surface
+     */
+    inline Controls &getControls() { return controls; };
+
+    /**
+     * Time of the simulation.
+     *
+     * @return samples played
+     */
+    inline size_t getTime() const { return time; };
+
+    /**
+     * Played audio of the left channel, followed by the rendered block
+     * queued in the double buffer.
+     *
+     * @return samples from the start of the simulation
+     */
+    inline const std::vector<float> &getOutput() const { return output; };
+
+    /**
+     * Last rendered block of the left channel.
+     *
+     * @return BLOCK samples
+     */
+    inline const float *getBlock() { return driver.getBuffer().getReadPointer(0); };
+
+private:
+    /**
+     * Converts the position of a slider.
+     */
+    uint16_t convert(size_t slider) const {
+        return static_cast<uint16_t>(position[slider] * (ADC_MAX_VALUE - 1) + 0.5f);
+    };
+
+    /**
+     * Audio thread, one block of the synth.
+     */
+    void renderBlock() {
+        driver.getAudioProcessable().process();
+        if (record) output.insert(output.end(), getBlock(), getBlock() + BLOCK);
+    };
+
+    AudioDriver driver;
+    FaustAudioProcessor synth;
+    EventQueue events;
+    Controls controls;
+    AdcDmaModel<4, ADC_AVG_SAMPLES> dma;
+
+    /**
+     * Positions of the sliders.
+     */
+    float position[4];
+
+    /**
+     * Played audio, kept if record is true.
+     */
+    bool record;
+    std::vector<float> output;
+    size_t time;
+    size_t blocks;
+
+    /**
+     * Samples until the next scan of the ADC.
+     */
+    size_t adcCountdown;
+};
+
+#endif //MIOSIX_DRUM_CONTROL_SURFACE_SIMULATION_H
@@ -0,0 +1,101 @@
+#include "catch.hpp"
+#include "fake_registers.h"
+#include "adc_dma_model.h"
+#include "../include/drivers/stm32f407vg_discovery/encoder.h"
+#include "../include/drivers/stm32f407vg_discovery/button.h"
+#include "../include/drivers/stm32f407vg_discovery/potentiometer.h"
+#include "../include/drivers/stm32f407vg_discovery/adc_scanner.h"
+
+namespace {
+    typedef Encoder<TIM3_BASE, GPIOB_BASE, 4, 5> encoder;
+    typedef Button<GPIOD_BASE, 2> button;
+    typedef Potentiometer<GPIOA_BASE, 5, 5> slider1;
+    typedef Potentiometer<GPIOA_BASE, 6, 6> slider2;
+    typedef Potentiometer<GPIOC_BASE, 1, 11> slider3;
+    typedef AdcScanner<slider1, slider2, slider3> sliders;
+}
+
+TEST_CASE("Encoder on the fake registers", "[controls]") {
+    FakeRegisters::reset();
+    encoder::init();
+
+    SECTION("timer in encoder mode on its alternate function pins") {
+        REQUIRE(RCC->AHB1ENR & RCC_AHB1ENR_GPIOBEN);
+        REQUIRE(RCC->APB1ENR & RCC_APB1ENR_TIM3EN);
+        REQUIRE(((GPIOB->MODER >> 8) & 0xF) == 0xA);
+        REQUIRE(((GPIOB->AFR[0] >> 16) & 0xFF) == 0x22);
+        REQUIRE((TIM3->SMCR & TIM_SMCR_SMS) == (TIM_SMCR_SMS_0 | TIM_SMCR_SMS_1));
+        REQUIRE(TIM3->ARR == 0xFFFF);
+        REQUIRE(TIM3->CR1 & TIM_CR1_CEN);
+    }
+
+    SECTION("counts since the previous read") {
+        REQUIRE(encoder::getCountIncrement() == 0);
+        TIM3->CNT += 8;
+        REQUIRE(encoder::getCountIncrement() == 8);
+        REQUIRE(encoder::getCountIncrement() == 0);
+        TIM3->CNT -= 3;
+        REQUIRE(encoder::getCountIncrement() == -3);
+    }
+
+    SECTION("counts across the wrap of the counter") {
+        TIM3->CNT = 0xFFFE;
+        encoder::getCountIncrement();
+        TIM3->CNT = 0x0002;
+        REQUIRE(encoder::getCountIncrement() == 4);
+        TIM3->CNT = 0xFFFC;
+        REQUIRE(encoder::getCountIncrement() == -6);
+    }
+}
+
+TEST_CASE("Button on the fake registers", "[controls]") {
+    FakeRegisters::reset();
+    GPIOD->MODER = 0xFFFFFFFF;
+    button::init();
+
+    REQUIRE(RCC->AHB1ENR & RCC_AHB1ENR_GPIODEN);
+    REQUIRE(((GPIOD->MODER >> 4) & 3) == 0);
+    REQUIRE(((GPIOD->PUPDR >> 4) & 3) == 2);
+    // the other pins are untouched
+    REQUIRE(((GPIOD->MODER >> 6) & 3) == 3);
+
+    REQUIRE_FALSE(button::getState());
+    GPIOD->IDR = 1 << 2;
+    REQUIRE(button::getState());
+    GPIOD->IDR = ~(1u << 2);
+    REQUIRE_FALSE(button::getState());
+}
+
+TEST_CASE("Potentiometers on the fake registers", "[controls]") {
+    FakeRegisters::reset();
+    sliders::init();
+
+    SECTION("analog pins and scan sequence") {
+        REQUIRE(((GPIOA->MODER >> 10) & 3) == 3);
+        REQUIRE(((GPIOA->MODER >> 12) & 3) == 3);
+        REQUIRE(((GPIOC->MODER >> 2) & 3) == 3);
+        REQUIRE(((ADC1->SQR1 >> 20) & 0xF) == 2);
+        REQUIRE((ADC1->SQR3 & 0x7FFF) == (5 | (6 << 5) | (11 << 10)));
+        REQUIRE(ADC1->CR1 & ADC_CR1_SCAN);
+        REQUIRE(ADC1->CR2 & ADC_CR2_CONT);
+        const uint32_t size = sliders::getBuffer().SIZE;
+        REQUIRE(DMA2_Stream0->NDTR == size);
+        REQUIRE(DMA2_Stream0->CR & DMA_SxCR_CIRC);
+        REQUIRE(DMA2_Stream0->CR & DMA_SxCR_EN);
+    }
+
+    SECTION("positions averaged from the DMA buffer") {
+        AdcDmaModel<3, ADC_AVG_SAMPLES> dma(sliders::getBuffer());
+        const uint16_t values[3] = {0, 512, 1023};
+        for (int i = 0; i < ADC_AVG_SAMPLES; i++) dma.scan(values);
+        REQUIRE(sliders::read(0) == Approx(0.0f));
+        REQUIRE(sliders::read(1) == Approx(0.5f));
+        REQUIRE(sliders::read(2) == Approx(1023.0f / ADC_MAX_VALUE));
+    }
+}
+
+TEST_CASE("Fake registers bounds", "[controls]") {
+    REQUIRE_NOTHROW(FakeRegisters::at(PERIPH_BASE));
+    REQUIRE_THROWS(FakeRegisters::at(PERIPH_BASE - 4));
+    REQUIRE_THROWS(FakeRegisters::at(PERIPH_BASE + FakeRegisters::SIZE));
+}
@@ -0,0 +1,167 @@
+#include "catch.hpp"
+#include "../include/drivers/common/debouncer.h"
+#include "../include/containers/spsc_queue.h"
+#include <thread>
+#include <vector>
+
+namespace {
+    /**
+     * Times in microseconds.
+     */
+    const uint32_t DEBOUNCE = 5000;
+    const uint32_t LONG_PRESS = 600000;
+    const uint32_t TICK = 5000;
+
+    /**
+     * Transition of the input of a button.
+     */
+    struct Transition {
+        uint32_t time;
+        bool level;
+    };
+
+    /**
+     * Feeds a scripted waveform to a debouncer, with a tick every TICK
+     * until the end time, and returns the reported events.
+     */
+    std::vector<ButtonEvent> run(const std::vector<Transition> &waveform, uint32_t end, uint32_t start = 0) {
+        Debouncer debouncer(DEBOUNCE, LONG_PRESS);
+        debouncer.reset(false, start);
+        std::vector<ButtonEvent> events;
+        ButtonEvent::Type type;
+        bool level = false;
+        size_t next = 0;
+        for (uint32_t tick = start + TICK; tick - start <= end - start; tick += TICK) {
+            while (next < waveform.size() && waveform[next].time - start <= tick - start) {
+                level = waveform[next].level;
+                if (debouncer.edge(level, waveform[next].time, type)) {
+                    events.push_back({0, type, waveform[next].time});
+                }
+                next++;
+            }
+            if (debouncer.tick(level, tick, type)) events.push_back({0, type, tick});
+        }
+        return events;
+    }
+
+    /**
+     * Bouncing transition: the contact chatters for a few milliseconds
+     * before settling on the final level.
+     */
+    void bounce(std::vector<Transition> &waveform, uint32_t time, bool level) {
+        const uint32_t chatter[] = {0, 40, 90, 400, 700, 1500, 2100};
+        for (size_t i = 0; i < 7; i++) waveform.push_back({time + chatter[i], (i % 2 == 0) == level});
+    }
+}
+
+TEST_CASE("Debouncer", "[debouncer]") {
+    SECTION("Clean press and release") {
+        std::vector<ButtonEvent> events = run({{10000, true}, {100000, false}}, 200000);
+        REQUIRE(events.size() == 2);
+        REQUIRE(events[0].type == ButtonEvent::PRESS);
+        REQUIRE(events[0].time == 10000);
+        REQUIRE(events[1].type == ButtonEvent::RELEASE);
+        REQUIRE(events[1].time == 100000);
+    }
+
+    SECTION("Bouncing contacts are reported on the first edge") {
+        std::vector<Transition> waveform;
+        bounce(waveform, 10123, true);
+        bounce(waveform, 150321, false);
+        std::vector<ButtonEvent> events = run(waveform, 300000);
+        REQUIRE(events.size() == 2);
+        REQUIRE(events[0].type == ButtonEvent::PRESS);
+        REQUIRE(events[0].time == 10123);
+        REQUIRE(events[1].type == ButtonEvent::RELEASE);
+        REQUIRE(events[1].time == 150321);
+    }
+
+    SECTION("A spike shorter than the debounce time is released by the tick") {
+        std::vector<ButtonEvent> events = run({{10000, true}, {10300, false}}, 100000);
+        REQUIRE(events.size() == 2);
+        REQUIRE(events[0].type == ButtonEvent::PRESS);
+        REQUIRE(events[1].type == ButtonEvent::RELEASE);
+        REQUIRE(events[1].time >= 10300 + DEBOUNCE);
+        REQUIRE(events[1].time <= 10300 + DEBOUNCE + TICK);
+    }
+
+    SECTION("Fast taps are all detected") {
+        std::vector<Transition> waveform;
+        for (uint32_t tap = 0; tap < 10; tap++) {
+            bounce(waveform, 10000 + tap * 30000, true);
+            bounce(waveform, 10000 + tap * 30000 + 12000, false);
+        }
+        std::vector<ButtonEvent> events = run(waveform, 400000);
+        REQUIRE(events.size() == 20);
+        for (size_t i = 0; i < events.size(); i++) {
+            REQUIRE(events[i].type == ((i % 2) ? ButtonEvent::RELEASE : ButtonEvent::PRESS));
+        }
+    }
+
+    SECTION("Long press is reported once") {
+        std::vector<Transition> waveform;
+        bounce(waveform, 10000, true);
+        bounce(waveform, 1500000, false);
+        std::vector<ButtonEvent> events = run(waveform, 2000000);
+        REQUIRE(events.size() == 3);
+        REQUIRE(events[0].type == ButtonEvent::PRESS);
+        REQUIRE(events[1].type == ButtonEvent::LONG_PRESS);
+        REQUIRE(events[1].time >= 10000 + LONG_PRESS);
+        REQUIRE(events[1].time <= 10000 + LONG_PRESS + TICK);
+        REQUIRE(events[2].type == ButtonEvent::RELEASE);
+    }
+
+    SECTION("Short presses are not long") {
+        std::vector<Transition> waveform;
+        bounce(waveform, 10000, true);
+        bounce(waveform, 400000, false);
+        bounce(waveform, 500000, true);
+        bounce(waveform, 900000, false);
+        std::vector<ButtonEvent> events = run(waveform, 2000000);
+        REQUIRE(events.size() == 4);
+        for (const ButtonEvent &event : events) REQUIRE(event.type != ButtonEvent::LONG_PRESS);
+    }
+
+    SECTION("Timer wrap") {
+        uint32_t start = 0xffffffffu - 20000;
+        std::vector<Transition> waveform;
+        bounce(waveform, start + 10000, true);
+        bounce(waveform, start + 100000, false);
+        std::vector<ButtonEvent> events = run(waveform, start + 300000, start);
+        REQUIRE(events.size() == 2);
+        REQUIRE(events[0].time == start + 10000);
+        REQUIRE(events[1].time == start + 100000);
+    }
+}
+
+TEST_CASE("SpscQueue", "[debouncer]") {
+    SpscQueue<int, 8> queue;
+    int value;
+
+    SECTION("Order and capacity") {
+        REQUIRE(queue.isEmpty());
+        REQUIRE_FALSE(queue.pop(value));
+        for (int i = 0; i < 7; i++) REQUIRE(queue.push(i));
+        REQUIRE_FALSE(queue.push(7));
+        for (int i = 0; i < 7; i++) {
+            REQUIRE(queue.pop(value));
+            REQUIRE(value == i);
+        }
+        REQUIRE(queue.isEmpty());
+    }
+
+    SECTION("Concurrent producer and consumer") {
+        const int COUNT = 100000;
+        std::thread producer([&] {
+            for (int i = 0; i < COUNT; i++) {
+                while (!queue.push(i)) std::this_thread::yield();
+            }
+        });
+        for (int i = 0; i < COUNT; i++) {
+            while (!queue.pop(value)) std::this_thread::yield();
+            REQUIRE(value == i);
+        }
+        producer.join();
+        REQUIRE(queue.isEmpty());
+    }
+}
@@ -0,0 +1,248 @@
+#include "catch.hpp"
+#include "kernel/scheduler/edf/edf_deadline_list.h"
+#include "../include/drivers/common/block_deadline.h"
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <vector>
+
+using miosix::EDFDeadlineList;
+
+namespace {
+    /**
+     * Thread of the tests, with the scheduler data of a Miosix thread under
+     * SCHED_TYPE_EDF, and the work left of its released jobs.
+     */
+    struct Task {
+        long long deadline;
+        Task *next;
+        bool ready;
+        long long remaining;
+        size_t jobs;
+        size_t misses;
+    };
+
+    struct Links {
+        static Task *&next(Task *t) { return t->next; }
+
+        static long long deadline(Task *t) { return t->deadline; }
+    };
+
+    typedef EDFDeadlineList<Task, Links> List;
+
+    /**
+     * Deadlines of the synth configuration, 128 samples at 48kHz and a 1ms tick.
+     */
+    typedef BlockDeadline<128, 48000, 1000> Deadlines;
+
+    /**
+     * Threads of the synth, in the order of main.cpp.
+     */
+    enum Thread {
+        AUDIO, MIDI_PROCESSING, UI, MIDI_PARSING, REPORT, THREADS
+    };
+
+    /**
+     * Fixed priorities of thread_priorities.h.
+     */
+    const int priorities[THREADS] = {3, 1, 2, 1, 1};
+
+    /**
+     * Release of a job in the workload trace.
+     */
+    struct Job {
+        long long time;
+        Thread thread;
+        long long cost;
+    };
+
+    /**
+     * End of an audio block, in microseconds.
+     */
+    long long blockEnd(long long block) { return block * 128 * 1000000 / 48000; }
+
+    /**
+     * Workload trace of the synth: the audio thread released by the DMA at
+     * the end of every block, the MIDI processing thread every two blocks,
+     * and the UI events, the MIDI bytes and the reports at their own times.
+     *
+     * @param audioLoad worst DSP time, as a fraction of the block
+     */
+    std::vector<Job> makeTrace(unsigned int seed, long long duration, double audioLoad) {
+        std::mt19937 random(seed);
+        auto uniform = [&](long long min, long long max) -> long long {
+            return min + static_cast<long long>(random() % static_cast<unsigned long>(max - min + 1));
+        };
+        std::vector<Job> trace;
+        long long blockTime = blockEnd(1);
+        for (long long block = 1; blockEnd(block) < duration; block++) {
+            long long cost = uniform(static_cast<long long>(blockTime * audioLoad * 0.7),
+                                     static_cast<long long>(blockTime * audioLoad));
+            trace.push_back({blockEnd(block), AUDIO, cost});
+            if (block % 2 == 0) trace.push_back({blockEnd(block), MIDI_PROCESSING, uniform(50, 300)});
+        }
+        for (long long t = uniform(0, 20000); t < duration; t += uniform(5000, 40000))
+            trace.push_back({t, UI, uniform(500, 4000)});
+        for (long long t = uniform(0, 20000); t < duration; t += uniform(320, 20000))
+            trace.push_back({t, MIDI_PARSING, uniform(20, 80)});
+        for (long long t = 1000000; t < duration; t += 1000000)
+            trace.push_back({t, REPORT, 3000});
+        std::stable_sort(trace.begin(), trace.end(), [](const Job &a, const Job &b) { return a.time < b.time; });
+        return trace;
+    }
+
+    /**
+     * Replays a trace on one CPU, running the first ready thread of the
+     * deadline list at every release and completion, as the interrupts
+     * releasing the threads call IRQfindNextThread().
+     */
+    class Replay {
+    public:
+        /**
+         * @param edf true to release the periodic threads with block deadlines
+         * and run the other ones in the background, as ThreadDeadline with
+         * SCHED_TYPE_EDF, false for fixed priorities as keys of the list
+         * @param audioPriority fixed priority of the audio thread
+         */
+        Replay(bool edf, int audioPriority) : tasks(THREADS), list(), edf(edf) {
+            for (int i = 0; i < THREADS; i++) {
+                tasks[i] = Task();
+                int priority = i == AUDIO ? audioPriority : priorities[i];
+                tasks[i].deadline = edf ? Deadlines::background(priority) : 100 - priority;
+                list.add(&tasks[i]);
+            }
+        }
+
+        void run(const std::vector<Job> &trace) {
+            size_t next = 0;
+            long long time = 0;
+            while (next < trace.size()) {
+                Task *running = list.find([](Task *t) { return t->ready; });
+                if (running != nullptr && time + running->remaining <= trace[next].time) {
+                    time += running->remaining;
+                    running->remaining = 0;
+                    running->ready = false;
+                    continue;
+                }
+                if (running != nullptr) running->remaining -= trace[next].time - time;
+                time = trace[next].time;
+                release(trace[next++], time);
+            }
+        }
+
+        std::vector<Task> tasks;
+
+    private:
+        void release(const Job &job, long long time) {
+            Task *task = &tasks[job.thread];
+            bool periodic = job.thread == AUDIO || job.thread == MIDI_PROCESSING;
+            // a periodic thread still running its previous job missed its
+            // deadline, the end of the next block for the audio thread
+            if (periodic && task->ready) task->misses++;
+            if (periodic && edf) {
+                unsigned int blocks = job.thread == AUDIO ? 1 : 2;
+                long long deadline = Deadlines::absolute(time / 1000, blocks);
+                // the block deadline never comes after the true one
+                REQUIRE(deadline * 1000 <= time + blockEnd(blocks));
+                REQUIRE(list.remove(task));
+                task->deadline = deadline;
+                list.add(task);
+            }
+            task->ready = true;
+            task->remaining += job.cost;
+            task->jobs++;
+        }
+
+        List list;
+        bool edf;
+    };
+}
+
+TEST_CASE("EDF deadline list", "[scheduler]") {
+    std::vector<Task> tasks(5);
+    List list = List();
+    REQUIRE(list.empty());
+    const long long deadlines[] = {30, 10, 20, 10, 40};
+    for (size_t i = 0; i < tasks.size(); i++) {
+        tasks[i] = Task();
+        tasks[i].deadline = deadlines[i];
+        list.add(&tasks[i]);
+    }
+    auto first = [&](bool (*condition)(Task *)) { return list.find(condition); };
+
+    SECTION("the closest deadline first, the last added first among equal ones") {
+        tasks[0].ready = tasks[1].ready = tasks[3].ready = true;
+        REQUIRE(first([](Task *t) { return t->ready; }) == &tasks[3]);
+        tasks[3].ready = false;
+        REQUIRE(first([](Task *t) { return t->ready; }) == &tasks[1]);
+        tasks[1].ready = false;
+        REQUIRE(first([](Task *t) { return t->ready; }) == &tasks[0]);
+        tasks[0].ready = false;
+        REQUIRE(first([](Task *t) { return t->ready; }) == nullptr);
+    }
+
+    SECTION("a new deadline moves the thread") {
+        for (auto &t : tasks) t.ready = true;
+        REQUIRE(list.remove(&tasks[4]));
+        REQUIRE_FALSE(list.remove(&tasks[4]));
+        tasks[4].deadline = 5;
+        list.add(&tasks[4]);
+        REQUIRE(first([](Task *t) { return t->ready; }) == &tasks[4]);
+    }
+
+    SECTION("removing the threads matching a condition") {
+        tasks[1].ready = tasks[2].ready = true;
+        std::vector<Task *> removed;
+        list.removeIf([](Task *t) { return t->ready; }, [&](Task *t) { removed.push_back(t); });
+        REQUIRE(removed.size() == 2);
+        REQUIRE(list.find([](Task *t) { return t->deadline == 10 || t->deadline == 20; }) == &tasks[3]);
+        list.removeIf([](Task *) { return true; }, [](Task *) {});
+        REQUIRE(list.empty());
+    }
+}
+
+TEST_CASE("Block deadlines", "[scheduler]") {
+    // 2.67ms blocks, rounded down to whole ticks
+    REQUIRE(Deadlines::relative(1) == 2);
+    REQUIRE(Deadlines::relative(2) == 5);
+    REQUIRE(Deadlines::relative(3) == 8);
+    REQUIRE(Deadlines::absolute(100, 1) == 102);
+    REQUIRE(BlockDeadline<32, 48000, 1000>::relative(1) == 0);
+
+    // background threads after every deadline, before the idle thread
+    const long long idle = std::numeric_limits<long long>::max() - 1;
+    REQUIRE(Deadlines::background(0) < idle);
+    REQUIRE(Deadlines::background(2) < Deadlines::background(1));
+    REQUIRE(Deadlines::absolute(1ll << 50, 100) < Deadlines::background(3));
+}
+
+TEST_CASE("EDF replay of the synth workload", "[scheduler]") {
+    const long long duration = 20000000;
+
+    SECTION("no audio deadline missed with EDF") {
+        for (unsigned int seed = 1; seed <= 5; seed++) {
+            Replay replay(true, priorities[AUDIO]);
+            replay.run(makeTrace(seed, duration, 0.85));
+            REQUIRE(replay.tasks[AUDIO].jobs > 7000);
+            REQUIRE(replay.tasks[AUDIO].misses == 0);
+            REQUIRE(replay.tasks[MIDI_PROCESSING].misses == 0);
+            // the background threads still run
+            REQUIRE(replay.tasks[UI].jobs > 400);
+            REQUIRE(replay.tasks[UI].remaining < 50000);
+        }
+    }
+
+    SECTION("the audio thread below the UI thread misses deadlines") {
+        // the previous setPriority(PRIORITY_MAX) was out of range and
+        // ignored, leaving the audio thread at MAIN_PRIORITY
+        Replay replay(false, 1);
+        replay.run(makeTrace(1, duration, 0.85));
+        REQUIRE(replay.tasks[AUDIO].misses > 0);
+    }
+
+    SECTION("the audio thread at the highest fixed priority") {
+        Replay replay(false, priorities[AUDIO]);
+        replay.run(makeTrace(1, duration, 0.85));
+        REQUIRE(replay.tasks[AUDIO].misses == 0);
+    }
+}
@@ -0,0 +1,95 @@
+#include "catch.hpp"
+#include "../include/drivers/common/encoder_acceleration.h"
+
+namespace {
+    const float DT = 0.005f;
+
+    /**
+     * Turns an encoder with 4 counts per detent at a constant speed for a
+     * given time, returning the total increment.
+     */
+    float turn(EncoderAcceleration &encoder, float detentsPerSecond, float seconds) {
+        float counts = 0, total = 0;
+        int32_t sent = 0;
+        for (float t = 0; t < seconds; t += DT) {
+            counts += 4 * detentsPerSecond * DT;
+            int32_t now = static_cast<int32_t>(counts);
+            total += encoder.update(now - sent, DT);
+            sent = now;
+        }
+        return total;
+    }
+}
+
+TEST_CASE("EncoderAcceleration", "[encoder]") {
+    const EncoderCurve flat = {100.0f, 0.0f, 1.0f, 1.0f};
+    const EncoderCurve curve = {100.0f, 0.02f, 2.0f, 10.0f};
+
+    SECTION("Counts are normalised to detents") {
+        EncoderAcceleration encoder(flat, 4);
+        REQUIRE(encoder.update(3, DT) == 0.0f);
+        REQUIRE(encoder.update(1, DT) == Approx(0.01f));
+        REQUIRE(encoder.update(2, DT) == 0.0f);
+        REQUIRE(encoder.update(-1, DT) == 0.0f);
+        REQUIRE(encoder.update(-1, DT) == 0.0f);
+        REQUIRE(encoder.update(-4, DT) == Approx(-0.01f));
+        REQUIRE(encoder.update(9, DT) == Approx(0.02f));
+        REQUIRE(encoder.update(3, DT) == Approx(0.01f));
+    }
+
+    SECTION("Two counts per detent") {
+        EncoderAcceleration encoder(flat, 2);
+        REQUIRE(encoder.update(1, DT) == 0.0f);
+        REQUIRE(encoder.update(1, DT) == Approx(0.01f));
+    }
+
+    SECTION("Without acceleration the step does not depend on the speed") {
+        EncoderAcceleration encoder(flat, 4);
+        REQUIRE(turn(encoder, 2.0f, 5.0f) == Approx(0.1f).margin(0.011f));
+        encoder.reset();
+        REQUIRE(turn(encoder, 50.0f, 0.2f) == Approx(0.1f).margin(0.011f));
+    }
+
+    SECTION("An isolated click is not accelerated") {
+        EncoderAcceleration encoder(curve, 4);
+        REQUIRE(encoder.update(4, DT) == Approx(0.01f).margin(0.0001f));
+    }
+
+    SECTION("Slow turns are precise") {
+        EncoderAcceleration encoder(curve, 4);
+        REQUIRE(turn(encoder, 2.0f, 5.0f) == Approx(0.1f).margin(0.015f));
+    }
+
+    SECTION("Fast turns are accelerated up to the maximum gain") {
+        EncoderAcceleration encoder(curve, 4);
+        float slow = turn(encoder, 4.0f, 2.5f);
+        encoder.reset();
+        float fast = turn(encoder, 20.0f, 0.5f);
+        // same number of detents
+        REQUIRE(fast > 4 * slow);
+        REQUIRE(encoder.getVelocity() == Approx(20.0f).margin(2.0f));
+        REQUIRE(encoder.getGain() == Approx(1 + 0.02f * 400).margin(1.0f));
+
+        encoder.reset();
+        turn(encoder, 80.0f, 0.5f);
+        REQUIRE(encoder.getGain() == 10.0f);
+    }
+
+    SECTION("The velocity decays when the encoder stops") {
+        EncoderAcceleration encoder(curve, 4);
+        turn(encoder, 30.0f, 0.5f);
+        REQUIRE(encoder.getGain() > 5.0f);
+        // still for half a second, at most 2 detents per second
+        for (int i = 0; i < 100; i++) encoder.update(0, DT);
+        REQUIRE(encoder.getVelocity() <= Approx(2.0f));
+        REQUIRE(encoder.update(4, DT) == Approx(0.01f).margin(0.001f));
+    }
+
+    SECTION("Both directions are symmetric") {
+        EncoderAcceleration encoder(curve, 4);
+        float up = turn(encoder, 25.0f, 0.4f);
+        encoder.reset();
+        float down = turn(encoder, -25.0f, 0.4f);
+        REQUIRE(down == Approx(-up));
+    }
+}
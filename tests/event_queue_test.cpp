@@ -0,0 +1,150 @@
+#include "catch.hpp"
+#include "benchmark.h"
+#include "allocation_counter.h"
+#include "e20/callback_ring.h"
+#include <functional>
+#include <list>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using miosix::CallbackRing;
+
+namespace {
+    /**
+     * Event of the control scan, with a pointer and two parameters bound
+     * as the callbacks of the UI.
+     */
+    struct Event {
+        std::vector<int> *log;
+        int id;
+        int value;
+
+        void operator()() const { log->push_back(id * 1000 + value); }
+    };
+
+    /**
+     * Storage of miosix::EventQueue: a list of std::function protected by
+     * a mutex, as the FastMutex of the target.
+     */
+    class ListQueue {
+    public:
+        void post(std::function<void()> event) {
+            std::lock_guard<std::mutex> l(m);
+            events.push_back(event);
+        }
+
+        bool runOne() {
+            std::function<void()> f;
+            {
+                std::lock_guard<std::mutex> l(m);
+                if (events.empty()) return false;
+                f = events.front();
+                events.pop_front();
+            }
+            f();
+            return true;
+        }
+
+    private:
+        std::list<std::function<void()>> events;
+        std::mutex m;
+    };
+}
+
+TEST_CASE("CallbackRing", "[event queue]") {
+    CallbackRing<4, 20> ring;
+    std::vector<int> log;
+    log.reserve(100);
+    REQUIRE(ring.empty());
+
+    SECTION("events run in order and all the slots are used") {
+        for (int i = 0; i < 4; i++) REQUIRE(ring.push(Event{&log, i, 7}));
+        REQUIRE_FALSE(ring.push(Event{&log, 9, 9}));
+        REQUIRE(ring.size() == 4);
+        REQUIRE(ring.runOne());
+        REQUIRE(ring.push(Event{&log, 4, 7}));
+        while (ring.runOne()) {}
+        REQUIRE(log == std::vector<int>({7, 1007, 2007, 3007, 4007}));
+        REQUIRE(ring.empty());
+        REQUIRE_FALSE(ring.runOne());
+    }
+
+    SECTION("function pointers and counters wrapping") {
+        static int calls;
+        calls = 0;
+        for (int i = 0; i < 10000; i++) {
+            REQUIRE(ring.push(+[] { calls++; }));
+            REQUIRE(ring.push(Event{&log, 1, 1}));
+            REQUIRE(ring.runOne());
+            REQUIRE(ring.runOne());
+            log.clear();
+        }
+        REQUIRE(calls == 10000);
+    }
+
+    SECTION("no heap allocation") {
+        size_t allocations = AllocationCounter::getCount();
+        for (int i = 0; i < 1000; i++) {
+            ring.push(Event{&log, i, 0});
+            ring.runOne();
+            log.clear();
+        }
+        REQUIRE(AllocationCounter::getCount() == allocations);
+    }
+
+    SECTION("the slot is released by a throwing event") {
+        REQUIRE(ring.push(+[] { throw 1; }));
+        REQUIRE_THROWS(ring.runOne());
+        REQUIRE(ring.empty());
+    }
+}
+
+TEST_CASE("CallbackRing with a concurrent producer", "[event queue]") {
+    CallbackRing<8, 20> ring;
+    std::vector<int> log;
+    const int EVENTS = 200000;
+    log.reserve(EVENTS);
+
+    std::thread producer([&] {
+        for (int i = 0; i < EVENTS; i++)
+            while (!ring.push(Event{&log, 0, i})) std::this_thread::yield();
+    });
+    while (static_cast<int>(log.size()) < EVENTS)
+        if (!ring.runOne()) std::this_thread::yield();
+    producer.join();
+
+    REQUIRE(ring.empty());
+    for (int i = 0; i < EVENTS; i++) REQUIRE(log[i] == i);
+}
+
+TEST_CASE("Event queue benchmark", "[.benchmark]") {
+    std::vector<int> log;
+    log.reserve(1000);
+    const int BURST = 4;
+    ListQueue list;
+    CallbackRing<4, 20> ring;
+
+    auto listRound = [&] {
+        for (int i = 0; i < BURST; i++) list.post(Event{&log, i, 1});
+        while (list.runOne()) {}
+        log.clear();
+    };
+    auto ringRound = [&] {
+        for (int i = 0; i < BURST; i++) ring.push(Event{&log, i, 1});
+        while (ring.runOne()) {}
+        log.clear();
+    };
+
+    Benchmark::report("std::list of std::function, post and run", Benchmark::measure(listRound, 100000) / BURST);
+    Benchmark::report("CallbackRing, post and run", Benchmark::measure(ringRound, 100000) / BURST);
+
+    size_t allocations = AllocationCounter::getCount();
+    listRound();
+    std::cout << "std::list of std::function: "
+              << static_cast<double>(AllocationCounter::getCount() - allocations) / BURST << " allocations per event\n";
+    allocations = AllocationCounter::getCount();
+    ringRound();
+    std::cout << "CallbackRing: "
+              << static_cast<double>(AllocationCounter::getCount() - allocations) / BURST << " allocations per event\n";
+}
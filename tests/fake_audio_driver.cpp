@@ -0,0 +1,23 @@
+#include "../include/drivers/common/audio.h"
+
+/**
+ * Host version of the AudioDriver, without the DAC and the DMA, so that the
+ * audio processors run on the host unchanged. The tests call process() of
+ * the processor one block at a time, in place of the audio thread.
+ */
+
+AudioDriver::AudioDriver()
+        : bufferSize(AUDIO_DRIVER_BUFFER_SIZE), audioProcessable(nullptr),
+          sampleRate(AUDIO_DRIVER_SAMPLE_RATE), volume(1) {}
+
+AudioDriver::~AudioDriver() {}
+
+void AudioDriver::init() {}
+
+void AudioDriver::start() {}
+
+void AudioDriver::setBlockListener(void (*)()) {}
+
+uint32_t AudioDriver::getDeadlineMisses() const { return 0; }
+
+void AudioDriver::setVolume(float newVolume) { volume = newVolume; }
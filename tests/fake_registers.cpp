@@ -0,0 +1,26 @@
+#include "fake_registers.h"
+#include "kernel/error.h"
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+    /**
+     * Fake peripheral space, word aligned like the real registers.
+     */
+    alignas(8) unsigned char memory[FakeRegisters::SIZE];
+}
+
+void *FakeRegisters::at(uint32_t address) {
+    if (address < PERIPH_BASE || address - PERIPH_BASE >= SIZE)
+        throw std::out_of_range("address outside of the fake peripherals");
+    return memory + (address - PERIPH_BASE);
+}
+
+void FakeRegisters::reset() {
+    std::memset(memory, 0, sizeof(memory));
+}
+
+void miosix::errorHandler(miosix::Error) {
+    // the unrecoverable errors of the kernel, e.g. a failed allocation of the Faust module
+    throw std::runtime_error("unrecoverable error");
+}
@@ -0,0 +1,118 @@
+#ifndef MIOSIX_DRUM_FAKE_REGISTERS_H
+#define MIOSIX_DRUM_FAKE_REGISTERS_H
+
+#include <cstddef>
+#include <cstdint>
+
+#define STM32F407xx
+#include "CMSIS/Device/ST/STM32F4xx/Include/stm32f4xx.h"
+
+/**
+ * Host fake of the STM32F407 peripheral registers, included by registers.h
+ * when MIOSIX_DRUM_FAKE_REGISTERS is defined, so that the hardware input
+ * drivers compile and run on the host with their real register accesses.
+ *
+ * The peripheral space from PERIPH_BASE to the end of AHB1 is backed by
+ * plain memory: peripheral() maps a base address of the CMSIS headers to
+ * the same offset in that memory, and the CMSIS macros of the peripherals
+ * used by the drivers are redefined on top of it. The registers hold what
+ * the drivers write, and the tests write the inputs, e.g. the counter of an
+ * encoder timer or the input data register of a button. The peripherals
+ * do not react to the writes, their behaviour is left to the host models.
+ */
+namespace FakeRegisters {
+    /**
+     * Size of the fake peripheral space, APB1, APB2 and AHB1.
+     */
+    const uint32_t SIZE = 0x80000;
+
+    /**
+     * Memory of the register at an address.
+     *
+     * @param address address of a register, from PERIPH_BASE to PERIPH_BASE + SIZE
+     * @return pointer to the fake register
+     * @throws std::out_of_range if the address is not in the fake space
+     */
+    void *at(uint32_t address);
+
+    /**
+     * Clears every register, as after a reset.
+     */
+    void reset();
+}
+
+/**
+ * Registers of a peripheral, in the fake peripheral space.
+ *
+ * @tparam T register block, e.g. TIM_TypeDef
+ * @param base base address of the peripheral
+ * @return pointer to the fake registers
+ */
+template<typename T>
+inline T *peripheral(uint32_t base) {
+    return static_cast<T *>(FakeRegisters::at(base));
+}
+
+// peripherals used by the drivers, on the fake registers
+#undef GPIOA
+#undef GPIOB
+#undef GPIOC
+#undef GPIOD
+#undef GPIOE
+#undef GPIOF
+#undef GPIOG
+#undef GPIOH
+#undef GPIOI
+#define GPIOA (peripheral<GPIO_TypeDef>(GPIOA_BASE))
+#define GPIOB (peripheral<GPIO_TypeDef>(GPIOB_BASE))
+#define GPIOC (peripheral<GPIO_TypeDef>(GPIOC_BASE))
+#define GPIOD (peripheral<GPIO_TypeDef>(GPIOD_BASE))
+#define GPIOE (peripheral<GPIO_TypeDef>(GPIOE_BASE))
+#define GPIOF (peripheral<GPIO_TypeDef>(GPIOF_BASE))
+#define GPIOG (peripheral<GPIO_TypeDef>(GPIOG_BASE))
+#define GPIOH (peripheral<GPIO_TypeDef>(GPIOH_BASE))
+#define GPIOI (peripheral<GPIO_TypeDef>(GPIOI_BASE))
+
+#undef TIM1
+#undef TIM2
+#undef TIM3
+#undef TIM4
+#undef TIM5
+#undef TIM8
+#undef TIM9
+#undef TIM10
+#undef TIM11
+#define TIM1 (peripheral<TIM_TypeDef>(TIM1_BASE))
+#define TIM2 (peripheral<TIM_TypeDef>(TIM2_BASE))
+#define TIM3 (peripheral<TIM_TypeDef>(TIM3_BASE))
+#define TIM4 (peripheral<TIM_TypeDef>(TIM4_BASE))
+#define TIM5 (peripheral<TIM_TypeDef>(TIM5_BASE))
+#define TIM8 (peripheral<TIM_TypeDef>(TIM8_BASE))
+#define TIM9 (peripheral<TIM_TypeDef>(TIM9_BASE))
+#define TIM10 (peripheral<TIM_TypeDef>(TIM10_BASE))
+#define TIM11 (peripheral<TIM_TypeDef>(TIM11_BASE))
+
+#undef RCC
+#undef ADC
+#undef ADC1
+#undef DMA2_Stream0
+#define RCC (peripheral<RCC_TypeDef>(RCC_BASE))
+#define ADC (peripheral<ADC_Common_TypeDef>(ADC_BASE))
+#define ADC1 (peripheral<ADC_TypeDef>(ADC1_BASE))
+#define DMA2_Stream0 (peripheral<DMA_Stream_TypeDef>(DMA2_Stream0_BASE))
+
+#define RCC_SYNC()
+
+/**
+ * The kernel functions used by the drivers, which do nothing on the host.
+ */
+namespace miosix {
+    class FastInterruptDisableLock {
+    public:
+        FastInterruptDisableLock() {}
+    };
+
+    inline void delayUs(unsigned int) {}
+}
+
+#endif //MIOSIX_DRUM_FAKE_REGISTERS_H
@@ -0,0 +1,267 @@
+#include "catch.hpp"
+#include "allocation_counter.h"
+#include "../include/faust/faust_synth.h"
+#include "../include/drivers/common/lcd_framebuffer.h"
+#include "../include/drivers/common/parameter_menu.h"
+#include "control_surface_simulation.h"
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+TEST_CASE("StaticMemoryManager", "[faust]") {
+    StaticMemoryManager<64> manager;
+
+    SECTION("aligned allocations") {
+        void *a = manager.allocate(3);
+        void *b = manager.allocate(8);
+        REQUIRE(a != nullptr);
+        REQUIRE(b != nullptr);
+        REQUIRE(reinterpret_cast<uintptr_t>(b) % 8 == 0);
+        REQUIRE(manager.getUsedBytes() == 16);
+    }
+
+    SECTION("exhaustion") {
+        REQUIRE(manager.allocate(64) != nullptr);
+        REQUIRE(manager.allocate(1) == nullptr);
+        manager.reset();
+        REQUIRE(manager.allocate(1) != nullptr);
+    }
+}
+
+TEST_CASE("MiosixUI", "[faust]") {
+    StaticMemoryManager<FAUST_MEMORY_ARENA_SIZE> manager;
+    FaustSynth::fManager = &manager;
+    FaustSynth *synth = createDSP<FaustSynth>(&manager);
+    MiosixUI control;
+    synth->buildUserInterface(&control);
+
+    SECTION("paths and labels") {
+        REQUIRE(control.getParamsCount() == 11);
+        int freq = control.getParamIndex("/faust_synth/freq");
+        REQUIRE(freq >= 0);
+        REQUIRE(control.getParamIndex("freq") == freq);
+        REQUIRE(control.getParamIndex("") == -1);
+        REQUIRE(control.getParamIndex("/faust_synth/unknown") == -1);
+        REQUIRE(std::string(control.getParamAddress(freq)) == "/faust_synth/freq");
+    }
+
+    SECTION("metadata") {
+        const MiosixUI::Parameter &freq = control.getParameter(control.getParamIndex("/faust_synth/freq"));
+        REQUIRE(std::string(freq.unit) == "Hz");
+        REQUIRE(freq.min == Approx(20.0f));
+        REQUIRE(freq.max == Approx(20000.0f));
+        const MiosixUI::Parameter &gain = control.getParameter(control.getParamIndex("/faust_synth/gain"));
+        REQUIRE(std::string(gain.unit) == "");
+    }
+
+    SECTION("set and get") {
+        int gate = control.getParamIndex("/faust_synth/gate");
+        control.setParamValue(gate, 1);
+        REQUIRE(control.getParamValue(gate) == Approx(1));
+        control.setParamValue("/faust_synth/gate", 0);
+        REQUIRE(control.getParamValue("gate") == Approx(0));
+        REQUIRE_NOTHROW(control.setParamValue(-1, 1));
+    }
+}
+
+// The generated code keeps its tables in file static variables, one copy for
+// each translation unit including faust_synth.h, so the tests render only
+// through the FaustAudioProcessor, whose translation unit initializes them.
+TEST_CASE("Faust Miosix architecture allocations", "[faust]") {
+    size_t allocations = AllocationCounter::getCount();
+
+    // init
+    AudioDriver driver;
+    FaustAudioProcessor synth(driver);
+
+    // processing
+    synth.gateOn();
+    for (int i = 0; i < 100; i++) {
+        synth.process();
+    }
+
+    REQUIRE(AllocationCounter::getCount() == allocations);
+
+    // the synth is producing sound
+    const float *left = driver.getBuffer().getReadPointer(0);
+    float energy = 0;
+    for (int i = 0; i < AUDIO_DRIVER_BUFFER_SIZE; i++) energy += left[i] * left[i];
+    REQUIRE(energy > 0);
+}
+
+namespace {
+    /**
+     * Reads a row of a framebuffer.
+     */
+    template<size_t ROWS, size_t COLS>
+    std::string row(const LcdFramebuffer<ROWS, COLS> &frame, size_t r) {
+        std::string text;
+        for (size_t col = 0; col < COLS; col++) text += frame.at(r, col);
+        return text;
+    }
+}
+
+TEST_CASE("Application init and processing allocations", "[faust]") {
+    size_t allocations = AllocationCounter::getCount();
+    float energy = 0;
+    {
+        // init, the objects of main() and the UI thread initializing the controls
+        ControlSurfaceSimulation simulation(false);
+        FaustAudioProcessor &synth = simulation.getSynth();
+        ControlSurfaceSimulation::Controls &controls = simulation.getControls();
+
+        // processing: slider sweeps, encoders, menu pages and notes, one audio block at a time
+        for (int block = 0; block < 1000; block++) {
+            simulation.moveSlider(block % 4, (block % 200) / 200.0f);
+            if (block % 3 == 0) simulation.turnEncoder(block % 4, (block / 100) % 2 == 0 ? 1 : -1);
+            if (block % 50 == 0) {
+                ButtonEvent event = {MENU_NEXT_BUTTON - 1, ButtonEvent::PRESS, 0};
+                controls.handleButton(event);
+            }
+            if (block % 100 == 0) {
+                if ((block / 100) % 2 == 0) synth.gateOn();
+                else synth.gateOff();
+            }
+            simulation.run(1);
+
+            const float *left = simulation.getBlock();
+            for (size_t i = 0; i < ControlSurfaceSimulation::BLOCK; i++) energy += left[i] * left[i];
+        }
+    }
+
+    REQUIRE(AllocationCounter::getCount() == allocations);
+    REQUIRE(energy > 0);
+}
+
+TEST_CASE("Parameter menu from the Faust UI", "[faust][menu]") {
+    StaticMemoryManager<FAUST_MEMORY_ARENA_SIZE> manager;
+    FaustSynth::fManager = &manager;
+    FaustSynth *synth = createDSP<FaustSynth>(&manager);
+    MiosixUI control;
+    synth->buildUserInterface(&control);
+
+    ParameterMenu<FAUST_UI_MAX_PARAMS, 4> menu;
+    for (int i = 0; i < control.getParamsCount(); i++) {
+        const MiosixUI::Parameter &parameter = control.getParameter(i);
+        if (std::string(parameter.label).size() == 1 || std::string(parameter.label) == "gate") continue;
+        menu.add(i, parameter.label, parameter.unit, parameter.min, parameter.max, parameter.init, parameter.step);
+    }
+    REQUIRE(menu.getCount() == 6);
+
+    // rendering a page does not allocate
+    LcdFramebuffer<2, 16> frame;
+    size_t allocations = AllocationCounter::getCount();
+    menu.render(frame);
+    REQUIRE(AllocationCounter::getCount() == allocations);
+    REQUIRE(row(frame, 0) == "bend        0.00");
+    REQUIRE(row(frame, 1) == ">ben dis fee fre");
+
+    // the parameter moved by an encoder is shown in full, with its unit
+    REQUIRE(menu.move(3, 0.01f));
+    REQUIRE(menu.getIndex(3) == control.getParamIndex("/faust_synth/freq"));
+    REQUIRE(menu.getValue(3) == Approx(640.0f));
+    menu.render(frame);
+    REQUIRE(row(frame, 0) == "freq      640 Hz");
+    REQUIRE(row(frame, 1) == " ben dis fee>fre");
+
+    menu.nextPage();
+    menu.render(frame);
+    REQUIRE(row(frame, 0) == "gain         3.0");
+    REQUIRE(row(frame, 1) == ">gai rat        ");
+}
+
+namespace {
+    typedef ControlSurfaceSimulation Simulation;
+
+    /**
+     * Control moved by a latency measure.
+     */
+    enum Control {
+        SLIDER,
+        ENCODER
+    };
+
+    /**
+     * Plays a session with the gate open, the sustain on the third slider
+     * and the first parameter of the menu on the first encoder, moving one
+     * of them after some blocks. The slider is moved across the held
+     * sustain, so it picks it up.
+     *
+     * @param control moved control
+     * @param moveBlock blocks played before the movement
+     * @param moved false to play the reference session, without the movement
+     * @return played audio
+     */
+    std::vector<float> playSession(Control control, size_t moveBlock, bool moved) {
+        Simulation simulation;
+        simulation.getSynth().gateOn();
+
+        simulation.run(moveBlock);
+        if (moved && control == SLIDER) simulation.moveSlider(2, 0.5f);
+        if (moved && control == ENCODER) simulation.turnEncoder(0, 1);
+        simulation.run(CONTROL_SCAN_BLOCKS + 4);
+        return simulation.getOutput();
+    }
+
+    /**
+     * Latency from the movement of a control to its first effect on the
+     * played audio, found comparing the session with a reference one.
+     *
+     * @return latency in samples, 0 if the movement has no effect
+     */
+    size_t measureLatency(Control control, size_t moveBlock) {
+        std::vector<float> reference = playSession(control, moveBlock, false);
+        std::vector<float> output = playSession(control, moveBlock, true);
+        REQUIRE(output.size() == reference.size());
+        for (size_t i = 0; i < output.size(); i++) {
+            if (output[i] != reference[i]) return i - moveBlock * Simulation::BLOCK;
+        }
+        return 0;
+    }
+
+    /**
+     * Latencies of a control moved at every phase of the control scan.
+     *
+     * @return minimum and maximum latency in samples
+     */
+    std::pair<size_t, size_t> latencyRange(Control control) {
+        size_t min = SIZE_MAX, max = 0;
+        for (size_t phase = 0; phase < CONTROL_SCAN_BLOCKS; phase++) {
+            size_t latency = measureLatency(control, 20 + phase);
+            REQUIRE(latency > 0);
+            min = std::min(min, latency);
+            max = std::max(max, latency);
+        }
+        return std::make_pair(min, max);
+    }
+}
+
+TEST_CASE("UI to audio latency", "[faust][controls]") {
+    const size_t block = Simulation::BLOCK;
+
+    SECTION("slider") {
+        // scanned at the end of a block, rendered at once and played after the queued block
+        std::pair<size_t, size_t> latency = latencyRange(SLIDER);
+        REQUIRE(latency.first == 2 * block);
+        REQUIRE(latency.second == (CONTROL_SCAN_BLOCKS + 1) * block);
+    }
+
+    SECTION("encoder") {
+        // the UI thread runs after the audio thread, so the change misses the first block
+        std::pair<size_t, size_t> latency = latencyRange(ENCODER);
+        REQUIRE(latency.first == 3 * block);
+        REQUIRE(latency.second == (CONTROL_SCAN_BLOCKS + 2) * block);
+    }
+}
+
+TEST_CASE("UI to audio latency report", "[.latency]") {
+    const float ms = 1000.0f / AUDIO_DRIVER_SAMPLE_RATE;
+    const char *names[2] = {"slider", "encoder"};
+    for (int control = SLIDER; control <= ENCODER; control++) {
+        std::pair<size_t, size_t> latency = latencyRange(static_cast<Control>(control));
+        std::cout << names[control] << " to audio latency: " << latency.first << " to " << latency.second
+                  << " samples (" << latency.first * ms << " to " << latency.second * ms << " ms)\n";
+    }
+}
@@ -0,0 +1,191 @@
+#include "catch.hpp"
+#include "kernel/trace_ring.h"
+#include "../tools/irq_trace_analysis.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+using miosix::TraceEvent;
+using miosix::TraceRing;
+
+namespace {
+    TraceEvent makeEvent(unsigned time, unsigned type, int id = 0, unsigned site = 0) {
+        TraceEvent event;
+        event.time = time;
+        event.site = site;
+        event.type = static_cast<unsigned short>(type);
+        event.id = static_cast<short>(id);
+        return event;
+    }
+
+    /**
+     * Ring of the tests, static as the one of IRQTrace.
+     */
+    TraceRing<8> staticRing;
+}
+
+TEST_CASE("TraceRing", "[irq trace]") {
+    TraceEvent events[8];
+
+    SECTION("usable without a constructor") {
+        REQUIRE(staticRing.getCount() == 0);
+        REQUIRE(staticRing.snapshot(events, 8) == 0);
+        staticRing.record(makeEvent(1, miosix::TRACE_IRQ_ENTER));
+        REQUIRE(staticRing.snapshot(events, 8) == 1);
+        REQUIRE(events[0].time == 1);
+    }
+
+    // zeroed as a static ring would be
+    TraceRing<8> ring{};
+
+    SECTION("newest events kept, oldest first") {
+        for (unsigned i = 0; i < 20; i++) ring.record(makeEvent(i, miosix::TRACE_CS_ENTER));
+        REQUIRE(ring.getCount() == 20);
+        REQUIRE(ring.snapshot(events, 8) == 8);
+        for (unsigned i = 0; i < 8; i++) REQUIRE(events[i].time == 12 + i);
+        REQUIRE(ring.snapshot(events, 3) == 3);
+        REQUIRE(events[0].time == 17);
+
+        TraceEvent event;
+        REQUIRE(ring.get(19, event));
+        REQUIRE(event.time == 19);
+        REQUIRE_FALSE(ring.get(11, event));
+    }
+
+    SECTION("no events while frozen") {
+        ring.record(makeEvent(1, miosix::TRACE_CS_ENTER));
+        ring.freeze();
+        ring.record(makeEvent(2, miosix::TRACE_CS_LEAVE));
+        REQUIRE(ring.getCount() == 1);
+        ring.resume();
+        ring.record(makeEvent(3, miosix::TRACE_CS_LEAVE));
+        REQUIRE(ring.snapshot(events, 8) == 2);
+        REQUIRE(events[1].time == 3);
+    }
+}
+
+TEST_CASE("TraceRing with concurrent writers", "[irq trace]") {
+    const unsigned THREADS = 4;
+    const unsigned EVENTS = 20000;
+    static TraceRing<64> ring;
+
+    std::vector<std::thread> threads;
+    for (unsigned t = 0; t < THREADS; t++) {
+        threads.emplace_back([t] {
+            for (unsigned i = 0; i < EVENTS; i++)
+                ring.record(makeEvent(i, miosix::TRACE_IRQ_ENTER, static_cast<int>(t), i ^ 0x5a5a5a5a));
+        });
+    }
+    for (auto &t : threads) t.join();
+
+    REQUIRE(ring.getCount() == THREADS * EVENTS);
+    TraceEvent events[64];
+    REQUIRE(ring.snapshot(events, 64) == 64);
+    // no torn events: the fields of each event were written together
+    for (const TraceEvent &event : events) {
+        REQUIRE(event.site == (event.time ^ 0x5a5a5a5a));
+        REQUIRE(event.id < static_cast<short>(THREADS));
+    }
+}
+
+TEST_CASE("IrqTraceAnalysis", "[irq trace]") {
+    const int DMA = 16;
+    const int OTHER = 44;
+    const int TICK = -1;
+    const uint32_t SITE = 0x08001235;
+    const uint32_t QUIET_SITE = 0x08002001;
+    const uint64_t PERIOD = 448000;
+    const uint64_t START = 0xfffff000;
+
+    // DMA requests every PERIOD cycles from START, served 20 cycles later
+    // unless something else is running
+    std::vector<std::pair<uint64_t, TraceEvent>> trace;
+    auto add = [&](uint64_t time, unsigned type, int id, uint32_t site) {
+        trace.push_back({time, makeEvent(static_cast<uint32_t>(time), type, id, site)});
+    };
+    for (uint64_t k = 0; k < 10; k++) {
+        uint64_t request = START + k * PERIOD;
+        uint64_t delay = 20;
+        if (k == 4) {
+            add(request - 1000, miosix::TRACE_CS_ENTER, 0, SITE);
+            add(request + 3000, miosix::TRACE_CS_LEAVE, 0, SITE + 0x40);
+            delay += 3000;
+        } else if (k == 7) {
+            add(request - 200, miosix::TRACE_IRQ_ENTER, OTHER, 0);
+            add(request + 800, miosix::TRACE_IRQ_EXIT, OTHER, 0);
+            delay += 800;
+        } else if (k == 2) {
+            add(request - 5000, miosix::TRACE_CS_ENTER, 0, QUIET_SITE);
+            add(request - 4000, miosix::TRACE_CS_LEAVE, 0, QUIET_SITE + 0x10);
+        } else if (k == 9) {
+            delay += 50;
+        }
+        add(request + delay, miosix::TRACE_IRQ_ENTER, DMA, 0);
+        add(request + delay + 2000, miosix::TRACE_IRQ_EXIT, DMA, 0);
+        add(request + 100000, miosix::TRACE_IRQ_ENTER, TICK, 0);
+        add(request + 100500, miosix::TRACE_IRQ_EXIT, TICK, 0);
+    }
+    std::stable_sort(trace.begin(), trace.end(), [](const std::pair<uint64_t, TraceEvent> &a,
+                                                    const std::pair<uint64_t, TraceEvent> &b) {
+        return a.first < b.first;
+    });
+
+    // serial log as printed by IRQTrace::dump()
+    std::ostringstream log;
+    log << "boot message\nirqtrace begin 168000000 " << trace.size() << "\n";
+    for (const auto &e : trace) {
+        char line[64];
+        snprintf(line, sizeof(line), "%08x %u %d %08x\n", e.second.time, e.second.type, e.second.id, e.second.site);
+        log << line;
+    }
+    log << "irqtrace end\nirqtrace begin 168000000 3\n00000001 1 16 00000000\n";
+
+    std::istringstream in(log.str());
+    std::vector<TraceEvent> events;
+    unsigned frequency = 0;
+    REQUIRE(IrqTraceAnalysis::readDump(in, events, frequency));
+    REQUIRE(frequency == 168000000);
+    REQUIRE(events.size() == trace.size());
+    REQUIRE(events[0].time == trace[0].second.time);
+    // the second dump is incomplete
+    std::vector<TraceEvent> truncated;
+    REQUIRE_FALSE(IrqTraceAnalysis::readDump(in, truncated, frequency));
+
+    IrqTraceAnalysis analysis(DMA);
+    analysis.add(events);
+
+    SECTION("latencies across the counter wrap") {
+        std::vector<uint64_t> expected = {0, 0, 0, 0, 3000, 0, 0, 800, 0, 50};
+        REQUIRE(analysis.getLatencies() == expected);
+        std::vector<size_t> histogram = analysis.getHistogram(1000);
+        REQUIRE(histogram == std::vector<size_t>({9, 0, 0, 1}));
+    }
+
+    SECTION("offenders, worst first") {
+        std::vector<IrqTraceAnalysis::Offender> offenders = analysis.getOffenders();
+        REQUIRE(offenders.size() == 3);
+        REQUIRE(offenders[0].type == miosix::TRACE_CS_ENTER);
+        REQUIRE(offenders[0].site == SITE);
+        REQUIRE(offenders[0].worst == 3000);
+        REQUIRE(offenders[1].type == miosix::TRACE_IRQ_ENTER);
+        REQUIRE(offenders[1].id == OTHER);
+        REQUIRE(offenders[1].worst == 800);
+        REQUIRE(offenders[2].type == 0);
+        REQUIRE(offenders[2].worst == 50);
+    }
+
+    SECTION("critical sections and interrupt handlers") {
+        const std::map<uint32_t, IrqTraceAnalysis::Durations> &sections = analysis.getCriticalSections();
+        REQUIRE(sections.size() == 2);
+        REQUIRE(sections.at(SITE).worst == 4000);
+        REQUIRE(sections.at(QUIET_SITE).worst == 1000);
+        const std::map<int, IrqTraceAnalysis::Durations> &interrupts = analysis.getInterrupts();
+        REQUIRE(interrupts.at(DMA).count == 10);
+        REQUIRE(interrupts.at(DMA).worst == 2000);
+        REQUIRE(interrupts.at(TICK).total == 5000);
+        REQUIRE(interrupts.at(OTHER).count == 1);
+    }
+}
@@ -0,0 +1,52 @@
+#include "catch.hpp"
+#include "../include/drivers/common/latency_stats.h"
+
+TEST_CASE("LatencyStats", "[latency]") {
+    const uint32_t PERIOD = 1000;
+    LatencyStats stats(PERIOD);
+
+    SECTION("Regular interrupts have no added latency") {
+        for (uint32_t i = 0; i < 100; i++) stats.update(500 + 12 + i * PERIOD);
+        REQUIRE(stats.getCount() == 100);
+        REQUIRE(stats.getWorstLatency() == 0);
+        REQUIRE(stats.getMissed() == 0);
+    }
+
+    SECTION("Worst latency relative to the best entry") {
+        // the reference entry is itself 30 cycles late
+        const uint32_t lateness[] = {30, 0, 45, 10, 230, 0, 30};
+        for (uint32_t i = 0; i < 7; i++) stats.update(i * PERIOD + lateness[i]);
+        REQUIRE(stats.getWorstLatency() == 230);
+        REQUIRE(stats.getMissed() == 0);
+    }
+
+    SECTION("Counter wrap") {
+        uint32_t start = 0xffffffffu - 2500;
+        for (uint32_t i = 0; i < 10; i++) stats.update(start + i * PERIOD + (i == 5 ? 77 : 0));
+        REQUIRE(stats.getWorstLatency() == 77);
+    }
+
+    SECTION("Coalesced events are counted as missed") {
+        stats.update(0);
+        stats.update(PERIOD);
+        // masked for 2.5 periods, the events at 2 and 3 periods are merged
+        stats.update(3 * PERIOD + PERIOD / 2);
+        REQUIRE(stats.getWorstLatency() == PERIOD + PERIOD / 2);
+        REQUIRE(stats.getMissed() == 1);
+        // the following entries are aligned again
+        stats.update(4 * PERIOD);
+        stats.update(5 * PERIOD + 3);
+        REQUIRE(stats.getWorstLatency() == PERIOD + PERIOD / 2);
+        REQUIRE(stats.getMissed() == 1);
+    }
+
+    SECTION("Reset") {
+        stats.update(0);
+        stats.update(PERIOD + 100);
+        stats.reset();
+        stats.update(7 * PERIOD + 33);
+        stats.update(8 * PERIOD + 33);
+        REQUIRE(stats.getWorstLatency() == 0);
+        REQUIRE(stats.getCount() == 2);
+    }
+}
@@ -0,0 +1,208 @@
+#include "catch.hpp"
+#include "allocation_counter.h"
+#include "../include/drivers/common/lcd_framebuffer.h"
+#include "../include/drivers/common/hd44780_writer.h"
+#include <cstring>
+#include <string>
+
+namespace {
+    /**
+     * Model of an HD44780 in 4 bit mode, latching the data lines on the
+     * falling edge of the enable line, with its address counter and its
+     * display memory. It records the transferred bytes and checks that
+     * the data lines are stable while the enable line is high.
+     */
+    struct Hd44780Model {
+        static bool rs, enabled, high, violation;
+        static uint8_t nibble, partial, address;
+        static char memory[128];
+        static int commands, characters, tick, lastByteTick, minByteTicks;
+
+        static void reset() {
+            rs = enabled = violation = false;
+            high = true;
+            nibble = partial = address = 0;
+            std::memset(memory, 0, sizeof(memory));
+            commands = characters = tick = lastByteTick = 0;
+            minByteTicks = 1000;
+        }
+
+        static void write(bool newRs, uint8_t newNibble) {
+            if (enabled) violation = true;
+            rs = newRs;
+            nibble = newNibble & 0x0F;
+        }
+
+        static void enable(bool level) {
+            if (enabled && !level) latch();
+            enabled = level;
+        }
+
+        static void latch() {
+            if (high) {
+                partial = nibble << 4;
+                high = false;
+                if (lastByteTick != 0 && tick - lastByteTick < minByteTicks) minByteTicks = tick - lastByteTick;
+                return;
+            }
+            high = true;
+            lastByteTick = tick;
+            uint8_t byte = partial | nibble;
+            if (rs) {
+                memory[address & 0x7F] = static_cast<char>(byte);
+                address++;
+                characters++;
+            } else {
+                if (byte & 0x80) address = byte & 0x7F;
+                commands++;
+            }
+        }
+
+        static char at(size_t row, size_t col) {
+            return memory[Hd44780Writer<Hd44780Model, 4, 20>::addressOf(row, col)];
+        }
+    };
+
+    bool Hd44780Model::rs, Hd44780Model::enabled, Hd44780Model::high, Hd44780Model::violation;
+    uint8_t Hd44780Model::nibble, Hd44780Model::partial, Hd44780Model::address;
+    char Hd44780Model::memory[128];
+    int Hd44780Model::commands, Hd44780Model::characters, Hd44780Model::tick,
+            Hd44780Model::lastByteTick, Hd44780Model::minByteTicks;
+
+    /**
+     * Runs the timer interrupt until the writer stops.
+     *
+     * @return number of ticks
+     */
+    template<typename W>
+    int flush(W &writer) {
+        int ticks = 0;
+        while (writer.step()) {
+            Hd44780Model::tick++;
+            ticks++;
+            REQUIRE(ticks < 100000);
+        }
+        return ticks;
+    }
+
+    /**
+     * Checks that the model shows the frame.
+     */
+    template<size_t ROWS, size_t COLS>
+    void requireShown(const LcdFramebuffer<ROWS, COLS> &frame) {
+        for (size_t row = 0; row < ROWS; row++) {
+            for (size_t col = 0; col < COLS; col++) {
+                INFO("row " << row << " col " << col);
+                REQUIRE(Hd44780Model::at(row, col) == frame.at(row, col));
+            }
+        }
+    }
+}
+
+TEST_CASE("LCD framebuffer drawing", "[lcd]") {
+    LcdFramebuffer<2, 16> frame;
+
+    SECTION("blank frame") {
+        for (size_t col = 0; col < 16; col++) REQUIRE(frame.at(1, col) == ' ');
+    }
+
+    SECTION("print clipped at the end of the row") {
+        REQUIRE(frame.print(0, 12, "ABCDEF") == 4);
+        REQUIRE(frame.at(0, 12) == 'A');
+        REQUIRE(frame.at(0, 15) == 'D');
+        REQUIRE(frame.at(1, 0) == ' ');
+        REQUIRE(frame.print(2, 0, "X") == 0);
+    }
+
+    SECTION("printf without allocations") {
+        size_t allocations = AllocationCounter::getCount();
+        REQUIRE(frame.printf(1, 0, ".%03d.%03d.%03d.%03d", 12, 345, 999, 0) == 16);
+        REQUIRE(AllocationCounter::getCount() == allocations);
+        std::string row;
+        for (size_t col = 0; col < 16; col++) row += frame.at(1, col);
+        REQUIRE(row == ".012.345.999.000");
+    }
+
+    SECTION("changes found once, in order") {
+        size_t row, col;
+        char c;
+        for (int i = 0; i < 32; i++) REQUIRE(frame.nextChange(row, col, c));
+        REQUIRE_FALSE(frame.nextChange(row, col, c));
+        REQUIRE_FALSE(frame.isDirty());
+
+        frame.print(1, 3, "Z");
+        frame.print(0, 7, "Y");
+        REQUIRE(frame.nextChange(row, col, c));
+        REQUIRE(row == 0);
+        REQUIRE(col == 7);
+        REQUIRE(c == 'Y');
+        REQUIRE(frame.nextChange(row, col, c));
+        REQUIRE(row == 1);
+        REQUIRE(col == 3);
+        REQUIRE(c == 'Z');
+        REQUIRE_FALSE(frame.nextChange(row, col, c));
+
+        // redrawing the same content is not a change
+        frame.print(0, 7, "Y");
+        REQUIRE_FALSE(frame.nextChange(row, col, c));
+    }
+}
+
+TEST_CASE("HD44780 writer", "[lcd]") {
+    Hd44780Model::reset();
+    LcdFramebuffer<4, 20> frame;
+    Hd44780Writer<Hd44780Model, 4, 20> writer(frame);
+
+    // first frame, one set address command per row
+    frame.print(0, 0, "miosix drum");
+    frame.print(3, 19, "!");
+    flush(writer);
+    requireShown(frame);
+    REQUIRE(Hd44780Model::characters == 80);
+    REQUIRE(Hd44780Model::commands == 4);
+    REQUIRE_FALSE(Hd44780Model::violation);
+    // the LCD has at least 3 ticks to execute a byte before the next latch
+    REQUIRE(Hd44780Model::minByteTicks >= 3);
+
+    SECTION("an unchanged frame is not sent") {
+        REQUIRE_FALSE(writer.step());
+        frame.print(0, 0, "miosix");
+        REQUIRE(flush(writer) == 0);
+        REQUIRE(Hd44780Model::characters == 80);
+    }
+
+    SECTION("only the changed characters are sent") {
+        frame.print(1, 5, "A");
+        frame.print(2, 10, "B");
+        flush(writer);
+        requireShown(frame);
+        REQUIRE(Hd44780Model::characters == 82);
+        REQUIRE(Hd44780Model::commands == 6);
+    }
+
+    SECTION("consecutive characters share the set address command") {
+        frame.printf(1, 0, "%d", 1234);
+        flush(writer);
+        requireShown(frame);
+        REQUIRE(Hd44780Model::characters == 84);
+        REQUIRE(Hd44780Model::commands == 5);
+    }
+
+    SECTION("changes while sending are not lost") {
+        frame.print(0, 0, "0123456789");
+        for (int i = 0; i < 20; i++) writer.step();
+        frame.print(0, 1, "abc");
+        frame.print(3, 0, "def");
+        flush(writer);
+        requireShown(frame);
+        REQUIRE_FALSE(Hd44780Model::violation);
+    }
+
+    SECTION("reset sends the whole frame again") {
+        std::memset(Hd44780Model::memory, 0, sizeof(Hd44780Model::memory));
+        writer.reset();
+        flush(writer);
+        requireShown(frame);
+        REQUIRE(Hd44780Model::characters == 160);
+    }
+}
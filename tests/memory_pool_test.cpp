@@ -0,0 +1,26 @@
+#include "catch.hpp"
+#include "../include/containers/memory_pool.h"
+#include <cstdint>
+
+TEST_CASE("MonotonicArena", "[memory pool]") {
+    MonotonicArena<64> arena;
+
+    SECTION("aligned allocations") {
+        void *a = arena.allocate(3, 1);
+        void *b = arena.allocate(4, 4);
+        void *c = arena.allocate(8);
+        REQUIRE(a != nullptr);
+        REQUIRE(reinterpret_cast<uintptr_t>(b) == reinterpret_cast<uintptr_t>(a) + 4);
+        REQUIRE(reinterpret_cast<uintptr_t>(c) % MEMORY_POOL_ALIGNMENT == 0);
+        REQUIRE(arena.getUsedBytes() == 16);
+    }
+
+    SECTION("exhaustion and reset") {
+        REQUIRE(arena.allocate(60) != nullptr);
+        REQUIRE(arena.allocate(8) == nullptr);
+        REQUIRE(arena.allocate(4, 4) != nullptr);
+        REQUIRE(arena.allocate(1, 1) == nullptr);
+        arena.reset();
+        REQUIRE(arena.allocate(64) != nullptr);
+    }
+}
@@ -0,0 +1,124 @@
+#include "catch.hpp"
+#include "benchmark.h"
+#include "../include/audio/oversampler.h"
+#include "../include/audio/audio_math.h"
+#include <cmath>
+#include <vector>
+
+/**
+ * Power of a DFT bin of a signal.
+ */
+static double binPower(const std::vector<float> &signal, size_t bin) {
+    double re = 0, im = 0;
+    for (size_t n = 0; n < signal.size(); n++) {
+        double phase = 2.0 * M_PI * static_cast<double>(bin * n % signal.size()) / signal.size();
+        re += signal[n] * std::cos(phase);
+        im -= signal[n] * std::sin(phase);
+    }
+    return re * re + im * im;
+}
+
+/**
+ * Ratio in dB between the power of the aliased components and the
+ * power of the harmonics of a bin-exact sinusoid, in a signal of N samples.
+ */
+static double aliasingRatio(const std::vector<float> &signal, size_t fundamentalBin) {
+    double harmonics = 0, aliases = 0;
+    for (size_t bin = 1; bin < signal.size() / 2; bin++) {
+        double power = binPower(signal, bin);
+        if (bin % fundamentalBin == 0) harmonics += power;
+        else aliases += power;
+    }
+    return 10.0 * std::log10(aliases / harmonics);
+}
+
+/**
+ * Renders a distorted sinusoid, with or without oversampling.
+ */
+template<size_t FACTOR>
+static std::vector<float> renderDistortedSine(size_t fundamentalBin, size_t length, bool oversampling) {
+    const size_t block = 128;
+    Oversampler<FACTOR, block> oversampler;
+    // default distortion of faust_synth.dsp
+    float amount = std::pow(10.0f, 12.0f / 20.0f);
+    auto shaper = [amount](float x) { return AudioMath::waveshaper(x, amount); };
+
+    // rendering some blocks before the analyzed ones to skip the transient
+    std::vector<float> signal(length + 8 * block);
+    for (size_t n = 0; n < signal.size(); n++) {
+        signal[n] = 0.9f * std::sin(2.0 * M_PI * static_cast<double>(fundamentalBin * n % length) / length);
+    }
+    for (size_t start = 0; start < signal.size(); start += block) {
+        if (oversampling) {
+            oversampler.process(&signal[start], block, shaper);
+        } else {
+            for (size_t n = start; n < start + block; n++) signal[n] = shaper(signal[n]);
+        }
+    }
+    return std::vector<float>(signal.end() - length, signal.end());
+}
+
+TEST_CASE("HalfBand resampling", "[audio]") {
+    const size_t length = 64;
+
+    SECTION("upsampling a constant") {
+        HalfBandUpsampler<HalfBand::Steep> upsampler;
+        std::array<float, length> input;
+        std::array<float, 2 * length> output;
+        input.fill(1.0f);
+        upsampler.process(input.data(), output.data(), length);
+        for (size_t i = 2 * length - 8; i < 2 * length; i++) {
+            REQUIRE(output[i] == Approx(1.0f).margin(1e-5));
+        }
+    }
+
+    SECTION("round trip of a low frequency sinusoid") {
+        HalfBandUpsampler<HalfBand::Steep> upsampler;
+        HalfBandDownsampler<HalfBand::Steep> downsampler;
+        std::array<float, 4 * length> input;
+        std::array<float, 8 * length> upsampled;
+        std::array<float, 4 * length> output;
+        for (size_t i = 0; i < input.size(); i++) input[i] = std::sin(2.0 * M_PI * 1000.0 * i / 48000.0);
+        upsampler.process(input.data(), upsampled.data(), input.size());
+        downsampler.process(upsampled.data(), output.data(), input.size());
+
+        // the round trip delay is 2 * HALF_LENGTH - 1 samples
+        const size_t delay = 2 * HalfBand::Steep::HALF_LENGTH - 1;
+        for (size_t i = 2 * delay; i < output.size(); i++) {
+            REQUIRE(output[i] == Approx(input[i - delay]).margin(1e-3));
+        }
+    }
+}
+
+TEST_CASE("Oversampler aliasing suppression", "[audio]") {
+    // 7031.25Hz at 48kHz, its 5th, 7th... harmonics alias below Nyquist
+    const size_t length = 4096;
+    const size_t bin = 600;
+
+    double plain = aliasingRatio(renderDistortedSine<2>(bin, length, false), bin);
+    double x2 = aliasingRatio(renderDistortedSine<2>(bin, length, true), bin);
+    double x4 = aliasingRatio(renderDistortedSine<4>(bin, length, true), bin);
+
+    INFO("aliasing without oversampling: " << plain << "dB, 2x: " << x2 << "dB, 4x: " << x4 << "dB");
+    REQUIRE(plain - x2 > 12.0);
+    REQUIRE(plain - x4 > 25.0);
+    REQUIRE(x4 < x2);
+}
+
+TEST_CASE("Oversampler benchmark", "[.benchmark]") {
+    const size_t block = 128;
+    std::array<float, block> buffer;
+    for (size_t i = 0; i < block; i++) buffer[i] = std::sin(2.0 * M_PI * i / 64.0);
+    float amount = 100.0f;
+    auto shaper = [amount](float x) { return AudioMath::waveshaper(x, amount); };
+
+    Oversampler<2, block> oversampler2;
+    Oversampler<4, block> oversampler4;
+
+    Benchmark::report("waveshaper, 128 samples block",
+                      Benchmark::measure([&]() { for (auto &x : buffer) x = shaper(x); }, 10000));
+    Benchmark::report("2x oversampled waveshaper, 128 samples block",
+                      Benchmark::measure([&]() { oversampler2.process(buffer.data(), block, shaper); }, 10000));
+    Benchmark::report("4x oversampled waveshaper, 128 samples block",
+                      Benchmark::measure([&]() { oversampler4.process(buffer.data(), block, shaper); }, 10000));
+}
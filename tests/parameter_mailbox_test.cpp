@@ -0,0 +1,87 @@
+#include "catch.hpp"
+#include "../include/containers/parameter_mailbox.h"
+#include "../include/drivers/common/change_detector.h"
+#include <thread>
+#include <vector>
+
+TEST_CASE("ParameterMailbox", "[mailbox]") {
+    ParameterMailbox<13> mailbox;
+    std::vector<std::pair<size_t, float>> applied;
+    auto apply = [&](size_t index, float value) { applied.push_back({index, value}); };
+
+    SECTION("Empty mailbox") {
+        REQUIRE_FALSE(mailbox.isPending());
+        REQUIRE(mailbox.drain(apply) == 0);
+        REQUIRE(applied.empty());
+    }
+
+    SECTION("Only the posted parameters are applied, in order") {
+        mailbox.post(12, 1.0f);
+        mailbox.post(3, 0.5f);
+        REQUIRE(mailbox.isPending());
+        REQUIRE(mailbox.drain(apply) == 2);
+        REQUIRE(applied.size() == 2);
+        REQUIRE(applied[0] == std::make_pair(size_t(3), 0.5f));
+        REQUIRE(applied[1] == std::make_pair(size_t(12), 1.0f));
+        REQUIRE_FALSE(mailbox.isPending());
+        REQUIRE(mailbox.drain(apply) == 0);
+    }
+
+    SECTION("Repeated posts are applied once with the last value") {
+        for (int i = 0; i <= 100; i++) mailbox.post(0, i / 100.0f);
+        REQUIRE(mailbox.drain(apply) == 1);
+        REQUIRE(applied[0].second == 1.0f);
+    }
+
+    SECTION("Concurrent producer and consumer") {
+        const int POSTS = 200000;
+        float last[13] = {0};
+        std::thread producer([&] {
+            for (int i = 1; i <= POSTS; i++) mailbox.post(i % 13, static_cast<float>(i));
+        });
+        // consuming until the last post is applied
+        while (last[POSTS % 13] != POSTS) {
+            mailbox.drain([&](size_t index, float value) {
+                // the values of a parameter never go back in time
+                REQUIRE(value >= last[index]);
+                last[index] = value;
+            });
+        }
+        producer.join();
+        mailbox.drain([&](size_t index, float value) { last[index] = value; });
+        for (int i = 0; i < 13; i++) {
+            REQUIRE(last[(POSTS - i) % 13] == static_cast<float>(POSTS - i));
+        }
+    }
+}
+
+TEST_CASE("ChangeDetector", "[mailbox]") {
+    SECTION("First sample is always reported") {
+        ChangeDetector<bool> button;
+        REQUIRE(button.update(false));
+        REQUIRE_FALSE(button.update(false));
+        REQUIRE(button.update(true));
+        REQUIRE_FALSE(button.update(true));
+        button.reset();
+        REQUIRE(button.update(true));
+    }
+
+    SECTION("Changes below the threshold are ignored") {
+        ChangeDetector<float> slider(0.01f);
+        REQUIRE(slider.update(0.5f));
+        REQUIRE_FALSE(slider.update(0.505f));
+        REQUIRE_FALSE(slider.update(0.495f));
+        // the difference is measured from the last reported value
+        REQUIRE(slider.update(0.515f));
+        REQUIRE(slider.getValue() == 0.515f);
+        REQUIRE_FALSE(slider.update(0.51f));
+        REQUIRE(slider.update(0.4f));
+    }
+
+    SECTION("Without threshold any change is reported") {
+        ChangeDetector<float> encoder;
+        REQUIRE(encoder.update(0.0f));
+        REQUIRE_FALSE(encoder.update(0.0f));
+        REQUIRE(encoder.update(0.0002f));
+    }
+}
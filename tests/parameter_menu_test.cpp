@@ -0,0 +1,77 @@
+#include "catch.hpp"
+#include "../include/drivers/common/parameter_menu.h"
+#include <string>
+
+namespace {
+    /**
+     * Formats a value into a string.
+     */
+    std::string format(float value, float step) {
+        char buffer[16];
+        size_t length = ParameterMenu<1, 4>::formatValue(buffer, sizeof(buffer), value, step);
+        REQUIRE(length == std::string(buffer).size());
+        return buffer;
+    }
+}
+
+TEST_CASE("Parameter menu value formatting", "[menu]") {
+    REQUIRE(format(440.0f, 1.0f) == "440");
+    REQUIRE(format(12.34f, 0.1f) == "12.3");
+    REQUIRE(format(0.2f, 0.01f) == "0.20");
+    REQUIRE(format(0.0049f, 0.01f) == "0.00");
+    REQUIRE(format(-0.001f, 0.01f) == "0.00");
+    REQUIRE(format(-95.96f, 0.1f) == "-96.0");
+    REQUIRE(format(0.12345f, 0.0f) == "0.123");
+    REQUIRE(format(5.0f, 5.0f) == "5");
+
+    char small[4];
+    REQUIRE(ParameterMenu<1, 4>::formatValue(small, sizeof(small), 12345.0f, 1.0f) == 3);
+    REQUIRE(std::string(small) == "123");
+}
+
+TEST_CASE("Parameter menu paging and editing", "[menu]") {
+    ParameterMenu<8, 4> menu;
+    REQUIRE(menu.getPageCount() == 1);
+    REQUIRE_FALSE(menu.isBound(0));
+    REQUIRE_FALSE(menu.move(0, 0.1f));
+
+    const char *labels[] = {"a", "b", "c", "d", "e", "f"};
+    for (int i = 0; i < 6; i++) REQUIRE(menu.add(10 + i, labels[i], "", 0.0f, 10.0f, 5.0f, 1.0f));
+    REQUIRE(menu.getCount() == 6);
+    REQUIRE(menu.getPageCount() == 2);
+
+    SECTION("pages wrap around") {
+        REQUIRE(menu.getIndex(3) == 13);
+        menu.nextPage();
+        REQUIRE(menu.getPage() == 1);
+        REQUIRE(menu.getIndex(0) == 14);
+        REQUIRE(menu.getIndex(1) == 15);
+        REQUIRE_FALSE(menu.isBound(2));
+        REQUIRE(menu.getIndex(2) == -1);
+        menu.nextPage();
+        REQUIRE(menu.getPage() == 0);
+        menu.previousPage();
+        REQUIRE(menu.getPage() == 1);
+    }
+
+    SECTION("values are rounded to the step and clipped to the range") {
+        REQUIRE(menu.getValue(0) == Approx(5.0f));
+        REQUIRE_FALSE(menu.move(0, 0.02f));
+        REQUIRE(menu.move(0, 0.04f));
+        REQUIRE(menu.getValue(0) == Approx(6.0f));
+        REQUIRE(menu.move(0, 2.0f));
+        REQUIRE(menu.getValue(0) == Approx(10.0f));
+        REQUIRE_FALSE(menu.move(0, 0.5f));
+        REQUIRE(menu.move(0, -0.5f));
+        REQUIRE(menu.getValue(0) == Approx(5.0f));
+    }
+
+    SECTION("each parameter keeps its value across pages") {
+        menu.move(1, -1.0f);
+        menu.nextPage();
+        menu.move(1, 1.0f);
+        REQUIRE(menu.getValue(1) == Approx(10.0f));
+        menu.nextPage();
+        REQUIRE(menu.getValue(1) == Approx(0.0f));
+    }
+}
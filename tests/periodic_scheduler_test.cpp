@@ -0,0 +1,175 @@
+#include "catch.hpp"
+#include "../include/drivers/common/periodic_scheduler.h"
+#include <vector>
+
+namespace {
+    /**
+     * Simulated cycle counter, advanced by the test and by the tasks
+     * to model their execution time.
+     */
+    struct SimulatedClock {
+        static uint32_t time;
+
+        static uint32_t read() { return time; }
+    };
+
+    uint32_t SimulatedClock::time;
+
+    typedef PeriodicScheduler<4, SimulatedClock> Scheduler;
+
+    /**
+     * Cycles of a tick of the simulation.
+     */
+    const uint32_t TICK_CYCLES = 1000;
+
+    /**
+     * Log of the runs, as pairs of task id and tick.
+     */
+    std::vector<std::pair<size_t, uint32_t>> runs;
+    uint32_t currentTick;
+
+    /**
+     * Execution time of each task, in cycles.
+     */
+    uint32_t cost[4];
+
+    bool logTask(size_t id) {
+        runs.push_back(std::make_pair(id, currentTick));
+        SimulatedClock::time += cost[id];
+        return id == 1;
+    }
+
+    /**
+     * Runs the scheduler for a number of ticks.
+     *
+     * @return number of ticks in which a task woke up a thread
+     */
+    int simulate(Scheduler &scheduler, uint32_t ticks, uint32_t from = 0) {
+        int woken = 0;
+        for (uint32_t i = 0; i < ticks; i++) {
+            currentTick = from + i;
+            SimulatedClock::time = currentTick * TICK_CYCLES;
+            if (scheduler.run(currentTick, SimulatedClock::time)) woken++;
+        }
+        return woken;
+    }
+
+    size_t countRuns(size_t id) {
+        size_t count = 0;
+        for (auto &run : runs) if (run.first == id) count++;
+        return count;
+    }
+}
+
+TEST_CASE("Periodic scheduler releases", "[scheduler]") {
+    runs.clear();
+    for (auto &c : cost) c = 0;
+    Scheduler scheduler;
+
+    SECTION("tasks are limited and need a period") {
+        for (int i = 0; i < 4; i++) REQUIRE(scheduler.add(logTask, 1) == i);
+        REQUIRE(scheduler.add(logTask, 1) == -1);
+        REQUIRE(scheduler.getCount() == 4);
+        Scheduler other;
+        REQUIRE(other.add(logTask, 0) == -1);
+    }
+
+    SECTION("periods and phases") {
+        REQUIRE(scheduler.add(logTask, 1) == 0);
+        REQUIRE(scheduler.add(logTask, 2, 1) == 1);
+        REQUIRE(scheduler.add(logTask, 3, 2) == 2);
+        REQUIRE(simulate(scheduler, 9) == 4);
+
+        std::vector<std::pair<size_t, uint32_t>> expected;
+        for (uint32_t tick = 0; tick < 9; tick++) {
+            expected.push_back(std::make_pair(0, tick));
+            if (tick % 2 == 1) expected.push_back(std::make_pair(1, tick));
+            if (tick % 3 == 2) expected.push_back(std::make_pair(2, tick));
+        }
+        REQUIRE(runs == expected);
+        REQUIRE(scheduler.getNextRelease(2) == 11);
+    }
+
+    SECTION("no drift over a long run") {
+        scheduler.add(logTask, 7, 3);
+        simulate(scheduler, 70003);
+        REQUIRE(countRuns(0) == 10000);
+        REQUIRE(scheduler.getStats(0).runs == 10000);
+        REQUIRE(scheduler.getStats(0).missed == 0);
+        for (auto &run : runs) REQUIRE(run.second % 7 == 3);
+    }
+
+    SECTION("late runs skip the missed releases") {
+        scheduler.add(logTask, 2);
+        simulate(scheduler, 3);
+        // the ticks from 3 to 9 are lost, the releases at 4, 6 and 8 are missed
+        simulate(scheduler, 4, 10);
+        REQUIRE(countRuns(0) == 4);
+        REQUIRE(runs[2].second == 10);
+        REQUIRE(scheduler.getStats(0).missed == 3);
+        // the task stays aligned to its absolute releases
+        REQUIRE(runs[3].second == 12);
+    }
+
+    SECTION("releases across the wrap of the ticks") {
+        scheduler.add(logTask, 4, 0xFFFFFFFE);
+        simulate(scheduler, 12, 0xFFFFFFFC);
+        REQUIRE(countRuns(0) == 3);
+        REQUIRE(runs[0].second == 0xFFFFFFFE);
+        REQUIRE(runs[1].second == 2);
+        REQUIRE(runs[2].second == 6);
+    }
+}
+
+TEST_CASE("Periodic scheduler jitter", "[scheduler]") {
+    runs.clear();
+    for (auto &c : cost) c = 0;
+    Scheduler scheduler;
+
+    SECTION("a task is delayed by the tasks before it") {
+        scheduler.add(logTask, 1);
+        scheduler.add(logTask, 2);
+        scheduler.add(logTask, 1);
+        cost[0] = 10;
+        cost[1] = 100;
+        simulate(scheduler, 100);
+
+        REQUIRE(scheduler.getStats(0).minDelay == 0);
+        REQUIRE(scheduler.getStats(0).getJitter() == 0);
+        REQUIRE(scheduler.getStats(1).minDelay == 10);
+        REQUIRE(scheduler.getStats(1).getJitter() == 0);
+        // the third task is delayed by 10 or 110 cycles, whether the second one runs
+        REQUIRE(scheduler.getStats(2).minDelay == 10);
+        REQUIRE(scheduler.getStats(2).maxDelay == 110);
+        REQUIRE(scheduler.getStats(2).getJitter() == 100);
+        REQUIRE(scheduler.getStats(2).runs == 100);
+
+        scheduler.resetStats();
+        REQUIRE(scheduler.getStats(2).runs == 0);
+        REQUIRE(scheduler.getStats(2).getJitter() == 0);
+    }
+
+    SECTION("a thread reports its own start") {
+        int id = scheduler.add(logTask, 1, 0, false);
+        for (currentTick = 0; currentTick < 10; currentTick++) {
+            SimulatedClock::time = currentTick * TICK_CYCLES;
+            scheduler.run(currentTick, SimulatedClock::time);
+            REQUIRE(scheduler.getStats(id).runs == currentTick);
+            // the thread wakes up after a delay growing with the tick
+            scheduler.record(id, SimulatedClock::time + 50 + currentTick * 5);
+        }
+        REQUIRE(scheduler.getStats(id).runs == 10);
+        REQUIRE(scheduler.getStats(id).minDelay == 50);
+        REQUIRE(scheduler.getStats(id).maxDelay == 95);
+
+        scheduler.miss(id);
+        REQUIRE(scheduler.getStats(id).missed == 1);
+    }
+
+    SECTION("delays across the wrap of the clock") {
+        scheduler.add(logTask, 1);
+        SimulatedClock::time = 0xFFFFFFF0;
+        scheduler.run(0, 0xFFFFFFF0 - 20);
+        REQUIRE(scheduler.getStats(0).minDelay == 20);
+    }
+}
@@ -0,0 +1,265 @@
+#include "catch.hpp"
+#include "benchmark.h"
+#include "kernel/scheduler/priority/priority_ready_queue.h"
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+using miosix::PriorityReadyQueue;
+using miosix::ReadyQueueLinks;
+
+namespace {
+    const int LEVELS = 4;
+
+    /**
+     * Thread of the tests, with the scheduler data of a Miosix thread.
+     */
+    struct FakeThread {
+        int priority;
+        bool ready;
+        FakeThread *next;
+        ReadyQueueLinks<FakeThread> links;
+    };
+
+    struct Links {
+        static ReadyQueueLinks<FakeThread> &get(FakeThread *t) { return t->links; }
+    };
+
+    typedef PriorityReadyQueue<FakeThread, LEVELS, Links> Queue;
+
+    /**
+     * Threads of the tests, and the ready queue kept up to date as in
+     * PriorityScheduler::IRQwaitStatusHook().
+     */
+    class Threads {
+    public:
+        explicit Threads(const std::vector<int> &priorities) : threads(priorities.size()), queue() {
+            for (size_t i = 0; i < threads.size(); i++) {
+                threads[i] = FakeThread();
+                threads[i].priority = priorities[i];
+            }
+        };
+
+        void setReady(size_t i, bool ready) {
+            FakeThread *t = &threads[i];
+            t->ready = ready;
+            if (ready && !Queue::contains(t)) queue.add(t, t->priority);
+            if (!ready && Queue::contains(t)) queue.remove(t, t->priority);
+        };
+
+        void setPriority(size_t i, int priority) {
+            FakeThread *t = &threads[i];
+            if (Queue::contains(t)) {
+                queue.remove(t, t->priority);
+                queue.add(t, priority);
+            }
+            t->priority = priority;
+        };
+
+        int index(const FakeThread *t) const { return t == nullptr ? -1 : static_cast<int>(t - &threads[0]); };
+
+        std::vector<FakeThread> threads;
+        Queue queue;
+    };
+
+    /**
+     * The previous selection of PriorityScheduler, walking the circular list
+     * of all the threads of each priority to find a ready one.
+     */
+    class LinearScheduler {
+    public:
+        explicit LinearScheduler(std::vector<FakeThread> &threads) {
+            for (int i = 0; i < LEVELS; i++) lists[i] = nullptr;
+            for (auto &t : threads) {
+                if (lists[t.priority] == nullptr) {
+                    lists[t.priority] = &t;
+                    t.next = &t;
+                } else {
+                    t.next = lists[t.priority]->next;
+                    lists[t.priority]->next = &t;
+                }
+            }
+        };
+
+        FakeThread *next() {
+            for (int i = LEVELS - 1; i >= 0; i--) {
+                if (lists[i] == nullptr) continue;
+                FakeThread *temp = lists[i]->next;
+                for (;;) {
+                    if (temp->ready) {
+                        lists[i] = temp;
+                        return temp;
+                    }
+                    temp = temp->next;
+                    if (temp == lists[i]->next) break;
+                }
+            }
+            return nullptr;
+        };
+
+    private:
+        FakeThread *lists[LEVELS];
+    };
+}
+
+TEST_CASE("Ready queue selection", "[scheduler]") {
+    Threads t({0, 1, 1, 3, 2});
+
+    SECTION("empty queue selects no thread") {
+        REQUIRE(t.queue.empty());
+        REQUIRE(t.queue.highestPriority() == -1);
+        REQUIRE(t.queue.next() == nullptr);
+    }
+
+    SECTION("highest ready priority from the bitmap") {
+        t.setReady(0, true);
+        t.setReady(1, true);
+        REQUIRE(t.queue.getBitmap() == 0x3);
+        REQUIRE(t.queue.highestPriority() == 1);
+        REQUIRE(t.index(t.queue.next()) == 1);
+
+        t.setReady(3, true);
+        REQUIRE(t.queue.highestPriority() == 3);
+        REQUIRE(t.index(t.queue.next()) == 3);
+
+        t.setReady(3, false);
+        t.setReady(1, false);
+        REQUIRE(t.queue.getBitmap() == 0x1);
+        REQUIRE(t.index(t.queue.next()) == 0);
+    }
+
+    SECTION("round robin within a priority") {
+        t.setReady(1, true);
+        t.setReady(2, true);
+        FakeThread *first = t.queue.next();
+        FakeThread *second = t.queue.next();
+        REQUIRE(first != second);
+        REQUIRE(t.queue.next() == first);
+        REQUIRE(t.queue.next() == second);
+    }
+
+    SECTION("a thread that becomes ready runs before the one selected last") {
+        t.threads[4].priority = 1;
+        t.setReady(1, true);
+        t.setReady(2, true);
+        FakeThread *first = t.queue.next();
+        FakeThread *running = t.queue.next();
+        t.setReady(4, true);
+        REQUIRE(t.queue.next() == first);
+        REQUIRE(t.index(t.queue.next()) == 4);
+        REQUIRE(t.queue.next() == running);
+    }
+
+    SECTION("removing a thread keeps the order of the other ones") {
+        t.threads[4].priority = 1;
+        t.setReady(1, true);
+        t.setReady(2, true);
+        t.setReady(4, true);
+        FakeThread *first = t.queue.next();
+        FakeThread *second = t.queue.next();
+        // the thread selected last stops, the following one is unchanged
+        t.setReady(t.index(second), false);
+        FakeThread *third = t.queue.next();
+        REQUIRE(third != first);
+        REQUIRE(third != second);
+        REQUIRE(t.queue.next() == first);
+        t.setReady(t.index(first), false);
+        REQUIRE(t.queue.next() == third);
+        t.setReady(t.index(third), false);
+        REQUIRE(t.queue.empty());
+        REQUIRE(t.queue.getBitmap() == 0);
+    }
+
+    SECTION("priority change moves a ready thread") {
+        t.setReady(0, true);
+        t.setReady(1, true);
+        t.setPriority(0, 3);
+        REQUIRE(t.queue.getBitmap() == 0xA);
+        REQUIRE(t.index(t.queue.next()) == 0);
+        t.setPriority(0, 0);
+        REQUIRE(t.index(t.queue.next()) == 1);
+        // a thread that is not ready is not added
+        t.setPriority(3, 2);
+        REQUIRE(t.queue.getBitmap() == 0x3);
+    }
+}
+
+TEST_CASE("Ready queue against the thread flags", "[scheduler]") {
+    std::mt19937 random(41);
+    for (int trial = 0; trial < 20; trial++) {
+        std::vector<int> priorities(10 + random() % 21);
+        for (auto &p : priorities) p = random() % LEVELS;
+        Threads t(priorities);
+
+        for (int step = 0; step < 2000; step++) {
+            size_t i = random() % t.threads.size();
+            if (random() % 8 == 0) t.setPriority(i, random() % LEVELS);
+            else t.setReady(i, random() % 4 == 0);
+
+            // same ready set as the flags, and the selected threads are ready
+            // with the highest priority among the ready ones
+            int highest = -1;
+            std::set<int> ready;
+            for (size_t j = 0; j < t.threads.size(); j++) {
+                const FakeThread &thread = t.threads[j];
+                REQUIRE(Queue::contains(&t.threads[j]) == thread.ready);
+                if (!thread.ready) continue;
+                highest = std::max(highest, thread.priority);
+            }
+            for (size_t j = 0; j < t.threads.size(); j++)
+                if (t.threads[j].ready && t.threads[j].priority == highest) ready.insert(static_cast<int>(j));
+            REQUIRE(t.queue.highestPriority() == highest);
+
+            // with no status changes, every ready thread of that priority
+            // runs once before any of them runs again
+            if (highest < 0) REQUIRE(t.queue.next() == nullptr);
+            std::set<int> selected;
+            for (size_t k = 0; k < ready.size(); k++) {
+                FakeThread *next = t.queue.next();
+                REQUIRE(next->priority == highest);
+                REQUIRE(next->ready);
+                REQUIRE(selected.insert(t.index(next)).second);
+            }
+            REQUIRE(selected.size() == ready.size());
+        }
+    }
+}
+
+TEST_CASE("Context switch benchmark", "[.benchmark]") {
+    // the audio thread at the highest priority, woken every block, two
+    // always ready threads at the lowest priority, and the other threads
+    // sleeping at the priorities in between
+    for (size_t count : {10, 20, 30}) {
+        std::vector<int> priorities(count);
+        for (size_t i = 0; i < count; i++) priorities[i] = 1 + i % (LEVELS - 2);
+        priorities[0] = LEVELS - 1;
+        priorities[1] = priorities[2] = 0;
+
+        Threads t(priorities);
+        t.setReady(1, true);
+        t.setReady(2, true);
+        LinearScheduler linear(t.threads);
+
+        // wake the audio thread and switch to it, then it waits again
+        // and the scheduler switches to a low priority thread
+        volatile FakeThread *sink;
+        double scan = Benchmark::measure([&]() {
+            t.threads[0].ready = true;
+            sink = linear.next();
+            t.threads[0].ready = false;
+            sink = linear.next();
+        }, 100000) / 2;
+        double bitmap = Benchmark::measure([&]() {
+            t.setReady(0, true);
+            sink = t.queue.next();
+            t.setReady(0, false);
+            sink = t.queue.next();
+        }, 100000) / 2;
+        (void) sink;
+
+        std::string threads = std::to_string(count) + " threads, 2 always ready";
+        Benchmark::report("linear scan context switch, " + threads, scan);
+        Benchmark::report("ready queue context switch, " + threads, bitmap);
+    }
+}
@@ -0,0 +1,215 @@
+#include "catch.hpp"
+#include "benchmark.h"
+#include "../include/audio/adpcm.h"
+#include "../include/audio/sample_voice.h"
+#include "../miosix/_examples/sad_trombone/adpcm.h"
+#include "../miosix/_examples/sad_trombone/sad_trombone.h"
+#include <cmath>
+#include <vector>
+
+static const float SAMPLE_RATE = 48000.0f;
+
+/**
+ * Sinusoid at 16 bit, with a given period in samples.
+ */
+static std::vector<int16_t> sine(size_t length, double period, double amplitude = 20000) {
+    std::vector<int16_t> result(length);
+    for (size_t i = 0; i < length; i++) {
+        result[i] = static_cast<int16_t>(std::round(amplitude * std::sin(2.0 * M_PI * i / period)));
+    }
+    return result;
+}
+
+/**
+ * Encodes 16 bit samples in IMA-ADPCM.
+ */
+static std::vector<uint8_t> encode(const std::vector<int16_t> &samples) {
+    ImaAdpcm::State encoder;
+    std::vector<uint8_t> result((samples.size() + 1) / 2, 0);
+    for (size_t i = 0; i < samples.size(); i++) {
+        uint8_t code = encoder.encode(samples[i]);
+        result[i / 2] |= (i & 1) ? (code << 4) : code;
+    }
+    return result;
+}
+
+/**
+ * Renders a voice until it stops, in blocks of 128 samples.
+ */
+static std::vector<float> render(SampleVoice &voice) {
+    std::vector<float> result;
+    float block[128];
+    while (voice.isActive()) {
+        std::fill(block, block + 128, 0.0f);
+        size_t rendered = voice.process(block, 128);
+        result.insert(result.end(), block, block + rendered);
+    }
+    return result;
+}
+
+TEST_CASE("ImaAdpcm is bit exact with the reference codec", "[sample]") {
+    // the reference keeps its state in static variables, so it is run only once
+    ImaAdpcm::State decoder;
+    for (unsigned int i = 0; i < sad_trombone_bin_len; i++) {
+        uint8_t byte = sad_trombone_bin[i];
+        int16_t low = ADPCM_Decode(byte & 0xf);
+        int16_t high = ADPCM_Decode(byte >> 4);
+        REQUIRE(decoder.decode(byte & 0xf) == low);
+        REQUIRE(decoder.decode(byte >> 4) == high);
+    }
+
+    ImaAdpcm::State encoder;
+    std::vector<int16_t> signal = sine(4000, 37.3);
+    for (int16_t s : signal) {
+        REQUIRE(encoder.encode(s) == ADPCM_Encode(s));
+    }
+}
+
+TEST_CASE("ImaAdpcm round trip", "[sample]") {
+    std::vector<int16_t> signal = sine(8000, 100.0);
+    std::vector<uint8_t> encoded = encode(signal);
+
+    ImaAdpcm::State decoder;
+    double signalPower = 0, errorPower = 0;
+    for (size_t i = 0; i < signal.size(); i++) {
+        uint8_t byte = encoded[i / 2];
+        int16_t decoded = decoder.decode((i & 1) ? (byte >> 4) : byte);
+        // skipping the adaptation of the step size
+        if (i >= 100) {
+            signalPower += static_cast<double>(signal[i]) * signal[i];
+            errorPower += static_cast<double>(signal[i] - decoded) * (signal[i] - decoded);
+        }
+    }
+    REQUIRE(10.0 * std::log10(signalPower / errorPower) > 25);
+}
+
+TEST_CASE("SampleVoice playback", "[sample]") {
+    std::vector<int16_t> data = sine(1001, 50.0);
+    Sample pcm = {"sine", SampleFormat::PCM16, data.data(), static_cast<uint32_t>(data.size()), SAMPLE_RATE};
+    SampleVoice voice(SAMPLE_RATE);
+
+    SECTION("Original pitch reproduces the sample") {
+        for (SampleInterpolation interpolation : {SampleInterpolation::LINEAR, SampleInterpolation::CUBIC}) {
+            voice.setInterpolation(interpolation);
+            voice.trigger(pcm);
+            std::vector<float> output = render(voice);
+            REQUIRE(output.size() == data.size());
+            for (size_t i = 0; i < data.size(); i++) {
+                REQUIRE(output[i] == Approx(data[i] / 32768.0f).margin(1e-6));
+            }
+        }
+    }
+
+    SECTION("Pitch changes the duration") {
+        voice.trigger(pcm, 2.0f);
+        REQUIRE(render(voice).size() == (data.size() + 1) / 2);
+        voice.trigger(pcm, 0.5f);
+        REQUIRE(render(voice).size() == 2 * data.size());
+    }
+
+    SECTION("Pitch is limited to the minimum, so the voice always ends") {
+        for (float pitch : {0.0f, -1.0f, NAN, 1.0f / 64}) {
+            voice.trigger(pcm, pitch);
+            REQUIRE(render(voice).size() == 16 * data.size());
+        }
+    }
+
+    SECTION("Sample rate of the recording is compensated") {
+        Sample slow = pcm;
+        slow.sampleRate = SAMPLE_RATE / 4;
+        voice.trigger(slow);
+        REQUIRE(render(voice).size() == 4 * data.size());
+    }
+
+    SECTION("Output is mixed and gain is applied") {
+        float block[16];
+        std::fill(block, block + 16, 1.0f);
+        voice.trigger(pcm, 1.0f, 0.5f);
+        voice.process(block, 16);
+        for (size_t i = 0; i < 16; i++) {
+            REQUIRE(block[i] == Approx(1.0f + 0.5f * data[i] / 32768.0f).margin(1e-6));
+        }
+    }
+
+    SECTION("Cubic interpolation is more accurate than linear") {
+        double error[2] = {0, 0};
+        SampleInterpolation interpolations[2] = {SampleInterpolation::LINEAR, SampleInterpolation::CUBIC};
+        for (int k = 0; k < 2; k++) {
+            voice.setInterpolation(interpolations[k]);
+            voice.trigger(pcm, 0.3f);
+            std::vector<float> output = render(voice);
+            for (size_t i = 10; i + 10 < output.size(); i++) {
+                double expected = 20000.0 / 32768.0 * std::sin(2.0 * M_PI * 0.3 * i / 50.0);
+                error[k] += (output[i] - expected) * (output[i] - expected);
+            }
+        }
+        REQUIRE(error[1] < error[0] / 10);
+    }
+
+    SECTION("ADPCM samples are decoded while playing") {
+        std::vector<uint8_t> encoded = encode(data);
+        Sample adpcm = {"sine", SampleFormat::IMA_ADPCM, encoded.data(), static_cast<uint32_t>(data.size()),
+                        SAMPLE_RATE};
+        voice.trigger(adpcm);
+        std::vector<float> output = render(voice);
+        REQUIRE(output.size() == data.size());
+
+        ImaAdpcm::State decoder;
+        for (size_t i = 0; i < data.size(); i++) {
+            uint8_t byte = encoded[i / 2];
+            REQUIRE(output[i] == Approx(decoder.decode((i & 1) ? (byte >> 4) : byte) / 32768.0f).margin(1e-6));
+        }
+    }
+
+    SECTION("Retrigger restarts the sample") {
+        float block[64] = {0};
+        voice.trigger(pcm);
+        voice.process(block, 64);
+        voice.trigger(pcm);
+        std::vector<float> output = render(voice);
+        REQUIRE(output.size() == data.size());
+        voice.stop();
+        REQUIRE_FALSE(voice.isActive());
+        REQUIRE(voice.process(block, 64) == 0);
+    }
+}
+
+TEST_CASE("SampleVoice benchmark", "[.benchmark]") {
+    std::vector<int16_t> data = sine(1 << 20, 123.4);
+    std::vector<uint8_t> encoded = encode(data);
+    Sample pcm = {"pcm", SampleFormat::PCM16, data.data(), static_cast<uint32_t>(data.size()), SAMPLE_RATE};
+    Sample adpcm = {"adpcm", SampleFormat::IMA_ADPCM, encoded.data(), static_cast<uint32_t>(data.size()),
+                    SAMPLE_RATE};
+    SampleVoice voice(SAMPLE_RATE);
+    float block[128];
+
+    struct Case {
+        const char *name;
+        const Sample *sample;
+        SampleInterpolation interpolation;
+        float pitch;
+    };
+    const Case cases[] = {
+            {"pcm16 linear, per sample", &pcm, SampleInterpolation::LINEAR, 1.0f},
+            {"pcm16 cubic, per sample", &pcm, SampleInterpolation::CUBIC, 1.0f},
+            {"adpcm linear, per sample", &adpcm, SampleInterpolation::LINEAR, 1.0f},
+            {"adpcm cubic, per sample", &adpcm, SampleInterpolation::CUBIC, 1.0f},
+            {"adpcm cubic at pitch 1.5, per sample", &adpcm, SampleInterpolation::CUBIC, 1.5f},
+    };
+    for (const Case &c : cases) {
+        voice.setInterpolation(c.interpolation);
+        voice.trigger(*c.sample, c.pitch);
+        Benchmark::report(c.name, Benchmark::measure([&] {
+            if (!voice.isActive()) voice.trigger(*c.sample, c.pitch);
+            voice.process(block, 128);
+        }, 5000) / 128);
+    }
+
+    ImaAdpcm::State decoder;
+    int32_t sum = 0;
+    size_t i = 0;
+    Benchmark::report("adpcm decode only, per sample", Benchmark::measure([&] {
+        for (size_t j = 0; j < 128; j++, i++) sum += decoder.decode(encoded[(i / 2) % encoded.size()] >> 4);
+    }, 5000) / 128);
+    REQUIRE(sum != 1);
+}
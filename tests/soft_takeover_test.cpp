@@ -0,0 +1,89 @@
+#include "catch.hpp"
+#include "../include/drivers/common/soft_takeover.h"
+#include "../include/drivers/common/change_detector.h"
+#include "../include/drivers/common/parameter_menu.h"
+#include <string>
+#include <vector>
+
+namespace {
+    /**
+     * Feeds a slider sweep through the change detection and the takeover,
+     * as done by the control scan, and returns the applied positions.
+     */
+    std::vector<float> sweep(SoftTakeover &takeover, ChangeDetector<float> &change,
+                             const std::vector<float> &positions) {
+        std::vector<float> applied;
+        for (float position : positions) {
+            if (change.update(position) && takeover.update(position) != SoftTakeover::HELD) {
+                applied.push_back(position);
+            }
+        }
+        return applied;
+    }
+}
+
+TEST_CASE("SoftTakeover", "[takeover]") {
+    SoftTakeover takeover(0.02f);
+
+    SECTION("released controls are always applied") {
+        REQUIRE_FALSE(takeover.isHeld());
+        REQUIRE(takeover.update(0.9f) == SoftTakeover::APPLY);
+    }
+
+    SECTION("held until within the window") {
+        takeover.hold(0.5f);
+        REQUIRE(takeover.isHeld());
+        REQUIRE(takeover.update(0.1f) == SoftTakeover::HELD);
+        REQUIRE(takeover.update(0.4f) == SoftTakeover::HELD);
+        REQUIRE(takeover.update(0.49f) == SoftTakeover::PICKUP);
+        REQUIRE_FALSE(takeover.isHeld());
+        REQUIRE(takeover.update(0.1f) == SoftTakeover::APPLY);
+    }
+
+    SECTION("crossing the value picks it up") {
+        takeover.hold(0.5f);
+        REQUIRE(takeover.update(0.9f) == SoftTakeover::HELD);
+        REQUIRE(takeover.update(0.7f) == SoftTakeover::HELD);
+        // a fast movement jumps over the window
+        REQUIRE(takeover.update(0.3f) == SoftTakeover::PICKUP);
+    }
+
+    SECTION("the first position is not a crossing") {
+        takeover.hold(0.5f);
+        REQUIRE(takeover.update(0.2f) == SoftTakeover::HELD);
+        takeover.hold(0.1f);
+        REQUIRE(takeover.update(0.3f) == SoftTakeover::HELD);
+        REQUIRE(takeover.update(0.3f) == SoftTakeover::HELD);
+    }
+
+    SECTION("release") {
+        takeover.hold(0.5f);
+        takeover.release();
+        REQUIRE(takeover.update(0.0f) == SoftTakeover::APPLY);
+    }
+}
+
+TEST_CASE("Slider scan with hysteresis and takeover", "[takeover]") {
+    SoftTakeover takeover(0.02f);
+    ChangeDetector<float> change(0.005f);
+
+    SECTION("a still noisy slider generates no traffic") {
+        std::vector<float> noise = {0.300f, 0.302f, 0.298f, 0.304f, 0.301f, 0.297f};
+        REQUIRE(sweep(takeover, change, noise) == std::vector<float>({0.300f}));
+    }
+
+    SECTION("a recalled value is kept until the slider reaches it") {
+        sweep(takeover, change, {0.8f});
+        takeover.hold(0.4f);
+        std::vector<float> applied = sweep(takeover, change, {0.8f, 0.7f, 0.6f, 0.5f, 0.41f, 0.35f});
+        REQUIRE(applied == std::vector<float>({0.41f, 0.35f}));
+    }
+}
+
+TEST_CASE("Pickup indication", "[takeover][menu]") {
+    LcdFramebuffer<2, 16> frame;
+    ParameterMenu<1, 4>::renderPickup(frame, "S", 0.85f, 0.2f, 0.01f);
+    std::string row;
+    for (size_t col = 0; col < 16; col++) row += frame.at(0, col);
+    REQUIRE(row == "S      0.85\x7E" "0.20");
+}
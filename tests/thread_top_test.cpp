@@ -0,0 +1,89 @@
+#include "catch.hpp"
+#include "../include/drivers/common/thread_top.h"
+#include <string>
+#include <vector>
+
+namespace {
+    /**
+     * Snapshot entry with the fields of miosix::ThreadUsage.
+     */
+    struct Usage {
+        void *thread;
+        unsigned long long cpuTime;
+        unsigned int stackSize;
+        unsigned int stackUsed;
+        bool watermarkOk;
+    };
+
+    typedef ThreadTop<Usage, 4> Top;
+}
+
+TEST_CASE("ThreadTop", "[thread top]") {
+    int audio, ui, idle, midi;
+    Top top;
+    REQUIRE(top.setName(&audio, "audio"));
+    REQUIRE(top.setName(&ui, "ui"));
+
+    // 168M cycles per second, the audio thread at 40% and the UI at 10%
+    std::vector<Usage> usage = {{&audio, 67200000, 4096, 1200, true},
+                                {&idle, 84000000, 256, 100, true},
+                                {&ui, 16800000, 2048, 2048, true}};
+
+    SECTION("the first snapshot counts from the creation of the threads") {
+        REQUIRE(top.update(usage.data(), usage.size()) == 3);
+        REQUIRE(top.getRow(0).thread == &idle);
+        REQUIRE(top.getRow(0).name == nullptr);
+        REQUIRE(top.getRow(1).thread == &audio);
+        REQUIRE(top.getRow(1).name == std::string("audio"));
+        REQUIRE(top.getRow(1).load == Approx(0.4));
+        REQUIRE(top.getRow(2).load == Approx(0.1));
+        REQUIRE(top.getRow(1).stackUsed == 1200);
+        REQUIRE_FALSE(top.getRow(1).overflow);
+        // the whole stack used is reported as an overflow
+        REQUIRE(top.getRow(2).overflow);
+    }
+
+    SECTION("the following snapshots count from the previous one") {
+        top.update(usage.data(), usage.size());
+        // one more second with the audio thread at 80%, a new thread and
+        // an overwritten watermark
+        usage[0].cpuTime += 134400000;
+        usage[1].cpuTime += 16800000;
+        usage[2].cpuTime += 8400000;
+        usage[2].stackUsed = 1000;
+        usage[2].watermarkOk = false;
+        usage.push_back({&midi, 8400000, 1024, 300, true});
+        REQUIRE(top.update(usage.data(), usage.size()) == 4);
+        REQUIRE(top.getRow(0).thread == &audio);
+        REQUIRE(top.getRow(0).load == Approx(0.8));
+        REQUIRE(top.getRow(1).thread == &idle);
+        REQUIRE(top.getRow(1).load == Approx(0.1));
+        REQUIRE(top.getRow(2).load == Approx(0.05));
+        REQUIRE(top.getRow(3).load == Approx(0.05));
+        for (size_t i = 0; i < top.getRowCount(); i++)
+            REQUIRE(top.getRow(i).overflow == (top.getRow(i).thread == &ui));
+    }
+
+    SECTION("a terminated thread leaves the table") {
+        top.update(usage.data(), usage.size());
+        usage.erase(usage.begin() + 2);
+        usage[0].cpuTime += 100;
+        usage[1].cpuTime += 300;
+        REQUIRE(top.update(usage.data(), usage.size()) == 2);
+        REQUIRE(top.getRow(0).load == Approx(0.75));
+        REQUIRE(top.getRow(1).load == Approx(0.25));
+    }
+
+    SECTION("the snapshot is truncated to the size of the table") {
+        usage.push_back({&midi, 0, 1024, 300, true});
+        int extra;
+        usage.push_back({&extra, 0, 1024, 300, true});
+        REQUIRE(top.update(usage.data(), usage.size()) == 4);
+    }
+
+    SECTION("no time elapsed") {
+        top.update(usage.data(), usage.size());
+        top.update(usage.data(), usage.size());
+        for (size_t i = 0; i < top.getRowCount(); i++) REQUIRE(top.getRow(i).load == 0.0f);
+    }
+}
@@ -0,0 +1,280 @@
+#include "catch.hpp"
+#include "kernel/timer_wheel.h"
+#include "kernel/tickless_timer.h"
+#include <deque>
+#include <random>
+#include <vector>
+
+using miosix::TicklessTimer;
+using miosix::TimerWheel;
+
+namespace {
+    /**
+     * Simulated TicklessTimerHardware: a free running 32 bit counter at one
+     * count per microsecond of the simulated time, with a compare interrupt.
+     */
+    template<unsigned int CPT>
+    struct SimulatedTimer {
+        static const unsigned int COUNTS_PER_TICK = CPT;
+
+        static unsigned int IRQread() { return static_cast<unsigned int>(time + offset); }
+
+        static void IRQsetCompare(unsigned int count) { compare = count; }
+
+        static void IRQpend() { pending = true; }
+
+        /**
+         * @return time at which the compare interrupt fires. A compare value
+         * equal to the counter has already matched, and matches again after
+         * the counter wraps
+         */
+        static long long nextInterrupt() {
+            if (pending) return time;
+            unsigned int ahead = compare - IRQread();
+            return time + (ahead == 0 ? 1ll << 32 : ahead);
+        }
+
+        static void reset(unsigned int counterAtStart) {
+            time = 0;
+            offset = counterAtStart;
+            compare = 0;
+            pending = false;
+        }
+
+        static long long time;
+        static unsigned int offset;
+        static unsigned int compare;
+        static bool pending;
+    };
+
+    template<unsigned int CPT> long long SimulatedTimer<CPT>::time;
+    template<unsigned int CPT> unsigned int SimulatedTimer<CPT>::offset;
+    template<unsigned int CPT> unsigned int SimulatedTimer<CPT>::compare;
+    template<unsigned int CPT> bool SimulatedTimer<CPT>::pending;
+
+    struct Sleep {
+        int id;
+        long long wakeup_time;
+        Sleep *next;
+        long long runFor;
+    };
+
+    /**
+     * Threads sleeping in the timer wheel, one CPU running the ready ones in
+     * order, and the tick interrupt as IRQtickInterrupt() with the tickless
+     * idle mode. An audio thread, if any, is woken by a DMA interrupt every
+     * block and runs before the other threads.
+     */
+    template<unsigned int CPT>
+    class Simulation {
+    public:
+        typedef SimulatedTimer<CPT> HW;
+
+        Simulation(unsigned int seed, unsigned int counterAtStart, size_t threads, long long maxSleep,
+                   long long blockTime)
+                : interrupts(0), idleInterrupts(0), wakeups(0), sleeps(threads), random(seed),
+                  maxSleep(maxSleep), blockTime(blockTime), wheel(), timer(), audioReady(false),
+                  audioLeft(0), nextBlock(blockTime > 0 ? blockTime : -1), lastWakeup(0) {
+            HW::reset(counterAtStart);
+            timer.IRQstart();
+            for (size_t i = 0; i < sleeps.size(); i++) {
+                sleeps[i] = {static_cast<int>(i), 0, nullptr, 0};
+                sleep(&sleeps[i]);
+            }
+        }
+
+        void run(long long duration) {
+            schedule(false);
+            while (HW::time < duration) {
+                long long interrupt = HW::nextInterrupt();
+                long long next = interrupt;
+                if (nextBlock >= 0 && nextBlock < next) next = nextBlock;
+                if (running() && HW::time + runningFor() < next) next = HW::time + runningFor();
+                consume(next - HW::time);
+                HW::time = next;
+
+                if (interrupt == HW::time) tickInterrupt();
+                else if (nextBlock == HW::time) dmaInterrupt();
+                else threadDone();
+            }
+        }
+
+        size_t interrupts;
+        size_t idleInterrupts;
+        size_t wakeups;
+
+    private:
+        bool running() const { return audioReady || !ready.empty(); }
+
+        long long runningFor() const { return audioReady ? audioLeft : ready.front()->runFor; }
+
+        void consume(long long time) {
+            if (audioReady) audioLeft -= time;
+            else if (!ready.empty()) ready.front()->runFor -= time;
+        }
+
+        /**
+         * The running thread sleeps for some ticks from the current tick,
+         * as Thread::sleep()
+         */
+        void sleep(Sleep *s) {
+            s->wakeup_time = wheel.getTime() + 1 + random() % maxSleep;
+            wheel.add(s);
+        }
+
+        /**
+         * As IRQticklessProgram(), called after the scheduler
+         */
+        void schedule(bool force) {
+            bool idle = !running();
+            if (force || idle != timer.isIdle()) timer.IRQprogram(wheel, idle);
+        }
+
+        void tickInterrupt() {
+            HW::pending = false;
+            interrupts++;
+            if (timer.isIdle()) idleInterrupts++;
+            timer.IRQupdate(wheel, [&](Sleep *s) {
+                // woken exactly at the tick of its wakeup time, in order
+                REQUIRE(s->wakeup_time == wheel.getTime());
+                REQUIRE(HW::time == s->wakeup_time * CPT);
+                REQUIRE(HW::time >= lastWakeup);
+                lastWakeup = HW::time;
+                s->runFor = 1 + random() % (CPT / 2);
+                ready.push_back(s);
+                wakeups++;
+            });
+            // the tick is never behind the counter
+            REQUIRE(wheel.getTime() == HW::time / CPT);
+            // preemption, round robin among the ready threads
+            if (!audioReady && ready.size() > 1) {
+                ready.push_back(ready.front());
+                ready.pop_front();
+            }
+            schedule(true);
+        }
+
+        void dmaInterrupt() {
+            audioReady = true;
+            audioLeft = blockTime / 4;
+            nextBlock += blockTime;
+            schedule(false);
+        }
+
+        void threadDone() {
+            if (audioReady) audioReady = false;
+            else {
+                Sleep *s = ready.front();
+                ready.pop_front();
+                sleep(s);
+            }
+            schedule(false);
+        }
+
+        std::vector<Sleep> sleeps;
+        std::mt19937 random;
+        long long maxSleep;
+        long long blockTime;
+        TimerWheel<Sleep, 4> wheel;
+        TicklessTimer<HW> timer;
+        std::deque<Sleep *> ready;
+        bool audioReady;
+        long long audioLeft;
+        long long nextBlock;
+        long long lastWakeup;
+    };
+}
+
+TEST_CASE("Tickless timer wakeups", "[timer wheel]") {
+    // 10 seconds with the counter wrapping after 3 seconds
+    const unsigned int beforeWrap = 0xffffffffu - 3000000u;
+
+    SECTION("UI threads polling, mostly idle") {
+        Simulation<1000> sim(1, beforeWrap, 5, 100, 0);
+        sim.run(10000000);
+        REQUIRE(sim.wakeups > 400);
+        // far fewer interrupts than the 10000 ticks
+        REQUIRE(sim.interrupts < 10000 / 3);
+        REQUIRE(sim.idleInterrupts > 0);
+    }
+
+    SECTION("UI threads and the audio thread woken by the DMA") {
+        Simulation<1000> sim(2, beforeWrap, 8, 50, 2667);
+        sim.run(10000000);
+        REQUIRE(sim.wakeups > 1000);
+        REQUIRE(sim.interrupts < 10000);
+    }
+
+    SECTION("long sleeps crossing the levels of the wheel") {
+        Simulation<1000> sim(3, beforeWrap, 3, 200000, 0);
+        sim.run(600000000);
+        REQUIRE(sim.wakeups > 10);
+    }
+
+    SECTION("idle longer than the range of the compare interrupt") {
+        // 21474 ticks at most between two interrupts
+        Simulation<100000> sim(4, 0, 2, 50000, 0);
+        sim.run(100000000000ll);
+        REQUIRE(sim.wakeups > 10);
+    }
+}
+
+TEST_CASE("Timer wheel advance", "[timer wheel]") {
+    std::mt19937 random(43);
+    TimerWheel<Sleep, 3> wheel = TimerWheel<Sleep, 3>();
+    std::vector<Sleep> sleeps(20);
+    for (size_t i = 0; i < sleeps.size(); i++) {
+        sleeps[i] = {static_cast<int>(i), static_cast<long long>(1 + random() % 40000), nullptr, 0};
+        wheel.add(&sleeps[i]);
+    }
+    size_t woken = 0;
+    while (wheel.getTime() < 500000) {
+        long long before = wheel.getTime();
+        long long time = before + random() % 3000;
+        REQUIRE(wheel.nextEvent() > before);
+        wheel.advance(time, [&](Sleep *s) {
+            REQUIRE(s->wakeup_time == wheel.getTime());
+            REQUIRE(s->wakeup_time > before);
+            REQUIRE(s->wakeup_time <= time);
+            s->wakeup_time = time + 1 + random() % 40000;
+            wheel.add(s);
+            woken++;
+        });
+        REQUIRE(wheel.getTime() == time);
+        for (auto &s : sleeps) REQUIRE(s.wakeup_time > time);
+    }
+    REQUIRE(woken > 100);
+}
+
+TEST_CASE("Tickless timer sub-tick sleep", "[timer wheel]") {
+    // Sleeps keep the tick resolution: the shortest sleep, which a request
+    // shorter than a tick rounds to, ends at the next tick of the counter
+    typedef SimulatedTimer<1000> HW;
+    HW::reset(0xffffffffu - 50000u);
+    TimerWheel<Sleep, 4> wheel = TimerWheel<Sleep, 4>();
+    TicklessTimer<HW> timer = TicklessTimer<HW>();
+    timer.IRQstart();
+
+    for (long long offset = 0; offset < 1000; offset += 37) {
+        // the thread sleeps at some point within a tick, as Thread::sleep()
+        HW::time += 1000 + offset - HW::time % 1000;
+        timer.IRQupdate(wheel, [](Sleep *) { FAIL("no thread is sleeping"); });
+        Sleep s = {0, wheel.getTime() + 1, nullptr, 0};
+        wheel.add(&s);
+        timer.IRQprogram(wheel, true);
+
+        // the idle CPU is woken at the next tick, not at the requested time
+        long long interrupt = HW::nextInterrupt();
+        REQUIRE(interrupt == (wheel.getTime() + 1) * 1000);
+        REQUIRE(interrupt - HW::time == 1000 - offset);
+        HW::time = interrupt;
+        HW::pending = false;
+        bool woken = false;
+        timer.IRQupdate(wheel, [&](Sleep *w) {
+            REQUIRE(w == &s);
+            woken = true;
+        });
+        REQUIRE(woken);
+        REQUIRE(wheel.empty());
+    }
+}
@@ -0,0 +1,243 @@
+#include "catch.hpp"
+#include "benchmark.h"
+#include "kernel/timer_wheel.h"
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+using miosix::TimerWheel;
+
+namespace {
+    /**
+     * Sleeping thread of the tests, with the fields of SleepData.
+     */
+    struct Sleep {
+        int id;
+        long long wakeup_time;
+        Sleep *next;
+    };
+
+    /**
+     * Runs a wheel until a time, checking that every element expires
+     * exactly at its wakeup time.
+     *
+     * @return number of expired elements
+     */
+    template<typename WHEEL>
+    size_t runUntil(WHEEL &wheel, long long time) {
+        size_t count = 0;
+        while (wheel.getTime() < time) {
+            wheel.tick([&](Sleep *s) {
+                REQUIRE(s->wakeup_time == wheel.getTime());
+                REQUIRE(s->next == nullptr);
+                count++;
+            });
+        }
+        return count;
+    }
+
+    /**
+     * The previous sleeping list of the kernel, sorted by wakeup time.
+     */
+    class SortedList {
+    public:
+        SortedList() : head(nullptr), now(0) {}
+
+        void add(Sleep *x) {
+            if (head == nullptr || x->wakeup_time <= head->wakeup_time) {
+                x->next = head;
+                head = x;
+            } else {
+                Sleep *cur = head;
+                for (;;) {
+                    if (cur->next == nullptr || x->wakeup_time <= cur->next->wakeup_time) {
+                        x->next = cur->next;
+                        cur->next = x;
+                        break;
+                    }
+                    cur = cur->next;
+                }
+            }
+        };
+
+        template<typename F>
+        bool tick(F expired) {
+            now++;
+            bool result = false;
+            while (head != nullptr && head->wakeup_time == now) {
+                Sleep *x = head;
+                head = head->next;
+                expired(x);
+                result = true;
+            }
+            return result;
+        };
+
+        long long getTime() const { return now; };
+
+    private:
+        Sleep *head;
+        long long now;
+    };
+}
+
+TEST_CASE("Timer wheel expiry", "[timer wheel]") {
+    TimerWheel<Sleep, 2> wheel = TimerWheel<Sleep, 2>();
+    REQUIRE(wheel.empty());
+    REQUIRE(wheel.getTime() == 0);
+
+    SECTION("elements in the first level") {
+        Sleep a = {0, 3, nullptr}, b = {1, 3, nullptr}, c = {2, 31, nullptr};
+        wheel.add(&a);
+        wheel.add(&b);
+        wheel.add(&c);
+        REQUIRE(wheel.getBitmap(0) == ((1u << 3) | (1u << 31)));
+        REQUIRE(runUntil(wheel, 2) == 0);
+        std::vector<int> woken;
+        REQUIRE(wheel.tick([&](Sleep *s) { woken.push_back(s->id); }));
+        REQUIRE(woken.size() == 2);
+        REQUIRE(runUntil(wheel, 31) == 1);
+        REQUIRE(wheel.empty());
+    }
+
+    SECTION("elements moved from the upper level") {
+        Sleep a = {0, 32, nullptr}, b = {1, 100, nullptr}, c = {2, 1023, nullptr};
+        wheel.add(&a);
+        wheel.add(&b);
+        wheel.add(&c);
+        REQUIRE(wheel.getBitmap(0) == 0);
+        REQUIRE(wheel.getBitmap(1) == ((1u << 1) | (1u << 3) | (1u << 31)));
+        REQUIRE(runUntil(wheel, 1023) == 3);
+        REQUIRE(wheel.empty());
+    }
+
+    SECTION("elements beyond the wheel") {
+        Sleep a = {0, 1024, nullptr}, b = {1, 5000, nullptr};
+        wheel.add(&a);
+        wheel.add(&b);
+        REQUIRE(wheel.getBitmap(1) == 0);
+        REQUIRE_FALSE(wheel.empty());
+        REQUIRE(runUntil(wheel, 1024) == 1);
+        REQUIRE(runUntil(wheel, 5000) == 1);
+        REQUIRE(wheel.empty());
+    }
+
+    SECTION("elements not in the future expire at the next tick") {
+        runUntil(wheel, 10);
+        Sleep a = {0, 10, nullptr}, b = {1, 2, nullptr};
+        wheel.add(&a);
+        wheel.add(&b);
+        size_t count = 0;
+        REQUIRE(wheel.tick([&](Sleep *) { count++; }));
+        REQUIRE(count == 2);
+    }
+
+    SECTION("adding to the current slot of an upper level, in the next round") {
+        runUntil(wheel, 1000);
+        // 1000 and 2023 are both in slot 31 of level 1
+        Sleep a = {0, 2023, nullptr}, b = {1, 1030, nullptr};
+        wheel.add(&a);
+        wheel.add(&b);
+        REQUIRE(runUntil(wheel, 1030) == 1);
+        REQUIRE(runUntil(wheel, 2023) == 1);
+        REQUIRE(wheel.empty());
+    }
+}
+
+/**
+ * Threads sleeping repeatedly for random times, as the UI threads, with
+ * some long sleeps crossing all the levels of the wheel.
+ */
+template<int LEVELS>
+static void randomSleeps(unsigned int seed, size_t threads, long long duration) {
+    TimerWheel<Sleep, LEVELS> wheel = TimerWheel<Sleep, LEVELS>();
+    std::vector<Sleep> sleeps(threads);
+    std::mt19937 random(seed);
+    auto sleepFor = [&]() -> long long {
+        switch (random() % 8) {
+            case 0: return 1 + random() % 100000;
+            case 1: return 1 + random() % 2000;
+            default: return 1 + random() % 50;
+        }
+    };
+
+    std::multimap<long long, int> expected;
+    for (size_t i = 0; i < threads; i++) {
+        sleeps[i].id = static_cast<int>(i);
+        sleeps[i].wakeup_time = sleepFor();
+        wheel.add(&sleeps[i]);
+        expected.insert({sleeps[i].wakeup_time, sleeps[i].id});
+    }
+
+    size_t woken = 0;
+    while (wheel.getTime() < duration) {
+        std::vector<Sleep *> expired;
+        wheel.tick([&](Sleep *s) { expired.push_back(s); });
+        long long now = wheel.getTime();
+
+        auto range = expected.equal_range(now);
+        REQUIRE(static_cast<size_t>(std::distance(range.first, range.second)) == expired.size());
+        expected.erase(range.first, range.second);
+        REQUIRE((expected.empty() || expected.begin()->first > now));
+
+        // the woken threads sleep again
+        for (Sleep *s : expired) {
+            REQUIRE(s->wakeup_time == now);
+            s->wakeup_time = now + sleepFor();
+            wheel.add(s);
+            expected.insert({s->wakeup_time, s->id});
+            woken++;
+        }
+    }
+    REQUIRE(woken > threads);
+}
+
+TEST_CASE("Timer wheel random sleeps", "[timer wheel]") {
+    SECTION("two levels and the far list") {
+        randomSleeps<2>(1, 20, 300000);
+    }
+    SECTION("kernel wheel") {
+        randomSleeps<4>(2, 30, 300000);
+    }
+    SECTION("long run across the far list") {
+        randomSleeps<3>(3, 10, 1500000);
+    }
+}
+
+TEST_CASE("Sleeping list benchmark", "[.benchmark]") {
+    // every tick the threads that wake sleep again for a few ticks, as the
+    // UI threads polling at short periods
+    for (size_t count : {10, 20, 30}) {
+        std::vector<Sleep> listSleeps(count), wheelSleeps(count);
+        SortedList list;
+        TimerWheel<Sleep, 4> wheel = TimerWheel<Sleep, 4>();
+        for (size_t i = 0; i < count; i++) {
+            listSleeps[i] = {static_cast<int>(i), static_cast<long long>(1 + i % 20), nullptr};
+            wheelSleeps[i] = listSleeps[i];
+            list.add(&listSleeps[i]);
+            wheel.add(&wheelSleeps[i]);
+        }
+
+        size_t listWakeups = 0, wheelWakeups = 0;
+        double listCost = Benchmark::measure([&]() {
+            list.tick([&](Sleep *s) {
+                s->wakeup_time = list.getTime() + 1 + s->id % 20;
+                list.add(s);
+                listWakeups++;
+            });
+        }, 100000);
+        double wheelCost = Benchmark::measure([&]() {
+            wheel.tick([&](Sleep *s) {
+                s->wakeup_time = wheel.getTime() + 1 + s->id % 20;
+                wheel.add(s);
+                wheelWakeups++;
+            });
+        }, 100000);
+
+        std::string threads = std::to_string(count) + " sleeping threads";
+        Benchmark::report("sorted list tick, " + threads, listCost);
+        Benchmark::report("timer wheel tick, " + threads, wheelCost);
+        REQUIRE(listWakeups == wheelWakeups);
+    }
+}
@@ -0,0 +1,284 @@
+#ifndef MIOSIX_DRUM_IRQ_TRACE_ANALYSIS_H
+#define MIOSIX_DRUM_IRQ_TRACE_ANALYSIS_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <istream>
+#include <map>
+#include <string>
+#include <vector>
+#include "../miosix/kernel/trace_ring.h"
+
+/**
+ * Analysis of the dumps of miosix::IRQTrace, used by tools/irqtrace.
+ *
+ * The latency of the traced interrupt is measured as in IrqLatencyProbe:
+ * its requests are periodic, like the end of the audio DMA transfers paced
+ * by the I2S clock, so every start of the handler is compared to the
+ * earliest one of the same dump, after removing the period estimated from
+ * the trace. Each late start is attributed to the critical section or to
+ * the other interrupt handler that ended last before it, if that ended
+ * after the interrupt was requested.
+ * The durations of all the critical sections, by the code that disabled
+ * the interrupts, and of all the traced interrupt handlers are also
+ * collected.
+ */
+class IrqTraceAnalysis {
+public:
+    /**
+     * Durations of the critical sections of a site, or of an interrupt, in cycles.
+     */
+    struct Durations {
+        size_t count;
+        uint64_t total;
+        uint64_t worst;
+    };
+
+    /**
+     * Cause of the delays of the traced interrupt: a critical section, by the
+     * code that disabled the interrupts, or another interrupt handler.
+     */
+    struct Offender {
+        unsigned type;  ///< TRACE_CS_ENTER, TRACE_IRQ_ENTER, or 0 if nothing was running
+        uint32_t site;  ///< Address of the code disabling the interrupts
+        int id;         ///< Interrupt number
+        size_t count;   ///< Delays caused
+        uint64_t worst; ///< Worst delay, in cycles
+    };
+
+    /**
+     * Constructor.
+     *
+     * @param irq interrupt whose latency is measured, as its IRQn_Type
+     */
+    explicit IrqTraceAnalysis(int irq) : irq(irq) {};
+
+    /**
+     * Reads the next dump of a serial log, skipping the other lines.
+     *
+     * @param in serial log
+     * @param events where the events of the dump are stored
+     * @param frequency where the frequency of the counter is stored, in Hz
+     * @return false if there are no more complete dumps
+     */
+    static bool readDump(std::istream &in, std::vector<miosix::TraceEvent> &events, unsigned &frequency) {
+        std::string line;
+        events.clear();
+        bool inside = false;
+        while (std::getline(in, line)) {
+            unsigned count;
+            if (std::sscanf(line.c_str(), "irqtrace begin %u %u", &frequency, &count) == 2) {
+                events.clear();
+                inside = true;
+                continue;
+            }
+            if (!inside) continue;
+            if (line.compare(0, 12, "irqtrace end") == 0) return true;
+            unsigned time, type, site;
+            int id;
+            if (std::sscanf(line.c_str(), "%x %u %d %x", &time, &type, &id, &site) != 4) continue;
+            miosix::TraceEvent event;
+            event.time = time;
+            event.site = site;
+            event.type = static_cast<unsigned short>(type);
+            event.id = static_cast<short>(id);
+            events.push_back(event);
+        }
+        return false;
+    };
+
+    /**
+     * Analyzes a dump.
+     *
+     * @param events events of the dump, oldest first
+     */
+    void add(const std::vector<miosix::TraceEvent> &events) {
+        if (events.empty()) return;
+
+        // counter unwrapped from the first event, the interrupts preempting
+        // the recording of an event may make the time go slightly back
+        std::vector<Record> records;
+        uint64_t time = uint64_t(1) << 32;
+        uint32_t previous = events[0].time;
+        for (const miosix::TraceEvent &event : events) {
+            time += static_cast<int32_t>(event.time - previous);
+            previous = event.time;
+            records.push_back({time, event});
+        }
+        std::stable_sort(records.begin(), records.end(), [](const Record &a, const Record &b) {
+            return a.time < b.time;
+        });
+
+        std::vector<Entry> entries;
+        Section last = {0, 0, 0, 0, 0};
+        bool inSection = false;
+        Section section = {0, 0, 0, 0, 0};
+        std::map<int, std::vector<uint64_t>> running;
+        for (const Record &record : records) {
+            switch (record.event.type) {
+                case miosix::TRACE_CS_ENTER:
+                    inSection = true;
+                    section = {miosix::TRACE_CS_ENTER, record.event.site, 0, record.time, 0};
+                    break;
+                case miosix::TRACE_CS_LEAVE:
+                    if (!inSection) break;
+                    inSection = false;
+                    section.end = record.time;
+                    addDuration(criticalSections[section.site], section.end - section.start);
+                    last = section;
+                    break;
+                case miosix::TRACE_IRQ_ENTER:
+                    if (record.event.id == irq) entries.push_back({record.time, last});
+                    running[record.event.id].push_back(record.time);
+                    break;
+                case miosix::TRACE_IRQ_EXIT: {
+                    std::vector<uint64_t> &starts = running[record.event.id];
+                    if (starts.empty()) break;
+                    uint64_t start = starts.back();
+                    starts.pop_back();
+                    addDuration(interrupts[record.event.id], record.time - start);
+                    if (record.event.id != irq) last = {miosix::TRACE_IRQ_ENTER, 0, record.event.id, start, record.time};
+                    break;
+                }
+                default:
+                    break;
+            }
+        }
+        addLatencies(entries);
+    };
+
+    /**
+     * Returns the latencies of the traced interrupt.
+     *
+     * @return latencies in cycles, by dump and in time order
+     */
+    inline const std::vector<uint64_t> &getLatencies() const { return latencies; };
+
+    /**
+     * Counts the latencies in bins of the same width.
+     *
+     * @param binWidth width of the bins, in cycles
+     * @return number of latencies in each bin, up to the worst one
+     */
+    std::vector<size_t> getHistogram(uint64_t binWidth) const {
+        std::vector<size_t> bins;
+        for (uint64_t latency : latencies) {
+            size_t bin = static_cast<size_t>(latency / binWidth);
+            if (bin >= bins.size()) bins.resize(bin + 1, 0);
+            bins[bin]++;
+        }
+        return bins;
+    };
+
+    /**
+     * Returns the causes of the delays of the traced interrupt.
+     *
+     * @return offenders, worst delay first
+     */
+    std::vector<Offender> getOffenders() const {
+        std::vector<Offender> result;
+        for (const auto &o : offenders) result.push_back(o.second);
+        std::sort(result.begin(), result.end(), [](const Offender &a, const Offender &b) {
+            return a.worst > b.worst;
+        });
+        return result;
+    };
+
+    /**
+     * Returns the durations of the critical sections.
+     *
+     * @return durations by the address of the code disabling the interrupts
+     */
+    inline const std::map<uint32_t, Durations> &getCriticalSections() const { return criticalSections; };
+
+    /**
+     * Returns the durations of the interrupt handlers.
+     *
+     * @return durations by interrupt number
+     */
+    inline const std::map<int, Durations> &getInterrupts() const { return interrupts; };
+
+private:
+    /**
+     * Event with the counter unwrapped.
+     */
+    struct Record {
+        uint64_t time;
+        miosix::TraceEvent event;
+    };
+
+    /**
+     * Critical section or interrupt handler that ran.
+     */
+    struct Section {
+        unsigned type;
+        uint32_t site;
+        int id;
+        uint64_t start;
+        uint64_t end;
+    };
+
+    /**
+     * Start of the traced interrupt, and what ended last before it.
+     */
+    struct Entry {
+        uint64_t time;
+        Section before;
+    };
+
+    static void addDuration(Durations &durations, uint64_t duration) {
+        durations.count++;
+        durations.total += duration;
+        durations.worst = std::max(durations.worst, duration);
+    };
+
+    /**
+     * Compares the starts of the traced interrupt of a dump to the earliest one.
+     */
+    void addLatencies(const std::vector<Entry> &entries) {
+        if (entries.size() < 3) return;
+        std::vector<uint64_t> intervals;
+        for (size_t i = 1; i < entries.size(); i++) intervals.push_back(entries[i].time - entries[i - 1].time);
+        std::nth_element(intervals.begin(), intervals.begin() + intervals.size() / 2, intervals.end());
+        double period = static_cast<double>(intervals[intervals.size() / 2]);
+
+        // start of each handler compared to the periodic requests
+        std::vector<double> offsets;
+        for (const Entry &entry : entries) {
+            double elapsed = static_cast<double>(entry.time - entries[0].time);
+            offsets.push_back(elapsed - std::round(elapsed / period) * period);
+        }
+        double earliest = *std::min_element(offsets.begin(), offsets.end());
+
+        for (size_t i = 0; i < entries.size(); i++) {
+            uint64_t latency = static_cast<uint64_t>(std::llround(offsets[i] - earliest));
+            latencies.push_back(latency);
+            if (latency == 0) continue;
+
+            // what was running when the interrupt was requested
+            const Section &before = entries[i].before;
+            bool blocked = before.type != 0 && before.end + latency >= entries[i].time;
+            Offender key = {0, 0, 0, 0, 0};
+            if (blocked) {
+                key.type = before.type;
+                key.site = before.site;
+                key.id = before.id;
+            }
+            Offender &offender = offenders[std::make_pair(key.type, blocked && key.type == miosix::TRACE_IRQ_ENTER
+                                                                    ? static_cast<uint32_t>(key.id) : key.site)];
+            if (offender.count == 0) offender = key;
+            offender.count++;
+            offender.worst = std::max(offender.worst, latency);
+        }
+    };
+
+    int irq;
+    std::vector<uint64_t> latencies;
+    std::map<std::pair<unsigned, uint32_t>, Offender> offenders;
+    std::map<uint32_t, Durations> criticalSections;
+    std::map<int, Durations> interrupts;
+};
+
+#endif //MIOSIX_DRUM_IRQ_TRACE_ANALYSIS_H
@@ -0,0 +1,154 @@
+/*
+ * irqtrace: latency histogram and worst offenders from an IRQTrace dump
+ * =====================================================================
+ * Reads a serial log holding the dumps printed by miosix::IRQTrace::dump(),
+ * measures the latency of an interrupt with periodic requests, the I2S DMA
+ * one by default, and prints its histogram, the critical sections and the
+ * interrupt handlers that caused the delays, worst first, and the longest
+ * critical sections of the trace.
+ *
+ * Build:  g++ -O2 -std=c++11 -o irqtrace irqtrace.cpp
+ * Usage:  ./irqtrace [-i irq] [-b bin_us] [-n offenders] [-e main.elf] serial.log
+ *
+ * With -e the addresses of the critical sections are resolved to file and
+ * line by arm-miosix-eabi-addr2line.
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "irq_trace_analysis.h"
+
+using namespace std;
+
+/**
+ * DMA1_Stream5_IRQn, the I2S3 transmit DMA of the audio driver.
+ */
+static const int AUDIO_DMA_IRQ = 16;
+
+/**
+ * Resolves the address of a call site, or returns it in hex if there is no elf.
+ */
+static string resolve(uint32_t site, const string &elf) {
+    char address[16];
+    snprintf(address, sizeof(address), "%08x", site);
+    if (elf.empty() || site == 0) return address;
+    // return address of a call in thumb code: back to the call instruction
+    char command[512];
+    snprintf(command, sizeof(command), "arm-miosix-eabi-addr2line -f -C -s -e %s %x", elf.c_str(),
+             ((site & ~1u) - 1));
+    FILE *pipe = popen(command, "r");
+    if (pipe == nullptr) return address;
+    char function[256] = "", line[256] = "";
+    bool ok = fgets(function, sizeof(function), pipe) != nullptr && fgets(line, sizeof(line), pipe) != nullptr;
+    pclose(pipe);
+    if (!ok) return address;
+    string result = string(address) + " " + function + " " + line;
+    result.erase(remove(result.begin(), result.end(), '\n'), result.end());
+    return result;
+}
+
+static string describe(const IrqTraceAnalysis::Offender &offender, const string &elf) {
+    switch (offender.type) {
+        case miosix::TRACE_CS_ENTER:
+            return "critical section " + resolve(offender.site, elf);
+        case miosix::TRACE_IRQ_ENTER:
+            return "irq " + to_string(offender.id);
+        default:
+            return "no traced blocker";
+    }
+}
+
+static void usage() {
+    cerr << "Usage: irqtrace [-i irq] [-b bin_us] [-n offenders] [-e main.elf] serial.log" << endl;
+}
+
+int main(int argc, char *argv[]) {
+    int irq = AUDIO_DMA_IRQ;
+    double binUs = 1.0;
+    size_t shown = 10;
+    string elf, input;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "-i" && i + 1 < argc) {
+            irq = atoi(argv[++i]);
+        } else if (arg == "-b" && i + 1 < argc) {
+            binUs = atof(argv[++i]);
+        } else if (arg == "-n" && i + 1 < argc) {
+            shown = static_cast<size_t>(atoi(argv[++i]));
+        } else if (arg == "-e" && i + 1 < argc) {
+            elf = argv[++i];
+        } else if (input.empty()) {
+            input = arg;
+        } else {
+            usage();
+            return 1;
+        }
+    }
+    if (input.empty() || binUs <= 0) {
+        usage();
+        return 1;
+    }
+
+    ifstream in(input.c_str());
+    if (!in) {
+        cerr << input << ": cannot open" << endl;
+        return 1;
+    }
+    IrqTraceAnalysis analysis(irq);
+    vector<miosix::TraceEvent> events;
+    unsigned frequency = 0;
+    size_t dumps = 0;
+    while (IrqTraceAnalysis::readDump(in, events, frequency)) {
+        analysis.add(events);
+        dumps++;
+    }
+    if (dumps == 0 || frequency == 0) {
+        cerr << input << ": no irqtrace dump" << endl;
+        return 1;
+    }
+    double cyclesPerUs = frequency / 1e6;
+
+    const vector<uint64_t> &latencies = analysis.getLatencies();
+    printf("%zu dumps, %zu starts of irq %d\n\n", dumps, latencies.size(), irq);
+    printf("Latency histogram\n");
+    uint64_t binWidth = static_cast<uint64_t>(binUs * cyclesPerUs + 0.5);
+    if (binWidth == 0) binWidth = 1;
+    vector<size_t> bins = analysis.getHistogram(binWidth);
+    for (size_t i = 0; i < bins.size(); i++) {
+        if (bins[i] == 0) continue;
+        printf("%8.1f-%-8.1fus %8zu\n", i * binWidth / cyclesPerUs, (i + 1) * binWidth / cyclesPerUs, bins[i]);
+    }
+
+    printf("\nWorst offenders\n");
+    vector<IrqTraceAnalysis::Offender> offenders = analysis.getOffenders();
+    for (size_t i = 0; i < offenders.size() && i < shown; i++) {
+        printf("%8.2fus %6zu times  %s\n", offenders[i].worst / cyclesPerUs, offenders[i].count,
+               describe(offenders[i], elf).c_str());
+    }
+
+    printf("\nLongest critical sections\n");
+    vector<pair<uint32_t, IrqTraceAnalysis::Durations>> sections(analysis.getCriticalSections().begin(),
+                                                                   analysis.getCriticalSections().end());
+    sort(sections.begin(), sections.end(), [](const pair<uint32_t, IrqTraceAnalysis::Durations> &a,
+                                              const pair<uint32_t, IrqTraceAnalysis::Durations> &b) {
+        return a.second.worst > b.second.worst;
+    });
+    for (size_t i = 0; i < sections.size() && i < shown; i++) {
+        const IrqTraceAnalysis::Durations &d = sections[i].second;
+        printf("%8.2fus max %8.2fus mean %6zu times  %s\n", d.worst / cyclesPerUs,
+               d.total / cyclesPerUs / d.count, d.count, resolve(sections[i].first, elf).c_str());
+    }
+
+    printf("\nInterrupt handlers\n");
+    for (const auto &h : analysis.getInterrupts()) {
+        printf("%8.2fus max %8.2fus mean %6zu times  irq %d\n", h.second.worst / cyclesPerUs,
+               h.second.total / cyclesPerUs / h.second.count, h.second.count, h.first);
+    }
+    return 0;
+}
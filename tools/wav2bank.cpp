@@ -0,0 +1,212 @@
+/*
+ * wav2bank: converts WAV files into a sample bank header for SampleVoice
+ * ======================================================================
+ * The generated header defines a const Sample for each WAV file, whose data
+ * is placed in flash and played in place by SampleVoice. The files are
+ * mixed down to mono and stored either as 16 bit PCM or as 4 bit IMA-ADPCM,
+ * which takes a quarter of the space. The original sample rate is kept,
+ * the voice resamples it to the output rate.
+ *
+ * Build:  g++ -O2 -std=c++11 -o wav2bank wav2bank.cpp
+ * Usage:  ./wav2bank [-f pcm16|adpcm] [-n namespace] -o bank.h file.wav...
+ *
+ * ADPCM is the default format. The generated header includes
+ * "../audio/sample.h", so it is meant to be written in include/samples/.
+ *
+ * Supported WAV encodings: 8/16/24/32 bit integer PCM and 32 bit float.
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "../include/audio/adpcm.h"
+
+using namespace std;
+
+/**
+ * Decoded content of a WAV file.
+ */
+struct Wav {
+    string name;
+    uint32_t sampleRate;
+    vector<int16_t> samples;
+};
+
+static uint32_t readLE(const uint8_t *p, int bytes) {
+    uint32_t value = 0;
+    for (int i = bytes - 1; i >= 0; i--) value = (value << 8) | p[i];
+    return value;
+}
+
+/**
+ * Reads a WAV file, mixing down to mono 16 bit. Returns false on errors.
+ */
+static bool readWav(const string &filename, Wav &wav) {
+    ifstream in(filename.c_str(), ios::binary);
+    vector<uint8_t> file((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+    if (file.size() < 12 || memcmp(&file[0], "RIFF", 4) != 0 || memcmp(&file[8], "WAVE", 4) != 0) {
+        cerr << filename << ": not a WAV file" << endl;
+        return false;
+    }
+
+    uint32_t format = 0, channels = 0, bits = 0;
+    const uint8_t *data = nullptr;
+    uint32_t dataSize = 0;
+    for (size_t pos = 12; pos + 8 <= file.size();) {
+        uint32_t size = readLE(&file[pos + 4], 4);
+        const uint8_t *chunk = &file[pos + 8];
+        if (pos + 8 + size > file.size()) size = file.size() - pos - 8;
+        if (memcmp(&file[pos], "fmt ", 4) == 0 && size >= 16) {
+            format = readLE(chunk, 2);
+            channels = readLE(chunk + 2, 2);
+            wav.sampleRate = readLE(chunk + 4, 4);
+            bits = readLE(chunk + 14, 2);
+            // WAVE_FORMAT_EXTENSIBLE, the format is in the subformat GUID
+            if (format == 0xfffe && size >= 26) format = readLE(chunk + 24, 2);
+        } else if (memcmp(&file[pos], "data", 4) == 0) {
+            data = chunk;
+            dataSize = size;
+        }
+        pos += 8 + size + (size & 1);
+    }
+
+    bool isFloat = (format == 3 && bits == 32);
+    bool isInt = (format == 1 && (bits == 8 || bits == 16 || bits == 24 || bits == 32));
+    if (data == nullptr || channels == 0 || !(isFloat || isInt)) {
+        cerr << filename << ": unsupported WAV encoding" << endl;
+        return false;
+    }
+
+    uint32_t bytes = bits / 8;
+    uint32_t frames = dataSize / (bytes * channels);
+    for (uint32_t frame = 0; frame < frames; frame++) {
+        double sum = 0;
+        for (uint32_t channel = 0; channel < channels; channel++) {
+            const uint8_t *p = data + (frame * channels + channel) * bytes;
+            uint32_t raw = readLE(p, bytes);
+            double value;
+            if (isFloat) {
+                float f;
+                memcpy(&f, &raw, 4);
+                value = f;
+            } else if (bits == 8) {
+                value = (static_cast<int>(raw) - 128) / 128.0; // 8 bit WAV is unsigned
+            } else {
+                // sign extension of the top bits
+                int32_t s = static_cast<int32_t>(raw << (32 - bits));
+                value = s / 2147483648.0;
+            }
+            sum += value;
+        }
+        double mono = sum / channels * 32768.0;
+        mono = max(-32768.0, min(32767.0, round(mono)));
+        wav.samples.push_back(static_cast<int16_t>(mono));
+    }
+    return true;
+}
+
+/**
+ * C identifier from the name of a file.
+ */
+static string identifier(const string &filename) {
+    size_t start = filename.find_last_of("/\\");
+    string base = filename.substr(start == string::npos ? 0 : start + 1);
+    base = base.substr(0, base.find_last_of('.'));
+    string id;
+    for (char c : base) id += isalnum(static_cast<unsigned char>(c)) ? tolower(c) : '_';
+    if (id.empty() || isdigit(static_cast<unsigned char>(id[0]))) id = "sample_" + id;
+    return id;
+}
+
+static void usage() {
+    cerr << "Usage: wav2bank [-f pcm16|adpcm] [-n namespace] -o bank.h file.wav..." << endl;
+}
+
+int main(int argc, char *argv[]) {
+    bool adpcm = true;
+    string ns = "SampleBank";
+    string output;
+    vector<string> inputs;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "-f" && i + 1 < argc) {
+            string f = argv[++i];
+            if (f != "pcm16" && f != "adpcm") {
+                usage();
+                return 1;
+            }
+            adpcm = (f == "adpcm");
+        } else if (arg == "-n" && i + 1 < argc) {
+            ns = argv[++i];
+        } else if (arg == "-o" && i + 1 < argc) {
+            output = argv[++i];
+        } else {
+            inputs.push_back(arg);
+        }
+    }
+    if (output.empty() || inputs.empty()) {
+        usage();
+        return 1;
+    }
+
+    vector<Wav> wavs;
+    for (const string &input : inputs) {
+        Wav wav;
+        wav.name = identifier(input);
+        if (!readWav(input, wav)) return 1;
+        wavs.push_back(wav);
+    }
+
+    string guard = "MIOSIX_DRUM_" + identifier(output) + "_H";
+    for (char &c : guard) c = toupper(c);
+
+    ofstream out(output.c_str());
+    out << "// Sample bank generated by tools/wav2bank, do not edit\n";
+    out << "#ifndef " << guard << "\n#define " << guard << "\n\n";
+    out << "#include <cstdint>\n#include <cstddef>\n#include \"../audio/sample.h\"\n\n";
+    out << "namespace " << ns << " {\n";
+
+    size_t totalBytes = 0;
+    for (const Wav &wav : wavs) {
+        size_t length = wav.samples.size();
+        if (adpcm) {
+            ImaAdpcm::State encoder;
+            vector<uint8_t> encoded((length + 1) / 2, 0);
+            for (size_t i = 0; i < length; i++) {
+                uint8_t code = encoder.encode(wav.samples[i]);
+                encoded[i / 2] |= (i & 1) ? (code << 4) : code;
+            }
+            out << "    const uint8_t " << wav.name << "_data[] = {";
+            for (size_t i = 0; i < encoded.size(); i++) {
+                char hex[8];
+                snprintf(hex, sizeof(hex), "0x%02x", encoded[i]);
+                out << ((i % 12) ? " " : "\n            ") << hex << (i + 1 < encoded.size() ? "," : "");
+            }
+            totalBytes += encoded.size();
+        } else {
+            out << "    const int16_t " << wav.name << "_data[] = {";
+            for (size_t i = 0; i < length; i++) {
+                out << ((i % 12) ? " " : "\n            ") << wav.samples[i] << (i + 1 < length ? "," : "");
+            }
+            totalBytes += 2 * length;
+        }
+        out << "\n    };\n\n";
+        out << "    const Sample " << wav.name << " = {\"" << wav.name << "\", "
+            << (adpcm ? "SampleFormat::IMA_ADPCM, " : "SampleFormat::PCM16, ")
+            << wav.name << "_data, " << length << ", " << wav.sampleRate << ".0f};\n\n";
+    }
+
+    out << "    const Sample *const SAMPLES[] = {";
+    for (size_t i = 0; i < wavs.size(); i++) out << (i ? ", &" : "&") << wavs[i].name;
+    out << "};\n\n";
+    out << "    const size_t SAMPLE_COUNT = " << wavs.size() << ";\n";
+    out << "}\n\n#endif //" << guard << "\n";
+
+    cout << output << ": " << wavs.size() << " samples, " << totalBytes << " bytes of flash" << endl;
+    return 0;
+}